@@ -18,9 +18,9 @@
 #ifndef ___LOCALE_H__
 #define ___LOCALE_H__
 
-#include <vector>
 #include <Arduino.h>
 #include <aqi.h>
+#include "alert_terms.h"
 
 // LC_TIME
 extern const char *LC_D_T_FMT;
@@ -108,6 +108,7 @@ extern const char *TXT_ATTEMPTING_HTTP_REQ;
 extern const char *TXT_AWAKE_FOR;
 extern const char *TXT_BATTERY_VOLTAGE;
 extern const char *TXT_CONNECTING_TO;
+extern const char *TXT_DATA_FROM;
 extern const char *TXT_COULD_NOT_CONNECT_TO;
 extern const char *TXT_ENTERING_DEEP_SLEEP_FOR;
 extern const char *TXT_READING_FROM;
@@ -127,32 +128,9 @@ extern const char *TXT_VERY_LOW_BATTERY_VOLTAGE;
 extern const char *TXT_CRIT_LOW_BATTERY_VOLTAGE;
 
 // ALERTS
-extern const std::vector<String> ALERT_URGENCY;
-// ALERT TERMINOLOGY
-extern const std::vector<String> TERM_SMOG;
-extern const std::vector<String> TERM_SMOKE;
-extern const std::vector<String> TERM_FOG;
-extern const std::vector<String> TERM_METEOR;
-extern const std::vector<String> TERM_NUCLEAR;
-extern const std::vector<String> TERM_BIOHAZARD;
-extern const std::vector<String> TERM_EARTHQUAKE;
-extern const std::vector<String> TERM_FIRE;
-extern const std::vector<String> TERM_HEAT;
-extern const std::vector<String> TERM_WINTER;
-extern const std::vector<String> TERM_TSUNAMI;
-extern const std::vector<String> TERM_LIGHTNING;
-extern const std::vector<String> TERM_SANDSTORM;
-extern const std::vector<String> TERM_FLOOD;
-extern const std::vector<String> TERM_VOLCANO;
-extern const std::vector<String> TERM_AIR_QUALITY;
-extern const std::vector<String> TERM_TORNADO;
-extern const std::vector<String> TERM_SMALL_CRAFT_ADVISORY;
-extern const std::vector<String> TERM_GALE_WARNING;
-extern const std::vector<String> TERM_STORM_WARNING;
-extern const std::vector<String> TERM_HURRICANE_WARNING;
-extern const std::vector<String> TERM_HURRICANE;
-extern const std::vector<String> TERM_DUST;
-extern const std::vector<String> TERM_STRONG_WIND;
+// automaton of the ALERT_URGENCY and TERM_* keywords, built at compile time,
+// see matchAlertTerms()
+extern const alert_node_t *const ALERT_AUTOMATON;
 
 // AIR QUALITY INDEX
 extern "C" {
@@ -0,0 +1,65 @@
+/* Alert selection declarations for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __ALERT_SELECT_H__
+#define __ALERT_SELECT_H__
+
+#include <cstdint>
+#include <vector>
+#include "api_response.h"
+
+// alerts kept for the display
+#define ALERT_SELECTED   2
+// event text read from the response, bytes (with the terminator)
+#define ALERT_READ_LEN 128
+// event and tag text kept of a candidate, bytes (with the terminator)
+#define ALERT_EVENT_LEN 64
+#define ALERT_TAG_LEN   32
+
+/*
+ * An alert that is still the most urgent of its tag.
+ */
+typedef struct alert_slot
+{
+  int64_t  start;
+  int64_t  end;
+  uint32_t tag_hash;              // FNV-1a of tags
+  int8_t   urgency;               // index in ALERT_URGENCY, or -1
+  bool     tagged;                // false if the alert has no tags
+  char     event[ALERT_EVENT_LEN]; // lowercase, extra info truncated
+  char     tags[ALERT_TAG_LEN];   // first tag, lowercase
+} alert_slot_t;
+
+/*
+ * Picks the alerts to display while the response is read, one alert at a
+ * time, in fixed slots.
+ */
+typedef struct alert_selector
+{
+  alert_slot_t slot[OWM_NUM_ALERTS]; // in the order the alerts came
+  uint8_t      used;
+  uint8_t      offered;
+} alert_selector_t;
+
+void truncateExtraAlertInfo(char *text);
+void alertSelectorInit(alert_selector_t &s);
+void alertSelectorOffer(alert_selector_t &s, char *event, char *tags,
+                        int64_t start, int64_t end);
+void alertSelectorResult(const alert_selector_t &s,
+                         std::vector<owm_alerts_t> &alerts);
+
+#endif
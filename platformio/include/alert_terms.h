@@ -0,0 +1,202 @@
+/* Alert terminology matching declarations for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __ALERT_TERMS_H__
+#define __ALERT_TERMS_H__
+
+#include <cstddef>
+#include <cstdint>
+
+// keywords per ALERT_URGENCY or TERM_* list, unused entries are nullptr
+#define ALERT_TERMS_MAX 16
+
+typedef const char *alert_terms_t[ALERT_TERMS_MAX];
+
+/*
+ * A state of the Aho-Corasick automaton of the locale's alert keywords. The
+ * states form a trie of the keywords, children are linked in byte order.
+ */
+typedef struct alert_node
+{
+  uint8_t  c;        // byte on the edge from the parent
+  int8_t   category; // first TERM_* list of a keyword that ends here, or -1
+  int8_t   urgency;  // highest ALERT_URGENCY level that ends here, or -1
+  uint16_t child;    // first child, 0 if none
+  uint16_t sibling;  // next child of the parent, 0 if none
+  uint16_t fail;     // state of the longest proper suffix in the trie
+} alert_node_t;
+
+/*
+ * What matchAlertTerms() found in a string, -1 where nothing matched.
+ */
+typedef struct alert_match
+{
+  int8_t category; // enum alert_category
+  int8_t urgency;  // index in ALERT_URGENCY
+} alert_match_t;
+
+template <size_t N>
+struct alert_automaton
+{
+  alert_node_t node[N];
+};
+
+/* Returns the state after reading byte c in state s.
+ */
+constexpr uint16_t alertNextState(const alert_node_t *node, uint16_t s,
+                                  uint8_t c)
+{
+  for (;;)
+  {
+    uint16_t t = node[s].child;
+    while (t && node[t].c < c)
+    {
+      t = node[t].sibling;
+    }
+    if (t && node[t].c == c)
+    {
+      return t;
+    }
+    if (s == 0)
+    {
+      return 0;
+    }
+    s = node[s].fail;
+  }
+} // end alertNextState
+
+/* The number of states the automaton of these lists needs at most, one more
+ * than the number of bytes in their keywords.
+ */
+constexpr size_t alertAutomatonSize(const char *const *const *categories,
+                                    size_t count,
+                                    const char *const *urgency)
+{
+  size_t n = 1;
+  for (size_t k = 0; k <= count; ++k)
+  {
+    const char *const *terms = k < count ? categories[k] : urgency;
+    for (size_t t = 0; t < ALERT_TERMS_MAX && terms[t]; ++t)
+    {
+      for (const char *p = terms[t]; *p; ++p)
+      {
+        ++n;
+      }
+    }
+  }
+  return n;
+} // end alertAutomatonSize
+
+/* Returns the child of s for byte c, added in byte order if there is none.
+ */
+template <size_t N>
+constexpr uint16_t alertAddChild(alert_automaton<N> &a, uint16_t &states,
+                                 uint16_t s, uint8_t c)
+{
+  uint16_t prev = 0;
+  uint16_t t = a.node[s].child;
+  while (t && a.node[t].c < c)
+  {
+    prev = t;
+    t = a.node[t].sibling;
+  }
+  if (t && a.node[t].c == c)
+  {
+    return t;
+  }
+  uint16_t n = states++;
+  a.node[n] = {c, -1, -1, 0, t, 0};
+  if (prev)
+  {
+    a.node[prev].sibling = n;
+  }
+  else
+  {
+    a.node[s].child = n;
+  }
+  return n;
+} // end alertAddChild
+
+/* Builds the automaton of the keywords of the TERM_* lists, categories[k]
+ * being the list of alert_category k, and of the ALERT_URGENCY list. Meant
+ * to run at compile time, N from alertAutomatonSize().
+ */
+template <size_t N>
+constexpr alert_automaton<N> buildAlertAutomaton(
+  const char *const *const *categories, size_t count,
+  const char *const *urgency)
+{
+  alert_automaton<N> a{};
+  uint16_t states = 1;
+  a.node[0] = {0, -1, -1, 0, 0, 0};
+  for (size_t k = 0; k <= count; ++k)
+  {
+    const char *const *terms = k < count ? categories[k] : urgency;
+    for (size_t t = 0; t < ALERT_TERMS_MAX && terms[t]; ++t)
+    {
+      uint16_t s = 0;
+      for (const char *p = terms[t]; *p; ++p)
+      {
+        s = alertAddChild(a, states, s, static_cast<uint8_t>(*p));
+      }
+      alert_node_t &end = a.node[s];
+      if (k == count)
+      {
+        end.urgency = static_cast<int8_t>(t);
+      }
+      else if (end.category < 0)
+      {
+        end.category = static_cast<int8_t>(k);
+      }
+    }
+  }
+
+  // failure links breadth first, so the suffix of a state is done before it
+  // and passes on the keywords that end with it
+  uint16_t queue[N] = {};
+  size_t head = 0;
+  size_t tail = 0;
+  queue[tail++] = 0;
+  while (head < tail)
+  {
+    uint16_t u = queue[head++];
+    if (u != 0)
+    {
+      const alert_node_t &f = a.node[a.node[u].fail];
+      alert_node_t &n = a.node[u];
+      if (f.category >= 0 && (n.category < 0 || f.category < n.category))
+      {
+        n.category = f.category;
+      }
+      if (f.urgency > n.urgency)
+      {
+        n.urgency = f.urgency;
+      }
+    }
+    for (uint16_t v = a.node[u].child; v; v = a.node[v].sibling)
+    {
+      a.node[v].fail = (u == 0)
+                     ? 0 : alertNextState(a.node, a.node[u].fail, a.node[v].c);
+      queue[tail++] = v;
+    }
+  }
+  return a;
+} // end buildAlertAutomaton
+
+alert_match_t matchAlertTerms(const char *text, size_t len);
+
+#endif
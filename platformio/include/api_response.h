@@ -34,12 +34,15 @@
 #define USGS_NUM_SIG_EVENTS   10 // no limit to earthquake events, set to 10 per day
 #define USGS_NUM_GEOMETRY      3 // 3 coordinate pts max
 
+/*
+ * Weather condition, packed. The group ("Rain", "Snow", ...) and description
+ * are implied by the id, so the text fields of the response are not kept.
+ */
 typedef struct owm_weather
 {
-  int     id;               // Weather condition id
-  String  main;             // Group of weather parameters (Rain, Snow, Extreme etc.)
-  String  description;      // Weather condition within the group (full list of weather conditions). Get the output in your language
-  String  icon;             // Weather icon id.
+  uint16_t id;              // Weather condition id
+  uint8_t  icon;            // Weather icon number, e.g. 10 for "10d"
+  bool     day;             // Weather icon id ends with d (day), otherwise n (night)
 } owm_weather_t;
 
 /*
@@ -163,6 +166,26 @@ typedef struct owm_alerts
   String  tags;             // Type of severe weather
 } owm_alerts_t;
 
+/*
+ * Hourly forecast shown on the outlook graph, stored column by column.
+ * Filled at parse time from the first HOURLY_GRAPH_MAX hourly entries.
+ * Temperature and precipitation are already in the configured display units.
+ */
+typedef struct owm_hourly_series
+{
+  int      count;                       // Number of hours in the series
+  int64_t  dt[OWM_NUM_HOURLY];          // Time of the forecasted data, unix, UTC
+  float    temp[OWM_NUM_HOURLY];        // Temperature, display units
+  float    precip[OWM_NUM_HOURLY];      // PoP (%) or precipitation volume, display units
+  uint8_t  clouds[OWM_NUM_HOURLY];      // Cloudiness, %
+  float    wind_speed[OWM_NUM_HOURLY];  // Wind speed, metre/sec
+  float    wind_gust[OWM_NUM_HOURLY];   // Wind gust, metre/sec
+  owm_weather_t weather[OWM_NUM_HOURLY];
+  float    temp_min;                    // Lowest temp in the series
+  float    temp_max;                    // Highest temp in the series
+  float    precip_max;                  // Highest precip in the series
+} owm_hourly_series_t;
+
 /*
  * Response from OpenWeatherMap's OneCall API
  *
@@ -178,6 +201,7 @@ typedef struct owm_resp_onecall
   // owm_minutely_t  minutely[OWM_NUM_MINUTELY];
 
   owm_hourly_t    hourly[OWM_NUM_HOURLY];
+  owm_hourly_series_t hourly_series;
   owm_daily_t     daily[OWM_NUM_DAILY];
   std::vector<owm_alerts_t> alerts;
 } owm_resp_onecall_t;
@@ -243,14 +267,19 @@ typedef struct usgs_feature
   usgs_properties_t properties;
   usgs_geom_t geometry;
   String id;                // ID for event
+  float distance;           // distance from the requested location in km
 } usgs_feature_t;
 
+/*
+* Top USGS_NUM_SIG_EVENTS events of a feed, ranked by USGS_RANK_BY_MAGNITUDE.
+* features[0] is the best ranked event.
+*/
 typedef struct usgs_earth_resp
 {
   usgs_metadata_t metadata;
   usgs_feature_t features[USGS_NUM_SIG_EVENTS];
+  int num_features;         // number of valid entries in features
   usgs_bbox_t bbox;
-  
 } usgs_earth_resp_t;
 
 
@@ -289,12 +318,16 @@ typedef struct owm_resp_air_pollution
 
 
 
-DeserializationError deserializeOneCall(WiFiClient &json,
+DeserializationError deserializeOneCall(Stream &json,
                                     owm_resp_onecall_t &r);
-DeserializationError deserializeAirQuality(WiFiClient &json,
+DeserializationError deserializeAirQuality(Stream &json,
                                     owm_resp_air_pollution_t &r);
-DeserializationError deserializeUSGSEarthquake(WiFiClient &json, 
-                                    usgs_feature_t &r, float my_lat, float my_lon);                                           
+DeserializationError deserializeUSGSEarthquake(Stream &json,
+                                    usgs_earth_resp_t &r, float my_lat, float my_lon);
+size_t packUSGSEarthquake(const usgs_earth_resp_t &r, uint8_t *buf,
+                          size_t size);
+bool unpackUSGSEarthquake(usgs_earth_resp_t &r, const uint8_t *buf,
+                          size_t len);
 
 #endif
 
@@ -19,27 +19,49 @@
 #define __CLIENT_UTILS_H__
 
 #include <Arduino.h>
+#include <HTTPClient.h>
 #include "api_response.h"
 #include "config.h"
 #ifdef USE_HTTP
   #include <WiFiClient.h>
 #else
   #include <WiFiClientSecure.h>
+  #include "tls_session.h"
 #endif
 
 wl_status_t startWiFi(int &wifiRSSI);
 void killWiFi();
 bool waitForSNTPSync(tm *timeInfo);
 bool printLocalTime(tm *timeInfo);
+
 #ifdef USE_HTTP
-  int getOWMonecall(WiFiClient &client, owm_resp_onecall_t &r);
-  int getOWMairpollution(WiFiClient &client, owm_resp_air_pollution_t &r);
-  int getUSGSEarthquake(WiFiClient &client, usgs_earth_resp_t &r);
+  typedef WiFiClient api_client_t;
 #else
-  int getOWMonecall(WiFiClientSecure &client, owm_resp_onecall_t &r);
-  int getOWMairpollution(WiFiClientSecure &client, owm_resp_air_pollution_t &r);
-  int getUSGSEarthquake(WiFiClientSecure &client, usgs_feature_t &r, String uri);
+  typedef ResumableClientSecure api_client_t;
 #endif
 
+// one connection for each request that may run, and one kept for another host
+#define HTTP_POOL_SIZE (CONCURRENT_REQUESTS + 1)
+
+/*
+ * Connection to an API host that is kept open (HTTP/1.1 keep-alive) for the
+ * next request to the same host, see acquireConnection().
+ */
+typedef struct http_connection
+{
+  api_client_t client;
+  HTTPClient   http;    // destroying it would close the connection
+  String       host;
+  bool         busy;
+} http_connection_t;
+
+http_connection_t *acquireConnection(const String &host, const char *caCert);
+void releaseConnection(http_connection_t *conn);
+void closeConnections();
+int getOWMonecall(http_connection_t &conn, owm_resp_onecall_t &r);
+int getOWMairpollution(http_connection_t &conn, owm_resp_air_pollution_t &r);
+int getUSGSEarthquake(http_connection_t &conn, usgs_earth_resp_t &r,
+                      String uri);
+
 #endif
 
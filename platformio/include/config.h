@@ -150,6 +150,74 @@
 // #define USE_HTTPS_NO_CERT_VERIF
 #define USE_HTTPS_WITH_CERT_VERIF
 
+// TLS SESSION RESUMPTION
+//   A full TLS handshake takes seconds at 80MHz, most of it in the key
+//   exchange. The TLS session of each API host is kept in RTC memory through
+//   deep sleep so that the next wake can offer it to the server and do an
+//   abbreviated handshake. Servers may decline, then a full handshake is done
+//   as usual. Takes ~3kB of the 8kB RTC memory. Not used with USE_HTTP.
+//   Sessions are offered for at most TLS_SESSION_MAX_AGE, see config.cpp.
+#define TLS_SESSION_RESUMPTION 1
+
+// HTTP RESPONSE CACHE
+//   The USGS feeds and the air pollution history often have not changed since
+//   the last wake. Their parsed responses are kept in flash (NVS) along with
+//   the ETag/Last-Modified the server sent, and requested again with
+//   If-None-Match/If-Modified-Since. If the server answers 304 Not Modified,
+//   the cached result is used and no body is downloaded or parsed. Flash is
+//   only written when a response has changed.
+//   0 : Always download the full responses
+#define HTTP_RESPONSE_CACHE 1
+
+// STALE DATA FALLBACK
+//   The last good response of each API request is kept in RTC memory as a
+//   compact snapshot (~2kB). If a request fails, the dashboard is drawn from
+//   the snapshot instead of the error screen, with the time the data is from
+//   in the status bar. Snapshots older than STALE_DATA_MAX_AGE are not used,
+//   see config.cpp. Takes 2.5kB of the 8kB RTC memory.
+//   0 : Show the error screen if any request fails
+#define STALE_DATA_FALLBACK 1
+
+// PARTIAL REFRESH
+//   Only used with DISP_BW_V2, the only panel with fast partial update. The
+//   frame on the panel is kept compressed in flash (LittleFS, ~17kB) and
+//   compared with the new frame. Only the areas that changed are refreshed,
+//   with partial refreshes instead of a full refresh that flashes the whole
+//   panel, and nothing is refreshed if the frame has not changed. A full
+//   refresh is still done every FULL_REFRESH_INTERVAL refreshes to clear
+//   ghosting, see config.cpp.
+//   0 : Always do a full refresh
+#define PARTIAL_REFRESH 1
+
+// FULL FRAME BUFFER
+//   GxEPD2 draws DISP_3C_B and DISP_7C_F in 2 (3C) or 4 (7C) pages, running all
+//   of the drawing once per page. Instead, the whole frame is drawn once, into
+//   two 1-bit planes (black and accent, 96kB; one 48kB plane for BW panels),
+//   and then sent to the panel. The planes are kept in PSRAM if the board has
+//   it, otherwise in the heap, in as few pages as fit. Icons and text are
+//   copied into the planes a byte at a time instead of pixel by pixel.
+//   On DISP_BW_V2 a frame drawn in pages gets a full refresh, and the next
+//   refresh is full too (PARTIAL_REFRESH needs the whole frame).
+//   0 : Draw with GxEPD2 (in pages on DISP_3C_B and DISP_7C_F)
+#define FULL_FRAME_BUFFER 1
+
+// DISPLAY LIST
+//   Only used with DISP_3C_B and DISP_7C_F when FULL_FRAME_BUFFER is 0. The
+//   draw calls of the first page are recorded (up to 48kB) and the other pages
+//   are drawn from the recording, skipping whatever is outside of the page,
+//   so the drawing code runs once instead of once per page.
+//   0 : Run the drawing code for every page (GxEPD2)
+#define DISPLAY_LIST 1
+
+// CONCURRENT REQUESTS
+//   The API requests do not depend on each other. Up to this many of them run
+//   at the same time, each in its own task with its own connection, so their
+//   TLS handshakes and round trips overlap and WiFi can be turned off sooner.
+//   Every HTTPS connection holds its own TLS buffers (~40kB of heap), only
+//   raise this if there is plenty of free heap.
+//   1 : One request after the other
+#define CONCURRENT_REQUESTS 2
+
 // WIND DIRECTION INDICATOR
 // Choose whether the wind direction indicator should be an arrow, number, or
 // expressed in Compass Point Notation (CPN).
@@ -170,11 +238,11 @@
 
 // WIND DIRECTION ICON PRECISION
 // The wind direction icon shown to the left of the wind speed can indicate wind
-// direction with a minimum error of ±0.5°. This uses more flash storage because
-// 360 24x24 wind direction icons must be stored, totaling ~25kB. For either
-// preference or in case flash space becomes a concern there are a handful of
-// selectable options listed below. 360 points seems excessive, but the option
-// is there.
+// direction with a minimum error of ±0.5°. Stored icons use more flash storage
+// the more directions there are, 360 24x24 wind direction icons total ~25kB.
+// Rotated draws the arrow at any whole degree from one outline instead, with a
+// sine table, for a few hundred bytes of flash. For either preference there
+// are a handful of selectable options listed below.
 //
 //   PRECISION                  #     ERROR  STORAGE
 //   Cardinal                   4  ±45.000°     288B  E
@@ -182,12 +250,14 @@
 //   Secondary Intercardinal   16  ±11.250°   1,152B  NNE
 //   Tertiary Intercardinal    32   ±5.625°   2,304B  NbE
 //   (360)                    360   ±0.500°  25,920B  1°
+//   Rotated                  360   ±0.500°    ~500B  1°
 // Uncomment your preferred wind level direction precision.
 // #define WIND_ICONS_CARDINAL
 // #define WIND_ICONS_INTERCARDINAL
 #define WIND_ICONS_SECONDARY_INTERCARDINAL
 // #define WIND_ICONS_TERTIARY_INTERCARDINAL
 // #define WIND_ICONS_360
+// #define WIND_ICONS_ROTATED
 
 // FONTS
 // A handful of popular Open Source typefaces have been included with this
@@ -219,6 +289,24 @@
 //   other artifacts.
 #define FONT_HEADER "fonts/FreeSans.h"
 
+// FONT SUBSET
+//   Before each build, scripts/font_subset.py writes a copy of FONT_HEADER with
+//   only the sizes the firmware uses, and in each only the glyphs it can draw:
+//   printable ASCII, the characters of the LOCALE strings and the degree sign.
+//   The other glyphs take no flash, text from the network that uses them
+//   (alerts, city names) draws them as '?'.
+//   0 : Build with every glyph of the font
+#define FONT_SUBSET 1
+
+// FONT COMPRESSION
+//   Requires FULL_FRAME_BUFFER. scripts/font_subset.py also stores each glyph
+//   as runs of 4-bit codes when that is smaller than its bitmap, and the
+//   glyphs are decoded row by row as they are drawn. Large sizes take about
+//   half the flash (FreeSans 26pt: 27kB to 14kB, 48pt temperature: 4kB to
+//   1.7kB), small sizes stay about the same.
+//   0 : Store glyph bitmaps uncompressed
+#define FONT_COMPRESS 1
+
 // DAILY PRECIPITATION
 // Daily precipitation indicated under Hi|Lo can optionally be configured using
 // the following options.
@@ -255,6 +343,25 @@
 //   If you wish to disable battery monitoring set this macro to 0.
 #define BATTERY_MONITORING 1
 
+// JSON PARSER
+//   The OpenWeatherMap One Call response is ~20kB. By default it is parsed as
+//   it arrives and written straight into the response struct, hourly entries
+//   that are not shown are skipped without being stored. This needs no
+//   JsonDocument and keeps the peak heap usage of the request low.
+//   Set to 0 to deserialize into an ArduinoJson document instead.
+//   0 : ArduinoJson document
+//   1 : Streaming
+#define JSON_STREAMING_PARSER 1
+
+// USGS EARTHQUAKE RANKING
+//   Each USGS feed is read one event at a time and only the best ranked events
+//   are kept, so feeds with thousands of events (all_day, 2.5_week) fit in the
+//   same amount of memory as significant_week.
+//   0 : Nearest event first
+//   1 : Magnitude-weighted, a strong earthquake further away can outrank a
+//       weak one nearby
+#define USGS_RANK_BY_MAGNITUDE 0
+
 // NON-VOLATILE STORAGE (NVS) NAMESPACE
 #define NVS_NAMESPACE "weather_epd"
 
@@ -283,6 +390,10 @@ extern const char *WIFI_SSID;
 extern const char *WIFI_PASSWORD;
 extern const unsigned long WIFI_TIMEOUT;
 extern const unsigned HTTP_CLIENT_TCP_TIMEOUT;
+extern const uint32_t TLS_SESSION_MAX_AGE;
+extern const uint32_t STALE_DATA_MAX_AGE;
+extern const uint16_t FULL_REFRESH_INTERVAL;
+extern const uint8_t PARTIAL_REFRESH_MAX_AREA;
 extern const String USGS_ENDPOINT;
 extern const String OWM_APIKEY;
 extern const String OWM_ENDPOINT;
@@ -371,6 +482,27 @@ extern const uint32_t MIN_BATTERY_VOLTAGE;
       ^ defined(USE_HTTPS_WITH_CERT_VERIF))
   #error Invalid configuration. Exactly one HTTP mode must be selected.
 #endif
+#if !(defined(TLS_SESSION_RESUMPTION))
+  #error Invalid configuration. TLS_SESSION_RESUMPTION not defined.
+#endif
+#if !(defined(HTTP_RESPONSE_CACHE))
+  #error Invalid configuration. HTTP_RESPONSE_CACHE not defined.
+#endif
+#if !(defined(STALE_DATA_FALLBACK))
+  #error Invalid configuration. STALE_DATA_FALLBACK not defined.
+#endif
+#if !(defined(PARTIAL_REFRESH))
+  #error Invalid configuration. PARTIAL_REFRESH not defined.
+#endif
+#if !(defined(FULL_FRAME_BUFFER))
+  #error Invalid configuration. FULL_FRAME_BUFFER not defined.
+#endif
+#if !(defined(DISPLAY_LIST))
+  #error Invalid configuration. DISPLAY_LIST not defined.
+#endif
+#if !(defined(CONCURRENT_REQUESTS)) || CONCURRENT_REQUESTS < 1
+  #error Invalid configuration. CONCURRENT_REQUESTS must be at least 1.
+#endif
 #if !(  defined(WIND_INDICATOR_ARROW)                         \
       || (                                                    \
           defined(WIND_INDICATOR_NUMBER)                      \
@@ -387,12 +519,22 @@ extern const uint32_t MIN_BATTERY_VOLTAGE;
       ^ defined(WIND_ICONS_INTERCARDINAL)           \
       ^ defined(WIND_ICONS_SECONDARY_INTERCARDINAL) \
       ^ defined(WIND_ICONS_TERTIARY_INTERCARDINAL)  \
-      ^ defined(WIND_ICONS_360))
+      ^ defined(WIND_ICONS_360)                     \
+      ^ defined(WIND_ICONS_ROTATED))
   #error Invalid configuration. Exactly one wind direction icon precision level must be selected.
 #endif
 #if !(defined(FONT_HEADER))
   #error Invalid configuration. Font not selected.
 #endif
+#if !(defined(FONT_SUBSET))
+  #error Invalid configuration. FONT_SUBSET not defined.
+#endif
+#if !(defined(FONT_COMPRESS))
+  #error Invalid configuration. FONT_COMPRESS not defined.
+#endif
+#if FONT_COMPRESS && !FULL_FRAME_BUFFER
+  #error Invalid configuration. FONT_COMPRESS requires FULL_FRAME_BUFFER.
+#endif
 #if !(defined(DISPLAY_DAILY_PRECIP))
   #error Invalid configuration. DISPLAY_DAILY_PRECIP not defined.
 #endif
@@ -402,6 +544,12 @@ extern const uint32_t MIN_BATTERY_VOLTAGE;
 #if !(defined(DISPLAY_ALERTS))
   #error Invalid configuration. DISPLAY_ALERTS not defined.
 #endif
+#if !(defined(JSON_STREAMING_PARSER))
+  #error Invalid configuration. JSON_STREAMING_PARSER not defined.
+#endif
+#if !(defined(USGS_RANK_BY_MAGNITUDE))
+  #error Invalid configuration. USGS_RANK_BY_MAGNITUDE not defined.
+#endif
 #if !(defined(BATTERY_MONITORING))
   #error Invalid configuration. BATTERY_MONITORING not defined.
 #endif
@@ -0,0 +1,390 @@
+/* Display list declarations for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __DISPLAY_LIST_H__
+#define __DISPLAY_LIST_H__
+
+#include <cstdint>
+#include <cstdlib>
+#include <Arduino.h>
+
+// the list grows from DISPLAY_LIST_MIN_CMDS up to DISPLAY_LIST_MAX_CMDS
+// commands (24B each on the esp32), a longer frame is drawn page by page
+#define DISPLAY_LIST_MIN_CMDS  256
+#define DISPLAY_LIST_MAX_CMDS 2048
+
+typedef enum display_cmd_type : uint8_t
+{
+  DL_PIXELS, // count (h) pixels in a row, step (w) apart
+  DL_LINE,   // (x, y) to (w, h)
+  DL_RECT,   // filled
+  DL_BITMAP, // inverted bitmap, set bits are not drawn
+  DL_GLYPH   // character c of font data at cursor (x, y), size (w, h)
+} display_cmd_type_t;
+
+typedef struct display_cmd
+{
+  const void *data;  // bitmap or font, in flash
+  int16_t     x;
+  int16_t     y;
+  int16_t     w;
+  int16_t     h;
+  uint16_t    color;
+  uint16_t    bg;
+  int16_t     ys;    // first and last panel row the command draws on
+  int16_t     ye;
+  uint8_t     type;  // display_cmd_type_t
+  uint8_t     c;
+} display_cmd_t;
+
+typedef enum display_list_state
+{
+  DL_OFF,       // drawing goes straight to the page, one pass per page
+  DL_RECORDING, // first page, drawing is recorded and drawn
+  DL_REPLAYING  // following pages, drawn from the list
+} display_list_state_t;
+
+/*
+ * Paged GxEPD2 display (GxEPD2_3C, GxEPD2_7C) that runs the drawing code only
+ * once per frame.
+ *
+ * During the first page, every draw call is recorded into a list, along with
+ * the panel rows it covers, and drawn as usual. nextPage() then draws each of
+ * the remaining pages from the list, skipping commands outside the page, and
+ * returns false. So the body of
+ *   do { ... } while (display.nextPage());
+ * runs once, and text formatting and measurement are not repeated per page.
+ *
+ * Bitmaps and fonts are recorded by pointer and must stay valid until the
+ * frame is done (the icons and fonts are in flash). If the list does not fit
+ * in DISPLAY_LIST_MAX_CMDS commands, or the text wraps or the rotation
+ * changes while recording, recording stops and nextPage() returns to the
+ * drawing code for every page, as GxEPD2 does.
+ */
+template <typename GxEPD2_GFX_Type>
+class DisplayListEPD : public GxEPD2_GFX_Type
+{
+public:
+  using GxEPD2_GFX_Type::GxEPD2_GFX_Type;
+  using GxEPD2_GFX_Type::write;
+
+  ~DisplayListEPD() { freeList(); }
+
+  void firstPage()
+  {
+    GxEPD2_GFX_Type::firstPage();
+    freeList();
+    _state = this->pages() > 1 ? DL_RECORDING : DL_OFF;
+  }
+
+  bool nextPage()
+  {
+    if (_state != DL_RECORDING)
+    {
+      return GxEPD2_GFX_Type::nextPage();
+    }
+    _state = DL_REPLAYING;
+    const int16_t page_height = this->pageHeight();
+    int16_t page_ys = 0;
+    while (GxEPD2_GFX_Type::nextPage())
+    {
+      page_ys += page_height;
+      replay(page_ys, page_ys + page_height - 1);
+    }
+    freeList();
+    _state = DL_OFF;
+    return false;
+  }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override
+  {
+    if (recording())
+    {
+      recordPixel(x, y, color);
+    }
+    GxEPD2_GFX_Type::drawPixel(x, y, color);
+  }
+
+  void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                uint16_t color) override
+  {
+    if (recording())
+    {
+      record(DL_LINE, x0, y0, x1, y1, color, std::min(x0, x1),
+             std::min(y0, y1), std::max(x0, x1), std::max(y0, y1));
+    }
+    ++_nested;
+    GxEPD2_GFX_Type::drawLine(x0, y0, x1, y1, color);
+    --_nested;
+  }
+
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override
+  {
+    if (recording())
+    {
+      record(DL_RECT, x, y, w, 1, color, x, y, x + w - 1, y);
+    }
+    ++_nested;
+    GxEPD2_GFX_Type::drawFastHLine(x, y, w, color);
+    --_nested;
+  }
+
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override
+  {
+    if (recording())
+    {
+      record(DL_RECT, x, y, 1, h, color, x, y, x, y + h - 1);
+    }
+    ++_nested;
+    GxEPD2_GFX_Type::drawFastVLine(x, y, h, color);
+    --_nested;
+  }
+
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                uint16_t color) override
+  {
+    if (recording())
+    {
+      record(DL_RECT, x, y, w, h, color, x, y, x + w - 1, y + h - 1);
+    }
+    ++_nested;
+    GxEPD2_GFX_Type::fillRect(x, y, w, h, color);
+    --_nested;
+  }
+
+  void fillScreen(uint16_t color) override
+  {
+    if (recording())
+    {
+      record(DL_RECT, 0, 0, this->width(), this->height(), color,
+             0, 0, this->width() - 1, this->height() - 1);
+    }
+    ++_nested;
+    GxEPD2_GFX_Type::fillScreen(color);
+    --_nested;
+  }
+
+  void drawInvertedBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
+                          int16_t w, int16_t h, uint16_t color)
+  {
+    if (recording())
+    {
+      record(DL_BITMAP, x, y, w, h, color, x, y, x + w - 1, y + h - 1,
+             bitmap);
+    }
+    ++_nested;
+    GxEPD2_GFX_Type::drawInvertedBitmap(x, y, bitmap, w, h, color);
+    --_nested;
+  }
+
+  size_t write(uint8_t c) override
+  {
+    if (recording())
+    {
+      recordGlyph(c);
+    }
+    ++_nested;
+    size_t n = GxEPD2_GFX_Type::write(c);
+    --_nested;
+    return n;
+  }
+
+  void setRotation(uint8_t r) override
+  {
+    if (_state == DL_RECORDING && _count > 0)
+    {
+      stopRecording();
+    }
+    GxEPD2_GFX_Type::setRotation(r);
+  }
+
+private:
+  display_cmd_t       *_cmds = nullptr;
+  uint16_t             _count = 0;
+  uint16_t             _capacity = 0;
+  int                  _nested = 0;
+  display_list_state_t _state = DL_OFF;
+
+  bool recording() const
+  {
+    return _state == DL_RECORDING && _nested == 0;
+  }
+
+  void freeList()
+  {
+    free(_cmds);
+    _cmds = nullptr;
+    _count = 0;
+    _capacity = 0;
+  }
+
+  /* The drawing code has to run for every page again.
+   */
+  void stopRecording()
+  {
+    freeList();
+    _state = DL_OFF;
+  }
+
+  /* Panel rows covered by the box (x0, y0)-(x1, y1), in the current rotation.
+   */
+  void panelRows(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                 int16_t &ys, int16_t &ye) const
+  {
+    const int16_t last = this->HEIGHT - 1;
+    switch (this->getRotation())
+    {
+    case 1:  ys = x0;        ye = x1;        break;
+    case 2:  ys = last - y1; ye = last - y0; break;
+    case 3:  ys = last - x1; ye = last - x0; break;
+    default: ys = y0;        ye = y1;        break;
+    }
+  }
+
+  display_cmd_t *append()
+  {
+    if (_count == _capacity)
+    {
+      uint16_t capacity = _capacity ? 2 * _capacity : DISPLAY_LIST_MIN_CMDS;
+      display_cmd_t *cmds = nullptr;
+      if (capacity <= DISPLAY_LIST_MAX_CMDS)
+      {
+        cmds = static_cast<display_cmd_t *>(
+          realloc(_cmds, capacity * sizeof(display_cmd_t)));
+      }
+      if (!cmds)
+      {
+        stopRecording();
+        return nullptr;
+      }
+      _cmds = cmds;
+      _capacity = capacity;
+    }
+    return &_cmds[_count++];
+  }
+
+  void record(display_cmd_type_t type, int16_t x, int16_t y, int16_t w,
+              int16_t h, uint16_t color, int16_t bx0, int16_t by0,
+              int16_t bx1, int16_t by1, const void *data = nullptr,
+              uint8_t c = 0, uint16_t bg = 0)
+  {
+    display_cmd_t *cmd = append();
+    if (!cmd)
+    {
+      return;
+    }
+    *cmd = {data, x, y, w, h, color, bg, 0, 0, type, c};
+    panelRows(bx0, by0, bx1, by1, cmd->ys, cmd->ye);
+  }
+
+  /* Pixels are mostly drawn in dotted rows (grid lines, hatching), evenly
+   * spaced pixels of a row are kept as one command.
+   */
+  void recordPixel(int16_t x, int16_t y, uint16_t color)
+  {
+    if (_count > 0)
+    {
+      display_cmd_t &last = _cmds[_count - 1];
+      if (last.type == DL_PIXELS && last.y == y && last.color == color)
+      {
+        int16_t step = x - last.x;
+        if (last.h == 1 && step > 0)
+        {
+          last.w = step;
+        }
+        if (step == last.w * last.h)
+        {
+          ++last.h;
+          int16_t ys, ye;
+          panelRows(std::min(last.x, x), y, std::max(last.x, x), y, ys, ye);
+          last.ys = std::min(last.ys, ys);
+          last.ye = std::max(last.ye, ye);
+          return;
+        }
+      }
+    }
+    record(DL_PIXELS, x, y, 1, 1, color, x, y, x, y);
+  }
+
+  void recordGlyph(uint8_t c)
+  {
+    if (c == '\n' || c == '\r')
+    {
+      return;
+    }
+    if (this->wrap)
+    {
+      // the glyph may move to the next line, where is left to Adafruit_GFX
+      stopRecording();
+      return;
+    }
+    int16_t x = this->cursor_x;
+    int16_t y = this->cursor_y;
+    int16_t minx = INT16_MAX, miny = INT16_MAX;
+    int16_t maxx = INT16_MIN, maxy = INT16_MIN;
+    this->charBounds(c, &x, &y, &minx, &miny, &maxx, &maxy);
+    if (maxx < minx || maxy < miny)
+    {
+      return; // nothing to draw, e.g. a space
+    }
+    record(DL_GLYPH, this->cursor_x, this->cursor_y, this->textsize_x,
+           this->textsize_y, this->textcolor, minx, miny, maxx, maxy,
+           this->gfxFont, c, this->textbgcolor);
+  }
+
+  /* Draws the commands that touch panel rows [ys, ye].
+   */
+  void replay(int16_t ys, int16_t ye)
+  {
+    GFXfont *font = this->gfxFont;
+    for (uint16_t i = 0; i < _count; ++i)
+    {
+      const display_cmd_t &cmd = _cmds[i];
+      if (cmd.ye < ys || cmd.ys > ye)
+      {
+        continue;
+      }
+      switch (cmd.type)
+      {
+      case DL_PIXELS:
+        for (int16_t n = 0; n < cmd.h; ++n)
+        {
+          GxEPD2_GFX_Type::drawPixel(cmd.x + n * cmd.w, cmd.y, cmd.color);
+        }
+        break;
+      case DL_LINE:
+        GxEPD2_GFX_Type::drawLine(cmd.x, cmd.y, cmd.w, cmd.h, cmd.color);
+        break;
+      case DL_RECT:
+        GxEPD2_GFX_Type::fillRect(cmd.x, cmd.y, cmd.w, cmd.h, cmd.color);
+        break;
+      case DL_BITMAP:
+        GxEPD2_GFX_Type::drawInvertedBitmap(
+          cmd.x, cmd.y, static_cast<const uint8_t *>(cmd.data), cmd.w, cmd.h,
+          cmd.color);
+        break;
+      case DL_GLYPH:
+        this->gfxFont = static_cast<GFXfont *>(const_cast<void *>(cmd.data));
+        this->drawChar(cmd.x, cmd.y, cmd.c, cmd.color, cmd.bg, cmd.w, cmd.h);
+        break;
+      }
+    }
+    this->gfxFont = font;
+  }
+};
+
+#endif
@@ -57,16 +57,14 @@ void getDateStr(String &s, tm *timeInfo);
 void getDateTimeStr(String &s, int64_t epochTime);
 void getRefreshTimeStr(String &s, bool timeSuccess, tm *timeInfo);
 void toTitleCase(String &text);
-void truncateExtraAlertInfo(String &text);
-void filterAlerts(std::vector<owm_alerts_t> &resp, int *ignore_list);
 const char *getUVIdesc(unsigned int uvi);
 float getAvgConc(const float pollutant[], int hours);
 int getAQI(const owm_resp_air_pollution_t &p);
 const char *getAQIdesc(int aqi);
 const char *getWiFidesc(int rssi);
 const uint8_t *getWiFiBitmap16(int rssi);
-const uint8_t *getHourlyForecastBitmap32(const owm_hourly_t &hourly,
-                                         const owm_daily_t  &today);
+const uint8_t *getHourlyForecastBitmap32(const owm_hourly_series_t &hourly,
+                                         int i, const owm_daily_t &today);
 const uint8_t *getDailyForecastBitmap64(const owm_daily_t &daily);
 const uint8_t *getCurrentConditionsBitmap196(const owm_current_t &current,
                                              const owm_daily_t   &today);
@@ -0,0 +1,46 @@
+/* Concurrent API request declarations for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __FETCH_SCHEDULER_H__
+#define __FETCH_SCHEDULER_H__
+
+#include <Arduino.h>
+
+// bytes. Before the requests ran in tasks they ran on the 8 KB Arduino loop
+// task, this leaves 2 KB more for the deepest TLS handshake. With
+// DEBUG_LEVEL >= 1 the unused stack of each task is printed, check it on the
+// device before lowering this.
+#define FETCH_TASK_STACK_SIZE 10240
+
+/*
+ * One API request. fetch sends the request, retries and parses the response
+ * into resp, and returns the HTTP status code (or a -256/-512 offset error
+ * like getOWMonecall()).
+ */
+typedef struct fetch_job
+{
+  String name;              // shown on the error screen if the request fails
+  int  (*fetch)(void *resp);
+  void *resp;
+  int   status;             // set by fetchAll()
+  uint32_t stackUnused;     // bytes of the task stack never used, 0 if the
+                            // request did not run in its own task
+} fetch_job_t;
+
+int fetchAll(fetch_job_t *jobs, int n);
+
+#endif
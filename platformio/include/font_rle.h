@@ -0,0 +1,76 @@
+/* Run-length coded font glyphs for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __FONT_RLE_H__
+#define __FONT_RLE_H__
+
+#include <algorithm>
+#include <cstdint>
+#include <Arduino.h>
+
+/*
+ * Compressed fonts (FONT_COMPRESS, written by scripts/font_subset.py) are
+ * GFXfonts where each glyph is stored either as the usual stream of w * h
+ * bits, or as runs, whichever is smaller. Runs are set in bit 15 of the
+ * glyph's bitmapOffset, the rest of the offset is where they start.
+ *
+ * Runs are 4-bit codes, the high nibble first, over the w * h pixels of the
+ * glyph in the same order as the bits, starting with clear pixels:
+ *   0-14 : that many pixels, then the other color
+ *   15   : 15 pixels, the color does not change
+ */
+#define FONT_RLE_GLYPH 0x8000
+#define FONT_RLE_LONG  15
+
+/* Calls span(x, y, n) for each run of n set pixels of a run coded glyph, in
+ * rows [j0, j1) of it, split where a run wraps to the next row. x and y are
+ * relative to the glyph's top left pixel.
+ */
+template <typename Span>
+void glyphRuns(const uint8_t *runs, uint8_t w, int16_t j0, int16_t j1,
+               Span span)
+{
+  const uint32_t start = uint32_t(j0) * w;
+  const uint32_t end = uint32_t(j1) * w;
+  uint32_t px = 0;
+  bool set = false;
+  for (uint32_t i = 0; px < end; ++i)
+  {
+    uint8_t b = pgm_read_byte(&runs[i / 2]);
+    uint8_t n = (i & 1) ? (b & 0x0F) : (b >> 4);
+    if (set && n)
+    {
+      uint32_t a = std::max(px, start);
+      uint32_t z = std::min(px + n, end);
+      while (a < z)
+      {
+        int16_t y = a / w;
+        int16_t x = a - uint32_t(y) * w;
+        int16_t len = std::min<uint32_t>(z - a, w - x);
+        span(x, y, len);
+        a += len;
+      }
+    }
+    px += n;
+    if (n != FONT_RLE_LONG)
+    {
+      set = !set;
+    }
+  }
+} // end glyphRuns
+
+#endif
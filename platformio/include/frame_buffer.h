@@ -0,0 +1,646 @@
+/* Full frame buffer declarations for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __FRAME_BUFFER_H__
+#define __FRAME_BUFFER_H__
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <Arduino.h>
+#include <GxEPD2_3C.h>
+#include <GxEPD2_7C.h>
+
+#include "font_rle.h"
+
+// rows converted to native 7-color pixels at a time
+#define FRAME_NATIVE_ROWS 16
+// the frame is never drawn in pages smaller than this, rows
+#define FRAME_MIN_PAGE_HEIGHT 8
+// bitmaps and glyphs up to this wide are blitted a byte at a time, px
+#define FRAME_BLIT_MAX_WIDTH 256
+
+typedef enum frame_panel
+{
+  FRAME_BW, // GxEPD2_BW panels, written as the black plane
+  FRAME_3C, // GxEPD2_3C panels, written as black and color planes
+  FRAME_7C  // GxEPD2_7C panels, written as native 4-bit pixels
+} frame_panel_t;
+
+typedef enum frame_ink
+{
+  INK_WHITE,
+  INK_BLACK,
+  INK_ACCENT
+} frame_ink_t;
+
+/*
+ * Drop-in for GxEPD2_BW/GxEPD2_3C/GxEPD2_7C that draws the whole frame in one
+ * pass.
+ *
+ * GxEPD2 keeps a page of HEIGHT / 2 (3C) or HEIGHT / 4 (7C) rows, so the
+ * dashboard is drawn once per page. Here the frame is kept as two 1-bit
+ * planes, black and accent, which is all the renderer draws with (96kB for
+ * 800x480, instead of the 192kB a 7-color frame takes natively), or just the
+ * black plane on BW panels. They are allocated in PSRAM if the board has it.
+ * Otherwise in the heap, in as few pages as fit, so drawing still works when
+ * the heap is fragmented.
+ *
+ * Colors other than black and white are drawn as accent_color on 7-color
+ * panels. On 3-color and BW panels they are mapped the way GxEPD2_3C and
+ * GxEPD2_BW do.
+ *
+ * With rotation 0, inverted bitmaps and the glyphs of custom fonts (text size
+ * 1) are blitted into the planes a byte at a time, with shifts and masks for
+ * any x, instead of through drawPixel() for every pixel.
+ *
+ * Fonts set with setCompressedFont() may have run coded glyphs (see
+ * font_rle.h), which are decoded a row at a time as they are drawn. Only
+ * this class can draw them.
+ */
+template <typename GxEPD2_Type, frame_panel_t panel, uint16_t accent_color>
+class FrameBufferEPD : public GxEPD2_GFX_BASE_CLASS
+{
+public:
+  GxEPD2_Type epd2;
+
+  FrameBufferEPD(GxEPD2_Type epd2_instance)
+    : GxEPD2_GFX_BASE_CLASS(GxEPD2_Type::WIDTH, GxEPD2_Type::HEIGHT),
+      epd2(epd2_instance) {}
+
+  ~FrameBufferEPD() { freePlanes(); }
+
+  uint16_t pages() { return _pages; }
+  uint16_t pageHeight() { return _page_height; }
+  bool inPsram() { return _in_psram; }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override
+  {
+    if ((x < 0) || (x >= width()) || (y < 0) || (y >= height()))
+    {
+      return;
+    }
+    // check rotation, move pixel around if necessary
+    switch (getRotation())
+    {
+    case 1: std::swap(x, y); x = WIDTH - x - 1; break;
+    case 2: x = WIDTH - x - 1; y = HEIGHT - y - 1; break;
+    case 3: std::swap(x, y); y = HEIGHT - y - 1; break;
+    }
+    // adjust for current page
+    y -= _current_page * _page_height;
+    if ((y < 0) || (y >= int16_t(_page_height)) || !_black)
+    {
+      return;
+    }
+    uint32_t i = x / 8 + uint32_t(y) * (WIDTH / 8);
+    paint(i, 1 << (7 - x % 8), ink(color));
+  }
+
+  void init(uint32_t serial_diag_bitrate = 0)
+  {
+    init(serial_diag_bitrate, true);
+  }
+
+  void init(uint32_t serial_diag_bitrate, bool initial,
+            uint16_t reset_duration = 10, bool pulldown_rst_mode = false)
+  {
+    epd2.init(serial_diag_bitrate, initial, reset_duration,
+              pulldown_rst_mode);
+    allocPlanes();
+  }
+
+  void fillScreen(uint16_t color) override
+  {
+    if (!_black)
+    {
+      return;
+    }
+    if constexpr (panel == FRAME_BW)
+    {
+      memset(_black, (color == GxEPD_WHITE) ? 0xFF : 0x00, planeSize());
+      return;
+    }
+    uint8_t black = (color == GxEPD_BLACK) ? 0x00 : 0xFF;
+    uint8_t accent = (color != GxEPD_BLACK && color != GxEPD_WHITE)
+                     ? 0x00 : 0xFF;
+    memset(_black, black, planeSize());
+    memset(_color, accent, planeSize());
+  }
+
+  void setFullWindow() {}
+
+  void firstPage()
+  {
+    fillScreen(GxEPD_WHITE);
+    _current_page = 0;
+    _second_phase = false;
+  }
+
+  bool nextPage()
+  {
+    if (!_black)
+    {
+      return false;
+    }
+    uint16_t page_ys = _current_page * _page_height;
+    uint16_t page_ye = _current_page < int16_t(_pages - 1)
+                     ? page_ys + _page_height : HEIGHT;
+    writePage(page_ys, page_ye - page_ys);
+    _current_page++;
+    if (_current_page == int16_t(_pages))
+    {
+      _current_page = 0;
+      if (_second_phase)
+      {
+        return false;
+      }
+      epd2.refresh(false);
+      if constexpr (panel == FRAME_BW)
+      {
+        if (epd2.hasFastPartialUpdate)
+        { // the controller's previous image is written too, as GxEPD2_BW does
+          if (_pages == 1)
+          {
+            epd2.writeImageAgain(_black, 0, 0, WIDTH, HEIGHT);
+            return false;
+          }
+          _second_phase = true;
+          fillScreen(GxEPD_WHITE);
+          return true;
+        }
+      }
+      return false;
+    }
+    fillScreen(GxEPD_WHITE);
+    return true;
+  }
+
+  void drawInvertedBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
+                          int16_t w, int16_t h, uint16_t color)
+  {
+    if (getRotation() == 0 && w > 0 && w <= FRAME_BLIT_MAX_WIDTH && _black)
+    {
+      blitBitmap(x, y, bitmap, w, h, color);
+      return;
+    }
+    int16_t byteWidth = (w + 7) / 8; // Bitmap scanline pad = whole byte
+    uint8_t byte = 0;
+    for (int16_t j = 0; j < h; j++)
+    {
+      for (int16_t i = 0; i < w; i++)
+      {
+        if (i & 7)
+        {
+          byte <<= 1;
+        }
+        else
+        {
+          byte = pgm_read_byte(&bitmap[j * byteWidth + i / 8]);
+        }
+        if (!(byte & 0x80))
+        {
+          drawPixel(x + i, y + j, color);
+        }
+      }
+    }
+  }
+
+  void setFont(const GFXfont *f = nullptr)
+  {
+    _compressed_font = false;
+    GxEPD2_GFX_BASE_CLASS::setFont(f);
+  }
+
+  /* Sets a font written with FONT_COMPRESS, see font_rle.h.
+   */
+  void setCompressedFont(const GFXfont *f)
+  {
+    GxEPD2_GFX_BASE_CLASS::setFont(f);
+    _compressed_font = f != nullptr;
+  }
+
+  size_t write(uint8_t c) override
+  {
+    const bool blit = textsize_x == 1 && textsize_y == 1
+                   && getRotation() == 0 && _black;
+    if (!gfxFont || !(blit || _compressed_font))
+    {
+      return GxEPD2_GFX_BASE_CLASS::write(c);
+    }
+    // same as Adafruit_GFX::write() for custom fonts, but blitting the glyph
+    // or decoding its runs
+    uint8_t y_advance = pgm_read_byte(&gfxFont->yAdvance);
+    uint16_t first = pgm_read_word(&gfxFont->first);
+    uint16_t last = pgm_read_word(&gfxFont->last);
+    if (c == '\n')
+    {
+      cursor_x = 0;
+      cursor_y += textsize_y * y_advance;
+    }
+    else if (c != '\r' && c >= first && c <= last)
+    {
+      const GFXglyph *glyph = &gfxFont->glyph[c - first];
+      uint8_t w = pgm_read_byte(&glyph->width);
+      uint8_t h = pgm_read_byte(&glyph->height);
+      if (w > 0 && h > 0)
+      {
+        int16_t xo = static_cast<int8_t>(pgm_read_byte(&glyph->xOffset));
+        int16_t yo = static_cast<int8_t>(pgm_read_byte(&glyph->yOffset));
+        if (wrap && (cursor_x + textsize_x * (xo + w)) > _width)
+        {
+          cursor_x = 0;
+          cursor_y += textsize_y * y_advance;
+        }
+        uint16_t offset = pgm_read_word(&glyph->bitmapOffset);
+        if (_compressed_font && (offset & FONT_RLE_GLYPH))
+        {
+          drawGlyphRuns(&gfxFont->bitmap[offset & ~FONT_RLE_GLYPH], xo, yo,
+                        w, h, blit);
+        }
+        else if (blit)
+        {
+          blitGlyph(cursor_x + xo, cursor_y + yo, &gfxFont->bitmap[offset],
+                    w, h, textcolor);
+        }
+        else
+        {
+          drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x,
+                   textsize_y);
+        }
+      }
+      cursor_x += textsize_x * pgm_read_byte(&glyph->xAdvance);
+    }
+    return 1;
+  }
+
+  void powerOff() { epd2.powerOff(); }
+  void hibernate()
+  {
+    epd2.hibernate();
+    freePlanes();
+  }
+
+private:
+  uint8_t *_black = nullptr; // ink = 0 bit, MSB first, like GxEPD2_3C
+  uint8_t *_color = nullptr; // not used by FRAME_BW
+  bool     _in_psram = false;
+  bool     _second_phase = false;
+  bool     _compressed_font = false;
+  uint16_t _page_height = 0;
+  uint16_t _pages = 0;
+  int16_t  _current_page = 0;
+
+  static constexpr int planes = panel == FRAME_BW ? 1 : 2;
+
+  size_t planeSize() const
+  {
+    return (uint32_t(WIDTH) / 8) * _page_height;
+  }
+
+  /* How color is drawn, mapped as GxEPD2_BW, GxEPD2_3C or as accent_color.
+   */
+  static frame_ink_t ink(uint16_t color)
+  {
+    if (color == GxEPD_WHITE)
+    {
+      return INK_WHITE;
+    }
+    else if (panel == FRAME_BW || color == GxEPD_BLACK)
+    {
+      return INK_BLACK;
+    }
+    else if (panel == FRAME_7C
+          || (color == GxEPD_RED) || (color == GxEPD_YELLOW)
+          || ((color & 0xF100) > (0xF100 / 2)))
+    {
+      return INK_ACCENT;
+    }
+    else if ((((color & 0xF100) >> 11) + ((color & 0x07E0) >> 5)
+              + (color & 0x001F)) < 3 * 255 / 2)
+    {
+      return INK_BLACK;
+    }
+    return INK_WHITE;
+  }
+
+  /* Draws the pixels of mask (MSB is the leftmost) in byte i of the planes.
+   */
+  void paint(uint32_t i, uint8_t mask, frame_ink_t ink)
+  {
+    if constexpr (panel == FRAME_BW)
+    {
+      _black[i] = (ink == INK_WHITE) ? (_black[i] | mask)
+                                     : (_black[i] & ~mask);
+      return;
+    }
+    _black[i] = (ink == INK_BLACK) ? (_black[i] & ~mask) : (_black[i] | mask);
+    _color[i] = (ink == INK_ACCENT) ? (_color[i] & ~mask) : (_color[i] | mask);
+  }
+
+  /* Draws the set bits of row, w pixels, MSB first and clear past w, at
+   * frame row y of the current page (rotation 0). x may be unaligned and
+   * partly off the panel.
+   */
+  void blitRow(const uint8_t *row, int16_t x, int16_t y, int16_t w,
+               frame_ink_t ink)
+  {
+    const int16_t stride = WIDTH / 8;
+    const int16_t shift = x & 7;
+    const int16_t first = x >> 3; // rounds down for negative x too
+    const int16_t n = (w + 7) / 8;
+    const uint32_t base = uint32_t(y - _current_page * _page_height) * stride;
+    uint8_t prev = 0;
+    for (int16_t j = 0; j <= n; ++j)
+    {
+      uint8_t cur = j < n ? row[j] : 0;
+      uint8_t mask = (prev << (8 - shift)) | (cur >> shift);
+      prev = cur;
+      int16_t b = first + j;
+      if (mask && b >= 0 && b < stride)
+      {
+        paint(base + b, mask, ink);
+      }
+    }
+  }
+
+  /* Rows [j0, j1) of an h rows high image at y, that are in the current
+   * page.
+   */
+  void pageRows(int16_t y, int16_t h, int16_t &j0, int16_t &j1) const
+  {
+    int16_t page_ys = _current_page * _page_height;
+    int16_t page_ye = std::min<int16_t>(page_ys + _page_height, HEIGHT);
+    j0 = std::max<int16_t>(0, page_ys - y);
+    j1 = std::min<int16_t>(h, page_ye - y);
+  }
+
+  void blitBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w,
+                  int16_t h, uint16_t color)
+  {
+    const int16_t byteWidth = (w + 7) / 8;
+    const uint8_t last = 0xFF << ((8 - w % 8) % 8);
+    const frame_ink_t k = ink(color);
+    uint8_t row[FRAME_BLIT_MAX_WIDTH / 8];
+    int16_t j0, j1;
+    pageRows(y, h, j0, j1);
+    for (int16_t j = j0; j < j1; ++j)
+    {
+      const uint8_t *src = &bitmap[j * byteWidth];
+      for (int16_t i = 0; i < byteWidth; ++i)
+      {
+        row[i] = ~pgm_read_byte(&src[i]); // clear bits are drawn
+      }
+      row[byteWidth - 1] &= last;
+      blitRow(row, x, y + j, w, k);
+    }
+  }
+
+  /* Glyph bitmaps are a stream of w * h bits, rows do not start on a byte.
+   */
+  void blitGlyph(int16_t x, int16_t y, const uint8_t *bits, uint8_t w,
+                 uint8_t h, uint16_t color)
+  {
+    const int16_t byteWidth = (w + 7) / 8;
+    const uint8_t last = 0xFF << ((8 - w % 8) % 8);
+    const frame_ink_t k = ink(color);
+    uint8_t row[FRAME_BLIT_MAX_WIDTH / 8];
+    int16_t j0, j1;
+    pageRows(y, h, j0, j1);
+    for (int16_t j = j0; j < j1; ++j)
+    {
+      uint32_t bit = uint32_t(j) * w;
+      for (int16_t i = 0; i < byteWidth; ++i, bit += 8)
+      {
+        const uint8_t *p = &bits[bit / 8];
+        uint8_t shift = bit % 8;
+        uint8_t v = pgm_read_byte(p) << shift;
+        // the next byte only if this row still has bits in it
+        if (shift && (w - 8 * i) > (8 - shift))
+        {
+          v |= pgm_read_byte(p + 1) >> (8 - shift);
+        }
+        row[i] = v;
+      }
+      row[byteWidth - 1] &= last;
+      blitRow(row, x, y + j, w, k);
+    }
+  }
+
+  /* Draws pixels [x, x + n) of frame row y of the current page (rotation 0),
+   * x may be partly off the panel.
+   */
+  void paintSpan(int16_t x, int16_t y, int16_t n, frame_ink_t ink)
+  {
+    const int16_t x0 = std::max<int16_t>(x, 0);
+    const int16_t x1 = std::min<int16_t>(x + n, WIDTH) - 1;
+    if (x0 > x1)
+    {
+      return;
+    }
+    const uint32_t base = uint32_t(y - _current_page * _page_height)
+                        * (WIDTH / 8);
+    const int16_t b0 = x0 >> 3;
+    const int16_t b1 = x1 >> 3;
+    const uint8_t first = 0xFF >> (x0 & 7);
+    const uint8_t last = 0xFF << (7 - (x1 & 7));
+    if (b0 == b1)
+    {
+      paint(base + b0, first & last, ink);
+      return;
+    }
+    paint(base + b0, first, ink);
+    for (int16_t b = b0 + 1; b < b1; ++b)
+    {
+      paint(base + b, 0xFF, ink);
+    }
+    paint(base + b1, last, ink);
+  }
+
+  /* Draws a run coded glyph at the cursor, into the planes (blit) or with
+   * fillRect() for other rotations and text sizes.
+   */
+  void drawGlyphRuns(const uint8_t *runs, int16_t xo, int16_t yo, uint8_t w,
+                     uint8_t h, bool blit)
+  {
+    const int16_t x = cursor_x;
+    const int16_t y = cursor_y;
+    if (blit)
+    {
+      const frame_ink_t k = ink(textcolor);
+      int16_t j0, j1;
+      pageRows(y + yo, h, j0, j1);
+      if (j0 >= j1)
+      {
+        return;
+      }
+      glyphRuns(runs, w, j0, j1, [&](int16_t i, int16_t j, int16_t n)
+      {
+        paintSpan(x + xo + i, y + yo + j, n, k);
+      });
+      return;
+    }
+    const int16_t sx = textsize_x;
+    const int16_t sy = textsize_y;
+    const uint16_t color = textcolor;
+    startWrite();
+    glyphRuns(runs, w, 0, h, [&](int16_t i, int16_t j, int16_t n)
+    {
+      writeFillRect(x + (xo + i) * sx, y + (yo + j) * sy, n * sx, sy, color);
+    });
+    endWrite();
+  }
+
+  /* The planes in one block, the whole frame if it fits.
+   */
+  void allocPlanes()
+  {
+    if (_black)
+    {
+      return;
+    }
+    for (_page_height = HEIGHT; _page_height >= FRAME_MIN_PAGE_HEIGHT;
+         _page_height = (_page_height + 1) / 2)
+    {
+      _in_psram = psramFound();
+      _black = static_cast<uint8_t *>(
+        _in_psram ? ps_malloc(planes * planeSize()) : nullptr);
+      if (!_black)
+      {
+        _in_psram = false;
+        _black = static_cast<uint8_t *>(malloc(planes * planeSize()));
+      }
+      if (_black)
+      {
+        break;
+      }
+    }
+    if (!_black)
+    {
+      _page_height = 0;
+      _pages = 0;
+      return;
+    }
+    _color = (planes == 2) ? _black + planeSize() : nullptr;
+    _pages = (HEIGHT + _page_height - 1) / _page_height;
+    _current_page = 0;
+  }
+
+  void freePlanes()
+  {
+    free(_black);
+    _black = nullptr;
+    _color = nullptr;
+  }
+
+  /* Sends rows [y, y + h) of the frame, which the planes hold now.
+   */
+  void writePage(uint16_t y, uint16_t h)
+  {
+    if constexpr (panel == FRAME_BW)
+    {
+      if (_second_phase)
+      {
+        epd2.writeImageAgain(_black, 0, y, WIDTH, h);
+      }
+      else
+      {
+        epd2.writeImage(_black, 0, y, WIDTH, h);
+      }
+    }
+    else if constexpr (panel == FRAME_3C)
+    {
+      epd2.writeImage(_black, _color, 0, y, WIDTH, h);
+    }
+    else
+    {
+      static const NativeLut lut;
+      const uint32_t stride = WIDTH / 8;
+      uint8_t *native = static_cast<uint8_t *>(
+        malloc((uint32_t(WIDTH) / 2) * FRAME_NATIVE_ROWS));
+      if (!native)
+      {
+        return;
+      }
+      if (y == 0)
+      {
+        epd2.setPaged(); // rows are streamed in one transfer
+      }
+      for (uint16_t r = 0; r < h; r += FRAME_NATIVE_ROWS)
+      {
+        uint16_t rows = std::min<uint16_t>(FRAME_NATIVE_ROWS, h - r);
+        uint8_t *out = native;
+        for (uint32_t i = r * stride; i < (r + rows) * stride; ++i)
+        {
+          uint8_t black = _black[i];
+          uint8_t color = _color[i];
+          for (int shift = 6; shift >= 0; shift -= 2)
+          {
+            *out++ = lut.pair[(((black >> shift) & 0x03) << 2)
+                              | ((color >> shift) & 0x03)];
+          }
+        }
+        epd2.writeNative(native, nullptr, 0, y + r, WIDTH, rows);
+      }
+      free(native);
+    }
+  }
+
+  /* Two native pixels for each combination of two bits in each plane.
+   */
+  struct NativeLut
+  {
+    uint8_t pair[16];
+
+    NativeLut()
+    {
+      uint8_t accent = nativeColor(accent_color);
+      for (int i = 0; i < 16; ++i)
+      {
+        uint8_t hi = (i & 0x02) ? ((i & 0x08) ? 0x01 : 0x00) : accent;
+        uint8_t lo = (i & 0x01) ? ((i & 0x04) ? 0x01 : 0x00) : accent;
+        pair[i] = (hi << 4) | lo;
+      }
+    }
+  };
+
+  /* Native 7-color code of an RGB565 color, the same as GxEPD2_7C.
+   */
+  static uint8_t nativeColor(uint16_t color)
+  {
+    uint16_t red = color & 0xF800;
+    uint16_t green = (color & 0x07E0) << 5;
+    uint16_t blue = (color & 0x001F) << 11;
+    if ((red < 0x8000) && (green < 0x8000) && (blue < 0x8000))
+      return 0x00; // black
+    else if ((red >= 0x8000) && (green >= 0x8000) && (blue >= 0x8000))
+      return 0x01; // white
+    else if ((red >= 0x8000) && (blue >= 0x8000))
+      return red > blue ? 0x04 : 0x03; // red, blue
+    else if ((green >= 0x8000) && (blue >= 0x8000))
+      return green > blue ? 0x02 : 0x03; // green, blue
+    else if ((red >= 0x8000) && (green >= 0x8000))
+      return green >= 0xC000 ? 0x05 : 0x06; // yellow, orange
+    else if (red >= 0x8000)
+      return 0x04; // red
+    else if (green >= 0x8000)
+      return 0x02; // green
+    return 0x03; // blue
+  }
+};
+
+#endif
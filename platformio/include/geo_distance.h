@@ -0,0 +1,47 @@
+/* Great-circle distance declarations for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GEO_DISTANCE_H__
+#define __GEO_DISTANCE_H__
+
+#define GEO_EARTH_RADIUS_KM 6371.0f
+
+/*
+ * Observer side of repeated distance queries. Everything that only depends on
+ * the observer or on the current search radius is computed once.
+ */
+typedef struct geo_observer
+{
+  float lat;          // latitude, radians
+  float lon;          // longitude, radians
+  float cos_lat;      // cos(lat)
+  float max_distance; // search radius, km, INFINITY to accept everything
+  float max_dlat;     // latitude half-height of the radius' bounding box, radians
+  float max_dlon;     // longitude half-width of the bounding box, radians
+  float max_hav;      // haversine of the radius' central angle
+} geo_observer_t;
+
+float calculateDistance(float lat1, float lon1, float lat2, float lon2);
+
+void geoObserverInit(geo_observer_t &o, float lat, float lon);
+void geoObserverSetMaxDistance(geo_observer_t &o, float km);
+bool geoDistanceWithin(const geo_observer_t &o, float lat, float lon,
+                       float &distance);
+int geoDistanceBatch(const geo_observer_t &o, const float *lat,
+                     const float *lon, float *distance, int n);
+
+#endif
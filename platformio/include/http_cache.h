@@ -0,0 +1,52 @@
+/* HTTP response cache declarations for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __HTTP_CACHE_H__
+#define __HTTP_CACHE_H__
+
+#include <cstdint>
+#include <Arduino.h>
+
+#define HTTP_CACHE_NAMESPACE  "http_cache"
+// bytes, largest parsed response that is kept
+#define HTTP_CACHE_MAX_RESULT 2048
+// increment when the layout of a cached result changes without its size
+#define HTTP_CACHE_VERSION    1
+
+/*
+ * Validators of a cached response, sent back as If-None-Match and
+ * If-Modified-Since. Either may be empty if the server did not send it.
+ */
+typedef struct http_cache_validators
+{
+  char etag[64];
+  char last_modified[32]; // IMF-fixdate, "Thu, 16 Oct 2025 15:00:00 GMT"
+} http_cache_validators_t;
+
+uint32_t httpCacheFormat(const void *settings, size_t len);
+bool httpCacheValidators(const String &uri, uint32_t format,
+                         http_cache_validators_t &v);
+size_t httpCacheLoad(const String &uri, uint32_t format, void *result,
+                     size_t size);
+void httpCacheStore(const String &uri, uint32_t format, const String &etag,
+                    const String &lastModified,
+                    const void *result, size_t len);
+void httpCacheForget(const String &uri);
+void httpCacheCount(bool hit);
+void httpCachePrintStats();
+
+#endif
@@ -0,0 +1,72 @@
+/* HTTP response body stream declarations for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __HTTP_STREAM_H__
+#define __HTTP_STREAM_H__
+
+#include <cstdint>
+#include <Arduino.h>
+#include <HTTPClient.h>
+
+/* The body of one HTTP/1.1 response, read from the connection's stream.
+ *
+ * HTTPClient::getStream() is the raw connection: a chunked body arrives with
+ * its chunk sizes in between, and a parser that stops early leaves the rest
+ * of the body in front of the next response on a kept-alive connection. This
+ * stream decodes "Transfer-Encoding: chunked", ends at Content-Length (or the
+ * last chunk), and drain() consumes whatever the parser did not read:
+ *
+ *   HttpBodyStream body(http);
+ *   jsonErr = deserializeOneCall(body, r);
+ *   bool keepAlive = body.drain();
+ *
+ * A body without either ends when the server closes the connection. The
+ * "Transfer-Encoding" header must be in HTTPClient::collectHeaders().
+ */
+class HttpBodyStream : public Stream
+{
+public:
+  HttpBodyStream(HTTPClient &http);
+
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t readBytes(char *buffer, size_t length) override;
+  using Stream::readBytes;
+  size_t write(uint8_t c) override { return 0; }
+  using Print::write;
+
+  bool drain();
+  bool complete() const { return _done && !_failed; }
+
+private:
+  Stream &_stream;
+  bool _chunked;
+  bool _sized;      // Content-Length was given
+  bool _done;       // end of the body was read
+  bool _failed;     // malformed chunk header, or the connection ended early
+  bool _inChunk;    // a chunk was read, its CRLF is still in the stream
+  uint32_t _remaining; // bytes left in the body, or in the current chunk
+
+  int getByte();
+  bool readLine(char *line, size_t size);
+  bool nextChunk();
+  bool ensure(bool wait);
+  int endOfStream();
+};
+
+#endif
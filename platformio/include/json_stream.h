@@ -0,0 +1,90 @@
+/* Streaming JSON reader declarations for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __JSON_STREAM_H__
+#define __JSON_STREAM_H__
+
+#include <cstdint>
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#define JSON_STREAM_MAX_DEPTH  16
+#define JSON_STREAM_BUFFER_LEN 64
+
+/* Pull parser that reads a JSON document from a Stream one token at a time.
+ *
+ * Nothing is stored besides a small read buffer, so memory use does not
+ * depend on the size of the response. The caller walks the document in the
+ * order it arrives:
+ *
+ *   if (json.beginObject())
+ *   {
+ *     while (json.nextKey(key, sizeof(key)))
+ *     {
+ *       if (strcmp(key, "temp") == 0) json.readFloat(r.temp);
+ *       else                          json.skipValue();
+ *     }
+ *   }
+ *   return json.error();
+ *
+ * After the first error every call returns false (or reads nothing) and
+ * error() reports the same DeserializationError codes as ArduinoJson.
+ */
+class JsonStreamReader
+{
+public:
+  JsonStreamReader(Stream &stream);
+
+  bool beginObject();
+  bool beginArray();
+  bool nextKey(char *key, size_t size);
+  bool nextElement();
+
+  // Type mismatches and null read as 0 or "", like JsonVariant::as<T>().
+  bool readInt(int &value);
+  bool readInt64(int64_t &value);
+  bool readFloat(float &value);
+  bool readString(char *buf, size_t size);
+  bool readString(String &value);
+  bool skipValue();
+
+  // Stops reading at the end of the enclosing object or array.
+  void skipRest();
+
+  DeserializationError error() const { return _error; }
+
+private:
+  Stream &_stream;
+  char _buf[JSON_STREAM_BUFFER_LEN];
+  size_t _len;
+  size_t _pos;
+  DeserializationError _error;
+  int _depth;
+  uint32_t _first;  // bit per depth, no member read yet
+  uint32_t _object; // bit per depth, object (1) or array (0)
+
+  int peek();
+  int get();
+  int peekToken();
+  bool fail(DeserializationError::Code code);
+  bool enter(char open);
+  bool next(char close);
+  bool readNumberToken(char *buf, size_t size);
+  bool readStringBody(char *buf, size_t size, String *str);
+};
+
+#endif
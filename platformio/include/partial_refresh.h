@@ -0,0 +1,152 @@
+/* Partial refresh declarations for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PARTIAL_REFRESH_H__
+#define __PARTIAL_REFRESH_H__
+
+#include <cstdint>
+#include <Arduino.h>
+
+#define FRAME_FILE                "/frame.bin"
+// changed areas are found in tiles of this size, px
+#define FRAME_TILE_WIDTH          32 // multiple of 8, partial windows are
+#define FRAME_TILE_HEIGHT         16 // byte aligned
+#define PARTIAL_REFRESH_MAX_RECTS  4
+
+typedef struct refresh_rect
+{
+  int16_t x;
+  int16_t y;
+  int16_t w;
+  int16_t h;
+} refresh_rect_t;
+
+/*
+ * How a frame gets to the panel. Either one full refresh, or a partial
+ * refresh of each rect (none if nothing changed).
+ */
+typedef struct refresh_plan
+{
+  bool            full;
+  int             num_rects;
+  refresh_rect_t  rects[PARTIAL_REFRESH_MAX_RECTS];
+  uint8_t        *previous; // frame on the panel, restored into the controller
+  uint16_t        partials; // partial refreshes since the last full refresh
+} refresh_plan_t;
+
+bool previousFrameAvailable(uint16_t width, uint16_t height);
+void forgetFrame();
+void planRefresh(refresh_plan_t &plan, const uint8_t *frame,
+                 uint16_t width, uint16_t height, bool restorable,
+                 uint16_t fullRefreshMs, uint16_t partialRefreshMs);
+void finishRefresh(refresh_plan_t &plan, const uint8_t *frame,
+                   uint16_t width, uint16_t height, unsigned long ms);
+
+/*
+ * GxEPD2 driver that refreshes only the parts of the panel that changed since
+ * the last wake. GxEPD2_BW hands the whole frame to writeImage() and then
+ * calls refresh(), with a single page (page_height == HEIGHT) and a panel
+ * with fast partial update. A frame written in pages (FrameBufferEPD when the
+ * heap is short) gets a full refresh and is not kept, so the next refresh is
+ * full too.
+ *
+ * The controller loses the previous image when the panel is powered off. It
+ * is restored from flash (writeImageAgain()) before the new frame is written,
+ * so the partial update waveform only drives the pixels that differ.
+ */
+template <typename GxEPD2_Type>
+class PartialRefreshEPD : public GxEPD2_Type
+{
+public:
+  using GxEPD2_Type::init;
+  using GxEPD2_Type::refresh;
+  using GxEPD2_Type::writeImage;
+
+  PartialRefreshEPD(int16_t cs, int16_t dc, int16_t rst, int16_t busy)
+    : GxEPD2_Type(cs, dc, rst, busy) {}
+
+  void init(uint32_t serial_diag_bitrate, bool initial,
+            uint16_t reset_duration = 10, bool pulldown_rst_mode = false)
+  {
+    // without the initial flag, the driver allows a partial refresh as the
+    // first refresh after power on
+    _restorable = initial
+               && previousFrameAvailable(GxEPD2_Type::WIDTH,
+                                         GxEPD2_Type::HEIGHT);
+    GxEPD2_Type::init(serial_diag_bitrate, initial && !_restorable,
+                      reset_duration, pulldown_rst_mode);
+  }
+
+  void writeImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w,
+                  int16_t h, bool invert = false, bool mirror_y = false,
+                  bool pgm = false)
+  {
+    _frame = nullptr;
+    if (x == 0 && y == 0 && w == GxEPD2_Type::WIDTH
+     && h == GxEPD2_Type::HEIGHT && !invert && !mirror_y && !pgm)
+    {
+      _frame = bitmap;
+      planRefresh(_plan, bitmap, GxEPD2_Type::WIDTH, GxEPD2_Type::HEIGHT,
+                  _restorable, GxEPD2_Type::full_refresh_time,
+                  GxEPD2_Type::partial_refresh_time);
+      if (!_plan.full)
+      {
+        GxEPD2_Type::writeImageAgain(_plan.previous, 0, 0,
+                                     GxEPD2_Type::WIDTH,
+                                     GxEPD2_Type::HEIGHT);
+      }
+    }
+    else if (!_paged)
+    { // the frame kept in flash will not match the panel after this
+      forgetFrame();
+      _paged = true;
+      _restorable = false;
+    }
+    GxEPD2_Type::writeImage(bitmap, x, y, w, h, invert, mirror_y, pgm);
+  }
+
+  void refresh(bool partial_update_mode = false)
+  {
+    if (!_frame)
+    {
+      GxEPD2_Type::refresh(partial_update_mode);
+      return;
+    }
+    unsigned long start = millis();
+    if (_plan.full)
+    {
+      GxEPD2_Type::refresh(false);
+    }
+    for (int i = 0; !_plan.full && i < _plan.num_rects; ++i)
+    {
+      const refresh_rect_t &r = _plan.rects[i];
+      GxEPD2_Type::refresh(r.x, r.y, r.w, r.h);
+    }
+    finishRefresh(_plan, _frame, GxEPD2_Type::WIDTH, GxEPD2_Type::HEIGHT,
+                  millis() - start);
+    _frame = nullptr;
+    _restorable = true; // the controller holds this frame now
+  }
+
+private:
+  bool           _restorable = false;
+  bool           _paged = false; // a frame was written in pages
+  const uint8_t *_frame = nullptr;
+  refresh_plan_t _plan = {};
+};
+
+#endif
@@ -28,29 +28,61 @@
   #define DISP_WIDTH  800
   #define DISP_HEIGHT 480
   #include <GxEPD2_BW.h>
-  extern GxEPD2_BW<GxEPD2_750_T7,
-                   GxEPD2_750_T7::HEIGHT> display;
+  #include "partial_refresh.h"
+  #if FULL_FRAME_BUFFER
+    #include "frame_buffer.h"
+    extern FrameBufferEPD<PartialRefreshEPD<GxEPD2_750_T7>, FRAME_BW,
+                          GxEPD_BLACK> display;
+  #else
+    extern GxEPD2_BW<PartialRefreshEPD<GxEPD2_750_T7>,
+                     GxEPD2_750_T7::HEIGHT> display;
+  #endif
 #endif
 #ifdef DISP_3C_B
   #define DISP_WIDTH  800
   #define DISP_HEIGHT 480
   #include <GxEPD2_3C.h>
-  extern GxEPD2_3C<GxEPD2_750c_Z08,
-                   GxEPD2_750c_Z08::HEIGHT / 2> display;
+  #if FULL_FRAME_BUFFER
+    #include "frame_buffer.h"
+    extern FrameBufferEPD<GxEPD2_750c_Z08, FRAME_3C, ACCENT_COLOR> display;
+  #elif DISPLAY_LIST
+    #include "display_list.h"
+    extern DisplayListEPD<GxEPD2_3C<GxEPD2_750c_Z08,
+                                    GxEPD2_750c_Z08::HEIGHT / 2>> display;
+  #else
+    extern GxEPD2_3C<GxEPD2_750c_Z08,
+                     GxEPD2_750c_Z08::HEIGHT / 2> display;
+  #endif
 #endif
 #ifdef DISP_7C_F
   #define DISP_WIDTH  800
   #define DISP_HEIGHT 480
   #include <GxEPD2_7C.h>
-  extern GxEPD2_7C<GxEPD2_730c_GDEY073D46, 
-                   GxEPD2_730c_GDEY073D46::HEIGHT / 4> display;
+  #if FULL_FRAME_BUFFER
+    #include "frame_buffer.h"
+    extern FrameBufferEPD<GxEPD2_730c_GDEY073D46, FRAME_7C,
+                          ACCENT_COLOR> display;
+  #elif DISPLAY_LIST
+    #include "display_list.h"
+    extern DisplayListEPD<GxEPD2_7C<GxEPD2_730c_GDEY073D46,
+                                    GxEPD2_730c_GDEY073D46::HEIGHT / 4>>
+           display;
+  #else
+    extern GxEPD2_7C<GxEPD2_730c_GDEY073D46,
+                     GxEPD2_730c_GDEY073D46::HEIGHT / 4> display;
+  #endif
 #endif
 #ifdef DISP_BW_V1
   #define DISP_WIDTH  640
   #define DISP_HEIGHT 384
   #include <GxEPD2_BW.h>
-  extern GxEPD2_BW<GxEPD2_750,
-                   GxEPD2_750::HEIGHT> display;
+  #if FULL_FRAME_BUFFER
+    #include "frame_buffer.h"
+    extern FrameBufferEPD<GxEPD2_750, FRAME_BW, GxEPD_BLACK> display;
+  #else
+    extern GxEPD2_BW<GxEPD2_750,
+                     GxEPD2_750::HEIGHT> display;
+  #endif
 #endif
 
 typedef enum alignment
@@ -60,6 +92,7 @@ typedef enum alignment
   CENTER
 } alignment_t;
 
+void setFont(const GFXfont *font);
 uint16_t getStringWidth(const String &text);
 uint16_t getStringHeight(const String &text);
 void drawString(int16_t x, int16_t y, const String &text, alignment_t alignment,
@@ -79,8 +112,8 @@ void drawForecast(const owm_daily_t *daily, tm timeInfo);
 void drawAlerts(std::vector<owm_alerts_t> &alerts,
                 const String &city, const String &date);
 void drawLocationDate(const String &city, const String &date);
-void drawOutlookGraph(const owm_hourly_t *hourly, const owm_daily_t *daily,
-                      tm timeInfo);
+void drawOutlookGraph(const owm_hourly_series_t &hourly,
+                      const owm_daily_t *daily, tm timeInfo);
 void drawStatusBar(const String &statusStr, const String &refreshTimeStr,
                    int rssi, uint32_t batVoltage);
 void drawError(const uint8_t *bitmap_196x196,
@@ -0,0 +1,53 @@
+/* Parsed data snapshot declarations for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SNAPSHOT_H__
+#define __SNAPSHOT_H__
+
+#include <cstdint>
+#include "api_response.h"
+
+#define SNAPSHOT_VERSION        2
+// bytes of RTC memory for the encoded snapshot, enough for the longest
+// encoding of every section, see snapshot.cpp
+#define SNAPSHOT_MAX_LEN     4160
+#define SNAPSHOT_NUM_ALERTS     4 // alerts kept of a One Call response
+#define SNAPSHOT_NUM_EVENTS     1 // events kept of a USGS feed
+// bytes of the 8 KB RTC slow memory left for RTC_DATA_ATTR variables, after
+// the ULP reserve and ESP-IDF's own
+#define RTC_DATA_BUDGET      7168
+
+/*
+ * Parsed responses kept in the snapshot, one per API request. The response
+ * pointer passed with a section has the type noted here.
+ */
+typedef enum snapshot_section
+{
+  SNAPSHOT_ONECALL,          // owm_resp_onecall_t
+  SNAPSHOT_AIR_POLLUTION,    // owm_resp_air_pollution_t
+  SNAPSHOT_USGS_SIGNIFICANT, // usgs_earth_resp_t
+  SNAPSHOT_USGS_RECENT,      // usgs_earth_resp_t
+  SNAPSHOT_NUM_SECTIONS
+} snapshot_section_t;
+
+bool saveSnapshot(snapshot_section_t section, const void *resp,
+                  int64_t fetched);
+bool loadSnapshot(snapshot_section_t section, void *resp, int64_t &fetched);
+void advanceOneCall(owm_resp_onecall_t &r, int64_t now);
+
+#endif
+
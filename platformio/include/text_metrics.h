@@ -0,0 +1,59 @@
+/* Text measurement declarations for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __TEXT_METRICS_H__
+#define __TEXT_METRICS_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <gfxfont.h>
+
+// fonts with a glyph table in RAM, least recently used is replaced
+#define TEXT_METRICS_FONTS    8
+// measured strings kept, direct mapped by hash
+#define TEXT_METRICS_STRINGS 64
+// longest string kept, longer ones are measured every time
+#define TEXT_METRICS_TEXT_LEN 32
+
+/*
+ * Bounds of a string drawn with the cursor at (0, 0), as
+ * Adafruit_GFX::getTextBounds() reports them.
+ */
+typedef struct text_bounds
+{
+  int16_t  x1;
+  int16_t  y1;
+  uint16_t w;
+  uint16_t h;
+} text_bounds_t;
+
+/*
+ * Metrics of one glyph, copied from the font's GFXglyph in flash.
+ */
+typedef struct glyph_metrics
+{
+  int8_t  left;    // xOffset
+  int8_t  top;     // yOffset
+  uint8_t width;
+  uint8_t height;
+  uint8_t advance; // xAdvance
+} glyph_metrics_t;
+
+bool measureText(const GFXfont *font, const char *text, size_t len,
+                 text_bounds_t &bounds);
+
+#endif
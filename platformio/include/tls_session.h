@@ -0,0 +1,82 @@
+/* TLS session resumption declarations for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __TLS_SESSION_H__
+#define __TLS_SESSION_H__
+
+#include <Arduino.h>
+#include <mbedtls/ssl.h>
+#include <WiFiClientSecure.h>
+
+#include "config.h"
+
+#define TLS_SESSION_NUM_HOSTS 2
+// bytes per host. Sessions are saved without the server certificate, the
+// rest of a session and a ticket of up to 850 B fit.
+#define TLS_SESSION_MAX_LEN   1024
+
+// WiFiClientSecure keeps its mbedTLS context in the protected sslclient in
+// arduino-esp32 2.x, and mbedTLS 2.x sessions are read field by field. Check
+// both before moving to another core; until then connections are made without
+// resumption.
+#if defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR == 2
+#define TLS_SESSION_CONTEXT 1
+#else
+#define TLS_SESSION_CONTEXT 0
+#endif
+
+/*
+ * Session of one host, kept in RTC memory through deep sleep.
+ */
+typedef struct tls_session_entry
+{
+  char     host[32];
+  int64_t  saved;    // Unix time of the handshake that created the session
+  uint32_t lifetime; // s, how long the session may be offered
+  uint16_t len;      // size of data, 0 if the entry is empty
+  uint8_t  data[TLS_SESSION_MAX_LEN]; // mbedtls_ssl_session_save()
+} tls_session_entry_t;
+
+// bytes of RTC memory for the sessions
+#if TLS_SESSION_RESUMPTION
+#define TLS_SESSION_RTC_LEN (TLS_SESSION_NUM_HOSTS * sizeof(tls_session_entry_t))
+#else
+#define TLS_SESSION_RTC_LEN 0
+#endif
+
+/*
+ * WiFiClientSecure with access to its mbedTLS context, so that a session can
+ * be offered to the server between connect() and the handshake.
+ */
+class ResumableClientSecure : public WiFiClientSecure
+{
+public:
+  // nullptr on a core without the expected sslclient
+  mbedtls_ssl_context *sslContext()
+  {
+#if TLS_SESSION_CONTEXT
+    return &sslclient->ssl_ctx;
+#else
+    return nullptr;
+#endif
+  }
+};
+
+bool tlsConnect(ResumableClientSecure &client, const String &host,
+                uint16_t port);
+
+#endif
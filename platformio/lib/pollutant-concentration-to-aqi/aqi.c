@@ -20,6 +20,7 @@
 #include "aqi.h"
 #include <math.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #ifndef AQI_EXTERN_TXT
 const char *AUSTRALIA_AQI_TXT[6] =
@@ -138,6 +139,125 @@ int compute_piecewise_aqi(float i_lo, float i_hi,
                              * (c - c_lo) + i_lo)));
 } // end compute_piecewise_aqi
 
+/* A breakpoint of the concentrations of a pollutant. Concentrations past the
+ * previous breakpoint and up to c_max (or below c_max, see AQI_BP_BELOW) map
+ * linearly from [c_lo, c_hi] onto the sub-index range [i_lo, i_hi].
+ *
+ * c_max is a float. Where the published breakpoint is not one, c_max is the
+ * float on the side of it that keeps the concentrations it counts within the
+ * row, and the published value follows the row as a comment.
+ */
+typedef struct {
+  float   c_max;
+  float   c_lo;
+  float   slope;
+  int16_t i_lo;
+  int16_t i_hi;
+} aqi_breakpoint_t;
+
+// a row of breakpoints, its slope is computed once, in float as
+// compute_piecewise_aqi() does
+#define AQI_BP(c_max, c_lo, c_hi, i_lo, i_hi)                                 \
+  { c_max, c_lo,                                                              \
+    ((float) (i_hi) - (float) (i_lo)) / ((float) (c_hi) - (float) (c_lo)),    \
+    i_lo, i_hi }
+
+// rows end below c_max instead of at it
+#define AQI_BP_BELOW  (1 << 0)
+// concentrations below c_lo of the first row are not counted
+#define AQI_BP_CUTOFF (1 << 1)
+// concentrations past the last row are not counted, instead of being past the
+// top of the scale
+#define AQI_BP_CAPPED (1 << 2)
+
+#define AQI_COUNT(a) (sizeof(a) / sizeof((a)[0]))
+
+/* Returns the index of the first of the ascending 'bound' that c is at or
+ * below, or n if there is none. The last bound is checked first. NaN is past
+ * every bound.
+ */
+static inline int aqi_band(const float bound[], int n, float c)
+{
+  if (!(c <= bound[n - 1]))
+  {
+    return n;
+  }
+  int k = 0;
+  while (c > bound[k])
+  {
+    ++k;
+  }
+  return k;
+} // end aqi_band
+
+/* Returns nonzero if concentration c is past the top of the scale on the
+ * ascending breakpoint 'row's.
+ *
+ * NaN is within no row, it is past the top like the concentrations past the
+ * last row.
+ */
+static inline __attribute__((always_inline))
+int breakpoint_past_top(const aqi_breakpoint_t row[], int rows, int flags,
+                        float c)
+{
+  if ((flags & AQI_BP_CAPPED)
+   || ((flags & AQI_BP_CUTOFF) && !(c >= row[0].c_lo)))
+  {
+    return 0;
+  }
+  return (flags & AQI_BP_BELOW) ? !(c < row[rows - 1].c_max)
+                                : !(c <= row[rows - 1].c_max);
+} // end breakpoint_past_top
+
+/* Returns the sub-index of concentration c on the ascending breakpoint 'row's,
+ * 0 if it is not counted. c must not be past the top of the scale, see
+ * breakpoint_past_top().
+ */
+static inline __attribute__((always_inline))
+int breakpoint_aqi(const aqi_breakpoint_t row[], int rows, int flags, float c)
+{
+  if ((flags & AQI_BP_CUTOFF) && !(c >= row[0].c_lo))
+  {
+    return 0;
+  }
+
+  // the first row c is within is the number of rows below it, counted without
+  // a branch on c
+  int k = 0;
+  if (flags & AQI_BP_BELOW)
+  {
+    if ((flags & AQI_BP_CAPPED) && !(c < row[rows - 1].c_max))
+    {
+      return 0;
+    }
+    for (int i = 0; i < rows - 1; ++i)
+    {
+      k += c >= row[i].c_max;
+    }
+  }
+  else
+  {
+    if ((flags & AQI_BP_CAPPED) && !(c <= row[rows - 1].c_max))
+    {
+      return 0;
+    }
+    for (int i = 0; i < rows - 1; ++i)
+    {
+      k += c > row[i].c_max;
+    }
+  }
+
+  // compute_piecewise_aqi() of the row
+  const aqi_breakpoint_t *r = &row[k];
+  return min(r->i_hi, max(r->i_lo, round(r->slope * (c - r->c_lo)
+                                         + r->i_lo)));
+} // end breakpoint_aqi
+
+// breakpoint_past_top() and breakpoint_aqi() on a table of rows
+#define AQI_PAST_TOP(rows, flags, c)                                          \
+  breakpoint_past_top(rows, AQI_COUNT(rows), flags, c)
+#define AQI_SUB(rows, flags, c) breakpoint_aqi(rows, AQI_COUNT(rows), flags, c)
+
 /* Australia (AQI)
  *
  * References:
@@ -190,546 +310,130 @@ int canada_aqhi(float no2_3h, float o3_3h, float pm2_5_3h)
  *   https://en.wikipedia.org/wiki/Air_quality_index#Mainland_China
  *   https://datadrivenlab.org/air-quality-2/chinas-new-air-quality-index-how-does-it-measure-up/
  */
+// co    μg/m^3, Carbon Monoxide (CO)
+// 1mg/m^3 = 1000 μg/m^3
+static const aqi_breakpoint_t CHINA_CO_1H[] = {
+  AQI_BP(  5000,      0,   5000,   0,  50),
+  AQI_BP( 10000,   5000,  10000,  51, 100),
+  AQI_BP( 35000,  10000,  35000, 101, 150),
+  AQI_BP( 60000,  35000,  60000, 151, 200),
+  AQI_BP( 90000,  60000,  90000, 201, 300),
+  AQI_BP(120000,  90000, 120000, 301, 400),
+  AQI_BP(150000, 120000, 150000, 401, 500),
+};
+static const aqi_breakpoint_t CHINA_CO_24H[] = {
+  AQI_BP( 2000,     0,  2000,   0,  50),
+  AQI_BP( 4000,  2000,  4000,  51, 100),
+  AQI_BP(14000,  4000, 14000, 101, 150),
+  AQI_BP(24000, 14000, 24000, 151, 200),
+  AQI_BP(36000, 24000, 36000, 201, 300),
+  AQI_BP(48000, 36000, 48000, 301, 400),
+  AQI_BP(60000, 48000, 60000, 401, 500),
+};
+// no2   μg/m^3, Nitrogen Dioxide (NO2)
+static const aqi_breakpoint_t CHINA_NO2_1H[] = {
+  AQI_BP( 100,    0,  100,   0,  50),
+  AQI_BP( 200,  100,  200,  51, 100),
+  AQI_BP( 700,  200,  700, 101, 150),
+  AQI_BP(1200,  700, 1200, 151, 200),
+  AQI_BP(2340, 1200, 2340, 201, 300),
+  AQI_BP(3090, 2340, 3090, 301, 400),
+  AQI_BP(3840, 3090, 3840, 401, 500),
+};
+static const aqi_breakpoint_t CHINA_NO2_24H[] = {
+  AQI_BP( 40,   0,  40,   0,  50),
+  AQI_BP( 80,  40,  80,  51, 100),
+  AQI_BP(180,  80, 180, 101, 150),
+  AQI_BP(280, 180, 280, 151, 200),
+  AQI_BP(565, 280, 565, 201, 300),
+  AQI_BP(750, 565, 750, 301, 400),
+  AQI_BP(940, 750, 940, 401, 500),
+};
+// o3    μg/m^3, Ozone (O3)
+static const aqi_breakpoint_t CHINA_O3_1H[] = {
+  AQI_BP( 160,    0,  160,   0,  50),
+  AQI_BP( 200,  160,  200,  51, 100),
+  AQI_BP( 300,  200,  300, 101, 150),
+  AQI_BP( 400,  300,  400, 151, 200),
+  AQI_BP( 800,  400,  800, 201, 300),
+  AQI_BP(1000,  800, 1000, 301, 400),
+  AQI_BP(1200, 1000, 1200, 401, 500),
+};
+// If 8 hour average of o3 is > 800 μg/m^3 don't calculate it.
+static const aqi_breakpoint_t CHINA_O3_8H[] = {
+  AQI_BP(100,   0, 100,   0,  50),
+  AQI_BP(160, 100, 160,  51, 100),
+  AQI_BP(215, 160, 215, 101, 150),
+  AQI_BP(265, 215, 265, 151, 200),
+  AQI_BP(800, 265, 800, 201, 300),
+};
+// so2   μg/m^3, Sulfur Dioxide (SO2)
+// If 1 hour average of so2 is > 800 μg/m^3 don't calculate it.
+static const aqi_breakpoint_t CHINA_SO2_1H[] = {
+  AQI_BP(150,   0, 150,   0,  50),
+  AQI_BP(500, 150, 500,  51, 100),
+  AQI_BP(650, 500, 650, 101, 150),
+  AQI_BP(800, 650, 800, 151, 200),
+};
+static const aqi_breakpoint_t CHINA_SO2_24H[] = {
+  AQI_BP(  50,    0,   50,   0,  50),
+  AQI_BP( 150,   50,  150,  51, 100),
+  AQI_BP( 475,  150,  475, 101, 150),
+  AQI_BP( 800,  475,  800, 151, 200),
+  AQI_BP(1600,  800, 1600, 201, 300),
+  AQI_BP(2100, 1600, 2100, 301, 400),
+  AQI_BP(2620, 2100, 2620, 401, 500),
+};
+// pm10  μg/m^3, Coarse Particulate Matter (<10μm)
+static const aqi_breakpoint_t CHINA_PM10_24H[] = {
+  AQI_BP( 50,   0,  50,   0,  50),
+  AQI_BP(150,  50, 150,  51, 100),
+  AQI_BP(250, 150, 250, 101, 150),
+  AQI_BP(350, 250, 350, 151, 200),
+  AQI_BP(420, 350, 420, 201, 300),
+  AQI_BP(500, 420, 500, 301, 400),
+  AQI_BP(600, 500, 600, 401, 500),
+};
+// pm2_5 μg/m^3, Fine Particulate Matter (<2.5μm)
+static const aqi_breakpoint_t CHINA_PM2_5_24H[] = {
+  AQI_BP( 35,   0,  35,   0,  50),
+  AQI_BP( 75,  35,  75,  51, 100),
+  AQI_BP(115,  75, 115, 101, 150),
+  AQI_BP(150, 115, 150, 151, 200),
+  AQI_BP(250, 150, 250, 201, 300),
+  AQI_BP(350, 250, 350, 301, 400),
+  AQI_BP(500, 350, 500, 401, 500),
+};
+
 int china_aqi(float co_1h, float co_24h, float no2_1h, float no2_24h,
               float o3_1h, float o3_8h,  float so2_1h, float so2_24h,
               float pm10_24h, float pm2_5_24h)
 {
-  int aqi = 0;
-  float i_lo, i_hi;
-  float c_lo, c_hi;
-
-  // co    μg/m^3, Carbon Monoxide (CO)
-  // 1mg/m^3 = 1000 μg/m^3
-  if (co_1h <= 5000)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 5000;
-  }
-  else if (co_1h <= 10000)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 5000;
-    c_hi = 10000;
-  }
-  else if (co_1h <= 35000)
-  {
-    i_lo = 101;
-    i_hi = 150;
-    c_lo = 10000;
-    c_hi = 35000;
-  }
-  else if (co_1h <= 60000)
-  {
-    i_lo = 151;
-    i_hi = 200;
-    c_lo = 35000;
-    c_hi = 60000;
-  }
-  else if (co_1h <= 90000)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 60000;
-    c_hi = 90000;
-  }
-  else if (co_1h <= 120000)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 90000;
-    c_hi = 120000;
-  }
-  else if (co_1h <= 150000)
-  {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 120000;
-    c_hi = 150000;
-  }
-  else
-  {
-    // index > 500
-    return 501;
-  }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, co_1h));
-
-  if (co_24h <= 2000)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 2000;
-  }
-  else if (co_24h <= 4000)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 2000;
-    c_hi = 4000;
-  }
-  else if (co_24h <= 14000)
-  {
-    i_lo = 101;
-    i_hi = 150;
-    c_lo = 4000;
-    c_hi = 14000;
-  }
-  else if (co_24h <= 24000)
-  {
-    i_lo = 151;
-    i_hi = 200;
-    c_lo = 14000;
-    c_hi = 24000;
-  }
-  else if (co_24h <= 36000)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 24000;
-    c_hi = 36000;
-  }
-  else if (co_24h <= 48000)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 36000;
-    c_hi = 48000;
-  }
-  else if (co_24h <= 60000)
-  {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 48000;
-    c_hi = 60000;
-  }
-  else
-  {
-    // index > 500
-    return 501;
-  }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, co_24h));
-
-  // no2   μg/m^3, Nitrogen Dioxide (NO2)
-  if (no2_1h <= 100)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 100;
-  }
-  else if (no2_1h <= 200)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 100;
-    c_hi = 200;
-  }
-  else if (no2_1h <= 700)
-  {
-    i_lo = 101;
-    i_hi = 150;
-    c_lo = 200;
-    c_hi = 700;
-  }
-  else if (no2_1h <= 1200)
-  {
-    i_lo = 151;
-    i_hi = 200;
-    c_lo = 700;
-    c_hi = 1200;
-  }
-  else if (no2_1h <= 2340)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 1200;
-    c_hi = 2340;
-  }
-  else if (no2_1h <= 3090)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 2340;
-    c_hi = 3090;
-  }
-  else if (no2_1h <= 3840)
-  {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 3090;
-    c_hi = 3840;
-  }
-  else
-  {
-    // index > 500
-    return 501;
-  }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, no2_1h));
-
-  if (no2_24h <= 40)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 40;
-  }
-  else if (no2_24h <= 80)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 40;
-    c_hi = 80;
-  }
-  else if (no2_24h <= 180)
-  {
-    i_lo = 101;
-    i_hi = 150;
-    c_lo = 80;
-    c_hi = 180;
-  }
-  else if (no2_24h <= 280)
-  {
-    i_lo = 151;
-    i_hi = 200;
-    c_lo = 180;
-    c_hi = 280;
-  }
-  else if (no2_24h <= 565)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 280;
-    c_hi = 565;
-  }
-  else if (no2_24h <= 750)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 565;
-    c_hi = 750;
-  }
-  else if (no2_24h <= 940)
-  {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 750;
-    c_hi = 940;
-  }
-  else
-  {
-    // index > 500
-    return 501;
-  }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, no2_24h));
-
-  // o3    μg/m^3, Ozone (O3)
-  if (o3_1h <= 160)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 160;
-  }
-  else if (o3_1h <= 200)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 160;
-    c_hi = 200;
-  }
-  else if (o3_1h <= 300)
-  {
-    i_lo = 101;
-    i_hi = 150;
-    c_lo = 200;
-    c_hi = 300;
-  }
-  else if (o3_1h <= 400)
-  {
-    i_lo = 151;
-    i_hi = 200;
-    c_lo = 300;
-    c_hi = 400;
-  }
-  else if (o3_1h <= 800)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 400;
-    c_hi = 800;
-  }
-  else if (o3_1h <= 1000)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 800;
-    c_hi = 1000;
-  }
-  else if (o3_1h <= 1200)
-  {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 1000;
-    c_hi = 1200;
-  }
-  else
-  {
-    // index > 500
-    return 501;
-  }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, o3_1h));
-
-  // If 8 hour average of o3 is > 800 μg/m^3 don't calculate it.
-  if (o3_8h <= 800)
-  {
-    if (o3_8h <= 100)
-    {
-      i_lo = 0;
-      i_hi = 50;
-      c_lo = 0;
-      c_hi = 100;
-    }
-    else if (o3_8h <= 160)
-    {
-      i_lo = 51;
-      i_hi = 100;
-      c_lo = 100;
-      c_hi = 160;
-    }
-    else if (o3_8h <= 215)
-    {
-      i_lo = 101;
-      i_hi = 150;
-      c_lo = 160;
-      c_hi = 215;
-    }
-    else if (o3_8h <= 265)
-    {
-      i_lo = 151;
-      i_hi = 200;
-      c_lo = 215;
-      c_hi = 265;
-    }
-    else
-    {
-      // 265 < o3_8h <= 800
-      i_lo = 201;
-      i_hi = 300;
-      c_lo = 265;
-      c_hi = 800;
-    }
-    aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, o3_8h));
-  }
-
-  // so2   μg/m^3, Sulfur Dioxide (SO2)
-  // If 1 hour average of so2 is > 800 μg/m^3 don't calculate it.
-  if (so2_1h <= 800)
-  {
-    if (so2_1h <= 150)
-    {
-      i_lo = 0;
-      i_hi = 50;
-      c_lo = 0;
-      c_hi = 150;
-    }
-    else if (so2_1h <= 500)
-    {
-      i_lo = 51;
-      i_hi = 100;
-      c_lo = 150;
-      c_hi = 500;
-    }
-    else if (so2_1h <= 650)
-    {
-      i_lo = 101;
-      i_hi = 150;
-      c_lo = 500;
-      c_hi = 650;
-    }
-    else
-    {
-      // 650 < so2_1h <= 800
-      i_lo = 151;
-      i_hi = 200;
-      c_lo = 650;
-      c_hi = 800;
-    }
-    aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, so2_1h));
-  }
-
-  if (so2_24h <= 50)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 50;
-  }
-  else if (so2_24h <= 150)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 50;
-    c_hi = 150;
-  }
-  else if (so2_24h <= 475)
-  {
-    i_lo = 101;
-    i_hi = 150;
-    c_lo = 150;
-    c_hi = 475;
-  }
-  else if (so2_24h <= 800)
-  {
-    i_lo = 151;
-    i_hi = 200;
-    c_lo = 475;
-    c_hi = 800;
-  }
-  else if (so2_24h <= 1600)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 800;
-    c_hi = 1600;
-  }
-  else if (so2_24h <= 2100)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 1600;
-    c_hi = 2100;
-  }
-  else if (so2_24h <= 2620)
-  {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 2100;
-    c_hi = 2620;
-  }
-  else
-  {
-    // index > 500
-    return 501;
-  }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, so2_24h));
-
-  // pm10  μg/m^3, Coarse Particulate Matter (<10μm)
-  if (pm10_24h <= 50)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 50;
-  }
-  else if (pm10_24h <= 150)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 50;
-    c_hi = 150;
-  }
-  else if (pm10_24h <= 250)
-  {
-    i_lo = 101;
-    i_hi = 150;
-    c_lo = 150;
-    c_hi = 250;
-  }
-  else if (pm10_24h <= 350)
-  {
-    i_lo = 151;
-    i_hi = 200;
-    c_lo = 250;
-    c_hi = 350;
-  }
-  else if (pm10_24h <= 420)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 350;
-    c_hi = 420;
-  }
-  else if (pm10_24h <= 500)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 420;
-    c_hi = 500;
-  }
-  else if (pm10_24h <= 600)
-  {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 500;
-    c_hi = 600;
-  }
-  else
-  {
-    // index > 500
-    return 501;
-  }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, pm10_24h));
-
-  // pm2_5 μg/m^3, Fine Particulate Matter (<2.5μm)
-  if (pm2_5_24h <= 35)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 35;
-  }
-  else if (pm2_5_24h <= 75)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 35;
-    c_hi = 75;
-  }
-  else if (pm2_5_24h <= 115)
-  {
-    i_lo = 101;
-    i_hi = 150;
-    c_lo = 75;
-    c_hi = 115;
-  }
-  else if (pm2_5_24h <= 150)
-  {
-    i_lo = 151;
-    i_hi = 200;
-    c_lo = 115;
-    c_hi = 150;
-  }
-  else if (pm2_5_24h <= 250)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 150;
-    c_hi = 250;
-  }
-  else if (pm2_5_24h <= 350)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 250;
-    c_hi = 350;
-  }
-  else if (pm2_5_24h <= 500)
-  {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 350;
-    c_hi = 500;
-  }
-  else
+  // past the top of the scale, checked before any sub-index is computed
+  if (AQI_PAST_TOP(CHINA_CO_1H,     0, co_1h) ||
+      AQI_PAST_TOP(CHINA_CO_24H,    0, co_24h) ||
+      AQI_PAST_TOP(CHINA_NO2_1H,    0, no2_1h) ||
+      AQI_PAST_TOP(CHINA_NO2_24H,   0, no2_24h) ||
+      AQI_PAST_TOP(CHINA_O3_1H,     0, o3_1h) ||
+      AQI_PAST_TOP(CHINA_SO2_24H,   0, so2_24h) ||
+      AQI_PAST_TOP(CHINA_PM10_24H,  0, pm10_24h) ||
+      AQI_PAST_TOP(CHINA_PM2_5_24H, 0, pm2_5_24h))
   {
     // index > 500
-    return 501;
+    return CHINA_AQI_MAX + 1;
   }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, pm2_5_24h));
 
+  int aqi = 0;
+  aqi = max(aqi, AQI_SUB(CHINA_CO_1H,     0, co_1h));
+  aqi = max(aqi, AQI_SUB(CHINA_CO_24H,    0, co_24h));
+  aqi = max(aqi, AQI_SUB(CHINA_NO2_1H,    0, no2_1h));
+  aqi = max(aqi, AQI_SUB(CHINA_NO2_24H,   0, no2_24h));
+  aqi = max(aqi, AQI_SUB(CHINA_O3_1H,     0, o3_1h));
+  aqi = max(aqi, AQI_SUB(CHINA_O3_8H,     AQI_BP_CAPPED, o3_8h));
+  aqi = max(aqi, AQI_SUB(CHINA_SO2_1H,    AQI_BP_CAPPED, so2_1h));
+  aqi = max(aqi, AQI_SUB(CHINA_SO2_24H,   0, so2_24h));
+  aqi = max(aqi, AQI_SUB(CHINA_PM10_24H,  0, pm10_24h));
+  aqi = max(aqi, AQI_SUB(CHINA_PM2_5_24H, 0, pm2_5_24h));
   return aqi;
 } // end china_aqi
 
@@ -739,156 +443,52 @@ int china_aqi(float co_1h, float co_24h, float no2_1h, float no2_24h,
  *   http://airqualitynow.eu/about_indices_definition.php
  *   https://en.wikipedia.org/wiki/Air_quality_index#CAQI
  */
+// no2   μg/m^3, Nitrogen Dioxide (NO2)
+static const aqi_breakpoint_t EUROPEAN_UNION_NO2_1H[] = {
+  AQI_BP( 50,   0,  50,  0,  25),
+  AQI_BP(100,  50, 100, 26,  50),
+  AQI_BP(200, 100, 200, 51,  75),
+  AQI_BP(400, 200, 400, 76, 100),
+};
+// o3    μg/m^3, Ground-Level Ozone (O3)
+static const aqi_breakpoint_t EUROPEAN_UNION_O3_1H[] = {
+  AQI_BP( 60,   0,  60,  0,  25),
+  AQI_BP(120,  60, 120, 25,  50),
+  AQI_BP(180, 120, 180, 51,  75),
+  AQI_BP(240, 180, 240, 76, 100),
+};
+// pm10  μg/m^3, Coarse Particulate Matter (<10μm)
+static const aqi_breakpoint_t EUROPEAN_UNION_PM10_1H[] = {
+  AQI_BP( 25,  0,  25,  0,  25),
+  AQI_BP( 50, 25,  50, 26,  50),
+  AQI_BP( 90, 50,  90, 51,  75),
+  AQI_BP(180, 90, 180, 76, 100),
+};
+// pm2_5 μg/m^3, Fine Particulate Matter (<2.5μm)
+static const aqi_breakpoint_t EUROPEAN_UNION_PM2_5_1H[] = {
+  AQI_BP( 15,  0,  15,  0,  25),
+  AQI_BP( 30, 15,  30, 26,  50),
+  AQI_BP( 55, 30,  55, 51,  75),
+  AQI_BP(110, 55, 110, 76, 100),
+};
+
 int european_union_caqi(float no2_1h, float o3_1h, float pm10_1h, float pm2_5_1h)
 {
-  int caqi = 0;
-  float i_lo, i_hi;
-  float c_lo, c_hi;
-
-  // no2   μg/m^3, Nitrogen Dioxide (NO2)
-  if (no2_1h <= 50)
-  {
-    i_lo = 0;
-    i_hi = 25;
-    c_lo = 0;
-    c_hi = 50;
-  }
-  else if (no2_1h <= 100)
-  {
-    i_lo = 26;
-    i_hi = 50;
-    c_lo = 50;
-    c_hi = 100;
-  }
-  else if (no2_1h <= 200)
-  {
-    i_lo = 51;
-    i_hi = 75;
-    c_lo = 100;
-    c_hi = 200;
-  }
-  else if (no2_1h <= 400)
-  {
-    i_lo = 76;
-    i_hi = 100;
-    c_lo = 200;
-    c_hi = 400;
-  }
-  else
+  // past the top of the scale, checked before any sub-index is computed
+  if (AQI_PAST_TOP(EUROPEAN_UNION_NO2_1H,   0, no2_1h) ||
+      AQI_PAST_TOP(EUROPEAN_UNION_O3_1H,    0, o3_1h) ||
+      AQI_PAST_TOP(EUROPEAN_UNION_PM10_1H,  0, pm10_1h) ||
+      AQI_PAST_TOP(EUROPEAN_UNION_PM2_5_1H, 0, pm2_5_1h))
   {
     // index > 100
-    return 101;
+    return EUROPEAN_UNION_CAQI_MAX + 1;
   }
-  caqi = max(caqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, no2_1h));
-
-  // o3    μg/m^3, Ground-Level Ozone (O3)
-  if (o3_1h <= 60)
-  {
-    i_lo = 0;
-    i_hi = 25;
-    c_lo = 0;
-    c_hi = 60;
-  }
-  else if (o3_1h <= 120)
-  {
-    i_lo = 25;
-    i_hi = 50;
-    c_lo = 60;
-    c_hi = 120;
-  }
-  else if (o3_1h <= 180)
-  {
-    i_lo = 51;
-    i_hi = 75;
-    c_lo = 120;
-    c_hi = 180;
-  }
-  else if (o3_1h <= 240)
-  {
-    i_lo = 76;
-    i_hi = 100;
-    c_lo = 180;
-    c_hi = 240;
-  }
-  else
-  {
-    // index > 100
-    return 101;
-  }
-  caqi = max(caqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, o3_1h));
-
-  // pm10  μg/m^3, Coarse Particulate Matter (<10μm)
-  if (pm10_1h <= 25)
-  {
-    i_lo = 0;
-    i_hi = 25;
-    c_lo = 0;
-    c_hi = 25;
-  }
-  else if (pm10_1h <= 50)
-  {
-    i_lo = 26;
-    i_hi = 50;
-    c_lo = 25;
-    c_hi = 50;
-  }
-  else if (pm10_1h <= 90)
-  {
-    i_lo = 51;
-    i_hi = 75;
-    c_lo = 50;
-    c_hi = 90;
-  }
-  else if (pm10_1h <= 180)
-  {
-    i_lo = 76;
-    i_hi = 100;
-    c_lo = 90;
-    c_hi = 180;
-  }
-  else
-  {
-    // index > 100
-    return 101;
-  }
-  caqi = max(caqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, pm10_1h));
-
-  // pm2_5 μg/m^3, Fine Particulate Matter (<2.5μm)
-  if (pm2_5_1h <= 15)
-  {
-    i_lo = 0;
-    i_hi = 25;
-    c_lo = 0;
-    c_hi = 15;
-  }
-  else if (pm2_5_1h <= 30)
-  {
-    i_lo = 26;
-    i_hi = 50;
-    c_lo = 15;
-    c_hi = 30;
-  }
-  else if (pm2_5_1h <= 55)
-  {
-    i_lo = 51;
-    i_hi = 75;
-    c_lo = 30;
-    c_hi = 55;
-  }
-  else if (pm2_5_1h <= 110)
-  {
-    i_lo = 76;
-    i_hi = 100;
-    c_lo = 55;
-    c_hi = 110;
-  }
-  else
-  {
-    // index > 100
-    return 101;
-  }
-  caqi = max(caqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, pm2_5_1h));
 
+  int caqi = 0;
+  caqi = max(caqi, AQI_SUB(EUROPEAN_UNION_NO2_1H,   0, no2_1h));
+  caqi = max(caqi, AQI_SUB(EUROPEAN_UNION_O3_1H,    0, o3_1h));
+  caqi = max(caqi, AQI_SUB(EUROPEAN_UNION_PM10_1H,  0, pm10_1h));
+  caqi = max(caqi, AQI_SUB(EUROPEAN_UNION_PM2_5_1H, 0, pm2_5_1h));
   return caqi;
 } // end european_union_caqi
 
@@ -898,55 +498,18 @@ int european_union_caqi(float no2_1h, float o3_1h, float pm10_1h, float pm2_5_1h
  *   https://www.aqhi.gov.hk/en/what-is-aqhi/faqs.html
  *   https://aqicn.org/faq/2015-06-03/overview-of-hong-kongs-air-quality-health-index/
  */
+// highest added health risk (%AR) of AQHI 1 to 10, the last one is the float
+// below 19.37
+static const float HONG_KONG_AQHI_AR[] = {
+  1.88, 3.76, 5.64, 7.52, 9.41, 11.29, 12.91, 15.07, 17.22, 19.3699989,
+};
+
 int hong_kong_aqhi(float no2_3h,  float o3_3h, float so2_3h,
                    float pm10_3h, float pm2_5_3h)
 {
   float ar = ((exp(0.0004462559 * no2_3h) - 1) * 100) + ((exp(0.0001393235 * so2_3h) - 1) * 100) + ((exp(0.0005116328 * o3_3h) - 1) * 100) + fmax(((exp(0.0002821751 * pm10_3h) - 1) * 100), ((exp(0.0002180567 * pm2_5_3h) - 1) * 100));
-  if (ar <= 1.88)
-  {
-    return 1;
-  }
-  else if (ar <= 3.76)
-  {
-    return 2;
-  }
-  else if (ar <= 5.64)
-  {
-    return 3;
-  }
-  else if (ar <= 7.52)
-  {
-    return 4;
-  }
-  else if (ar <= 9.41)
-  {
-    return 5;
-  }
-  else if (ar <= 11.29)
-  {
-    return 6;
-  }
-  else if (ar <= 12.91)
-  {
-    return 7;
-  }
-  else if (ar <= 15.07)
-  {
-    return 8;
-  }
-  else if (ar <= 17.22)
-  {
-    return 9;
-  }
-  else if (ar <= 19.37)
-  {
-    return 10;
-  }
-  else
-  {
-    // index > 10
-    return 11;
-  }
+  // index > 10 past the last
+  return 1 + aqi_band(HONG_KONG_AQHI_AR, AQI_COUNT(HONG_KONG_AQHI_AR), ar);
 } // end hong_kong_aqhi
 
 /* India (AQI)
@@ -955,358 +518,98 @@ int hong_kong_aqhi(float no2_3h,  float o3_3h, float so2_3h,
  *   https://www.aqi.in/blog/aqi/
  *   https://www.pranaair.com/blog/what-is-air-quality-index-aqi-and-its-calculation/
  */
+// co    μg/m^3, Carbon Monoxide (CO)
+// 1mg/m^3 = 1000 μg/m^3
+static const aqi_breakpoint_t INDIA_CO_8H[] = {
+  AQI_BP( 1050,     0,  1000,   0,  50),
+  AQI_BP( 2050,  1100,  2000,  51, 100),
+  AQI_BP(10050,  2100, 10000, 101, 200),
+  AQI_BP(17050, 10100, 17000, 201, 300),
+  AQI_BP(34050, 17100, 34000, 301, 400),
+};
+// nh3   μg/m^3, Ammonia (NH3)
+static const aqi_breakpoint_t INDIA_NH3_24H[] = {
+  AQI_BP( 200.5,    0,  200,   0,  50),
+  AQI_BP( 400.5,  201,  400,  51, 100),
+  AQI_BP( 800.5,  401,  800, 101, 200),
+  AQI_BP(1200.5,  801, 1200, 201, 300),
+  AQI_BP(1800.5, 1201, 1800, 301, 400),
+};
+// no2   μg/m^3, Nitrogen Dioxide (NO2)
+static const aqi_breakpoint_t INDIA_NO2_24H[] = {
+  AQI_BP( 40.5,   0,  40,   0,  50),
+  AQI_BP( 80.5,  41,  80,  51, 100),
+  AQI_BP(180.5,  81, 180, 101, 200),
+  AQI_BP(280.5, 181, 280, 201, 300),
+  AQI_BP(400.5, 281, 400, 301, 400),
+};
+// o3    μg/m^3, Ozone (O3)
+static const aqi_breakpoint_t INDIA_O3_8H[] = {
+  AQI_BP( 50.5,   0,  50,   0,  50),
+  AQI_BP(100.5,  51, 100,  51, 100),
+  AQI_BP(168.5, 101, 168, 101, 200),
+  AQI_BP(208.5, 169, 208, 201, 300),
+  AQI_BP(748.5, 209, 748, 301, 400),
+};
+// pb    μg/m^3, Lead (Pb)
+static const aqi_breakpoint_t INDIA_PB_24H[] = {
+  AQI_BP(      0.55,   0, 0.5,   0,  50),
+  AQI_BP(1.05000007, 0.6, 1.0,  51, 100), // < 1.05
+  AQI_BP(2.05000019, 1.1, 2.0, 101, 200), // < 2.05
+  AQI_BP(3.05000019, 2.1, 3.0, 201, 300), // < 3.05
+  AQI_BP(3.55000019, 3.1, 3.5, 301, 400), // < 3.55
+};
+// so2   μg/m^3, Sulfur Dioxide (SO2)
+static const aqi_breakpoint_t INDIA_SO2_24H[] = {
+  AQI_BP(  40.5,   0,   40,   0,  50),
+  AQI_BP(  80.5,  41,   80,  51, 100),
+  AQI_BP( 380.5,  81,  380, 101, 200),
+  AQI_BP( 800.5, 381,  800, 201, 300),
+  AQI_BP(1600.5, 801, 1600, 301, 400),
+};
+// pm10  μg/m^3, Coarse Particulate Matter (<10μm)
+static const aqi_breakpoint_t INDIA_PM10_24H[] = {
+  AQI_BP( 50.5,   0,  50,   0,  50),
+  AQI_BP(100.5,  51, 100,  51, 100),
+  AQI_BP(250.5, 101, 250, 101, 200),
+  AQI_BP(350.5, 251, 350, 201, 300),
+  AQI_BP(430.5, 351, 430, 301, 400),
+};
+// pm2_5 μg/m^3, Fine Particulate Matter (<2.5μm)
+static const aqi_breakpoint_t INDIA_PM2_5_24H[] = {
+  AQI_BP( 30.5,   0,  30,   0,  50),
+  AQI_BP( 60.5,  31,  60,  51, 100),
+  AQI_BP( 90.5,  61,  90, 101, 200),
+  AQI_BP(120.5,  91, 120, 201, 300),
+  AQI_BP(250.5, 121, 250, 301, 400),
+};
+
 int india_aqi(float co_8h,  float nh3_24h, float no2_24h,  float o3_8h,
               float pb_24h, float so2_24h, float pm10_24h, float pm2_5_24h)
 {
-  int aqi = 0;
-  float i_lo, i_hi;
-  float c_lo, c_hi;
-
-  // co    μg/m^3, Carbon Monoxide (CO)
-  // 1mg/m^3 = 1000 μg/m^3
-  if (co_8h < 1050)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 1000;
-  }
-  else if (co_8h < 2050)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 1100;
-    c_hi = 2000;
-  }
-  else if (co_8h < 10050)
-  {
-    i_lo = 101;
-    i_hi = 200;
-    c_lo = 2100;
-    c_hi = 10000;
-  }
-  else if (co_8h < 17050)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 10100;
-    c_hi = 17000;
-  }
-  else if (co_8h < 34050)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 17100;
-    c_hi = 34000;
-  }
-  else
-  {
-    // index > 400
-    return 401;
-  }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, co_8h));
-
-  // nh3   μg/m^3, Ammonia (NH3)
-  if (nh3_24h < 200.5)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 200;
-  }
-  else if (nh3_24h < 400.5)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 201;
-    c_hi = 400;
-  }
-  else if (nh3_24h < 800.5)
-  {
-    i_lo = 101;
-    i_hi = 200;
-    c_lo = 401;
-    c_hi = 800;
-  }
-  else if (nh3_24h < 1200.5)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 801;
-    c_hi = 1200;
-  }
-  else if (nh3_24h < 1800.5)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 1201;
-    c_hi = 1800;
-  }
-  else
-  {
-    // index > 400
-    return 401;
-  }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, nh3_24h));
-
-  // no2   μg/m^3, Nitrogen Dioxide (NO2)
-  if (no2_24h < 40.5)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 40;
-  }
-  else if (no2_24h < 80.5)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 41;
-    c_hi = 80;
-  }
-  else if (no2_24h < 180.5)
-  {
-    i_lo = 101;
-    i_hi = 200;
-    c_lo = 81;
-    c_hi = 180;
-  }
-  else if (no2_24h < 280.5)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 181;
-    c_hi = 280;
-  }
-  else if (no2_24h < 400.5)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 281;
-    c_hi = 400;
-  }
-  else
-  {
-    // index > 400
-    return 401;
-  }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, no2_24h));
-
-  // o3    μg/m^3, Ozone (O3)
-  if (o3_8h < 50.5)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 50;
-  }
-  else if (o3_8h < 100.5)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 51;
-    c_hi = 100;
-  }
-  else if (o3_8h < 168.5)
-  {
-    i_lo = 101;
-    i_hi = 200;
-    c_lo = 101;
-    c_hi = 168;
-  }
-  else if (o3_8h < 208.5)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 169;
-    c_hi = 208;
-  }
-  else if (o3_8h < 748.5)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 209;
-    c_hi = 748;
-  }
-  else
-  {
-    // index > 400
-    return 401;
-  }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, o3_8h));
-
-  // pb    μg/m^3, Lead (Pb)
-  if (pb_24h < 0.55)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 0.5;
-  }
-  else if (pb_24h < 1.05)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 0.6;
-    c_hi = 1.0;
-  }
-  else if (pb_24h < 2.05)
-  {
-    i_lo = 101;
-    i_hi = 200;
-    c_lo = 1.1;
-    c_hi = 2.0;
-  }
-  else if (pb_24h < 3.05)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 2.1;
-    c_hi = 3.0;
-  }
-  else if (pb_24h < 3.55)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 3.1;
-    c_hi = 3.5;
-  }
-  else
-  {
-    // index > 400
-    return 401;
-  }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, pb_24h));
-
-  // so2   μg/m^3, Sulfur Dioxide (SO2)
-  if (so2_24h < 40.5)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 40;
-  }
-  else if (so2_24h < 80.5)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 41;
-    c_hi = 80;
-  }
-  else if (so2_24h < 380.5)
-  {
-    i_lo = 101;
-    i_hi = 200;
-    c_lo = 81;
-    c_hi = 380;
-  }
-  else if (so2_24h < 800.5)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 381;
-    c_hi = 800;
-  }
-  else if (so2_24h < 1600.5)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 801;
-    c_hi = 1600;
-  }
-  else
-  {
-    // index > 400
-    return 401;
-  }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, so2_24h));
-
-  // pm10  μg/m^3, Coarse Particulate Matter (<10μm)
-  if (pm10_24h < 50.5)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 50;
-  }
-  else if (pm10_24h < 100.5)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 51;
-    c_hi = 100;
-  }
-  else if (pm10_24h < 250.5)
-  {
-    i_lo = 101;
-    i_hi = 200;
-    c_lo = 101;
-    c_hi = 250;
-  }
-  else if (pm10_24h < 350.5)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 251;
-    c_hi = 350;
-  }
-  else if (pm10_24h < 430.5)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 351;
-    c_hi = 430;
-  }
-  else
-  {
-    // index > 400
-    return 401;
-  }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, pm10_24h));
-
-  // pm2_5 μg/m^3, Fine Particulate Matter (<2.5μm)
-  if (pm2_5_24h < 30.5)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 30;
-  }
-  else if (pm2_5_24h < 60.5)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 31;
-    c_hi = 60;
-  }
-  else if (pm2_5_24h < 90.5)
-  {
-    i_lo = 101;
-    i_hi = 200;
-    c_lo = 61;
-    c_hi = 90;
-  }
-  else if (pm2_5_24h < 120.5)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 91;
-    c_hi = 120;
-  }
-  else if (pm2_5_24h < 250.5)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 121;
-    c_hi = 250;
-  }
-  else
+  // past the top of the scale, checked before any sub-index is computed
+  if (AQI_PAST_TOP(INDIA_CO_8H,     AQI_BP_BELOW, co_8h) ||
+      AQI_PAST_TOP(INDIA_NH3_24H,   AQI_BP_BELOW, nh3_24h) ||
+      AQI_PAST_TOP(INDIA_NO2_24H,   AQI_BP_BELOW, no2_24h) ||
+      AQI_PAST_TOP(INDIA_O3_8H,     AQI_BP_BELOW, o3_8h) ||
+      AQI_PAST_TOP(INDIA_PB_24H,    AQI_BP_BELOW, pb_24h) ||
+      AQI_PAST_TOP(INDIA_SO2_24H,   AQI_BP_BELOW, so2_24h) ||
+      AQI_PAST_TOP(INDIA_PM10_24H,  AQI_BP_BELOW, pm10_24h) ||
+      AQI_PAST_TOP(INDIA_PM2_5_24H, AQI_BP_BELOW, pm2_5_24h))
   {
     // index > 400
-    return 401;
+    return INDIA_AQI_MAX + 1;
   }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, pm2_5_24h));
 
+  int aqi = 0;
+  aqi = max(aqi, AQI_SUB(INDIA_CO_8H,     AQI_BP_BELOW, co_8h));
+  aqi = max(aqi, AQI_SUB(INDIA_NH3_24H,   AQI_BP_BELOW, nh3_24h));
+  aqi = max(aqi, AQI_SUB(INDIA_NO2_24H,   AQI_BP_BELOW, no2_24h));
+  aqi = max(aqi, AQI_SUB(INDIA_O3_8H,     AQI_BP_BELOW, o3_8h));
+  aqi = max(aqi, AQI_SUB(INDIA_PB_24H,    AQI_BP_BELOW, pb_24h));
+  aqi = max(aqi, AQI_SUB(INDIA_SO2_24H,   AQI_BP_BELOW, so2_24h));
+  aqi = max(aqi, AQI_SUB(INDIA_PM10_24H,  AQI_BP_BELOW, pm10_24h));
+  aqi = max(aqi, AQI_SUB(INDIA_PM2_5_24H, AQI_BP_BELOW, pm2_5_24h));
   return aqi;
 } // end india_aqi
 
@@ -1316,342 +619,97 @@ int india_aqi(float co_8h,  float nh3_24h, float no2_24h,  float o3_8h,
  *   https://www.haze.gov.sg/
  *   http://www.haze.gov.sg/docs/default-source/faq/computation-of-the-pollutant-standards-index-%28psi%29.pdf
  */
+// co    μg/m^3, Carbon Monoxide (CO)
+// 1mg/m^3 = 1000 μg/m^3
+static const aqi_breakpoint_t SINGAPORE_CO_8H[] = {
+  AQI_BP( 5050,     0,  5000,   0,  50),
+  AQI_BP(10050,  5100, 10000,  51, 100),
+  AQI_BP(17050, 10100, 17000, 101, 200),
+  AQI_BP(34050, 17100, 34000, 201, 300),
+  AQI_BP(46050, 34100, 46000, 301, 400),
+  AQI_BP(57550, 46100, 57500, 401, 500),
+};
+// no2   μg/m^3, Nitrogen Dioxide (NO2)
+// only calculated if >= 1130 μg/m^3, where the sub-index is 200
+static const aqi_breakpoint_t SINGAPORE_NO2_1H[] = {
+  AQI_BP(1130.5, 1129.5, 1130.5, 200, 200),
+  AQI_BP(2260.5,   1131,   2260, 201, 300),
+  AQI_BP(3000.5,   2261,   3000, 301, 400),
+  AQI_BP(3750.5,   3001,   3750, 401, 500),
+};
+// so2   μg/m^3, Sulfur Dioxide (SO2)
+static const aqi_breakpoint_t SINGAPORE_SO2_24H[] = {
+  AQI_BP(  80.5,    0,   80,   0,  50),
+  AQI_BP( 365.5,   81,  365,  51, 100),
+  AQI_BP( 800.5,  366,  800, 101, 200),
+  AQI_BP(1600.5,  801, 1600, 201, 300),
+  AQI_BP(2100.5, 1601, 2100, 301, 400),
+  AQI_BP(2620.5, 2101, 2620, 401, 500),
+};
+// pm10  μg/m^3, Coarse Particulate Matter (<10μm)
+static const aqi_breakpoint_t SINGAPORE_PM10_24H[] = {
+  AQI_BP( 50.5,   0,  50,   0,  50),
+  AQI_BP(150.5,  51, 150,  51, 100),
+  AQI_BP(350.5, 151, 350, 101, 200),
+  AQI_BP(420.5, 351, 420, 201, 300),
+  AQI_BP(500.5, 421, 500, 301, 400),
+  AQI_BP(600.5, 501, 600, 401, 500),
+};
+// pm2_5 μg/m^3, Fine Particulate Matter (<2.5μm)
+static const aqi_breakpoint_t SINGAPORE_PM2_5_24H[] = {
+  AQI_BP( 12.5,   0,  12,   0,  50),
+  AQI_BP( 55.5,  13,  55,  51, 100),
+  AQI_BP(150.5,  56, 150, 101, 200),
+  AQI_BP(250.5, 151, 250, 201, 300),
+  AQI_BP(350.5, 251, 350, 301, 400),
+  AQI_BP(500.5, 351, 500, 401, 500),
+};
+// o3    μg/m^3, Ozone (O3)
+// When 8-hour o3 concentration is > 785 μg/m^3, then the PSI sub-index is
+// calculated using the 1 hour concentration.
+static const aqi_breakpoint_t SINGAPORE_O3_8H[] = {
+  AQI_BP(   118.5,   0, 118,   0,  50),
+  AQI_BP(   157.5, 119, 157,  51, 100),
+  AQI_BP(   235.5, 158, 235, 101, 200),
+  AQI_BP(HUGE_VAL, 236, 785, 201, 300), // o3_8h <= 785
+};
+static const aqi_breakpoint_t SINGAPORE_O3_1H[] = {
+  AQI_BP( 118.5,   0,  118,   0,  50),
+  AQI_BP( 157.5, 119,  157,  51, 100),
+  AQI_BP( 235.5, 158,  235, 101, 200),
+  AQI_BP( 785.5, 236,  785, 201, 300),
+  AQI_BP( 980.5, 786,  980, 301, 400),
+  AQI_BP(1180.5, 981, 1180, 401, 500),
+};
+
 int singapore_psi(float co_8h,   float no2_1h,   float o3_1h, float o3_8h,
                   float so2_24h, float pm10_24h, float pm2_5_24h)
 {
-  int psi = 0;
-  float i_lo, i_hi;
-  float c_lo, c_hi;
-
-  // co    μg/m^3, Carbon Monoxide (CO)
-  // 1mg/m^3 = 1000 μg/m^3
-  if (co_8h < 5050)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 5000;
-  }
-  else if (co_8h < 10050)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 5100;
-    c_hi = 10000;
-  }
-  else if (co_8h < 17050)
-  {
-    i_lo = 101;
-    i_hi = 200;
-    c_lo = 10100;
-    c_hi = 17000;
-  }
-  else if (co_8h < 34050)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 17100;
-    c_hi = 34000;
-  }
-  else if (co_8h < 46050)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 34100;
-    c_hi = 46000;
-  }
-  else if (co_8h < 57550)
-  {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 46100;
-    c_hi = 57500;
-  }
-  else
-  {
-    // index > 500
-    return 501;
-  }
-  psi = max(psi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, co_8h));
-
-  // no2   μg/m^3, Nitrogen Dioxide (NO2)
-  // only calculated if >= 1130 μg/m^3
-  if (no2_1h >= 1129.5)
-  {
-    if (no2_1h < 2260.5)
-    {
-      i_lo = 201;
-      i_hi = 300;
-      c_lo = 1131;
-      c_hi = 2260;
-    }
-    else if (no2_1h < 3000.5)
-    {
-      i_lo = 301;
-      i_hi = 400;
-      c_lo = 2261;
-      c_hi = 3000;
-    }
-    else if (no2_1h < 3750.5)
-    {
-      i_lo = 401;
-      i_hi = 500;
-      c_lo = 3001;
-      c_hi = 3750;
-    }
-    else
-    {
-      // index > 500
-      return 501;
-    }
-    if (no2_1h >= 1129.5 && no2_1h < 1130.5)
-    {
-      psi = max(psi, 200);
-    }
-    else
-    {
-      psi = max(psi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, no2_1h));
-    }
-  }
-
-  // o3    μg/m^3, Ozone (O3)
-  // When 8-hour o3 concentration is > 785 μg/m^3, then the PSI sub-index is
-  // calculated using the 1 hour concentration.
-  if (o3_8h <= 785)
-  {
-    if (o3_8h < 118.5)
-    {
-      i_lo = 0;
-      i_hi = 50;
-      c_lo = 0;
-      c_hi = 118;
-    }
-    else if (o3_8h < 157.5)
-    {
-      i_lo = 51;
-      i_hi = 100;
-      c_lo = 119;
-      c_hi = 157;
-    }
-    else if (o3_8h < 235.5)
-    {
-      i_lo = 101;
-      i_hi = 200;
-      c_lo = 158;
-      c_hi = 235;
-    }
-    else
-    {
-      // o3_8h <= 785
-      i_lo = 201;
-      i_hi = 300;
-      c_lo = 236;
-      c_hi = 785;
-    }
-    psi = max(psi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, o3_8h));
-  }
-  else
-  {
-    if (o3_1h < 118.5)
-    {
-      i_lo = 0;
-      i_hi = 50;
-      c_lo = 0;
-      c_hi = 118;
-    }
-    else if (o3_1h < 157.5)
-    {
-      i_lo = 51;
-      i_hi = 100;
-      c_lo = 119;
-      c_hi = 157;
-    }
-    else if (o3_1h < 235.5)
-    {
-      i_lo = 101;
-      i_hi = 200;
-      c_lo = 158;
-      c_hi = 235;
-    }
-    else if (o3_1h < 785.5)
-    {
-      i_lo = 201;
-      i_hi = 300;
-      c_lo = 236;
-      c_hi = 785;
-    }
-    else if (o3_1h < 980.5)
-    {
-      i_lo = 301;
-      i_hi = 400;
-      c_lo = 786;
-      c_hi = 980;
-    }
-    else if (o3_1h < 1180.5)
-    {
-      i_lo = 401;
-      i_hi = 500;
-      c_lo = 981;
-      c_hi = 1180;
-    }
-    else
-    {
-      // index > 500
-      return 501;
-    }
-    psi = max(psi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, o3_1h));
-  }
-
-  // so2   μg/m^3, Sulfur Dioxide (SO2)
-  if (so2_24h < 80.5)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 80;
-  }
-  else if (so2_24h < 365.5)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 81;
-    c_hi = 365;
-  }
-  else if (so2_24h < 800.5)
-  {
-    i_lo = 101;
-    i_hi = 200;
-    c_lo = 366;
-    c_hi = 800;
-  }
-  else if (so2_24h < 1600.5)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 801;
-    c_hi = 1600;
-  }
-  else if (so2_24h < 2100.5)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 1601;
-    c_hi = 2100;
-  }
-  else if (so2_24h < 2620.5)
-  {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 2101;
-    c_hi = 2620;
-  }
-  else
+  // past the top of the scale, checked before any sub-index is computed
+  if (AQI_PAST_TOP(SINGAPORE_CO_8H,     AQI_BP_BELOW, co_8h) ||
+      AQI_PAST_TOP(SINGAPORE_NO2_1H,    AQI_BP_BELOW | AQI_BP_CUTOFF, no2_1h) ||
+      // o3_8h > 785 is read on the 1 hour breakpoints
+      (o3_8h <= 785
+         ? AQI_PAST_TOP(SINGAPORE_O3_8H, AQI_BP_BELOW, o3_8h)
+         : AQI_PAST_TOP(SINGAPORE_O3_1H, AQI_BP_BELOW, o3_1h)) ||
+      AQI_PAST_TOP(SINGAPORE_SO2_24H,   AQI_BP_BELOW, so2_24h) ||
+      AQI_PAST_TOP(SINGAPORE_PM10_24H,  AQI_BP_BELOW, pm10_24h) ||
+      AQI_PAST_TOP(SINGAPORE_PM2_5_24H, AQI_BP_BELOW, pm2_5_24h))
   {
     // index > 500
-    return 501;
+    return SINGAPORE_PSI_MAX + 1;
   }
-  psi = max(psi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, so2_24h));
-
-  // pm10  μg/m^3, Coarse Particulate Matter (<10μm)
-  if (pm10_24h < 50.5)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 50;
-  }
-  else if (pm10_24h < 150.5)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 51;
-    c_hi = 150;
-  }
-  else if (pm10_24h < 350.5)
-  {
-    i_lo = 101;
-    i_hi = 200;
-    c_lo = 151;
-    c_hi = 350;
-  }
-  else if (pm10_24h < 420.5)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 351;
-    c_hi = 420;
-  }
-  else if (pm10_24h < 500.5)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 421;
-    c_hi = 500;
-  }
-  else if (pm10_24h < 600.5)
-  {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 501;
-    c_hi = 600;
-  }
-  else
-  {
-    // index > 500
-    return 501;
-  }
-  psi = max(psi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, pm10_24h));
-
-  // pm2_5 μg/m^3, Fine Particulate Matter (<2.5μm)
-  if (pm2_5_24h < 12.5)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 12;
-  }
-  else if (pm2_5_24h < 55.5)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 13;
-    c_hi = 55;
-  }
-  else if (pm2_5_24h < 150.5)
-  {
-    i_lo = 101;
-    i_hi = 200;
-    c_lo = 56;
-    c_hi = 150;
-  }
-  else if (pm2_5_24h < 250.5)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 151;
-    c_hi = 250;
-  }
-  else if (pm2_5_24h < 350.5)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 251;
-    c_hi = 350;
-  }
-  else if (pm2_5_24h < 500.5)
-  {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 351;
-    c_hi = 500;
-  }
-  else
-  {
-    // index > 500
-    return 501;
-  }
-  psi = max(psi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, pm2_5_24h));
 
+  int psi = 0;
+  psi = max(psi, AQI_SUB(SINGAPORE_CO_8H,     AQI_BP_BELOW, co_8h));
+  psi = max(psi, AQI_SUB(SINGAPORE_NO2_1H,    AQI_BP_BELOW | AQI_BP_CUTOFF,
+                         no2_1h));
+  psi = max(psi, (o3_8h <= 785)
+                   ? AQI_SUB(SINGAPORE_O3_8H, AQI_BP_BELOW, o3_8h)
+                   : AQI_SUB(SINGAPORE_O3_1H, AQI_BP_BELOW, o3_1h));
+  psi = max(psi, AQI_SUB(SINGAPORE_SO2_24H,   AQI_BP_BELOW, so2_24h));
+  psi = max(psi, AQI_SUB(SINGAPORE_PM10_24H,  AQI_BP_BELOW, pm10_24h));
+  psi = max(psi, AQI_SUB(SINGAPORE_PM2_5_24H, AQI_BP_BELOW, pm2_5_24h));
   return psi;
 } // end singapore_psi
 
@@ -1660,234 +718,76 @@ int singapore_psi(float co_8h,   float no2_1h,   float o3_1h, float o3_8h,
  * References:
  *   https://www.airkorea.or.kr/eng/khaiInfo?pMENU_NO=166
  */
-int south_korea_cai(float co_1h,  float no2_1h,   float o3_1h,
-                    float so2_1h, float pm10_24h, float pm2_5_24h)
-{
-  int cai = 0;
-  float i_lo, i_hi;
-  float c_lo, c_hi;
-
-  // co    μg/m^3, Carbon Monoxide (CO)
-  // 1ppm * 1000ppb/1ppm * 1.1456 μg/m^3/ppb = 1145.6 μg/m^3
-  if (co_1h < 2348.48)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 2291.2;
-  }
-  else if (co_1h < 10367.68)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 2405.76;
-    c_hi = 10310.4;
-  }
-  else if (co_1h < 17241.28)
-  {
-    i_lo = 101;
-    i_hi = 250;
-    c_lo = 10424.96;
-    c_hi = 17184;
-  }
-  else if (co_1h < 57337.28)
-  {
-    i_lo = 251;
-    i_hi = 500;
-    c_lo = 17298.56;
-    c_hi = 57280;
-  }
-  else
-  {
-    // index > 500
-    return 501;
-  }
-  cai = max(cai, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, co_1h));
-
-  // no2   μg/m^3, Nitrogen Dioxide (NO2)
-  // 1ppm * 1000ppb/1ppm * 1.8816 μg/m^3/ppb = 1881.6 μg/m^3
-  if (no2_1h < 57.3888)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 56.448;
-  }
-  else if (no2_1h < 113.8368)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 58.3296;
-    c_hi = 112.896;
-  }
-  else if (no2_1h < 377.2608)
-  {
-    i_lo = 101;
-    i_hi = 250;
-    c_lo = 114.7776;
-    c_hi = 376.32;
-  }
-  else if (no2_1h < 3772.608)
-  {
-    i_lo = 251;
-    i_hi = 500;
-    c_lo = 378.2016;
-    c_hi = 3763.2;
-  }
-  else
-  {
-    // index > 500
-    return 501;
-  }
-  cai = max(cai, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, no2_1h));
-
-  // o3    μg/m^3, Ozone (O3)
-  // 1ppm * 1000ppb/1ppm * 1.9632 μg/m^3/ppb = 1963.2 μg/m^3
-  if (o3_1h < 59.8776)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 58.896;
-  }
-  else if (o3_1h < 177.6696)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 60.8592;
-    c_hi = 176.688;
-  }
-  else if (o3_1h < 295.4616)
-  {
-    i_lo = 101;
-    i_hi = 250;
-    c_lo = 178.6512;
-    c_hi = 294.48;
-  }
-  else if (o3_1h < 1178.9016)
-  {
-    i_lo = 251;
-    i_hi = 500;
-    c_lo = 296.4432;
-    c_hi = 1177.92;
-  }
-  else
-  {
-    // index > 500
-    return 501;
-  }
-  cai = max(cai, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, o3_1h));
-
-  // so2   μg/m^3, Sulfur Dioxide (SO2)
-  // 1ppm * 1000ppb/1ppm * 8.4744 μg/m^3/ppb = 8474.4 μg/m^3
-  if (so2_1h < 173.7252)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 169.488;
-  }
-  else if (so2_1h < 427.9572)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 177.9624;
-    c_hi = 423.72;
-  }
-  else if (so2_1h < 1271.16)
-  {
-    i_lo = 101;
-    i_hi = 250;
-    c_lo = 432.1944;
-    c_hi = 1271.16;
-  }
-  else if (so2_1h < 8478.6372)
-  {
-    i_lo = 251;
-    i_hi = 500;
-    c_lo = 1279.6344;
-    c_hi = 8474.4;
-  }
-  else
-  {
-    // index > 500
-    return 501;
-  }
-  cai = max(cai, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, so2_1h));
-
-  // pm10  μg/m^3, Coarse Particulate Matter (<10μm)
-  if (pm10_24h < 30.5)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 30;
-  }
-  else if (pm10_24h < 80.5)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 31;
-    c_hi = 80;
-  }
-  else if (pm10_24h < 150.5)
-  {
-    i_lo = 101;
-    i_hi = 250;
-    c_lo = 81;
-    c_hi = 150;
-  }
-  else if (pm10_24h < 600.5)
-  {
-    i_lo = 251;
-    i_hi = 500;
-    c_lo = 151;
-    c_hi = 600;
-  }
-  else
-  {
-    // index > 500
-    return 501;
-  }
-  cai = max(cai, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, pm10_24h));
-
-  // pm2_5 μg/m^3, Fine Particulate Matter (<2.5μm)
-  if (pm2_5_24h < 15.5)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 15;
-  }
-  else if (pm2_5_24h < 35.5)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 16;
-    c_hi = 35;
-  }
-  else if (pm2_5_24h < 75.5)
-  {
-    i_lo = 101;
-    i_hi = 250;
-    c_lo = 36;
-    c_hi = 75;
-  }
-  else if (pm2_5_24h < 500.5)
-  {
-    i_lo = 251;
-    i_hi = 500;
-    c_lo = 76;
-    c_hi = 500;
-  }
-  else
+// co    μg/m^3, Carbon Monoxide (CO)
+// 1ppm * 1000ppb/1ppm * 1.1456 μg/m^3/ppb = 1145.6 μg/m^3
+static const aqi_breakpoint_t SOUTH_KOREA_CO_1H[] = {
+  AQI_BP(2348.48022,        0,  2291.2,   0,  50), // < 2348.48
+  AQI_BP(10367.6807,  2405.76, 10310.4,  51, 100), // < 10367.68
+  AQI_BP(17241.2812, 10424.96,   17184, 101, 250), // < 17241.28
+  AQI_BP(  57337.28, 17298.56,   57280, 251, 500),
+};
+// no2   μg/m^3, Nitrogen Dioxide (NO2)
+// 1ppm * 1000ppb/1ppm * 1.8816 μg/m^3/ppb = 1881.6 μg/m^3
+static const aqi_breakpoint_t SOUTH_KOREA_NO2_1H[] = {
+  AQI_BP(   57.3888,        0,  56.448,   0,  50),
+  AQI_BP(113.836807,  58.3296, 112.896,  51, 100), // < 113.8368
+  AQI_BP(  377.2608, 114.7776,  376.32, 101, 250),
+  AQI_BP(3772.60815, 378.2016,  3763.2, 251, 500), // < 3772.608
+};
+// o3    μg/m^3, Ozone (O3)
+// 1ppm * 1000ppb/1ppm * 1.9632 μg/m^3/ppb = 1963.2 μg/m^3
+static const aqi_breakpoint_t SOUTH_KOREA_O3_1H[] = {
+  AQI_BP(  59.8776,        0,  58.896,   0,  50),
+  AQI_BP( 177.6696,  60.8592, 176.688,  51, 100),
+  AQI_BP( 295.4616, 178.6512,  294.48, 101, 250),
+  AQI_BP(1178.9016, 296.4432, 1177.92, 251, 500),
+};
+// so2   μg/m^3, Sulfur Dioxide (SO2)
+// 1ppm * 1000ppb/1ppm * 8.4744 μg/m^3/ppb = 8474.4 μg/m^3
+static const aqi_breakpoint_t SOUTH_KOREA_SO2_1H[] = {
+  AQI_BP( 173.7252,         0, 169.488,   0,  50),
+  AQI_BP( 427.9572,  177.9624,  423.72,  51, 100),
+  AQI_BP(  1271.16,  432.1944, 1271.16, 101, 250),
+  AQI_BP(8478.6377, 1279.6344,  8474.4, 251, 500), // < 8478.6372
+};
+// pm10  μg/m^3, Coarse Particulate Matter (<10μm)
+static const aqi_breakpoint_t SOUTH_KOREA_PM10_24H[] = {
+  AQI_BP( 30.5,   0,  30,   0,  50),
+  AQI_BP( 80.5,  31,  80,  51, 100),
+  AQI_BP(150.5,  81, 150, 101, 250),
+  AQI_BP(600.5, 151, 600, 251, 500),
+};
+// pm2_5 μg/m^3, Fine Particulate Matter (<2.5μm)
+static const aqi_breakpoint_t SOUTH_KOREA_PM2_5_24H[] = {
+  AQI_BP( 15.5,  0,  15,   0,  50),
+  AQI_BP( 35.5, 16,  35,  51, 100),
+  AQI_BP( 75.5, 36,  75, 101, 250),
+  AQI_BP(500.5, 76, 500, 251, 500),
+};
+
+int south_korea_cai(float co_1h,  float no2_1h,   float o3_1h,
+                    float so2_1h, float pm10_24h, float pm2_5_24h)
+{
+  // past the top of the scale, checked before any sub-index is computed
+  if (AQI_PAST_TOP(SOUTH_KOREA_CO_1H,     AQI_BP_BELOW, co_1h) ||
+      AQI_PAST_TOP(SOUTH_KOREA_NO2_1H,    AQI_BP_BELOW, no2_1h) ||
+      AQI_PAST_TOP(SOUTH_KOREA_O3_1H,     AQI_BP_BELOW, o3_1h) ||
+      AQI_PAST_TOP(SOUTH_KOREA_SO2_1H,    AQI_BP_BELOW, so2_1h) ||
+      AQI_PAST_TOP(SOUTH_KOREA_PM10_24H,  AQI_BP_BELOW, pm10_24h) ||
+      AQI_PAST_TOP(SOUTH_KOREA_PM2_5_24H, AQI_BP_BELOW, pm2_5_24h))
   {
     // index > 500
-    return 501;
+    return SOUTH_KOREA_CAI_MAX + 1;
   }
-  cai = max(cai, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, pm2_5_24h));
 
-  return cai;
+  int aqi = 0;
+  aqi = max(aqi, AQI_SUB(SOUTH_KOREA_CO_1H,     AQI_BP_BELOW, co_1h));
+  aqi = max(aqi, AQI_SUB(SOUTH_KOREA_NO2_1H,    AQI_BP_BELOW, no2_1h));
+  aqi = max(aqi, AQI_SUB(SOUTH_KOREA_O3_1H,     AQI_BP_BELOW, o3_1h));
+  aqi = max(aqi, AQI_SUB(SOUTH_KOREA_SO2_1H,    AQI_BP_BELOW, so2_1h));
+  aqi = max(aqi, AQI_SUB(SOUTH_KOREA_PM10_24H,  AQI_BP_BELOW, pm10_24h));
+  aqi = max(aqi, AQI_SUB(SOUTH_KOREA_PM2_5_24H, AQI_BP_BELOW, pm2_5_24h));
+  return aqi;
 } // end south_korea_cai
 
 /* United Kingdom (DAQI)
@@ -1897,59 +797,34 @@ int south_korea_cai(float co_1h,  float no2_1h,   float o3_1h,
  *   https://en.wikipedia.org/wiki/Air_quality_index#United_Kingdom
  *   https://uk-air.defra.gov.uk/library/reports?report_id=750
  */
+// Pollutant averages are rounded to nearest integer, the lowest of each
+// pollutant for index 2 to 10, in the order of united_kingdom_daqi()'s
+// parameters.
+static const float UNITED_KINGDOM_DAQI_BANDS[][UNITED_KINGDOM_DAQI_MAX - 1] = {
+  {67.5, 134.5, 200.5, 267.5, 334.5, 400.5, 467.5, 534.5,  600.5}, // no2
+  {33.5,  66.5, 100.5, 120.5, 140.5, 160.5, 187.5, 213.5,  240.5}, // o3
+  {88.5, 177.5, 266.5, 354.5, 443.5, 532.5, 710.5, 887.5, 1064.5}, // so2
+  {16.5,  33.5,  50.5,  58.5,  66.5,  75.5,  83.5,  91.5,  100.5}, // pm10
+  {11.5,  23.5,  35.5,  41.5,  47.5,  53.5,  58.5,  64.5,   70.5}, // pm2_5
+};
+
 int united_kingdom_daqi(float no2_1h,   float o3_8h, float so2_15min,
                         float pm10_24h, float pm2_5_24h)
 {
-  // Pollutant averages are rounded to nearest integer
-  if (o3_8h >= 240.5 || no2_1h >= 600.5 || so2_15min >= 1064.5 ||
-      pm2_5_24h >= 70.5 || pm10_24h >= 100.5)
-  {
-    return 10;
-  }
-  else if (o3_8h >= 213.5 || no2_1h >= 534.5 || so2_15min >= 887.5 ||
-           pm2_5_24h >= 64.5 || pm10_24h >= 91.5)
-  {
-    return 9;
-  }
-  else if (o3_8h >= 187.5 || no2_1h >= 467.5 || so2_15min >= 710.5 ||
-           pm2_5_24h >= 58.5 || pm10_24h >= 83.5)
-  {
-    return 8;
-  }
-  else if (o3_8h >= 160.5 || no2_1h >= 400.5 || so2_15min >= 532.5 ||
-           pm2_5_24h >= 53.5 || pm10_24h >= 75.5)
-  {
-    return 7;
-  }
-  else if (o3_8h >= 140.5 || no2_1h >= 334.5 || so2_15min >= 443.5 ||
-           pm2_5_24h >= 47.5 || pm10_24h >= 66.5)
-  {
-    return 6;
-  }
-  else if (o3_8h >= 120.5 || no2_1h >= 267.5 || so2_15min >= 354.5 ||
-           pm2_5_24h >= 41.5 || pm10_24h >= 58.5)
-  {
-    return 5;
-  }
-  else if (o3_8h >= 100.5 || no2_1h >= 200.5 || so2_15min >= 266.5 ||
-           pm2_5_24h >= 35.5 || pm10_24h >= 50.5)
-  {
-    return 4;
-  }
-  else if (o3_8h >= 66.5 || no2_1h >= 134.5 || so2_15min >= 177.5 ||
-           pm2_5_24h >= 23.5 || pm10_24h >= 33.5)
-  {
-    return 3;
-  }
-  else if (o3_8h >= 33.5 || no2_1h >= 67.5 || so2_15min >= 88.5 ||
-           pm2_5_24h >= 11.5 || pm10_24h >= 16.5)
-  {
-    return 2;
-  }
-  else
-  {
-    return 1;
+  // highest band any of them is in, NaN is below every band. Every pollutant
+  // is compared, a band takes one branch.
+  for (int band = UNITED_KINGDOM_DAQI_MAX - 2; band >= 0; --band)
+  {
+    if ((no2_1h    >= UNITED_KINGDOM_DAQI_BANDS[0][band]) |
+        (o3_8h     >= UNITED_KINGDOM_DAQI_BANDS[1][band]) |
+        (so2_15min >= UNITED_KINGDOM_DAQI_BANDS[2][band]) |
+        (pm10_24h  >= UNITED_KINGDOM_DAQI_BANDS[3][band]) |
+        (pm2_5_24h >= UNITED_KINGDOM_DAQI_BANDS[4][band]))
+    {
+      return band + 2;
+    }
   }
+  return 1;
 } // end united_kingdom_daqi
 
 /* United States (AQI)
@@ -1959,15 +834,84 @@ int united_kingdom_daqi(float no2_1h,   float o3_8h, float so2_15min,
  *   https://www.airnow.gov/sites/default/files/2020-05/aqi-technical-assistance-document-sept2018.pdf
  *   https://en.wikipedia.org/wiki/Air_quality_index#United_States
  */
+// co    μg/m^3, Carbon Monoxide (CO)
+static const aqi_breakpoint_t UNITED_STATES_CO_8H[] = {
+  AQI_BP(4.39999962,    0,  4.4,   0,  50), // <= 4.4
+  AQI_BP(       9.4,  4.5,  9.4,  51, 100),
+  AQI_BP(      12.4,  9.5, 12.4, 101, 150),
+  AQI_BP(      15.4, 12.5, 15.4, 151, 200),
+  AQI_BP(      30.4, 15.5, 30.4, 201, 300),
+  AQI_BP(40.3999977, 30.5, 40.4, 301, 400), // <= 40.4
+  AQI_BP(50.3999977, 40.5, 50.4, 401, 500), // <= 50.4
+};
+// no2   μg/m^3, Nitrogen Dioxide (NO2)
+static const aqi_breakpoint_t UNITED_STATES_NO2_1H[] = {
+  AQI_BP(  53,    0,   53,   0,  50),
+  AQI_BP( 100,   54,  100,  51, 100),
+  AQI_BP( 360,  101,  360, 101, 150),
+  AQI_BP( 649,  361,  649, 151, 200),
+  AQI_BP(1249,  350, 1249, 201, 300),
+  AQI_BP(1649, 1250, 1649, 301, 400),
+  AQI_BP(2049, 1650, 2049, 401, 500),
+};
+// o3    μg/m^3, Ground-Level Ozone (O3)
+static const aqi_breakpoint_t UNITED_STATES_O3_1H[] = {
+  AQI_BP( 0.16399999, 0.125, 0.164, 101, 150), // <= 0.164
+  AQI_BP(      0.204, 0.165, 0.204, 151, 200),
+  AQI_BP(0.403999984, 0.205, 0.404, 201, 300), // <= 0.404
+  AQI_BP(       1649,  1250,  1649, 301, 400),
+  AQI_BP(       2049,  1650,  2049, 401, 500),
+};
+static const aqi_breakpoint_t UNITED_STATES_O3_8H[] = {
+  AQI_BP(0.0539999977,     0, 0.054,   0,  50), // <= 0.054
+  AQI_BP(0.0699999928, 0.055, 0.070,  51, 100), // <= 0.070
+  AQI_BP(0.0849999934, 0.071, 0.085, 101, 150), // <= 0.085
+  AQI_BP(       0.105, 0.086, 0.105, 151, 200),
+  AQI_BP( 0.199999988, 0.106, 0.200, 201, 300), // <= 0.200
+};
+// pm10  μg/m^3, Coarse Particulate Matter (<10μm)
+static const aqi_breakpoint_t UNITED_STATES_PM10_24H[] = {
+  AQI_BP( 54,   0,  54,   0,  50),
+  AQI_BP(154,  55, 154,  51, 100),
+  AQI_BP(254, 155, 254, 101, 150),
+  AQI_BP(354, 255, 354, 151, 200),
+  AQI_BP(424, 355, 424, 201, 300),
+  AQI_BP(504, 425, 504, 301, 400),
+  AQI_BP(604, 505, 604, 401, 500),
+};
+// pm2_5 μg/m^3, Fine Particulate Matter (<2.5μm)
+static const aqi_breakpoint_t UNITED_STATES_PM2_5_24H[] = {
+  AQI_BP(      12.0,     0,  12.0,   0,  50),
+  AQI_BP(35.3999977,  12.1,  35.4,  51, 100), // <= 35.4
+  AQI_BP(55.3999977,  35.5,  55.4, 101, 150), // <= 55.4
+  AQI_BP(     150.4,  55.5, 150.4, 151, 200),
+  AQI_BP(     250.4, 150.5, 250.4, 201, 300),
+  AQI_BP(     350.4, 250.5, 350.4, 301, 400),
+  AQI_BP(     500.4, 350.5, 500.4, 401, 500),
+};
+// so2   μg/m^3, Sulfur Dioxide (SO2)
+// The 24 hour concentration is only used when the 1 hour concentration is
+// past 185.
+static const aqi_breakpoint_t UNITED_STATES_SO2_1H[] = {
+  AQI_BP( 35,  0,  35,   0,  50),
+  AQI_BP( 75, 36,  75,  51, 100),
+  AQI_BP(185, 76, 185, 101, 150),
+};
+static const aqi_breakpoint_t UNITED_STATES_SO2_24H[] = {
+  AQI_BP(  35,   0,   35,   0,  50),
+  AQI_BP(  75,  36,   75,  51, 100),
+  AQI_BP( 185,  76,  185, 101, 150),
+  AQI_BP( 304, 186,  304, 151, 200),
+  AQI_BP( 604, 305,  604, 201, 300),
+  AQI_BP( 804, 605,  804, 301, 400),
+  AQI_BP(1004, 805, 1004, 401, 500),
+};
+
 int united_states_aqi(float co_8h,    float no2_1h,
                       float o3_1h,    float o3_8h,
                       float so2_1h,   float so2_24h,
                       float pm10_24h, float pm2_5_24h)
 {
-  int aqi = 0;
-  float i_lo, i_hi;
-  float c_lo, c_hi;
-
   // Pollutant averages are truncated
   co_8h = truncate_float(co_8h / 1145.6, 1); // (ppm) truncate to 1 decimal place
   no2_1h = (int)(no2_1h / 1.8816);           // (ppb) truncate to integer
@@ -1977,406 +921,30 @@ int united_states_aqi(float co_8h,    float no2_1h,
   pm10_24h = (int)pm10_24h;                  // (μg/m^3) truncate to integer
   pm2_5_24h = truncate_float(pm2_5_24h, 1);  // (μg/m^3) truncate to 1 decimal place
 
-  // co    μg/m^3, Carbon Monoxide (CO)
-  if (co_8h <= 4.4)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 4.4;
-  }
-  else if (co_8h <= 9.4)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 4.5;
-    c_hi = 9.4;
-  }
-  else if (co_8h <= 12.4)
-  {
-    i_lo = 101;
-    i_hi = 150;
-    c_lo = 9.5;
-    c_hi = 12.4;
-  }
-  else if (co_8h <= 15.4)
-  {
-    i_lo = 151;
-    i_hi = 200;
-    c_lo = 12.5;
-    c_hi = 15.4;
-  }
-  else if (co_8h <= 30.4)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 15.5;
-    c_hi = 30.4;
-  }
-  else if (co_8h <= 40.4)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 30.5;
-    c_hi = 40.4;
-  }
-  else if (co_8h <= 50.4)
-  {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 40.5;
-    c_hi = 50.4;
-  }
-  else
-  {
-    // index > 500
-    return 501;
-  }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, co_8h));
-
-  // no2   μg/m^3, Nitrogen Dioxide (NO2)
-  if (no2_1h <= 53)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 53;
-  }
-  else if (no2_1h <= 100)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 54;
-    c_hi = 100;
-  }
-  else if (no2_1h <= 360)
-  {
-    i_lo = 101;
-    i_hi = 150;
-    c_lo = 101;
-    c_hi = 360;
-  }
-  else if (no2_1h <= 649)
-  {
-    i_lo = 151;
-    i_hi = 200;
-    c_lo = 361;
-    c_hi = 649;
-  }
-  else if (no2_1h <= 1249)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 350;
-    c_hi = 1249;
-  }
-  else if (no2_1h <= 1649)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 1250;
-    c_hi = 1649;
-  }
-  else if (no2_1h <= 2049)
-  {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 1650;
-    c_hi = 2049;
-  }
-  else
-  {
-    // index > 500
-    return 501;
-  }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, no2_1h));
-
-  // o3    μg/m^3, Ground-Level Ozone (O3)
-  if (o3_1h >= 0.125)
-  {
-    if (o3_1h <= 0.164)
-    {
-      i_lo = 101;
-      i_hi = 150;
-      c_lo = 0.125;
-      c_hi = 0.164;
-    }
-    else if (o3_1h <= 0.204)
-    {
-      i_lo = 151;
-      i_hi = 200;
-      c_lo = 0.165;
-      c_hi = 0.204;
-    }
-    else if (o3_1h <= 0.404)
-    {
-      i_lo = 201;
-      i_hi = 300;
-      c_lo = 0.205;
-      c_hi = 0.404;
-    }
-    else if (o3_1h <= 1649)
-    {
-      i_lo = 301;
-      i_hi = 400;
-      c_lo = 1250;
-      c_hi = 1649;
-    }
-    else if (o3_1h <= 2049)
-    {
-      i_lo = 401;
-      i_hi = 500;
-      c_lo = 1650;
-      c_hi = 2049;
-    }
-    else
-    {
-      // index > 500
-      return 501;
-    }
-    aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, o3_1h));
-  }
-  if (o3_8h <= 0.200)
-  {
-    if (o3_8h <= 0.054)
-    {
-      i_lo = 0;
-      i_hi = 50;
-      c_lo = 0;
-      c_hi = 0.054;
-    }
-    else if (o3_8h <= 0.070)
-    {
-      i_lo = 51;
-      i_hi = 100;
-      c_lo = 0.055;
-      c_hi = 0.070;
-    }
-    else if (o3_8h <= 0.085)
-    {
-      i_lo = 101;
-      i_hi = 150;
-      c_lo = 0.071;
-      c_hi = 0.085;
-    }
-    else if (o3_8h <= 0.105)
-    {
-      i_lo = 151;
-      i_hi = 200;
-      c_lo = 0.086;
-      c_hi = 0.105;
-    }
-    else
-    {
-      // 0.106 <= o3_8h <= 0.200
-      i_lo = 201;
-      i_hi = 300;
-      c_lo = 0.106;
-      c_hi = 0.200;
-    }
-    aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, o3_8h));
-  }
-
-  // so2   μg/m^3, Sulfur Dioxide (SO2)
-  if (so2_1h <= 185)
-  {
-    if (so2_1h <= 35)
-    {
-      i_lo = 0;
-      i_hi = 50;
-      c_lo = 0;
-      c_hi = 35;
-    }
-    else if (so2_1h <= 75)
-    {
-      i_lo = 51;
-      i_hi = 100;
-      c_lo = 36;
-      c_hi = 75;
-    }
-    else
-    {
-      // 76 <= so2_1h <= 185
-      i_lo = 101;
-      i_hi = 150;
-      c_lo = 76;
-      c_hi = 185;
-    }
-    aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, so2_1h));
-  }
-  else
-  {
-    if (so2_24h <= 35)
-    {
-      i_lo = 0;
-      i_hi = 50;
-      c_lo = 0;
-      c_hi = 35;
-    }
-    else if (so2_24h <= 75)
-    {
-      i_lo = 51;
-      i_hi = 100;
-      c_lo = 36;
-      c_hi = 75;
-    }
-    else if (so2_24h <= 185)
-    {
-      i_lo = 101;
-      i_hi = 150;
-      c_lo = 76;
-      c_hi = 185;
-    }
-    else if (so2_24h <= 304)
-    {
-      i_lo = 151;
-      i_hi = 200;
-      c_lo = 186;
-      c_hi = 304;
-    }
-    else if (so2_24h <= 604)
-    {
-      i_lo = 201;
-      i_hi = 300;
-      c_lo = 305;
-      c_hi = 604;
-    }
-    else if (so2_24h <= 804)
-    {
-      i_lo = 301;
-      i_hi = 400;
-      c_lo = 605;
-      c_hi = 804;
-    }
-    else if (so2_24h <= 1004)
-    {
-      i_lo = 401;
-      i_hi = 500;
-      c_lo = 805;
-      c_hi = 1004;
-    }
-    else
-    {
-      // index > 500
-      return 501;
-    }
-    aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, so2_24h));
-  }
-
-  // pm10  μg/m^3, Coarse Particulate Matter (<10μm)
-  if (pm10_24h <= 54)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 54;
-  }
-  else if (pm10_24h <= 154)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 55;
-    c_hi = 154;
-  }
-  else if (pm10_24h <= 254)
-  {
-    i_lo = 101;
-    i_hi = 150;
-    c_lo = 155;
-    c_hi = 254;
-  }
-  else if (pm10_24h <= 354)
-  {
-    i_lo = 151;
-    i_hi = 200;
-    c_lo = 255;
-    c_hi = 354;
-  }
-  else if (pm10_24h <= 424)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 355;
-    c_hi = 424;
-  }
-  else if (pm10_24h <= 504)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 425;
-    c_hi = 504;
-  }
-  else if (pm10_24h <= 604)
-  {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 505;
-    c_hi = 604;
-  }
-  else
-  {
-    // index > 500
-    return 501;
-  }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, pm10_24h));
-
-  // pm2_5 μg/m^3, Fine Particulate Matter (<2.5μm)
-  if (pm2_5_24h <= 12.0)
-  {
-    i_lo = 0;
-    i_hi = 50;
-    c_lo = 0;
-    c_hi = 12.0;
-  }
-  else if (pm2_5_24h <= 35.4)
-  {
-    i_lo = 51;
-    i_hi = 100;
-    c_lo = 12.1;
-    c_hi = 35.4;
-  }
-  else if (pm2_5_24h <= 55.4)
-  {
-    i_lo = 101;
-    i_hi = 150;
-    c_lo = 35.5;
-    c_hi = 55.4;
-  }
-  else if (pm2_5_24h <= 150.4)
-  {
-    i_lo = 151;
-    i_hi = 200;
-    c_lo = 55.5;
-    c_hi = 150.4;
-  }
-  else if (pm2_5_24h <= 250.4)
-  {
-    i_lo = 201;
-    i_hi = 300;
-    c_lo = 150.5;
-    c_hi = 250.4;
-  }
-  else if (pm2_5_24h <= 350.4)
-  {
-    i_lo = 301;
-    i_hi = 400;
-    c_lo = 250.5;
-    c_hi = 350.4;
-  }
-  else if (pm2_5_24h <= 500.4)
-  {
-    i_lo = 401;
-    i_hi = 500;
-    c_lo = 350.5;
-    c_hi = 500.4;
-  }
-  else
+  // past the top of the scale, checked before any sub-index is computed
+  if (AQI_PAST_TOP(UNITED_STATES_CO_8H,     0, co_8h) ||
+      AQI_PAST_TOP(UNITED_STATES_NO2_1H,    0, no2_1h) ||
+      AQI_PAST_TOP(UNITED_STATES_O3_1H,     AQI_BP_CUTOFF, o3_1h) ||
+      // so2_1h past the top is read on the 24 hour breakpoints
+      (AQI_PAST_TOP(UNITED_STATES_SO2_1H,   0, so2_1h) &&
+       AQI_PAST_TOP(UNITED_STATES_SO2_24H,  0, so2_24h)) ||
+      AQI_PAST_TOP(UNITED_STATES_PM10_24H,  0, pm10_24h) ||
+      AQI_PAST_TOP(UNITED_STATES_PM2_5_24H, 0, pm2_5_24h))
   {
     // index > 500
-    return 501;
+    return UNITED_STATES_AQI_MAX + 1;
   }
-  aqi = max(aqi, compute_piecewise_aqi(i_lo, i_hi, c_lo, c_hi, pm2_5_24h));
 
+  int aqi = 0;
+  aqi = max(aqi, AQI_SUB(UNITED_STATES_CO_8H,     0, co_8h));
+  aqi = max(aqi, AQI_SUB(UNITED_STATES_NO2_1H,    0, no2_1h));
+  aqi = max(aqi, AQI_SUB(UNITED_STATES_O3_1H,     AQI_BP_CUTOFF, o3_1h));
+  aqi = max(aqi, AQI_SUB(UNITED_STATES_O3_8H,     AQI_BP_CAPPED, o3_8h));
+  aqi = max(aqi, AQI_PAST_TOP(UNITED_STATES_SO2_1H, 0, so2_1h)
+                   ? AQI_SUB(UNITED_STATES_SO2_24H, 0, so2_24h)
+                   : AQI_SUB(UNITED_STATES_SO2_1H,  0, so2_1h));
+  aqi = max(aqi, AQI_SUB(UNITED_STATES_PM10_24H,  0, pm10_24h));
+  aqi = max(aqi, AQI_SUB(UNITED_STATES_PM2_5_24H, 0, pm2_5_24h));
   return aqi;
 } // end united_states_aqi
 
@@ -2654,15 +1222,17 @@ const char *united_states_aqi_desc(int aqi)
   }
 } // end united_states_aqi_desc
 
-/* Returns the average pollutant concentration over a given number of previous
+/* Computes the average concentration of a pollutant over the most recent
  * hours.
  *
  * 'pollutant' is an array of hourly concentrations. The last element in
- * pollutant is the most recent hourly concentration. 'hours' must be a positive
- * integer.
+ * pollutant is the most recent hourly concentration. The period is summed from
+ * its least recent sample to the most recent, so the average does not depend
+ * on which other periods are computed.
  *
  * Passing NULL will return 0.
  */
+static inline __attribute__((always_inline))
 float avg_conc(const float pollutant[24], int hours)
 {
   if (pollutant == NULL)
@@ -2672,29 +1242,287 @@ float avg_conc(const float pollutant[24], int hours)
 
   float avg = 0;
   // index (size - 1) is most recent hourly concentration
-  for (int h = (24 - 1) - (hours - 1) ; h < 24 ; ++h)
+  for (int h = 24 - hours; h < 24; ++h)
   {
     avg += pollutant[h];
   }
+  return avg / (float) hours;
+} // end avg_conc
+
+/* Each scale averages only the periods it reads, every other average is left
+ * unset.
+ */
+static inline __attribute__((always_inline))
+void avg_australia_aqi(aqi_averages_t *a,
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24])
+{
+  a->co.h8     = avg_conc(co,     8);
+  a->no2.h1    = avg_conc(no2,    1);
+  a->o3.h1     = avg_conc(o3,     1);
+  a->o3.h4     = avg_conc(o3,     4);
+  a->so2.h1    = avg_conc(so2,    1);
+  a->pm10.h24  = avg_conc(pm10,  24);
+  a->pm2_5.h24 = avg_conc(pm2_5, 24);
+} // end avg_australia_aqi
+
+static inline __attribute__((always_inline))
+void avg_canada_aqhi(aqi_averages_t *a,
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24])
+{
+  a->no2.h3   = avg_conc(no2,    3);
+  a->o3.h3    = avg_conc(o3,     3);
+  a->pm2_5.h3 = avg_conc(pm2_5,  3);
+} // end avg_canada_aqhi
+
+static inline __attribute__((always_inline))
+void avg_china_aqi(aqi_averages_t *a,
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24])
+{
+  a->co.h1     = avg_conc(co,     1);
+  a->co.h24    = avg_conc(co,    24);
+  a->no2.h1    = avg_conc(no2,    1);
+  a->no2.h24   = avg_conc(no2,   24);
+  a->o3.h1     = avg_conc(o3,     1);
+  a->o3.h8     = avg_conc(o3,     8);
+  a->so2.h1    = avg_conc(so2,    1);
+  a->so2.h24   = avg_conc(so2,   24);
+  a->pm10.h24  = avg_conc(pm10,  24);
+  a->pm2_5.h24 = avg_conc(pm2_5, 24);
+} // end avg_china_aqi
+
+static inline __attribute__((always_inline))
+void avg_european_union_caqi(aqi_averages_t *a,
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24])
+{
+  a->no2.h1   = avg_conc(no2,    1);
+  a->o3.h1    = avg_conc(o3,     1);
+  a->pm10.h1  = avg_conc(pm10,   1);
+  a->pm2_5.h1 = avg_conc(pm2_5,  1);
+} // end avg_european_union_caqi
+
+static inline __attribute__((always_inline))
+void avg_hong_kong_aqhi(aqi_averages_t *a,
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24])
+{
+  a->no2.h3   = avg_conc(no2,    3);
+  a->o3.h3    = avg_conc(o3,     3);
+  a->so2.h3   = avg_conc(so2,    3);
+  a->pm10.h3  = avg_conc(pm10,   3);
+  a->pm2_5.h3 = avg_conc(pm2_5,  3);
+} // end avg_hong_kong_aqhi
+
+static inline __attribute__((always_inline))
+void avg_india_aqi(aqi_averages_t *a,
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24])
+{
+  a->co.h8     = avg_conc(co,     8);
+  a->nh3.h24   = avg_conc(nh3,   24);
+  a->no2.h24   = avg_conc(no2,   24);
+  a->o3.h8     = avg_conc(o3,     8);
+  a->pb.h24    = avg_conc(pb,    24);
+  a->so2.h24   = avg_conc(so2,   24);
+  a->pm10.h24  = avg_conc(pm10,  24);
+  a->pm2_5.h24 = avg_conc(pm2_5, 24);
+} // end avg_india_aqi
+
+static inline __attribute__((always_inline))
+void avg_singapore_psi(aqi_averages_t *a,
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24])
+{
+  a->co.h8     = avg_conc(co,     8);
+  a->no2.h1    = avg_conc(no2,    1);
+  a->o3.h1     = avg_conc(o3,     1);
+  a->o3.h8     = avg_conc(o3,     8);
+  a->so2.h24   = avg_conc(so2,   24);
+  a->pm10.h24  = avg_conc(pm10,  24);
+  a->pm2_5.h24 = avg_conc(pm2_5, 24);
+} // end avg_singapore_psi
+
+static inline __attribute__((always_inline))
+void avg_south_korea_cai(aqi_averages_t *a,
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24])
+{
+  a->co.h1     = avg_conc(co,     1);
+  a->no2.h1    = avg_conc(no2,    1);
+  a->o3.h1     = avg_conc(o3,     1);
+  a->so2.h1    = avg_conc(so2,    1);
+  a->pm10.h24  = avg_conc(pm10,  24);
+  a->pm2_5.h24 = avg_conc(pm2_5, 24);
+} // end avg_south_korea_cai
+
+static inline __attribute__((always_inline))
+void avg_united_kingdom_daqi(aqi_averages_t *a,
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24])
+{
+  a->no2.h1    = avg_conc(no2,    1);
+  a->o3.h8     = avg_conc(o3,     8);
+  a->so2.h1    = avg_conc(so2,    1);
+  a->pm10.h24  = avg_conc(pm10,  24);
+  a->pm2_5.h24 = avg_conc(pm2_5, 24);
+} // end avg_united_kingdom_daqi
+
+static inline __attribute__((always_inline))
+void avg_united_states_aqi(aqi_averages_t *a,
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24])
+{
+  a->co.h8     = avg_conc(co,     8);
+  a->no2.h1    = avg_conc(no2,    1);
+  a->o3.h1     = avg_conc(o3,     1);
+  a->o3.h8     = avg_conc(o3,     8);
+  a->so2.h1    = avg_conc(so2,    1);
+  a->so2.h24   = avg_conc(so2,   24);
+  a->pm10.h24  = avg_conc(pm10,  24);
+  a->pm2_5.h24 = avg_conc(pm2_5, 24);
+} // end avg_united_states_aqi
+
+/* Fast lookup for the averaging functions of each scale. Organized
+ * alphabetically (same order as aqi_scale_t enums).
+ */
+static void (*AQI_AVERAGES_LOOKUP_TABLE[NUM_AQI_SCALES])(aqi_averages_t *,
+             const float *, const float *, const float *,
+             const float *, const float *, const float *,
+             const float *, const float *, const float *) = {
+  avg_australia_aqi,
+  avg_canada_aqhi,
+  avg_china_aqi,
+  avg_european_union_caqi,
+  avg_hong_kong_aqhi,
+  avg_india_aqi,
+  avg_singapore_psi,
+  avg_south_korea_cai,
+  avg_united_kingdom_daqi,
+  avg_united_states_aqi,
+};
+
+void aqi_averages(aqi_averages_t *avg, aqi_scale_t scale,
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24])
+{
+  AQI_AVERAGES_LOOKUP_TABLE[scale](avg, co, nh3, no, no2, o3, pb, so2, pm10,
+                                   pm2_5);
+  return;
+} // end aqi_averages
+
+static inline __attribute__((always_inline))
+int australia_aqi_averages(const aqi_averages_t *a)
+{
+  return australia_aqi(a->co.h8, a->no2.h1, a->o3.h1, a->o3.h4, a->so2.h1,
+                       a->pm10.h24, a->pm2_5.h24);
+} // end australia_aqi_averages
+
+static inline __attribute__((always_inline))
+int canada_aqhi_averages(const aqi_averages_t *a)
+{
+  return canada_aqhi(a->no2.h3, a->o3.h3, a->pm2_5.h3);
+} // end canada_aqhi_averages
+
+static inline __attribute__((always_inline))
+int china_aqi_averages(const aqi_averages_t *a)
+{
+  return china_aqi(a->co.h1, a->co.h24, a->no2.h1, a->no2.h24, a->o3.h1,
+                   a->o3.h8, a->so2.h1, a->so2.h24, a->pm10.h24, a->pm2_5.h24);
+} // end china_aqi_averages
+
+static inline __attribute__((always_inline))
+int european_union_caqi_averages(const aqi_averages_t *a)
+{
+  return european_union_caqi(a->no2.h1, a->o3.h1, a->pm10.h1, a->pm2_5.h1);
+} // end european_union_caqi_averages
+
+static inline __attribute__((always_inline))
+int hong_kong_aqhi_averages(const aqi_averages_t *a)
+{
+  return hong_kong_aqhi(a->no2.h3, a->o3.h3, a->so2.h3, a->pm10.h3,
+                        a->pm2_5.h3);
+} // end hong_kong_aqhi_averages
+
+static inline __attribute__((always_inline))
+int india_aqi_averages(const aqi_averages_t *a)
+{
+  return india_aqi(a->co.h8, a->nh3.h24, a->no2.h24, a->o3.h8, a->pb.h24,
+                   a->so2.h24, a->pm10.h24, a->pm2_5.h24);
+} // end india_aqi_averages
+
+static inline __attribute__((always_inline))
+int singapore_psi_averages(const aqi_averages_t *a)
+{
+  return singapore_psi(a->co.h8, a->no2.h1, a->o3.h1, a->o3.h8, a->so2.h24,
+                       a->pm10.h24, a->pm2_5.h24);
+} // end singapore_psi_averages
+
+static inline __attribute__((always_inline))
+int south_korea_cai_averages(const aqi_averages_t *a)
+{
+  return south_korea_cai(a->co.h1, a->no2.h1, a->o3.h1, a->so2.h1,
+                         a->pm10.h24, a->pm2_5.h24);
+} // end south_korea_cai_averages
+
+static inline __attribute__((always_inline))
+int united_kingdom_daqi_averages(const aqi_averages_t *a)
+{
+  // USING LAST HOURLY CONCENTRATION for so2_15min!!!
+  return united_kingdom_daqi(a->no2.h1, a->o3.h8, a->so2.h1, a->pm10.h24,
+                             a->pm2_5.h24);
+} // end united_kingdom_daqi_averages
+
+static inline __attribute__((always_inline))
+int united_states_aqi_averages(const aqi_averages_t *a)
+{
+  return united_states_aqi(a->co.h8, a->no2.h1, a->o3.h1, a->o3.h8, a->so2.h1,
+                           a->so2.h24, a->pm10.h24, a->pm2_5.h24);
+} // end united_states_aqi_averages
+
+/* Fast lookup for the AQI functions of average concentrations. Organized
+ * alphabetically (same order as aqi_scale_t enums).
+ */
+static int (*CALC_AQI_AVERAGES_LOOKUP_TABLE[NUM_AQI_SCALES])(
+                                                  const aqi_averages_t *) = {
+  australia_aqi_averages,
+  canada_aqhi_averages,
+  china_aqi_averages,
+  european_union_caqi_averages,
+  hong_kong_aqhi_averages,
+  india_aqi_averages,
+  singapore_psi_averages,
+  south_korea_cai_averages,
+  united_kingdom_daqi_averages,
+  united_states_aqi_averages,
+};
 
-  avg = avg / (float) hours;
-  return avg;
-}
+int calc_aqi_averages(aqi_scale_t scale, const aqi_averages_t *avg)
+{
+  return CALC_AQI_AVERAGES_LOOKUP_TABLE[scale](avg);
+} // end calc_aqi_averages
 
 int calc_australia_aqi(
              const float co[24],  const float nh3[24],  const float no[24],
              const float no2[24], const float o3[24],   const float pb[24],
              const float so2[24], const float pm10[24], const float pm2_5[24])
 {
-  float co_8h     = avg_conc(co,     8);
-  float no2_1h    = avg_conc(no2,    1);
-  float o3_1h     = avg_conc(o3,     1);
-  float o3_4h     = avg_conc(o3,     4);
-  float so2_1h    = avg_conc(so2,    1);
-  float pm10_24h  = avg_conc(pm10,  24);
-  float pm2_5_24h = avg_conc(pm2_5, 24);
-  return australia_aqi(co_8h, no2_1h, o3_1h, o3_4h, so2_1h, pm10_24h,
-                       pm2_5_24h);
+  aqi_averages_t avg;
+  avg_australia_aqi(&avg, co, nh3, no, no2, o3, pb, so2, pm10, pm2_5);
+  return australia_aqi_averages(&avg);
 } // end calc_australia_aqi
 
 int calc_canada_aqhi(
@@ -2702,10 +1530,9 @@ int calc_canada_aqhi(
              const float no2[24], const float o3[24],   const float pb[24],
              const float so2[24], const float pm10[24], const float pm2_5[24])
 {
-  float no2_3h    = avg_conc(no2,    3);
-  float o3_3h     = avg_conc(o3,     3);
-  float pm2_5_3h  = avg_conc(pm2_5,  3);
-  return canada_aqhi(no2_3h, o3_3h, pm2_5_3h);
+  aqi_averages_t avg;
+  avg_canada_aqhi(&avg, co, nh3, no, no2, o3, pb, so2, pm10, pm2_5);
+  return canada_aqhi_averages(&avg);
 } // end calc_canada_aqhi
 
 int calc_china_aqi(
@@ -2713,18 +1540,9 @@ int calc_china_aqi(
              const float no2[24], const float o3[24],   const float pb[24],
              const float so2[24], const float pm10[24], const float pm2_5[24])
 {
-  float co_1h     = avg_conc(co,     1);
-  float co_24h    = avg_conc(co,    24);
-  float no2_1h    = avg_conc(no2,    1);
-  float no2_24h   = avg_conc(no2,   24);
-  float o3_1h     = avg_conc(o3,     1);
-  float o3_8h     = avg_conc(o3,     8);
-  float so2_1h    = avg_conc(so2,    1);
-  float so2_24h   = avg_conc(so2,   24);
-  float pm10_24h  = avg_conc(pm10,  24);
-  float pm2_5_24h = avg_conc(pm2_5, 24);
-  return china_aqi(co_1h, co_24h, no2_1h, no2_24h, o3_1h, o3_8h, so2_1h,
-                   so2_24h, pm10_24h, pm2_5_24h);
+  aqi_averages_t avg;
+  avg_china_aqi(&avg, co, nh3, no, no2, o3, pb, so2, pm10, pm2_5);
+  return china_aqi_averages(&avg);
 } // end calc_china_aqi
 
 int calc_european_union_caqi(
@@ -2732,11 +1550,9 @@ int calc_european_union_caqi(
              const float no2[24], const float o3[24],   const float pb[24],
              const float so2[24], const float pm10[24], const float pm2_5[24])
 {
-  float no2_1h    = avg_conc(no2,    1);
-  float o3_1h     = avg_conc(o3,     1);
-  float pm10_1h   = avg_conc(pm10,   1);
-  float pm2_5_1h  = avg_conc(pm2_5,  1);
-  return european_union_caqi(no2_1h, o3_1h, pm10_1h, pm2_5_1h);
+  aqi_averages_t avg;
+  avg_european_union_caqi(&avg, co, nh3, no, no2, o3, pb, so2, pm10, pm2_5);
+  return european_union_caqi_averages(&avg);
 } // end calc_european_union_caqi
 
 int calc_hong_kong_aqhi(
@@ -2744,12 +1560,9 @@ int calc_hong_kong_aqhi(
              const float no2[24], const float o3[24],   const float pb[24],
              const float so2[24], const float pm10[24], const float pm2_5[24])
 {
-  float no2_3h    = avg_conc(no2,    3);
-  float o3_3h     = avg_conc(o3,     3);
-  float so2_3h    = avg_conc(so2,    3);
-  float pm10_3h   = avg_conc(pm10,   3);
-  float pm2_5_3h  = avg_conc(pm2_5,  3);
-  return hong_kong_aqhi(no2_3h,  o3_3h, so2_3h, pm10_3h, pm2_5_3h);
+  aqi_averages_t avg;
+  avg_hong_kong_aqhi(&avg, co, nh3, no, no2, o3, pb, so2, pm10, pm2_5);
+  return hong_kong_aqhi_averages(&avg);
 } // end calc_hong_kong_aqhi
 
 int calc_india_aqi(
@@ -2757,16 +1570,9 @@ int calc_india_aqi(
              const float no2[24], const float o3[24],   const float pb[24],
              const float so2[24], const float pm10[24], const float pm2_5[24])
 {
-  float co_8h     = avg_conc(co,     8);
-  float nh3_24h   = avg_conc(nh3,   24);
-  float no2_24h   = avg_conc(no2,   24);
-  float o3_8h     = avg_conc(o3,     8);
-  float pb_24h    = avg_conc(pb,    24);
-  float so2_24h   = avg_conc(so2,   24);
-  float pm10_24h  = avg_conc(pm10,  24);
-  float pm2_5_24h = avg_conc(pm2_5, 24);
-  return india_aqi(co_8h, nh3_24h, no2_24h, o3_8h, pb_24h, so2_24h, pm10_24h,
-                   pm2_5_24h);
+  aqi_averages_t avg;
+  avg_india_aqi(&avg, co, nh3, no, no2, o3, pb, so2, pm10, pm2_5);
+  return india_aqi_averages(&avg);
 } // end calc_india_aqi
 
 int calc_singapore_psi(
@@ -2774,15 +1580,9 @@ int calc_singapore_psi(
              const float no2[24], const float o3[24],   const float pb[24],
              const float so2[24], const float pm10[24], const float pm2_5[24])
 {
-  float co_8h     = avg_conc(co,     8);
-  float no2_1h    = avg_conc(no2,    1);
-  float o3_1h     = avg_conc(o3,     1);
-  float o3_8h     = avg_conc(o3,     8);
-  float so2_24h   = avg_conc(so2,   24);
-  float pm10_24h  = avg_conc(pm10,  24);
-  float pm2_5_24h = avg_conc(pm2_5, 24);
-  return singapore_psi(co_8h, no2_1h, o3_1h, o3_8h, so2_24h, pm10_24h,
-                       pm2_5_24h);
+  aqi_averages_t avg;
+  avg_singapore_psi(&avg, co, nh3, no, no2, o3, pb, so2, pm10, pm2_5);
+  return singapore_psi_averages(&avg);
 } // end calc_singapore_psi
 
 int calc_south_korea_cai(
@@ -2790,13 +1590,9 @@ int calc_south_korea_cai(
              const float no2[24], const float o3[24],   const float pb[24],
              const float so2[24], const float pm10[24], const float pm2_5[24])
 {
-  float co_1h     = avg_conc(co,     1);
-  float no2_1h    = avg_conc(no2,    1);
-  float o3_1h     = avg_conc(o3,     1);
-  float so2_1h    = avg_conc(so2,    1);
-  float pm10_24h  = avg_conc(pm10,  24);
-  float pm2_5_24h = avg_conc(pm2_5, 24);
-  return south_korea_cai(co_1h, no2_1h, o3_1h, so2_1h, pm10_24h, pm2_5_24h);
+  aqi_averages_t avg;
+  avg_south_korea_cai(&avg, co, nh3, no, no2, o3, pb, so2, pm10, pm2_5);
+  return south_korea_cai_averages(&avg);
 } // end calc_south_korea_cai
 
 int calc_united_kingdom_daqi(
@@ -2804,12 +1600,9 @@ int calc_united_kingdom_daqi(
              const float no2[24], const float o3[24],   const float pb[24],
              const float so2[24], const float pm10[24], const float pm2_5[24])
 {
-  float no2_1h    = avg_conc(no2,    1);
-  float o3_8h     = avg_conc(o3,     8);
-  float so2_15min = avg_conc(so2,    1); // USING LAST HOURLY CONCENTRATION!!!
-  float pm10_24h  = avg_conc(pm10,  24);
-  float pm2_5_24h = avg_conc(pm2_5, 24);
-  return united_kingdom_daqi(no2_1h, o3_8h, so2_15min, pm10_24h, pm2_5_24h);
+  aqi_averages_t avg;
+  avg_united_kingdom_daqi(&avg, co, nh3, no, no2, o3, pb, so2, pm10, pm2_5);
+  return united_kingdom_daqi_averages(&avg);
 } // end calc_united_kingdom_daqi
 
 int calc_united_states_aqi(
@@ -2817,16 +1610,9 @@ int calc_united_states_aqi(
              const float no2[24], const float o3[24],   const float pb[24],
              const float so2[24], const float pm10[24], const float pm2_5[24])
 {
-  float co_8h     = avg_conc(co,     8);
-  float no2_1h    = avg_conc(no2,    1);
-  float o3_1h     = avg_conc(o3,     1);
-  float o3_8h     = avg_conc(o3,     8);
-  float so2_1h    = avg_conc(so2,    1);
-  float so2_24h   = avg_conc(so2,   24);
-  float pm10_24h  = avg_conc(pm10,  24);
-  float pm2_5_24h = avg_conc(pm2_5, 24);
-  return united_states_aqi(co_8h, no2_1h, o3_1h, o3_8h, so2_1h, so2_24h,
-                           pm10_24h, pm2_5_24h);
+  aqi_averages_t avg;
+  avg_united_states_aqi(&avg, co, nh3, no, no2, o3, pb, so2, pm10, pm2_5);
+  return united_states_aqi_averages(&avg);
 } // end calc_united_states_aqi
 
 /* Fast lookup for calc_aqi functions. Organized alphabetically
@@ -2877,6 +1663,26 @@ int aqi_scale_max(aqi_scale_t scale) {
   return AQI_MAX_LOOKUP_TABLE[scale];
 } // end aqi_scale_max
 
+/* Fast lookup for AQI scale pollutant masks. Organized alphabetically
+ * (same order as aqi_scale_t enums).
+ */
+static const int AQI_POLLUTANTS_LOOKUP_TABLE[NUM_AQI_SCALES] = {
+  AUSTRALIA_AQI_POLLUTANTS,
+  CANADA_AQHI_POLLUTANTS,
+  CHINA_AQI_POLLUTANTS,
+  EUROPEAN_UNION_CAQI_POLLUTANTS,
+  HONG_KONG_AQHI_POLLUTANTS,
+  INDIA_AQI_POLLUTANTS,
+  SINGAPORE_PSI_POLLUTANTS,
+  SOUTH_KOREA_CAI_POLLUTANTS,
+  UNITED_KINGDOM_DAQI_POLLUTANTS,
+  UNITED_STATES_AQI_POLLUTANTS,
+};
+
+int aqi_scale_pollutants(aqi_scale_t scale) {
+  return AQI_POLLUTANTS_LOOKUP_TABLE[scale];
+} // end aqi_scale_pollutants
+
 /* Fast lookup for AQI descriptor functions. Organized alphabetically
  * (same order as aqi_scale_t enums).
  */
@@ -227,6 +227,104 @@ const char *aqi_desc(aqi_scale_t scale, int val);
  */
 aqi_desc_type_t aqi_desc_type(aqi_scale_t scale);
 
+/* Pollutants used by each AQI scale, as a bitmask. Concentrations of pollutants
+ * that are not in the mask of a scale are never read by its calc function and
+ * may be left unset (or NULL).
+ */
+#define AQI_POLLUTANT_CO    (1 << 0)
+#define AQI_POLLUTANT_NH3   (1 << 1)
+#define AQI_POLLUTANT_NO    (1 << 2)
+#define AQI_POLLUTANT_NO2   (1 << 3)
+#define AQI_POLLUTANT_O3    (1 << 4)
+#define AQI_POLLUTANT_PB    (1 << 5)
+#define AQI_POLLUTANT_SO2   (1 << 6)
+#define AQI_POLLUTANT_PM10  (1 << 7)
+#define AQI_POLLUTANT_PM2_5 (1 << 8)
+
+#define AUSTRALIA_AQI_POLLUTANTS       (AQI_POLLUTANT_CO  | AQI_POLLUTANT_NO2  \
+                                      | AQI_POLLUTANT_O3  | AQI_POLLUTANT_SO2  \
+                                      | AQI_POLLUTANT_PM10                     \
+                                      | AQI_POLLUTANT_PM2_5)
+#define CANADA_AQHI_POLLUTANTS         (AQI_POLLUTANT_NO2 | AQI_POLLUTANT_O3   \
+                                      | AQI_POLLUTANT_PM2_5)
+#define CHINA_AQI_POLLUTANTS           (AQI_POLLUTANT_CO  | AQI_POLLUTANT_NO2  \
+                                      | AQI_POLLUTANT_O3  | AQI_POLLUTANT_SO2  \
+                                      | AQI_POLLUTANT_PM10                     \
+                                      | AQI_POLLUTANT_PM2_5)
+#define EUROPEAN_UNION_CAQI_POLLUTANTS (AQI_POLLUTANT_NO2 | AQI_POLLUTANT_O3   \
+                                      | AQI_POLLUTANT_PM10                     \
+                                      | AQI_POLLUTANT_PM2_5)
+#define HONG_KONG_AQHI_POLLUTANTS      (AQI_POLLUTANT_NO2 | AQI_POLLUTANT_O3   \
+                                      | AQI_POLLUTANT_SO2 | AQI_POLLUTANT_PM10 \
+                                      | AQI_POLLUTANT_PM2_5)
+#define INDIA_AQI_POLLUTANTS           (AQI_POLLUTANT_CO  | AQI_POLLUTANT_NH3  \
+                                      | AQI_POLLUTANT_NO2 | AQI_POLLUTANT_O3   \
+                                      | AQI_POLLUTANT_PB  | AQI_POLLUTANT_SO2  \
+                                      | AQI_POLLUTANT_PM10                     \
+                                      | AQI_POLLUTANT_PM2_5)
+#define SINGAPORE_PSI_POLLUTANTS       (AQI_POLLUTANT_CO  | AQI_POLLUTANT_NO2  \
+                                      | AQI_POLLUTANT_O3  | AQI_POLLUTANT_SO2  \
+                                      | AQI_POLLUTANT_PM10                     \
+                                      | AQI_POLLUTANT_PM2_5)
+#define SOUTH_KOREA_CAI_POLLUTANTS     (AQI_POLLUTANT_CO  | AQI_POLLUTANT_NO2  \
+                                      | AQI_POLLUTANT_O3  | AQI_POLLUTANT_SO2  \
+                                      | AQI_POLLUTANT_PM10                     \
+                                      | AQI_POLLUTANT_PM2_5)
+#define UNITED_KINGDOM_DAQI_POLLUTANTS (AQI_POLLUTANT_NO2 | AQI_POLLUTANT_O3   \
+                                      | AQI_POLLUTANT_SO2 | AQI_POLLUTANT_PM10 \
+                                      | AQI_POLLUTANT_PM2_5)
+#define UNITED_STATES_AQI_POLLUTANTS   (AQI_POLLUTANT_CO  | AQI_POLLUTANT_NO2  \
+                                      | AQI_POLLUTANT_O3  | AQI_POLLUTANT_SO2  \
+                                      | AQI_POLLUTANT_PM10                     \
+                                      | AQI_POLLUTANT_PM2_5)
+
+/* Given an AQI scale, returns the AQI_POLLUTANT_* bitmask of the pollutant
+ * concentrations it uses.
+ */
+int aqi_scale_pollutants(aqi_scale_t scale);
+
+/* The average concentrations of a pollutant over the most recent 1, 3, 4, 8
+ * and 24 hours, every period the scales use.
+ */
+typedef struct {
+  float h1;
+  float h3;
+  float h4;
+  float h8;
+  float h24;
+} aqi_avg_conc_t;
+
+typedef struct {
+  aqi_avg_conc_t co;
+  aqi_avg_conc_t nh3;
+  aqi_avg_conc_t no;
+  aqi_avg_conc_t no2;
+  aqi_avg_conc_t o3;
+  aqi_avg_conc_t pb;
+  aqi_avg_conc_t so2;
+  aqi_avg_conc_t pm10;
+  aqi_avg_conc_t pm2_5;
+} aqi_averages_t;
+
+/* Given a scale and hourly pollutant concentrations, organized as for
+ * calc_aqi, computes only the average concentrations the scale uses. Averages
+ * the scale does not use are left unset.
+ *
+ * Usage Example:
+ *   aqi_averages_t avg;
+ *   aqi_averages(&avg, scale, co, nh3, no, no2, o3, pb, so2, pm10, pm2_5);
+ *   aqi = calc_aqi_averages(scale, &avg);
+ */
+void aqi_averages(aqi_averages_t *avg, aqi_scale_t scale,
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24]);
+
+/* Given a scale and average concentrations returns the Air Quality Index.
+ * 'avg' must hold the averages of aqi_averages() for the same scale.
+ */
+int calc_aqi_averages(aqi_scale_t scale, const aqi_averages_t *avg);
+
 /* If you do not want to use the default descriptors, you may define the
  * AQI_EXTERN_TXT macro below and define the descriptor strings externally.
  */
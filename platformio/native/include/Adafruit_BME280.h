@@ -0,0 +1,40 @@
+/* Native (host) Adafruit_BME280 shim for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Readings come from the --bme option of the native harness. When the option
+ * is "none" the sensor is reported as not found.
+ */
+
+#ifndef __NATIVE_ADAFRUIT_BME280_H__
+#define __NATIVE_ADAFRUIT_BME280_H__
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#define BME280_ADDRESS (0x77)
+#define BME280_ADDRESS_ALTERNATE (0x76)
+
+class Adafruit_BME280
+{
+public:
+  bool begin(uint8_t addr = BME280_ADDRESS, TwoWire *theWire = &Wire);
+  float readTemperature(void);
+  float readPressure(void);
+  float readHumidity(void);
+};
+
+#endif
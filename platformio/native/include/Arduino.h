@@ -0,0 +1,159 @@
+/* Native (host) Arduino core shim for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Only the parts of the esp32 Arduino core that this project touches are
+ * provided. Pins, ADC and sleep calls are recorded or ignored, time is driven
+ * by the simulated clock of the native harness (see native/README.md).
+ */
+
+#ifndef __NATIVE_ARDUINO_H__
+#define __NATIVE_ARDUINO_H__
+
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+
+using std::isinf;
+using std::isnan;
+using std::max;
+using std::min;
+
+// the core of platform espressif32 @ 6.9.0, which the shims follow
+#define ESP_ARDUINO_VERSION_MAJOR 2
+#define ESP_ARDUINO_VERSION_MINOR 0
+#define ESP_ARDUINO_VERSION_PATCH 17
+
+#define PI          3.1415926535897932384626433832795
+#define HALF_PI     1.5707963267948966192313216916398
+#define TWO_PI      6.283185307179586476925286766559
+#define DEG_TO_RAD  0.017453292519943295769236907684886
+#define RAD_TO_DEG  57.295779513082320876798154814105
+
+#define radians(deg) ((deg) * DEG_TO_RAD)
+#define degrees(rad) ((rad) * RAD_TO_DEG)
+#define constrain(amt, low, high) \
+  ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+#define HIGH   0x1
+#define LOW    0x0
+#define INPUT  0x01
+#define OUTPUT 0x03
+
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+#define F(s) (s)
+#define pgm_read_byte(addr)    (*reinterpret_cast<const uint8_t *>(addr))
+#define pgm_read_word(addr)    (*reinterpret_cast<const uint16_t *>(addr))
+#define pgm_read_dword(addr)   (*reinterpret_cast<const uint32_t *>(addr))
+#define pgm_read_pointer(addr) (*reinterpret_cast<void *const *>(addr))
+
+// RTC slow memory is emulated by the harness, see nativeRtc*() below.
+#define RTC_DATA_ATTR __attribute__((section("rtc_data"), used))
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef int esp_err_t;
+#define ESP_OK   0
+#define ESP_FAIL -1
+
+// FireBeetle 2 ESP32-E analog pins and builtin LED
+static const uint8_t A0 = 36;
+static const uint8_t A1 = 39;
+static const uint8_t A2 = 34;
+static const uint8_t A3 = 35;
+static const uint8_t A4 = 15;
+static const uint8_t LED_BUILTIN = 2;
+
+typedef enum {
+  GPIO_NUM_0 = 0,
+  GPIO_NUM_MAX = 40,
+} gpio_num_t;
+
+inline int toUpperCase(int c) { return toupper(c); }
+inline int toLowerCase(int c) { return tolower(c); }
+inline bool isDigit(int c) { return isdigit(c) != 0; }
+inline bool isAlpha(int c) { return isalpha(c) != 0; }
+inline bool isSpace(int c) { return isspace(c) != 0; }
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+uint16_t analogRead(uint8_t pin);
+esp_err_t gpio_hold_en(gpio_num_t gpio_num);
+esp_err_t gpio_hold_dis(gpio_num_t gpio_num);
+void gpio_deep_sleep_hold_en(void);
+
+bool getLocalTime(struct tm *info, uint32_t ms = 5000);
+void configTzTime(const char *tz, const char *server1,
+                  const char *server2 = nullptr,
+                  const char *server3 = nullptr);
+
+// no PSRAM on the emulated board
+inline bool psramFound() { return false; }
+inline void *ps_malloc(size_t size) { return malloc(size); }
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us);
+[[noreturn]] void esp_deep_sleep_start(void);
+
+class HardwareSerial : public Stream
+{
+public:
+  void begin(unsigned long baud) {}
+  void end() {}
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *buffer, size_t size) override;
+  using Print::write;
+  void flush() override;
+  operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+class EspClass
+{
+public:
+  uint32_t getHeapSize();
+  uint32_t getFreeHeap();
+  uint32_t getMinFreeHeap();
+  uint32_t getMaxAllocHeap();
+  uint32_t getPsramSize() { return 0; }
+  uint32_t getFreePsram() { return 0; }
+};
+
+extern EspClass ESP;
+
+#endif
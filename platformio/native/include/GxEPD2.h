@@ -0,0 +1,202 @@
+/* Native (host) GxEPD2 shim for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __NATIVE_GXEPD2_H__
+#define __NATIVE_GXEPD2_H__
+
+#include <Arduino.h>
+#include <SPI.h>
+
+// color definitions for GxEPD, values correspond to RGB565 values for TFTs
+#define GxEPD_BLACK     0x0000
+#define GxEPD_WHITE     0xFFFF
+#define GxEPD_DARKGREY  0x7BEF
+#define GxEPD_LIGHTGREY 0xC618
+#define GxEPD_RED       0xF800
+#define GxEPD_YELLOW    0xFFE0
+#define GxEPD_COLORED   GxEPD_RED
+#define GxEPD_GREEN     0x07E0
+#define GxEPD_BLUE      0x001F
+#define GxEPD_ORANGE    0xFC00
+
+#ifndef GxEPD2_GFX_BASE_CLASS
+  #include <Adafruit_GFX.h>
+  #define GxEPD2_GFX_BASE_CLASS Adafruit_GFX
+#endif
+
+/* The controller frame memory of every panel is emulated by one in-memory
+ * canvas. Pixels are stored as native 7-color codes (0 black, 1 white,
+ * 2 green, 3 blue, 4 red, 5 yellow, 6 orange).
+ */
+enum native_panel_format
+{
+  NATIVE_PANEL_BW,
+  NATIVE_PANEL_3C,
+  NATIVE_PANEL_7C
+};
+
+void nativePanelInit(native_panel_format format, uint16_t width,
+                     uint16_t height, uint16_t full_refresh_time,
+                     uint16_t partial_refresh_time);
+void nativePanelWriteBW(const uint8_t *bitmap, int16_t x, int16_t y,
+                        int16_t w, int16_t h, bool invert);
+void nativePanelWrite3C(const uint8_t *black, const uint8_t *color,
+                        int16_t x, int16_t y, int16_t w, int16_t h);
+void nativePanelWrite7C(const uint8_t *native, int16_t x, int16_t y,
+                        int16_t w, int16_t h);
+void nativePanelRefresh(int16_t x, int16_t y, int16_t w, int16_t h,
+                        bool partial);
+void nativePanelHibernate();
+
+/* Common driver behaviour of the emulated panels.
+ */
+class GxEPD2_EPD
+{
+public:
+  const uint16_t WIDTH;
+  const uint16_t HEIGHT;
+  const bool hasColor;
+  const bool hasPartialUpdate;
+  const bool hasFastPartialUpdate;
+
+  GxEPD2_EPD(int16_t cs, int16_t dc, int16_t rst, int16_t busy,
+             native_panel_format format, uint16_t w, uint16_t h,
+             bool c, bool pu, bool fpu, uint16_t full_refresh_time,
+             uint16_t partial_refresh_time)
+    : WIDTH(w), HEIGHT(h), hasColor(c), hasPartialUpdate(pu),
+      hasFastPartialUpdate(fpu), _format(format),
+      _full_refresh_time(full_refresh_time),
+      _partial_refresh_time(partial_refresh_time) {}
+
+  void init(uint32_t serial_diag_bitrate = 0)
+  {
+    init(serial_diag_bitrate, true, 10, false);
+  }
+  void init(uint32_t serial_diag_bitrate, bool initial,
+            uint16_t reset_duration = 10, bool pulldown_rst_mode = false)
+  {
+    nativePanelInit(_format, WIDTH, HEIGHT, _full_refresh_time,
+                    _partial_refresh_time);
+  }
+
+  void refresh(bool partial_update_mode = false)
+  {
+    nativePanelRefresh(0, 0, WIDTH, HEIGHT, partial_update_mode);
+  }
+  void refresh(int16_t x, int16_t y, int16_t w, int16_t h)
+  {
+    nativePanelRefresh(x, y, w, h, true);
+  }
+  void powerOff() {}
+  void hibernate() { nativePanelHibernate(); }
+
+protected:
+  native_panel_format _format;
+  uint16_t _full_refresh_time;    // ms, typical
+  uint16_t _partial_refresh_time; // ms, typical
+};
+
+/* Black/White panels (GxEPD2_BW)
+ */
+class GxEPD2_EPD_BW : public GxEPD2_EPD
+{
+public:
+  using GxEPD2_EPD::GxEPD2_EPD;
+  void writeImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w,
+                  int16_t h, bool invert = false, bool mirror_y = false,
+                  bool pgm = false)
+  {
+    nativePanelWriteBW(bitmap, x, y, w, h, invert);
+  }
+  void writeImageAgain(const uint8_t bitmap[], int16_t x, int16_t y,
+                       int16_t w, int16_t h, bool invert = false,
+                       bool mirror_y = false, bool pgm = false)
+  {
+    nativePanelWriteBW(bitmap, x, y, w, h, invert);
+  }
+};
+
+class GxEPD2_750_T7 : public GxEPD2_EPD_BW
+{
+public:
+  static const uint16_t WIDTH = 800;
+  static const uint16_t HEIGHT = 480;
+  static const uint16_t full_refresh_time = 4000;
+  static const uint16_t partial_refresh_time = 800;
+  GxEPD2_750_T7(int16_t cs, int16_t dc, int16_t rst, int16_t busy)
+    : GxEPD2_EPD_BW(cs, dc, rst, busy, NATIVE_PANEL_BW, WIDTH, HEIGHT,
+                    false, true, true, full_refresh_time,
+                    partial_refresh_time) {}
+};
+
+class GxEPD2_750 : public GxEPD2_EPD_BW
+{
+public:
+  static const uint16_t WIDTH = 640;
+  static const uint16_t HEIGHT = 384;
+  static const uint16_t full_refresh_time = 4000;
+  static const uint16_t partial_refresh_time = 2000;
+  GxEPD2_750(int16_t cs, int16_t dc, int16_t rst, int16_t busy)
+    : GxEPD2_EPD_BW(cs, dc, rst, busy, NATIVE_PANEL_BW, WIDTH, HEIGHT,
+                    false, true, false, full_refresh_time,
+                    partial_refresh_time) {}
+};
+
+/* Black/White/Red panels (GxEPD2_3C)
+ */
+class GxEPD2_750c_Z08 : public GxEPD2_EPD
+{
+public:
+  static const uint16_t WIDTH = 800;
+  static const uint16_t HEIGHT = 480;
+  static const uint16_t full_refresh_time = 16000;
+  static const uint16_t partial_refresh_time = 16000;
+  GxEPD2_750c_Z08(int16_t cs, int16_t dc, int16_t rst, int16_t busy)
+    : GxEPD2_EPD(cs, dc, rst, busy, NATIVE_PANEL_3C, WIDTH, HEIGHT,
+                 true, false, false, full_refresh_time,
+                 partial_refresh_time) {}
+  void writeImage(const uint8_t *black, const uint8_t *color, int16_t x,
+                  int16_t y, int16_t w, int16_t h, bool invert = false,
+                  bool mirror_y = false, bool pgm = false)
+  {
+    nativePanelWrite3C(black, color, x, y, w, h);
+  }
+};
+
+/* 7-Color ACeP panels (GxEPD2_7C)
+ */
+class GxEPD2_730c_GDEY073D46 : public GxEPD2_EPD
+{
+public:
+  static const uint16_t WIDTH = 800;
+  static const uint16_t HEIGHT = 480;
+  static const uint16_t full_refresh_time = 30000;
+  static const uint16_t partial_refresh_time = 30000;
+  GxEPD2_730c_GDEY073D46(int16_t cs, int16_t dc, int16_t rst, int16_t busy)
+    : GxEPD2_EPD(cs, dc, rst, busy, NATIVE_PANEL_7C, WIDTH, HEIGHT,
+                 true, false, false, full_refresh_time,
+                 partial_refresh_time) {}
+  void setPaged() {}
+  void writeNative(const uint8_t *data1, const uint8_t *data2, int16_t x,
+                   int16_t y, int16_t w, int16_t h, bool invert = false,
+                   bool mirror_y = false, bool pgm = false)
+  {
+    nativePanelWrite7C(data1, x, y, w, h);
+  }
+};
+
+#endif
@@ -0,0 +1,184 @@
+/* Native (host) GxEPD2_3C shim for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Paged two plane frame buffer with the same page/buffer layout as
+ * GxEPD2_3C (black and color planes, ink = 0 bit, MSB first).
+ */
+
+#ifndef __NATIVE_GXEPD2_3C_H__
+#define __NATIVE_GXEPD2_3C_H__
+
+#include "GxEPD2.h"
+
+template <typename GxEPD2_Type, const uint16_t page_height>
+class GxEPD2_3C : public GxEPD2_GFX_BASE_CLASS
+{
+public:
+  GxEPD2_Type epd2;
+
+  GxEPD2_3C(GxEPD2_Type epd2_instance)
+    : GxEPD2_GFX_BASE_CLASS(GxEPD2_Type::WIDTH, GxEPD2_Type::HEIGHT),
+      epd2(epd2_instance)
+  {
+    _page_height = page_height;
+    _pages = (HEIGHT / _page_height) + ((HEIGHT % _page_height) > 0);
+    _current_page = 0;
+    setFullWindow();
+  }
+
+  uint16_t pages() { return _pages; }
+  uint16_t pageHeight() { return _page_height; }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override
+  {
+    if ((x < 0) || (x >= width()) || (y < 0) || (y >= height()))
+    {
+      return;
+    }
+    // check rotation, move pixel around if necessary
+    switch (getRotation())
+    {
+    case 1: std::swap(x, y); x = WIDTH - x - 1; break;
+    case 2: x = WIDTH - x - 1; y = HEIGHT - y - 1; break;
+    case 3: std::swap(x, y); y = HEIGHT - y - 1; break;
+    }
+    // adjust for current page
+    y -= _current_page * _page_height;
+    // check if in current page
+    if ((y < 0) || (y >= int16_t(_page_height)))
+    {
+      return;
+    }
+    uint32_t i = x / 8 + uint32_t(y) * (WIDTH / 8);
+    uint8_t bit = 1 << (7 - x % 8);
+    _black_buffer[i] |= bit;
+    _color_buffer[i] |= bit;
+    if (color == GxEPD_WHITE)
+    {
+      return;
+    }
+    else if (color == GxEPD_BLACK)
+    {
+      _black_buffer[i] &= ~bit;
+    }
+    else if ((color == GxEPD_RED) || (color == GxEPD_YELLOW)
+          || ((color & 0xF100) > (0xF100 / 2)))
+    {
+      _color_buffer[i] &= ~bit;
+    }
+    else if ((((color & 0xF100) >> 11) + ((color & 0x07E0) >> 5)
+              + (color & 0x001F)) < 3 * 255 / 2)
+    {
+      _black_buffer[i] &= ~bit;
+    }
+  }
+
+  void init(uint32_t serial_diag_bitrate = 0)
+  {
+    epd2.init(serial_diag_bitrate);
+  }
+
+  void init(uint32_t serial_diag_bitrate, bool initial,
+            uint16_t reset_duration = 10, bool pulldown_rst_mode = false)
+  {
+    epd2.init(serial_diag_bitrate, initial, reset_duration,
+              pulldown_rst_mode);
+  }
+
+  void fillScreen(uint16_t color) override
+  {
+    uint8_t black = 0xFF;
+    uint8_t red = 0xFF;
+    if (color == GxEPD_BLACK)
+    {
+      black = 0x00;
+    }
+    else if ((color == GxEPD_RED) || (color == GxEPD_YELLOW))
+    {
+      red = 0x00;
+    }
+    memset(_black_buffer, black, sizeof(_black_buffer));
+    memset(_color_buffer, red, sizeof(_color_buffer));
+  }
+
+  void setFullWindow() {}
+
+  void firstPage()
+  {
+    fillScreen(GxEPD_WHITE);
+    _current_page = 0;
+  }
+
+  bool nextPage()
+  {
+    uint16_t page_ys = _current_page * _page_height;
+    uint16_t page_ye = _current_page < int16_t(_pages - 1)
+                     ? page_ys + _page_height : HEIGHT;
+    epd2.writeImage(_black_buffer, _color_buffer, 0, page_ys, WIDTH,
+                    page_ye - page_ys);
+    _current_page++;
+    if (_current_page == int16_t(_pages))
+    {
+      _current_page = 0;
+      epd2.refresh(false);
+      return false;
+    }
+    fillScreen(GxEPD_WHITE);
+    return true;
+  }
+
+  void display(bool partial_update_mode = false)
+  {
+    epd2.writeImage(_black_buffer, _color_buffer, 0, 0, WIDTH, _page_height);
+    epd2.refresh(partial_update_mode);
+  }
+
+  void drawInvertedBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
+                          int16_t w, int16_t h, uint16_t color)
+  {
+    int16_t byteWidth = (w + 7) / 8; // Bitmap scanline pad = whole byte
+    uint8_t byte = 0;
+    for (int16_t j = 0; j < h; j++)
+    {
+      for (int16_t i = 0; i < w; i++)
+      {
+        if (i & 7)
+        {
+          byte <<= 1;
+        }
+        else
+        {
+          byte = pgm_read_byte(&bitmap[j * byteWidth + i / 8]);
+        }
+        if (!(byte & 0x80))
+        {
+          drawPixel(x + i, y + j, color);
+        }
+      }
+    }
+  }
+
+  void powerOff() { epd2.powerOff(); }
+  void hibernate() { epd2.hibernate(); }
+
+private:
+  uint8_t _black_buffer[(uint32_t(GxEPD2_Type::WIDTH) / 8) * page_height];
+  uint8_t _color_buffer[(uint32_t(GxEPD2_Type::WIDTH) / 8) * page_height];
+  int16_t _page_height, _pages, _current_page;
+};
+
+#endif
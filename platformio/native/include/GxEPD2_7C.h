@@ -0,0 +1,179 @@
+/* Native (host) GxEPD2_7C shim for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Paged 4bpp frame buffer with the same page/buffer layout as GxEPD2_7C
+ * (native color codes, even x in the high nibble).
+ */
+
+#ifndef __NATIVE_GXEPD2_7C_H__
+#define __NATIVE_GXEPD2_7C_H__
+
+#include "GxEPD2.h"
+
+template <typename GxEPD2_Type, const uint16_t page_height>
+class GxEPD2_7C : public GxEPD2_GFX_BASE_CLASS
+{
+public:
+  GxEPD2_Type epd2;
+
+  GxEPD2_7C(GxEPD2_Type epd2_instance)
+    : GxEPD2_GFX_BASE_CLASS(GxEPD2_Type::WIDTH, GxEPD2_Type::HEIGHT),
+      epd2(epd2_instance)
+  {
+    _page_height = page_height;
+    _pages = (HEIGHT / _page_height) + ((HEIGHT % _page_height) > 0);
+    _current_page = 0;
+    setFullWindow();
+  }
+
+  uint16_t pages() { return _pages; }
+  uint16_t pageHeight() { return _page_height; }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override
+  {
+    if ((x < 0) || (x >= width()) || (y < 0) || (y >= height()))
+    {
+      return;
+    }
+    // check rotation, move pixel around if necessary
+    switch (getRotation())
+    {
+    case 1: std::swap(x, y); x = WIDTH - x - 1; break;
+    case 2: x = WIDTH - x - 1; y = HEIGHT - y - 1; break;
+    case 3: std::swap(x, y); y = HEIGHT - y - 1; break;
+    }
+    // adjust for current page
+    y -= _current_page * _page_height;
+    // check if in current page
+    if ((y < 0) || (y >= int16_t(_page_height)))
+    {
+      return;
+    }
+    uint32_t i = x / 2 + uint32_t(y) * (WIDTH / 2);
+    uint8_t pv = color7(color);
+    _buffer[i] = (_buffer[i] & (0x0F << 4 * (x % 2)))
+               | (pv << 4 * (1 - x % 2));
+  }
+
+  void init(uint32_t serial_diag_bitrate = 0)
+  {
+    epd2.init(serial_diag_bitrate);
+  }
+
+  void init(uint32_t serial_diag_bitrate, bool initial,
+            uint16_t reset_duration = 10, bool pulldown_rst_mode = false)
+  {
+    epd2.init(serial_diag_bitrate, initial, reset_duration,
+              pulldown_rst_mode);
+  }
+
+  void fillScreen(uint16_t color) override
+  {
+    uint8_t pv = color7(color);
+    memset(_buffer, (pv << 4) | pv, sizeof(_buffer));
+  }
+
+  void setFullWindow() {}
+
+  void firstPage()
+  {
+    fillScreen(GxEPD_WHITE);
+    _current_page = 0;
+  }
+
+  bool nextPage()
+  {
+    uint16_t page_ys = _current_page * _page_height;
+    uint16_t page_ye = _current_page < int16_t(_pages - 1)
+                     ? page_ys + _page_height : HEIGHT;
+    epd2.writeNative(_buffer, 0, 0, page_ys, WIDTH, page_ye - page_ys);
+    _current_page++;
+    if (_current_page == int16_t(_pages))
+    {
+      _current_page = 0;
+      epd2.refresh(false);
+      return false;
+    }
+    fillScreen(GxEPD_WHITE);
+    return true;
+  }
+
+  void display(bool partial_update_mode = false)
+  {
+    epd2.writeNative(_buffer, 0, 0, 0, WIDTH, _page_height);
+    epd2.refresh(partial_update_mode);
+  }
+
+  void drawInvertedBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
+                          int16_t w, int16_t h, uint16_t color)
+  {
+    int16_t byteWidth = (w + 7) / 8; // Bitmap scanline pad = whole byte
+    uint8_t byte = 0;
+    for (int16_t j = 0; j < h; j++)
+    {
+      for (int16_t i = 0; i < w; i++)
+      {
+        if (i & 7)
+        {
+          byte <<= 1;
+        }
+        else
+        {
+          byte = pgm_read_byte(&bitmap[j * byteWidth + i / 8]);
+        }
+        if (!(byte & 0x80))
+        {
+          drawPixel(x + i, y + j, color);
+        }
+      }
+    }
+  }
+
+  void powerOff() { epd2.powerOff(); }
+  void hibernate() { epd2.hibernate(); }
+
+private:
+  static uint8_t color7(uint16_t color)
+  {
+    uint16_t red = color & 0xF800;
+    uint16_t green = (color & 0x07E0) << 5;
+    uint16_t blue = (color & 0x001F) << 11;
+    uint8_t cv7 = 0x00;
+    if ((red < 0x8000) && (green < 0x8000) && (blue < 0x8000))
+      cv7 = 0x00; // black
+    else if ((red >= 0x8000) && (green >= 0x8000) && (blue >= 0x8000))
+      cv7 = 0x01; // white
+    else if ((red >= 0x8000) && (blue >= 0x8000))
+      cv7 = red > blue ? 0x04 : 0x03; // red, blue
+    else if ((green >= 0x8000) && (blue >= 0x8000))
+      cv7 = green > blue ? 0x02 : 0x03; // green, blue
+    else if ((red >= 0x8000) && (green >= 0x8000))
+      cv7 = green >= 0xC000 ? 0x05 : 0x06; // yellow, orange
+    else if (red >= 0x8000)
+      cv7 = 0x04; // red
+    else if (green >= 0x8000)
+      cv7 = 0x02; // green
+    else
+      cv7 = 0x03; // blue
+    return cv7;
+  }
+
+  uint8_t _buffer[(uint32_t(GxEPD2_Type::WIDTH) / 2) * page_height];
+  int16_t _page_height, _pages, _current_page;
+};
+
+#endif
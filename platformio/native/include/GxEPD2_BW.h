@@ -0,0 +1,188 @@
+/* Native (host) GxEPD2_BW shim for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Paged 1bpp frame buffer with the same page/buffer layout as GxEPD2_BW
+ * (black = 0 bit, MSB first, page_height rows per page).
+ */
+
+#ifndef __NATIVE_GXEPD2_BW_H__
+#define __NATIVE_GXEPD2_BW_H__
+
+#include "GxEPD2.h"
+
+template <typename GxEPD2_Type, const uint16_t page_height>
+class GxEPD2_BW : public GxEPD2_GFX_BASE_CLASS
+{
+public:
+  GxEPD2_Type epd2;
+
+  GxEPD2_BW(GxEPD2_Type epd2_instance)
+    : GxEPD2_GFX_BASE_CLASS(GxEPD2_Type::WIDTH, GxEPD2_Type::HEIGHT),
+      epd2(epd2_instance)
+  {
+    _page_height = page_height;
+    _pages = (HEIGHT / _page_height) + ((HEIGHT % _page_height) > 0);
+    _current_page = 0;
+    _second_phase = false;
+    setFullWindow();
+  }
+
+  uint16_t pages() { return _pages; }
+  uint16_t pageHeight() { return _page_height; }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override
+  {
+    if ((x < 0) || (x >= width()) || (y < 0) || (y >= height()))
+    {
+      return;
+    }
+    // check rotation, move pixel around if necessary
+    switch (getRotation())
+    {
+    case 1: std::swap(x, y); x = WIDTH - x - 1; break;
+    case 2: x = WIDTH - x - 1; y = HEIGHT - y - 1; break;
+    case 3: std::swap(x, y); y = HEIGHT - y - 1; break;
+    }
+    // adjust for current page
+    y -= _current_page * _page_height;
+    // check if in current page
+    if ((y < 0) || (y >= int16_t(_page_height)))
+    {
+      return;
+    }
+    uint32_t i = x / 8 + uint32_t(y) * (WIDTH / 8);
+    if (color == GxEPD_WHITE)
+    {
+      _buffer[i] = (_buffer[i] | (1 << (7 - x % 8)));
+    }
+    else
+    {
+      _buffer[i] = (_buffer[i] & (0xFF ^ (1 << (7 - x % 8))));
+    }
+  }
+
+  void init(uint32_t serial_diag_bitrate = 0)
+  {
+    epd2.init(serial_diag_bitrate);
+  }
+
+  void init(uint32_t serial_diag_bitrate, bool initial,
+            uint16_t reset_duration = 10, bool pulldown_rst_mode = false)
+  {
+    epd2.init(serial_diag_bitrate, initial, reset_duration,
+              pulldown_rst_mode);
+  }
+
+  void fillScreen(uint16_t color) override
+  {
+    uint8_t data = (color == GxEPD_WHITE) ? 0xFF : 0x00;
+    memset(_buffer, data, sizeof(_buffer));
+  }
+
+  void setFullWindow() {}
+
+  void firstPage()
+  {
+    fillScreen(GxEPD_WHITE);
+    _current_page = 0;
+    _second_phase = false;
+  }
+
+  bool nextPage()
+  {
+    if (1 == _pages)
+    {
+      epd2.writeImage(_buffer, 0, 0, WIDTH, HEIGHT);
+      epd2.refresh(false);
+      if (epd2.hasFastPartialUpdate)
+      {
+        epd2.writeImageAgain(_buffer, 0, 0, WIDTH, HEIGHT);
+      }
+      return false;
+    }
+    uint16_t page_ys = _current_page * _page_height;
+    uint16_t page_ye = _current_page < int16_t(_pages - 1)
+                     ? page_ys + _page_height : HEIGHT;
+    if (!_second_phase)
+    {
+      epd2.writeImage(_buffer, 0, page_ys, WIDTH, page_ye - page_ys);
+    }
+    else
+    {
+      epd2.writeImageAgain(_buffer, 0, page_ys, WIDTH, page_ye - page_ys);
+    }
+    _current_page++;
+    if (_current_page == int16_t(_pages))
+    {
+      _current_page = 0;
+      if (!_second_phase)
+      {
+        epd2.refresh(false);
+        if (epd2.hasFastPartialUpdate)
+        { // the controller's previous image buffer is rewritten page by page
+          _second_phase = true;
+          fillScreen(GxEPD_WHITE);
+          return true;
+        }
+      }
+      return false;
+    }
+    fillScreen(GxEPD_WHITE);
+    return true;
+  }
+
+  void display(bool partial_update_mode = false)
+  {
+    epd2.writeImage(_buffer, 0, 0, WIDTH, _page_height);
+    epd2.refresh(partial_update_mode);
+  }
+
+  void drawInvertedBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
+                          int16_t w, int16_t h, uint16_t color)
+  {
+    int16_t byteWidth = (w + 7) / 8; // Bitmap scanline pad = whole byte
+    uint8_t byte = 0;
+    for (int16_t j = 0; j < h; j++)
+    {
+      for (int16_t i = 0; i < w; i++)
+      {
+        if (i & 7)
+        {
+          byte <<= 1;
+        }
+        else
+        {
+          byte = pgm_read_byte(&bitmap[j * byteWidth + i / 8]);
+        }
+        if (!(byte & 0x80))
+        {
+          drawPixel(x + i, y + j, color);
+        }
+      }
+    }
+  }
+
+  void powerOff() { epd2.powerOff(); }
+  void hibernate() { epd2.hibernate(); }
+
+private:
+  uint8_t _buffer[(uint32_t(GxEPD2_Type::WIDTH) / 8) * page_height];
+  int16_t _page_height, _pages, _current_page;
+  bool _second_phase;
+};
+
+#endif
@@ -0,0 +1,41 @@
+/* Native (host) IPAddress shim for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __NATIVE_IPADDRESS_H__
+#define __NATIVE_IPADDRESS_H__
+
+#include <Arduino.h>
+
+class IPAddress
+{
+public:
+  IPAddress() : _addr{0, 0, 0, 0} {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _addr{a, b, c, d} {}
+
+  String toString() const
+  {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u",
+             _addr[0], _addr[1], _addr[2], _addr[3]);
+    return String(buf);
+  }
+
+private:
+  uint8_t _addr[4];
+};
+
+#endif
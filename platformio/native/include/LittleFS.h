@@ -0,0 +1,84 @@
+/* Native (host) LittleFS shim for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Files are kept in the harness state directory as fs-<name>, with the
+ * slashes of the path replaced, so they survive between simulated wakes the
+ * same way the flash partition does.
+ */
+
+#ifndef __NATIVE_LITTLEFS_H__
+#define __NATIVE_LITTLEFS_H__
+
+#include <cstdio>
+#include <memory>
+
+#include <Arduino.h>
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+namespace fs
+{
+
+class File
+{
+public:
+  File() {}
+  explicit File(FILE *f) : _f(f, fclose) {}
+
+  size_t read(uint8_t *buf, size_t size);
+  int read();
+  size_t write(const uint8_t *buf, size_t size);
+  size_t write(uint8_t c) { return write(&c, 1); }
+  bool seek(uint32_t pos);
+  size_t position() const;
+  size_t size() const;
+  int available() const { return size() - position(); }
+  void flush();
+  void close() { _f.reset(); }
+  operator bool() const { return static_cast<bool>(_f); }
+
+private:
+  std::shared_ptr<FILE> _f;
+};
+
+class LittleFSFS
+{
+public:
+  bool begin(bool formatOnFail = false, const char *basePath = "/littlefs",
+             uint8_t maxOpenFiles = 10, const char *partitionLabel = "spiffs");
+  void end();
+  bool format();
+  File open(const char *path, const char *mode = FILE_READ);
+  bool exists(const char *path);
+  bool remove(const char *path);
+  size_t totalBytes() { return 896 * 1024; }
+  size_t usedBytes();
+
+private:
+  bool _mounted = false;
+
+  bool filePath(const char *path, char *out, size_t size);
+};
+
+} // namespace fs
+
+using fs::File;
+extern fs::LittleFSFS LittleFS;
+
+#endif
@@ -0,0 +1,85 @@
+/* Native (host) Preferences shim for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Non-volatile storage is kept in the harness state directory, one file per
+ * key, so it survives between simulated wakes the same way NVS does.
+ */
+
+#ifndef __NATIVE_PREFERENCES_H__
+#define __NATIVE_PREFERENCES_H__
+
+#include <Arduino.h>
+
+class Preferences
+{
+public:
+  bool begin(const char *name, bool readOnly = false,
+             const char *partition_label = nullptr);
+  void end();
+
+  bool clear();
+  bool remove(const char *key);
+  bool isKey(const char *key);
+
+  size_t putBool(const char *key, bool value);
+  size_t putUChar(const char *key, uint8_t value);
+  size_t putShort(const char *key, int16_t value);
+  size_t putUShort(const char *key, uint16_t value);
+  size_t putInt(const char *key, int32_t value);
+  size_t putUInt(const char *key, uint32_t value);
+  size_t putLong64(const char *key, int64_t value);
+  size_t putULong64(const char *key, uint64_t value);
+  size_t putFloat(const char *key, float value);
+  size_t putString(const char *key, const char *value);
+  size_t putString(const char *key, String value);
+  size_t putBytes(const char *key, const void *value, size_t len);
+
+  bool getBool(const char *key, bool defaultValue = false);
+  uint8_t getUChar(const char *key, uint8_t defaultValue = 0);
+  int16_t getShort(const char *key, int16_t defaultValue = 0);
+  uint16_t getUShort(const char *key, uint16_t defaultValue = 0);
+  int32_t getInt(const char *key, int32_t defaultValue = 0);
+  uint32_t getUInt(const char *key, uint32_t defaultValue = 0);
+  int64_t getLong64(const char *key, int64_t defaultValue = 0);
+  uint64_t getULong64(const char *key, uint64_t defaultValue = 0);
+  float getFloat(const char *key, float defaultValue = NAN);
+  String getString(const char *key, String defaultValue = String());
+  size_t getBytesLength(const char *key);
+  size_t getBytes(const char *key, void *buf, size_t maxLen);
+
+private:
+  bool _started = false;
+  bool _readOnly = false;
+  char _name[16] = {};
+
+  bool keyPath(const char *key, char *path, size_t size);
+  template <typename T> size_t putValue(const char *key, T value)
+  {
+    return putBytes(key, &value, sizeof(value));
+  }
+  template <typename T> T getValue(const char *key, T defaultValue)
+  {
+    T value;
+    if (getBytes(key, &value, sizeof(value)) != sizeof(value))
+    {
+      return defaultValue;
+    }
+    return value;
+  }
+};
+
+#endif
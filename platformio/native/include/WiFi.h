@@ -0,0 +1,76 @@
+/* Native (host) WiFi shim for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* The station interface connects after a simulated association time and
+ * reports a fixed RSSI, both configurable from the native harness.
+ */
+
+#ifndef __NATIVE_WIFI_H__
+#define __NATIVE_WIFI_H__
+
+#include <Arduino.h>
+#include "IPAddress.h"
+#include "WiFiClient.h"
+
+typedef enum {
+  WL_NO_SHIELD        = 255, // for compatibility with WiFi Shield library
+  WL_STOPPED          = 254,
+  WL_IDLE_STATUS      = 0,
+  WL_NO_SSID_AVAIL    = 1,
+  WL_SCAN_COMPLETED   = 2,
+  WL_CONNECTED        = 3,
+  WL_CONNECT_FAILED   = 4,
+  WL_CONNECTION_LOST  = 5,
+  WL_DISCONNECTED     = 6
+} wl_status_t;
+
+typedef enum {
+  WIFI_MODE_NULL = 0,
+  WIFI_MODE_STA,
+  WIFI_MODE_AP,
+  WIFI_MODE_APSTA,
+  WIFI_MODE_MAX
+} wifi_mode_t;
+
+#define WIFI_OFF     WIFI_MODE_NULL
+#define WIFI_STA     WIFI_MODE_STA
+#define WIFI_AP      WIFI_MODE_AP
+#define WIFI_AP_STA  WIFI_MODE_APSTA
+
+class WiFiClass
+{
+public:
+  bool mode(wifi_mode_t m);
+  wl_status_t begin(const char *ssid, const char *passphrase = nullptr);
+  wl_status_t begin(const String &ssid, const String &passphrase)
+  {
+    return begin(ssid.c_str(), passphrase.c_str());
+  }
+  wl_status_t status();
+  bool disconnect(bool wifioff = false, bool eraseap = false);
+  int8_t RSSI();
+  IPAddress localIP();
+
+private:
+  wifi_mode_t _mode = WIFI_MODE_NULL;
+  bool _begun = false;
+  unsigned long _connectAt = 0;
+};
+
+extern WiFiClass WiFi;
+
+#endif
@@ -0,0 +1,67 @@
+/* Native (host) WiFiClient shim for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* A client never opens a socket. HTTPClient attaches the recorded response
+ * body to it and every byte read is charged to the simulated link, so the
+ * time a deserializer spends pulling from the stream includes the transfer
+ * time it would have on the device.
+ */
+
+#ifndef __NATIVE_WIFICLIENT_H__
+#define __NATIVE_WIFICLIENT_H__
+
+#include <Arduino.h>
+
+class WiFiClient : public Stream
+{
+public:
+  virtual ~WiFiClient() {}
+
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t readBytes(char *buffer, size_t length) override;
+  using Stream::readBytes;
+  size_t write(uint8_t c) override { return 1; }
+  size_t write(const uint8_t *buf, size_t size) override { return size; }
+  using Print::write;
+
+  int connect(const char *host, uint16_t port);
+  uint8_t connected();
+  virtual void stop();
+  operator bool() { return connected(); }
+
+  /* Harness side of the emulated connection.
+   */
+  bool nativeIsConnectedTo(const String &host, uint16_t port) const;
+  void nativeConnect(const String &host, uint16_t port);
+  void nativeAttachBody(const uint8_t *body, size_t len);
+  size_t nativeBodyConsumed() const { return _pos; }
+  virtual bool nativeIsSecure() const { return false; }
+
+protected:
+  virtual bool nativeHandshake() { return true; }
+
+  bool _connected = false;
+  String _host;
+  uint16_t _port = 0;
+  const uint8_t *_body = nullptr;
+  size_t _len = 0;
+  size_t _pos = 0;
+};
+
+#endif
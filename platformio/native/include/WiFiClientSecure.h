@@ -0,0 +1,59 @@
+/* Native (host) WiFiClientSecure shim for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Certificates are accepted but not checked; the secure client only differs
+ * from WiFiClient by the extra round trips its handshake is charged.
+ *
+ * A full handshake hands out a session that can be offered for resumption
+ * with mbedtls_ssl_set_session() between a plain start connect() and
+ * startTLS(). The emulated server accepts it for --tls-lifetime seconds and
+ * then only charges one round trip plus --tls-resume.
+ */
+
+#ifndef __NATIVE_WIFICLIENTSECURE_H__
+#define __NATIVE_WIFICLIENTSECURE_H__
+
+#include <mbedtls/ssl.h>
+
+#include "WiFiClient.h"
+
+typedef struct sslclient_context
+{
+  mbedtls_ssl_context ssl_ctx;
+} sslclient_context;
+
+class WiFiClientSecure : public WiFiClient
+{
+public:
+  void setCACert(const char *rootCA) { _CA_cert = rootCA; _insecure = false; }
+  void setInsecure() { _CA_cert = nullptr; _insecure = true; }
+  void setPlainStart() { _stillinPlainStart = true; }
+  int startTLS();
+  void stop() override;
+  bool nativeIsSecure() const override { return true; }
+
+protected:
+  sslclient_context _sslclient = {};
+  sslclient_context *sslclient = &_sslclient;
+  const char *_CA_cert = nullptr;
+  bool _insecure = false;
+  bool _stillinPlainStart = false;
+
+  bool nativeHandshake() override;
+};
+
+#endif
@@ -0,0 +1,39 @@
+/* Native (host) Wire shim for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __NATIVE_WIRE_H__
+#define __NATIVE_WIRE_H__
+
+#include <Arduino.h>
+
+class TwoWire
+{
+public:
+  TwoWire(uint8_t bus_num) : _num(bus_num) {}
+  bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0)
+  {
+    return true;
+  }
+  bool end() { return true; }
+
+private:
+  uint8_t _num;
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,78 @@
+/* Frozen reference copy of the pollutant-concentration-to-aqi library.
+ * Copyright (C) 2022-2024  Luke Marzen
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#ifndef __AQI_REFERENCE_H__
+#define __AQI_REFERENCE_H__
+
+#include "aqi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Same parameters and results as the functions of aqi.h without the
+ * reference_ prefix, see aqi_reference.c.
+ */
+int reference_australia_aqi(float co_8h,  float no2_1h,   float o3_1h,
+                            float o3_4h,  float so2_1h,   float pm10_24h,
+                            float pm2_5_24h);
+
+int reference_canada_aqhi(float no2_3h, float o3_3h, float pm2_5_3h);
+
+int reference_china_aqi(float co_1h,    float co_24h, float no2_1h,
+                        float no2_24h,  float o3_1h,  float o3_8h,
+                        float so2_1h,   float so2_24h,
+                        float pm10_24h, float pm2_5_24h);
+
+int reference_european_union_caqi(float no2_1h,  float o3_1h,
+                                  float pm10_1h, float pm2_5_1h);
+
+int reference_hong_kong_aqhi(float no2_3h,  float o3_3h, float so2_3h,
+                             float pm10_3h, float pm2_5_3h);
+
+int reference_india_aqi(float co_8h,    float nh3_24h, float no2_24h,
+                        float o3_8h,    float pb_24h,  float so2_24h,
+                        float pm10_24h, float pm2_5_24h);
+
+int reference_singapore_psi(float co_8h,    float no2_1h,   float o3_1h,
+                            float o3_8h,    float so2_24h,  float pm10_24h,
+                            float pm2_5_24h);
+
+int reference_south_korea_cai(float co_1h,  float no2_1h,   float o3_1h,
+                              float so2_1h, float pm10_24h, float pm2_5_24h);
+
+int reference_united_kingdom_daqi(float no2_1h,   float o3_8h,
+                                  float so2_15min, float pm10_24h,
+                                  float pm2_5_24h);
+
+int reference_united_states_aqi(float co_8h,    float no2_1h,
+                                float o3_1h,    float o3_8h,
+                                float so2_1h,   float so2_24h,
+                                float pm10_24h, float pm2_5_24h);
+
+int reference_calc_aqi(aqi_scale_t scale,
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,65 @@
+/* Native (host) esp_adc_cal shim for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* The characterization is linear over the 11db range (150mV to 2450mV), which
+ * is also how the harness derives raw readings from --battery.
+ */
+
+#ifndef __NATIVE_ESP_ADC_CAL_H__
+#define __NATIVE_ESP_ADC_CAL_H__
+
+#include <cstdint>
+#include "driver/adc.h"
+
+typedef enum {
+  ESP_ADC_CAL_VAL_EFUSE_VREF = 0,
+  ESP_ADC_CAL_VAL_EFUSE_TP = 1,
+  ESP_ADC_CAL_VAL_DEFAULT_VREF = 2,
+} esp_adc_cal_value_t;
+
+typedef struct {
+  adc_unit_t adc_num;
+  adc_atten_t atten;
+  adc_bits_width_t bit_width;
+  uint32_t coeff_a;
+  uint32_t coeff_b;
+  uint32_t vref;
+} esp_adc_cal_characteristics_t;
+
+#define NATIVE_ADC_MV_MIN  150
+#define NATIVE_ADC_MV_MAX 2450
+
+inline esp_adc_cal_value_t esp_adc_cal_characterize(
+  adc_unit_t adc_num, adc_atten_t atten, adc_bits_width_t bit_width,
+  uint32_t default_vref, esp_adc_cal_characteristics_t *chars)
+{
+  chars->adc_num = adc_num;
+  chars->atten = atten;
+  chars->bit_width = bit_width;
+  chars->coeff_a = NATIVE_ADC_MV_MAX - NATIVE_ADC_MV_MIN;
+  chars->coeff_b = NATIVE_ADC_MV_MIN;
+  chars->vref = default_vref;
+  return ESP_ADC_CAL_VAL_EFUSE_TP;
+}
+
+inline uint32_t esp_adc_cal_raw_to_voltage(
+  uint32_t adc_reading, const esp_adc_cal_characteristics_t *chars)
+{
+  return (adc_reading * chars->coeff_a + 2047) / 4095 + chars->coeff_b;
+}
+
+#endif
@@ -0,0 +1,42 @@
+/* Native (host) esp_rom_crc shim for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Same result as the ROM function: the standard (zlib) CRC-32 when crc is 0,
+ * and crc may be the result of a previous call to continue it.
+ */
+
+#ifndef __NATIVE_ESP_ROM_CRC_H__
+#define __NATIVE_ESP_ROM_CRC_H__
+
+#include <cstdint>
+
+inline uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf,
+                                 uint32_t len)
+{
+  crc = ~crc;
+  for (uint32_t i = 0; i < len; ++i)
+  {
+    crc ^= buf[i];
+    for (int b = 0; b < 8; ++b)
+    {
+      crc = (crc >> 1) ^ (0xedb88320u & -(crc & 1));
+    }
+  }
+  return ~crc;
+}
+
+#endif
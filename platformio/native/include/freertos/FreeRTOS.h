@@ -0,0 +1,39 @@
+/* Native (host) FreeRTOS shim for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Tasks are host threads and semaphores are host condition variables, see
+ * native/src/freertos.cpp for how they share the simulated clock.
+ */
+
+#ifndef __NATIVE_FREERTOS_H__
+#define __NATIVE_FREERTOS_H__
+
+#include <cstdint>
+
+typedef int      BaseType_t;
+typedef unsigned UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE 0
+#define pdTRUE  1
+#define pdFAIL  pdFALSE
+#define pdPASS  pdTRUE
+
+#define portMAX_DELAY  ((TickType_t)0xFFFFFFFFUL)
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+#endif
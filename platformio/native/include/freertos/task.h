@@ -0,0 +1,37 @@
+/* Native (host) FreeRTOS shim for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __NATIVE_FREERTOS_TASK_H__
+#define __NATIVE_FREERTOS_TASK_H__
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct native_task *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char *name,
+                                   uint32_t stackDepth, void *params,
+                                   UBaseType_t priority,
+                                   TaskHandle_t *createdTask,
+                                   BaseType_t coreId);
+// only the calling task (NULL) can be deleted
+void vTaskDelete(TaskHandle_t task);
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task);
+// host threads do not track their stack use, always 0
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+
+#endif
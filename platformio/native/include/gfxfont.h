@@ -0,0 +1,46 @@
+/* Native (host) GFX font structures for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Layout matches Adafruit-GFX-Library so the generated font headers in
+ * lib/esp32-weather-epd-assets/fonts can be used unmodified.
+ */
+
+#ifndef __NATIVE_GFXFONT_H__
+#define __NATIVE_GFXFONT_H__
+
+#include <cstdint>
+
+typedef struct
+{
+  uint16_t bitmapOffset; // Pointer into GFXfont->bitmap
+  uint8_t  width;        // Bitmap dimensions in pixels
+  uint8_t  height;       // Bitmap dimensions in pixels
+  uint8_t  xAdvance;     // Distance to advance cursor (x axis)
+  int8_t   xOffset;      // X dist from cursor pos to UL corner
+  int8_t   yOffset;      // Y dist from cursor pos to UL corner
+} GFXglyph;
+
+typedef struct
+{
+  uint8_t  *bitmap;      // Glyph bitmaps, concatenated
+  GFXglyph *glyph;       // Glyph array
+  uint16_t first;        // ASCII extents (first char)
+  uint16_t last;         // ASCII extents (last char)
+  uint8_t  yAdvance;     // Newline distance (y axis)
+} GFXfont;
+
+#endif
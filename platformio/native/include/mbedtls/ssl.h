@@ -0,0 +1,61 @@
+/* Native (host) mbedTLS session shim for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Only the session calls used for TLS session resumption. A session is what
+ * the emulated server handed out in its handshake, see
+ * WiFiClientSecure::nativeHandshake().
+ */
+
+#ifndef __NATIVE_MBEDTLS_SSL_H__
+#define __NATIVE_MBEDTLS_SSL_H__
+
+#include <cstddef>
+#include <cstdint>
+
+#define MBEDTLS_SSL_SESSION_TICKETS
+
+#define MBEDTLS_ERR_SSL_BAD_INPUT_DATA   -0x7100
+#define MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL -0x6A00
+
+typedef struct mbedtls_ssl_session
+{
+  int64_t start;             // Unix time of the full handshake
+  size_t id_len;
+  unsigned char id[32];
+  uint32_t ticket_lifetime;  // s, lifetime hint sent by the server
+  char native_host[64];      // server that issued the session
+} mbedtls_ssl_session;
+
+typedef struct mbedtls_ssl_context
+{
+  mbedtls_ssl_session session;     // current, or offered for resumption
+  bool                has_session;
+} mbedtls_ssl_context;
+
+void mbedtls_ssl_session_init(mbedtls_ssl_session *session);
+void mbedtls_ssl_session_free(mbedtls_ssl_session *session);
+int mbedtls_ssl_get_session(const mbedtls_ssl_context *ssl,
+                            mbedtls_ssl_session *session);
+int mbedtls_ssl_set_session(mbedtls_ssl_context *ssl,
+                            const mbedtls_ssl_session *session);
+int mbedtls_ssl_session_save(const mbedtls_ssl_session *session,
+                             unsigned char *buf, size_t buf_len,
+                             size_t *olen);
+int mbedtls_ssl_session_load(mbedtls_ssl_session *session,
+                             const unsigned char *buf, size_t len);
+
+#endif
@@ -0,0 +1,140 @@
+/* Native (host) harness interface for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Interface between the Arduino/ESP-IDF shims and the native harness.
+ *
+ * Every wake runs setup() in a forked child process. The child keeps a
+ * simulated clock, tracks heap usage and records phases (WiFi, SNTP, each
+ * HTTP request, rendering, panel refreshes); esp_deep_sleep_start() prints
+ * the wake report, hands the summary to the parent and exits.
+ */
+
+#ifndef __NATIVE_HARNESS_H__
+#define __NATIVE_HARNESS_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+#define NATIVE_MAX_FAILURES 8
+#define NATIVE_MAX_PHASES   64
+
+typedef struct native_failure
+{
+  char match[96];    // substring of "host/uri"
+  int  code;         // HTTP status code or HTTPC_ERROR_*
+} native_failure_t;
+
+typedef struct native_options
+{
+  const char      *fixtures;
+  const char      *state;
+  const char      *frame;
+  int              wakes;
+  int64_t          epoch;        // Unix time at the start of the first wake
+  uint32_t         rttMs;        // network round trip time
+  uint32_t         bandwidthKBps;
+  uint32_t         tlsMs;        // extra time charged for a TLS handshake
+  uint32_t         tlsResumeMs;  // extra time for an abbreviated handshake
+  uint32_t         tlsLifetimeS; // TLS sessions are accepted this long
+  uint32_t         chunkBytes;   // HTTP/1.1 bodies are sent chunked, 0 = not
+  bool             validators;   // send ETag/Last-Modified, answer 304
+  uint32_t         wifiMs;       // time until the station is associated
+  uint32_t         sntpMs;       // time until SNTP reports sync
+  int              wifiStatus;   // wl_status_t reported instead of connecting
+  uint32_t         batteryMv;
+  bool             bmeFound;
+  float            bmeTemp;      // Celsius
+  float            bmeHumidity;  // %
+  uint32_t         heapSize;
+  bool             keepState;
+  bool             quiet;
+  const char      *bench;        // run this benchmark instead of setup()
+  int              numFailures;
+  native_failure_t failures[NATIVE_MAX_FAILURES];
+} native_options_t;
+
+typedef struct native_phase
+{
+  char     name[96];
+  int      depth;
+  int      status;      // HTTP status of a request phase, otherwise 0
+  uint64_t startUs;     // simulated clock at begin
+  uint64_t endUs;       // simulated clock at end
+  uint64_t cpuUs;       // real (host) time spent inside the phase
+  size_t   bytes;       // response body bytes read
+  size_t   heapPeak;    // peak heap usage while the phase was open
+  int      heapMark;
+  bool     open;
+} native_phase_t;
+
+extern native_options_t nativeOpts;
+extern int nativeWakeIndex; // 1-based
+
+// simulated clock, microseconds since the start of the wake
+// (host time elapsed + time charged for waits, transfers and refreshes),
+// kept per task so requests made by concurrent tasks overlap
+uint64_t nativeNowUs();
+uint64_t nativeHostUs();
+void nativeAdvanceUs(uint64_t us);
+
+// heap accounting, see heap.cpp
+void nativeHeapReset();      // start counting from the current usage
+size_t nativeHeapInUse();
+size_t nativeHeapPeak();
+int nativeHeapPushMark();           // start a peak measurement
+size_t nativeHeapPopMark(int mark); // peak since the matching push
+
+// phase recording
+int nativePhaseBegin(const char *name);
+void nativePhaseEnd(int phase);
+native_phase_t *nativePhase(int phase);
+
+// panel statistics, see panel.cpp
+void nativePanelReport();
+void nativePanelSaveFrame(const char *path);
+
+// recorded responses
+bool nativeFixtureOpen(const char *host, const char *uri,
+                       const uint8_t **data, size_t *len,
+                       time_t *modified = nullptr);
+// body with chunked transfer coding, outside the heap the firmware uses
+bool nativeFixtureChunked(const uint8_t *body, size_t len, size_t chunk,
+                          const uint8_t **data, size_t *chunkedLen);
+int nativeInjectedFailure(const char *host, const char *uri);
+
+// files kept between wakes
+void nativeStatePath(char *buf, size_t size, const char *name);
+
+// micro benchmarks, run with --bench NAME instead of simulating wakes
+typedef struct native_bench
+{
+  const char *name;
+  const char *description;
+  void (*run)();
+} native_bench_t;
+
+// returns 1 if a benchmark called nativeBenchFail(), 2 if name is unknown
+int nativeBenchMain(const char *name);
+double nativeBenchNs(void (*fn)(void *), void *arg, int repeat);
+// a benchmark that checks results found a wrong one
+void nativeBenchFail();
+
+// called from esp_deep_sleep_start()
+[[noreturn]] void nativeWakeEnd(uint64_t sleepUs);
+
+#endif
@@ -0,0 +1,509 @@
+/* Native (host) Adafruit_GFX shim for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+
+#include "Adafruit_GFX.h"
+
+static inline void swapInt16(int16_t &a, int16_t &b)
+{
+  int16_t t = a;
+  a = b;
+  b = t;
+}
+
+Adafruit_GFX::Adafruit_GFX(int16_t w, int16_t h)
+  : WIDTH(w), HEIGHT(h), _width(w), _height(h), cursor_x(0), cursor_y(0),
+    textcolor(0xFFFF), textbgcolor(0xFFFF), textsize_x(1), textsize_y(1),
+    rotation(0), wrap(true), _cp437(false), gfxFont(nullptr)
+{
+}
+
+void Adafruit_GFX::writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                             uint16_t color)
+{
+  int16_t steep = abs(y1 - y0) > abs(x1 - x0);
+  if (steep)
+  {
+    swapInt16(x0, y0);
+    swapInt16(x1, y1);
+  }
+  if (x0 > x1)
+  {
+    swapInt16(x0, x1);
+    swapInt16(y0, y1);
+  }
+
+  int16_t dx = x1 - x0;
+  int16_t dy = abs(y1 - y0);
+  int16_t err = dx / 2;
+  int16_t ystep = (y0 < y1) ? 1 : -1;
+
+  for (; x0 <= x1; x0++)
+  {
+    if (steep)
+    {
+      writePixel(y0, x0, color);
+    }
+    else
+    {
+      writePixel(x0, y0, color);
+    }
+    err -= dy;
+    if (err < 0)
+    {
+      y0 += ystep;
+      err += dx;
+    }
+  }
+}
+
+void Adafruit_GFX::writePixel(int16_t x, int16_t y, uint16_t color)
+{
+  drawPixel(x, y, color);
+}
+
+void Adafruit_GFX::writeFastVLine(int16_t x, int16_t y, int16_t h,
+                                  uint16_t color)
+{
+  drawFastVLine(x, y, h, color);
+}
+
+void Adafruit_GFX::writeFastHLine(int16_t x, int16_t y, int16_t w,
+                                  uint16_t color)
+{
+  drawFastHLine(x, y, w, color);
+}
+
+void Adafruit_GFX::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                                 uint16_t color)
+{
+  fillRect(x, y, w, h, color);
+}
+
+void Adafruit_GFX::drawFastVLine(int16_t x, int16_t y, int16_t h,
+                                 uint16_t color)
+{
+  startWrite();
+  writeLine(x, y, x, y + h - 1, color);
+  endWrite();
+}
+
+void Adafruit_GFX::drawFastHLine(int16_t x, int16_t y, int16_t w,
+                                 uint16_t color)
+{
+  startWrite();
+  writeLine(x, y, x + w - 1, y, color);
+  endWrite();
+}
+
+void Adafruit_GFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                            uint16_t color)
+{
+  startWrite();
+  for (int16_t i = x; i < x + w; i++)
+  {
+    writeFastVLine(i, y, h, color);
+  }
+  endWrite();
+}
+
+void Adafruit_GFX::fillScreen(uint16_t color)
+{
+  fillRect(0, 0, _width, _height, color);
+}
+
+void Adafruit_GFX::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                            uint16_t color)
+{
+  if (x0 == x1)
+  {
+    if (y0 > y1)
+    {
+      swapInt16(y0, y1);
+    }
+    drawFastVLine(x0, y0, y1 - y0 + 1, color);
+  }
+  else if (y0 == y1)
+  {
+    if (x0 > x1)
+    {
+      swapInt16(x0, x1);
+    }
+    drawFastHLine(x0, y0, x1 - x0 + 1, color);
+  }
+  else
+  {
+    startWrite();
+    writeLine(x0, y0, x1, y1, color);
+    endWrite();
+  }
+}
+
+void Adafruit_GFX::drawRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                            uint16_t color)
+{
+  startWrite();
+  writeFastHLine(x, y, w, color);
+  writeFastHLine(x, y + h - 1, w, color);
+  writeFastVLine(x, y, h, color);
+  writeFastVLine(x + w - 1, y, h, color);
+  endWrite();
+}
+
+void Adafruit_GFX::drawCircle(int16_t x0, int16_t y0, int16_t r,
+                              uint16_t color)
+{
+  int16_t f = 1 - r;
+  int16_t ddF_x = 1;
+  int16_t ddF_y = -2 * r;
+  int16_t x = 0;
+  int16_t y = r;
+
+  startWrite();
+  writePixel(x0, y0 + r, color);
+  writePixel(x0, y0 - r, color);
+  writePixel(x0 + r, y0, color);
+  writePixel(x0 - r, y0, color);
+  while (x < y)
+  {
+    if (f >= 0)
+    {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+    writePixel(x0 + x, y0 + y, color);
+    writePixel(x0 - x, y0 + y, color);
+    writePixel(x0 + x, y0 - y, color);
+    writePixel(x0 - x, y0 - y, color);
+    writePixel(x0 + y, y0 + x, color);
+    writePixel(x0 - y, y0 + x, color);
+    writePixel(x0 + y, y0 - x, color);
+    writePixel(x0 - y, y0 - x, color);
+  }
+  endWrite();
+}
+
+void Adafruit_GFX::fillCircle(int16_t x0, int16_t y0, int16_t r,
+                              uint16_t color)
+{
+  startWrite();
+  writeFastVLine(x0, y0 - r, 2 * r + 1, color);
+  int16_t f = 1 - r;
+  int16_t ddF_x = 1;
+  int16_t ddF_y = -2 * r;
+  int16_t x = 0;
+  int16_t y = r;
+  int16_t px = x;
+  int16_t py = y;
+  while (x < y)
+  {
+    if (f >= 0)
+    {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+    if (x < (y + 1))
+    {
+      writeFastVLine(x0 + x, y0 - y, 2 * y + 1, color);
+      writeFastVLine(x0 - x, y0 - y, 2 * y + 1, color);
+    }
+    if (y != py)
+    {
+      writeFastVLine(x0 + py, y0 - px, 2 * px + 1, color);
+      writeFastVLine(x0 - py, y0 - px, 2 * px + 1, color);
+      py = y;
+    }
+    px = x;
+  }
+  endWrite();
+}
+
+void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
+                              int16_t w, int16_t h, uint16_t color)
+{
+  int16_t byteWidth = (w + 7) / 8;
+  uint8_t b = 0;
+
+  startWrite();
+  for (int16_t j = 0; j < h; j++, y++)
+  {
+    for (int16_t i = 0; i < w; i++)
+    {
+      if (i & 7)
+      {
+        b <<= 1;
+      }
+      else
+      {
+        b = pgm_read_byte(&bitmap[j * byteWidth + i / 8]);
+      }
+      if (b & 0x80)
+      {
+        writePixel(x + i, y, color);
+      }
+    }
+  }
+  endWrite();
+}
+
+void Adafruit_GFX::setRotation(uint8_t x)
+{
+  rotation = (x & 3);
+  switch (rotation)
+  {
+  case 0:
+  case 2:
+    _width = WIDTH;
+    _height = HEIGHT;
+    break;
+  case 1:
+  case 3:
+    _width = HEIGHT;
+    _height = WIDTH;
+    break;
+  }
+}
+
+void Adafruit_GFX::setTextSize(uint8_t s_x, uint8_t s_y)
+{
+  textsize_x = (s_x > 0) ? s_x : 1;
+  textsize_y = (s_y > 0) ? s_y : 1;
+}
+
+void Adafruit_GFX::setFont(const GFXfont *f)
+{
+  if (f)
+  {
+    if (!gfxFont)
+    { // Switching from classic to new font behavior.
+      // Move cursor pos down 6 pixels so it's on baseline.
+      cursor_y += 6;
+    }
+  }
+  else if (gfxFont)
+  { // Switching from new to classic font behavior.
+    // Move cursor pos up 6 pixels so it's at top-left of char.
+    cursor_y -= 6;
+  }
+  gfxFont = const_cast<GFXfont *>(f);
+}
+
+/* Only custom (GFXfont) fonts are supported, the renderer never uses the
+ * classic built-in font.
+ */
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c,
+                            uint16_t color, uint16_t bg, uint8_t size_x,
+                            uint8_t size_y)
+{
+  if (!gfxFont)
+  {
+    return;
+  }
+
+  c -= static_cast<uint8_t>(pgm_read_byte(&gfxFont->first));
+  const GFXglyph *glyph = &gfxFont->glyph[c];
+  const uint8_t *bitmap = gfxFont->bitmap;
+
+  uint16_t bo = pgm_read_word(&glyph->bitmapOffset);
+  uint8_t w = pgm_read_byte(&glyph->width);
+  uint8_t h = pgm_read_byte(&glyph->height);
+  int8_t xo = pgm_read_byte(&glyph->xOffset);
+  int8_t yo = pgm_read_byte(&glyph->yOffset);
+  uint8_t xx, yy, bits = 0, bit = 0;
+  int16_t xo16 = 0, yo16 = 0;
+
+  if (size_x > 1 || size_y > 1)
+  {
+    xo16 = xo;
+    yo16 = yo;
+  }
+
+  startWrite();
+  for (yy = 0; yy < h; yy++)
+  {
+    for (xx = 0; xx < w; xx++)
+    {
+      if (!(bit++ & 7))
+      {
+        bits = pgm_read_byte(&bitmap[bo++]);
+      }
+      if (bits & 0x80)
+      {
+        if (size_x == 1 && size_y == 1)
+        {
+          writePixel(x + xo + xx, y + yo + yy, color);
+        }
+        else
+        {
+          writeFillRect(x + (xo16 + xx) * size_x, y + (yo16 + yy) * size_y,
+                        size_x, size_y, color);
+        }
+      }
+      bits <<= 1;
+    }
+  }
+  endWrite();
+}
+
+size_t Adafruit_GFX::write(uint8_t c)
+{
+  if (!gfxFont)
+  {
+    return 1;
+  }
+
+  if (c == '\n')
+  {
+    cursor_x = 0;
+    cursor_y += static_cast<int16_t>(textsize_y)
+                * static_cast<uint8_t>(pgm_read_byte(&gfxFont->yAdvance));
+  }
+  else if (c != '\r')
+  {
+    uint8_t first = pgm_read_byte(&gfxFont->first);
+    if ((c >= first) && (c <= static_cast<uint8_t>(pgm_read_byte(&gfxFont->last))))
+    {
+      const GFXglyph *glyph = &gfxFont->glyph[c - first];
+      uint8_t w = pgm_read_byte(&glyph->width);
+      uint8_t h = pgm_read_byte(&glyph->height);
+      if ((w > 0) && (h > 0))
+      { // Is there an associated bitmap?
+        int16_t xo = static_cast<int8_t>(pgm_read_byte(&glyph->xOffset));
+        if (wrap && ((cursor_x + textsize_x * (xo + w)) > _width))
+        {
+          cursor_x = 0;
+          cursor_y += static_cast<int16_t>(textsize_y)
+                      * static_cast<uint8_t>(pgm_read_byte(&gfxFont->yAdvance));
+        }
+        drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x,
+                 textsize_y);
+      }
+      cursor_x += static_cast<uint8_t>(pgm_read_byte(&glyph->xAdvance))
+                  * static_cast<int16_t>(textsize_x);
+    }
+  }
+  return 1;
+}
+
+void Adafruit_GFX::charBounds(unsigned char c, int16_t *x, int16_t *y,
+                              int16_t *minx, int16_t *miny, int16_t *maxx,
+                              int16_t *maxy)
+{
+  if (!gfxFont)
+  {
+    return;
+  }
+
+  if (c == '\n')
+  { // Newline?
+    *x = 0;  // Reset x to zero, advance y by one line
+    *y += textsize_y * static_cast<uint8_t>(pgm_read_byte(&gfxFont->yAdvance));
+  }
+  else if (c != '\r')
+  { // Not a carriage return; is normal char
+    uint8_t first = pgm_read_byte(&gfxFont->first);
+    uint8_t last = pgm_read_byte(&gfxFont->last);
+    if ((c >= first) && (c <= last))
+    { // Char present in this font?
+      const GFXglyph *glyph = &gfxFont->glyph[c - first];
+      uint8_t gw = pgm_read_byte(&glyph->width);
+      uint8_t gh = pgm_read_byte(&glyph->height);
+      uint8_t xa = pgm_read_byte(&glyph->xAdvance);
+      int8_t xo = pgm_read_byte(&glyph->xOffset);
+      int8_t yo = pgm_read_byte(&glyph->yOffset);
+      if (wrap && ((*x + ((static_cast<int16_t>(xo) + gw) * textsize_x)) > _width))
+      {
+        *x = 0; // Reset x to zero, advance y by one line
+        *y += textsize_y
+              * static_cast<uint8_t>(pgm_read_byte(&gfxFont->yAdvance));
+      }
+      int16_t tsx = static_cast<int16_t>(textsize_x);
+      int16_t tsy = static_cast<int16_t>(textsize_y);
+      int16_t x1 = *x + xo * tsx;
+      int16_t y1 = *y + yo * tsy;
+      int16_t x2 = x1 + gw * tsx - 1;
+      int16_t y2 = y1 + gh * tsy - 1;
+      if (x1 < *minx)
+      {
+        *minx = x1;
+      }
+      if (y1 < *miny)
+      {
+        *miny = y1;
+      }
+      if (x2 > *maxx)
+      {
+        *maxx = x2;
+      }
+      if (y2 > *maxy)
+      {
+        *maxy = y2;
+      }
+      *x += xa * tsx;
+    }
+  }
+}
+
+void Adafruit_GFX::getTextBounds(const char *str, int16_t x, int16_t y,
+                                 int16_t *x1, int16_t *y1, uint16_t *w,
+                                 uint16_t *h)
+{
+  uint8_t c; // Current character
+  int16_t minx = 0x7FFF, miny = 0x7FFF, maxx = -1, maxy = -1; // Bound rect
+  // Bound rect is intentionally initialized inverted, so 1st char sets it
+
+  *x1 = x; // Initial position is value passed in
+  *y1 = y;
+  *w = *h = 0; // Initial size is zero
+
+  while ((c = *str++))
+  {
+    // charBounds() modifies x/y to advance for each character,
+    // and min/max x/y are updated to incrementally build bounding rect.
+    charBounds(c, &x, &y, &minx, &miny, &maxx, &maxy);
+  }
+
+  if (maxx >= minx)
+  {              // If legit string bounds were found...
+    *x1 = minx;  // Update x1 to least X coord,
+    *w = maxx - minx + 1; // And w to bound rect width
+  }
+  if (maxy >= miny)
+  { // Same for height
+    *y1 = miny;
+    *h = maxy - miny + 1;
+  }
+}
+
+void Adafruit_GFX::getTextBounds(const String &str, int16_t x, int16_t y,
+                                 int16_t *x1, int16_t *y1, uint16_t *w,
+                                 uint16_t *h)
+{
+  if (str.length() != 0)
+  {
+    getTextBounds(str.c_str(), x, y, x1, y1, w, h);
+  }
+}
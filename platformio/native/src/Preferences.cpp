@@ -0,0 +1,246 @@
+/* Native (host) Preferences (NVS) shim for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+#include <dirent.h>
+#include <unistd.h>
+
+#include <Preferences.h>
+
+#include "native_harness.h"
+
+/* Keys are stored as <state>/nvs-<namespace>-<key>. NVS limits both names to
+ * 15 characters, longer ones are rejected the same way.
+ */
+bool Preferences::keyPath(const char *key, char *path, size_t size)
+{
+  if (!_started || !key || strlen(key) > 15)
+  {
+    return false;
+  }
+  char name[48];
+  snprintf(name, sizeof(name), "nvs-%s-%s", _name, key);
+  nativeStatePath(path, size, name);
+  return true;
+}
+
+bool Preferences::begin(const char *name, bool readOnly,
+                        const char *partition_label)
+{
+  if (_started || !name || strlen(name) > 15)
+  {
+    return false;
+  }
+  snprintf(_name, sizeof(_name), "%s", name);
+  _readOnly = readOnly;
+  _started = true;
+  return true;
+}
+
+void Preferences::end()
+{
+  _started = false;
+}
+
+bool Preferences::clear()
+{
+  if (!_started || _readOnly)
+  {
+    return false;
+  }
+  char prefix[24];
+  snprintf(prefix, sizeof(prefix), "nvs-%s-", _name);
+  DIR *dir = opendir(nativeOpts.state);
+  if (!dir)
+  {
+    return true;
+  }
+  while (struct dirent *e = readdir(dir))
+  {
+    if (strncmp(e->d_name, prefix, strlen(prefix)) == 0)
+    {
+      char path[512];
+      nativeStatePath(path, sizeof(path), e->d_name);
+      unlink(path);
+    }
+  }
+  closedir(dir);
+  return true;
+}
+
+bool Preferences::remove(const char *key)
+{
+  char path[512];
+  if (_readOnly || !keyPath(key, path, sizeof(path)))
+  {
+    return false;
+  }
+  return unlink(path) == 0;
+}
+
+bool Preferences::isKey(const char *key)
+{
+  char path[512];
+  return keyPath(key, path, sizeof(path)) && access(path, F_OK) == 0;
+}
+
+size_t Preferences::putBytes(const char *key, const void *value, size_t len)
+{
+  char path[512];
+  if (_readOnly || !keyPath(key, path, sizeof(path)))
+  {
+    return 0;
+  }
+  FILE *f = fopen(path, "wb");
+  if (!f)
+  {
+    return 0;
+  }
+  size_t n = fwrite(value, 1, len, f);
+  fclose(f);
+  return n;
+}
+
+size_t Preferences::getBytesLength(const char *key)
+{
+  char path[512];
+  if (!keyPath(key, path, sizeof(path)))
+  {
+    return 0;
+  }
+  FILE *f = fopen(path, "rb");
+  if (!f)
+  {
+    return 0;
+  }
+  fseek(f, 0, SEEK_END);
+  long len = ftell(f);
+  fclose(f);
+  return len > 0 ? static_cast<size_t>(len) : 0;
+}
+
+size_t Preferences::getBytes(const char *key, void *buf, size_t maxLen)
+{
+  char path[512];
+  if (!keyPath(key, path, sizeof(path)))
+  {
+    return 0;
+  }
+  FILE *f = fopen(path, "rb");
+  if (!f)
+  {
+    return 0;
+  }
+  size_t n = fread(buf, 1, maxLen, f);
+  fclose(f);
+  return n;
+}
+
+size_t Preferences::putBool(const char *key, bool value)
+{
+  return putValue<uint8_t>(key, value);
+}
+size_t Preferences::putUChar(const char *key, uint8_t value)
+{
+  return putValue(key, value);
+}
+size_t Preferences::putShort(const char *key, int16_t value)
+{
+  return putValue(key, value);
+}
+size_t Preferences::putUShort(const char *key, uint16_t value)
+{
+  return putValue(key, value);
+}
+size_t Preferences::putInt(const char *key, int32_t value)
+{
+  return putValue(key, value);
+}
+size_t Preferences::putUInt(const char *key, uint32_t value)
+{
+  return putValue(key, value);
+}
+size_t Preferences::putLong64(const char *key, int64_t value)
+{
+  return putValue(key, value);
+}
+size_t Preferences::putULong64(const char *key, uint64_t value)
+{
+  return putValue(key, value);
+}
+size_t Preferences::putFloat(const char *key, float value)
+{
+  return putValue(key, value);
+}
+size_t Preferences::putString(const char *key, const char *value)
+{
+  return putBytes(key, value, strlen(value));
+}
+size_t Preferences::putString(const char *key, String value)
+{
+  return putBytes(key, value.c_str(), value.length());
+}
+
+bool Preferences::getBool(const char *key, bool defaultValue)
+{
+  return getValue<uint8_t>(key, defaultValue) != 0;
+}
+uint8_t Preferences::getUChar(const char *key, uint8_t defaultValue)
+{
+  return getValue(key, defaultValue);
+}
+int16_t Preferences::getShort(const char *key, int16_t defaultValue)
+{
+  return getValue(key, defaultValue);
+}
+uint16_t Preferences::getUShort(const char *key, uint16_t defaultValue)
+{
+  return getValue(key, defaultValue);
+}
+int32_t Preferences::getInt(const char *key, int32_t defaultValue)
+{
+  return getValue(key, defaultValue);
+}
+uint32_t Preferences::getUInt(const char *key, uint32_t defaultValue)
+{
+  return getValue(key, defaultValue);
+}
+int64_t Preferences::getLong64(const char *key, int64_t defaultValue)
+{
+  return getValue(key, defaultValue);
+}
+uint64_t Preferences::getULong64(const char *key, uint64_t defaultValue)
+{
+  return getValue(key, defaultValue);
+}
+float Preferences::getFloat(const char *key, float defaultValue)
+{
+  return getValue(key, defaultValue);
+}
+String Preferences::getString(const char *key, String defaultValue)
+{
+  if (!isKey(key))
+  {
+    return defaultValue;
+  }
+  size_t len = getBytesLength(key);
+  char *buf = static_cast<char *>(malloc(len + 1));
+  buf[getBytes(key, buf, len)] = '\0';
+  String value(buf);
+  free(buf);
+  return value;
+}
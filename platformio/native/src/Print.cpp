@@ -0,0 +1,181 @@
+/* Native (host) Print, Stream and Serial shims for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+#include "Arduino.h"
+#include "native_harness.h"
+
+HardwareSerial Serial;
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+  size_t n = 0;
+  while (size--)
+  {
+    n += write(*buffer++);
+  }
+  return n;
+}
+
+size_t Print::write(const char *str)
+{
+  return str ? write(str, strlen(str)) : 0;
+}
+
+size_t Print::printf(const char *format, ...)
+{
+  char loc_buf[64];
+  va_list arg;
+  va_start(arg, format);
+  int len = vsnprintf(loc_buf, sizeof(loc_buf), format, arg);
+  va_end(arg);
+  if (len < 0)
+  {
+    return 0;
+  }
+  if (static_cast<size_t>(len) < sizeof(loc_buf))
+  {
+    return write(loc_buf, len);
+  }
+  char *temp = static_cast<char *>(malloc(len + 1));
+  if (!temp)
+  {
+    return 0;
+  }
+  va_start(arg, format);
+  vsnprintf(temp, len + 1, format, arg);
+  va_end(arg);
+  len = write(temp, len);
+  free(temp);
+  return len;
+}
+
+size_t Print::print(const String &s)          { return write(s.c_str(), s.length()); }
+size_t Print::print(const char str[])         { return write(str); }
+size_t Print::print(char c)                   { return write(static_cast<uint8_t>(c)); }
+size_t Print::print(unsigned char n, int base){ return print(String(n, base)); }
+size_t Print::print(int n, int base)          { return print(String(n, base)); }
+size_t Print::print(unsigned int n, int base) { return print(String(n, base)); }
+size_t Print::print(long n, int base)         { return print(String(n, base)); }
+size_t Print::print(unsigned long n, int base){ return print(String(n, base)); }
+size_t Print::print(long long n, int base)    { return print(String(n, base)); }
+size_t Print::print(unsigned long long n, int base)
+{
+  return print(String(n, base));
+}
+size_t Print::print(double n, int digits)     { return print(String(n, digits)); }
+
+size_t Print::print(struct tm *timeinfo, const char *format)
+{
+  const char *f = format ? format : "%c";
+  char buf[64];
+  size_t written = strftime(buf, sizeof(buf), f, timeinfo);
+  return write(buf, written);
+}
+
+size_t Print::println(void)                   { return print("\r\n"); }
+size_t Print::println(const String &s)        { return print(s) + println(); }
+size_t Print::println(const char str[])       { return print(str) + println(); }
+size_t Print::println(char c)                 { return print(c) + println(); }
+size_t Print::println(unsigned char n, int b) { return print(n, b) + println(); }
+size_t Print::println(int n, int b)           { return print(n, b) + println(); }
+size_t Print::println(unsigned int n, int b)  { return print(n, b) + println(); }
+size_t Print::println(long n, int b)          { return print(n, b) + println(); }
+size_t Print::println(unsigned long n, int b) { return print(n, b) + println(); }
+size_t Print::println(long long n, int b)     { return print(n, b) + println(); }
+size_t Print::println(unsigned long long n, int b)
+{
+  return print(n, b) + println();
+}
+size_t Print::println(double n, int digits)   { return print(n, digits) + println(); }
+size_t Print::println(struct tm *timeinfo, const char *format)
+{
+  return print(timeinfo, format) + println();
+}
+
+int Stream::timedRead()
+{
+  unsigned long start = millis();
+  do
+  {
+    int c = read();
+    if (c >= 0)
+    {
+      return c;
+    }
+  } while (millis() - start < _timeout);
+  return -1;
+}
+
+size_t Stream::readBytes(char *buffer, size_t length)
+{
+  size_t count = 0;
+  while (count < length)
+  {
+    int c = timedRead();
+    if (c < 0)
+    {
+      break;
+    }
+    *buffer++ = static_cast<char>(c);
+    ++count;
+  }
+  return count;
+}
+
+String Stream::readString()
+{
+  String ret;
+  int c = timedRead();
+  while (c >= 0)
+  {
+    ret.concat(static_cast<char>(c));
+    c = timedRead();
+  }
+  return ret;
+}
+
+/* Serial output goes to stdout unless the harness runs with --quiet. The
+ * esp32 core terminates println() with "\r\n", the carriage returns are
+ * dropped to keep terminal logs clean.
+ */
+size_t HardwareSerial::write(uint8_t c)
+{
+  if (c != '\r' && !nativeOpts.quiet)
+  {
+    fputc(c, stdout);
+  }
+  return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+  for (size_t i = 0; i < size; ++i)
+  {
+    write(buffer[i]);
+  }
+  return size;
+}
+
+void HardwareSerial::flush()
+{
+  fflush(stdout);
+}
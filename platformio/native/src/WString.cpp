@@ -0,0 +1,574 @@
+/* Native (host) String shim for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "WString.h"
+
+/* Formats an integer in the given base, same output as the esp32 core.
+ */
+static void formatInteger(char *out, unsigned long long value, bool negative,
+                          unsigned char base)
+{
+  char tmp[66];
+  int i = 0;
+  if (base < 2 || base > 36)
+  {
+    base = 10;
+  }
+  do
+  {
+    int digit = value % base;
+    tmp[i++] = digit < 10 ? '0' + digit : 'a' + digit - 10;
+    value /= base;
+  } while (value);
+  if (negative)
+  {
+    tmp[i++] = '-';
+  }
+  int j = 0;
+  while (i)
+  {
+    out[j++] = tmp[--i];
+  }
+  out[j] = '\0';
+}
+
+String::String(const char *cstr)
+{
+  if (cstr)
+  {
+    copy(cstr, strlen(cstr));
+  }
+}
+
+String::String(const char *cstr, unsigned int length)
+{
+  if (cstr)
+  {
+    copy(cstr, length);
+  }
+}
+
+String::String(const String &str)
+{
+  copy(str.c_str(), str.len);
+}
+
+String::String(String &&rval)
+{
+  move(rval);
+}
+
+String::String(char c)
+{
+  char tmp[2] = {c, '\0'};
+  copy(tmp, 1);
+}
+
+String::String(unsigned char value, unsigned char base)
+  : String(static_cast<unsigned long long>(value), base) {}
+String::String(int value, unsigned char base)
+  : String(static_cast<long long>(value), base) {}
+String::String(unsigned int value, unsigned char base)
+  : String(static_cast<unsigned long long>(value), base) {}
+String::String(long value, unsigned char base)
+  : String(static_cast<long long>(value), base) {}
+String::String(unsigned long value, unsigned char base)
+  : String(static_cast<unsigned long long>(value), base) {}
+
+String::String(long long value, unsigned char base)
+{
+  char tmp[68];
+  bool negative = value < 0 && base == 10;
+  unsigned long long magnitude = negative
+                               ? 0ULL - static_cast<unsigned long long>(value)
+                               : static_cast<unsigned long long>(value);
+  formatInteger(tmp, magnitude, negative, base);
+  copy(tmp, strlen(tmp));
+}
+
+String::String(unsigned long long value, unsigned char base)
+{
+  char tmp[68];
+  formatInteger(tmp, value, false, base);
+  copy(tmp, strlen(tmp));
+}
+
+String::String(float value, unsigned int decimalPlaces)
+  : String(static_cast<double>(value), decimalPlaces) {}
+
+String::String(double value, unsigned int decimalPlaces)
+{
+  char tmp[64];
+  snprintf(tmp, sizeof(tmp), "%.*f", static_cast<int>(decimalPlaces), value);
+  copy(tmp, strlen(tmp));
+}
+
+String::~String()
+{
+  free(buf);
+}
+
+void String::invalidate()
+{
+  free(buf);
+  buf = nullptr;
+  len = capacity = 0;
+}
+
+bool String::changeBuffer(unsigned int maxStrLen)
+{
+  char *newbuf = static_cast<char *>(realloc(buf, maxStrLen + 1));
+  if (newbuf)
+  {
+    buf = newbuf;
+    capacity = maxStrLen;
+    return true;
+  }
+  return false;
+}
+
+bool String::reserve(unsigned int size)
+{
+  if (buf && capacity >= size)
+  {
+    return true;
+  }
+  if (changeBuffer(size))
+  {
+    if (len == 0)
+    {
+      buf[0] = '\0';
+    }
+    return true;
+  }
+  return false;
+}
+
+String &String::copy(const char *cstr, unsigned int length)
+{
+  if (!reserve(length))
+  {
+    invalidate();
+    return *this;
+  }
+  len = length;
+  memmove(buf, cstr, length);
+  buf[len] = '\0';
+  return *this;
+}
+
+void String::move(String &rhs)
+{
+  if (this != &rhs)
+  {
+    free(buf);
+    buf = rhs.buf;
+    len = rhs.len;
+    capacity = rhs.capacity;
+    rhs.buf = nullptr;
+    rhs.len = rhs.capacity = 0;
+  }
+}
+
+String &String::operator=(const String &rhs)
+{
+  if (this == &rhs)
+  {
+    return *this;
+  }
+  return copy(rhs.c_str(), rhs.len);
+}
+
+String &String::operator=(const char *cstr)
+{
+  if (cstr)
+  {
+    return copy(cstr, strlen(cstr));
+  }
+  invalidate();
+  return *this;
+}
+
+String &String::operator=(String &&rval)
+{
+  move(rval);
+  return *this;
+}
+
+bool String::concat(const char *cstr, unsigned int length)
+{
+  if (!cstr)
+  {
+    return false;
+  }
+  if (length == 0)
+  {
+    return true;
+  }
+  // cstr may point into our own buffer
+  if (buf && cstr >= buf && cstr < buf + len)
+  {
+    size_t offset = cstr - buf;
+    if (!reserve(len + length))
+    {
+      return false;
+    }
+    cstr = buf + offset;
+  }
+  else if (!reserve(len + length))
+  {
+    return false;
+  }
+  memmove(buf + len, cstr, length);
+  len += length;
+  buf[len] = '\0';
+  return true;
+}
+
+bool String::concat(const String &s)
+{
+  return concat(s.c_str(), s.len);
+}
+
+bool String::concat(const char *cstr)
+{
+  return cstr ? concat(cstr, strlen(cstr)) : false;
+}
+
+bool String::concat(char c)
+{
+  return concat(&c, 1);
+}
+
+bool String::concat(unsigned char num)      { return concat(String(num)); }
+bool String::concat(int num)                { return concat(String(num)); }
+bool String::concat(unsigned int num)       { return concat(String(num)); }
+bool String::concat(long num)               { return concat(String(num)); }
+bool String::concat(unsigned long num)      { return concat(String(num)); }
+bool String::concat(long long num)          { return concat(String(num)); }
+bool String::concat(unsigned long long num) { return concat(String(num)); }
+bool String::concat(float num)              { return concat(String(num)); }
+bool String::concat(double num)             { return concat(String(num)); }
+
+int String::compareTo(const String &s) const
+{
+  return strcmp(c_str(), s.c_str());
+}
+
+bool String::equals(const String &s) const
+{
+  return len == s.len && compareTo(s) == 0;
+}
+
+bool String::equals(const char *cstr) const
+{
+  return strcmp(c_str(), cstr ? cstr : "") == 0;
+}
+
+bool String::equalsIgnoreCase(const String &s) const
+{
+  return len == s.len && strcasecmp(c_str(), s.c_str()) == 0;
+}
+
+bool String::startsWith(const String &prefix) const
+{
+  return len >= prefix.len
+         && strncmp(c_str(), prefix.c_str(), prefix.len) == 0;
+}
+
+bool String::endsWith(const String &suffix) const
+{
+  return len >= suffix.len
+         && strcmp(c_str() + len - suffix.len, suffix.c_str()) == 0;
+}
+
+char String::charAt(unsigned int index) const
+{
+  return operator[](index);
+}
+
+void String::setCharAt(unsigned int index, char c)
+{
+  if (index < len)
+  {
+    buf[index] = c;
+  }
+}
+
+char String::operator[](unsigned int index) const
+{
+  return index < len ? buf[index] : '\0';
+}
+
+char &String::operator[](unsigned int index)
+{
+  static char dummy_writable_char;
+  if (index >= len || !buf)
+  {
+    dummy_writable_char = '\0';
+    return dummy_writable_char;
+  }
+  return buf[index];
+}
+
+int String::indexOf(char ch, unsigned int fromIndex) const
+{
+  if (fromIndex >= len)
+  {
+    return -1;
+  }
+  const char *p = strchr(buf + fromIndex, ch);
+  return p ? static_cast<int>(p - buf) : -1;
+}
+
+int String::indexOf(const String &str, unsigned int fromIndex) const
+{
+  if (fromIndex >= len)
+  {
+    return -1;
+  }
+  const char *p = strstr(buf + fromIndex, str.c_str());
+  return p ? static_cast<int>(p - buf) : -1;
+}
+
+int String::lastIndexOf(char ch) const
+{
+  return len ? lastIndexOf(ch, len - 1) : -1;
+}
+
+int String::lastIndexOf(char ch, unsigned int fromIndex) const
+{
+  if (fromIndex >= len)
+  {
+    return -1;
+  }
+  for (int i = fromIndex; i >= 0; --i)
+  {
+    if (buf[i] == ch)
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+int String::lastIndexOf(const String &str) const
+{
+  return len >= str.len ? lastIndexOf(str, len - str.len) : -1;
+}
+
+int String::lastIndexOf(const String &str, unsigned int fromIndex) const
+{
+  if (str.len == 0 || len == 0 || str.len > len)
+  {
+    return -1;
+  }
+  if (fromIndex >= len)
+  {
+    fromIndex = len - 1;
+  }
+  for (int i = fromIndex; i >= 0; --i)
+  {
+    if (strncmp(buf + i, str.c_str(), str.len) == 0)
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+String String::substring(unsigned int beginIndex) const
+{
+  return substring(beginIndex, len);
+}
+
+String String::substring(unsigned int left, unsigned int right) const
+{
+  if (left > right)
+  {
+    unsigned int tmp = left;
+    left = right;
+    right = tmp;
+  }
+  if (left >= len)
+  {
+    return String();
+  }
+  if (right > len)
+  {
+    right = len;
+  }
+  return String(buf + left, right - left);
+}
+
+void String::replace(char find, char replace)
+{
+  for (unsigned int i = 0; i < len; ++i)
+  {
+    if (buf[i] == find)
+    {
+      buf[i] = replace;
+    }
+  }
+}
+
+void String::replace(const String &find, const String &replace)
+{
+  if (len == 0 || find.len == 0)
+  {
+    return;
+  }
+  String out;
+  out.reserve(len);
+  unsigned int i = 0;
+  while (i < len)
+  {
+    if (strncmp(buf + i, find.c_str(), find.len) == 0)
+    {
+      out.concat(replace);
+      i += find.len;
+    }
+    else
+    {
+      out.concat(buf[i]);
+      ++i;
+    }
+  }
+  move(out);
+}
+
+void String::remove(unsigned int index)
+{
+  remove(index, static_cast<unsigned int>(-1));
+}
+
+void String::remove(unsigned int index, unsigned int count)
+{
+  if (index >= len)
+  {
+    return;
+  }
+  if (count > len - index)
+  {
+    count = len - index;
+  }
+  memmove(buf + index, buf + index + count, len - index - count);
+  len -= count;
+  buf[len] = '\0';
+}
+
+void String::toLowerCase()
+{
+  for (unsigned int i = 0; i < len; ++i)
+  {
+    buf[i] = tolower(static_cast<unsigned char>(buf[i]));
+  }
+}
+
+void String::toUpperCase()
+{
+  for (unsigned int i = 0; i < len; ++i)
+  {
+    buf[i] = toupper(static_cast<unsigned char>(buf[i]));
+  }
+}
+
+void String::trim()
+{
+  if (len == 0)
+  {
+    return;
+  }
+  unsigned int begin = 0;
+  while (begin < len && isspace(static_cast<unsigned char>(buf[begin])))
+  {
+    ++begin;
+  }
+  unsigned int end = len;
+  while (end > begin && isspace(static_cast<unsigned char>(buf[end - 1])))
+  {
+    --end;
+  }
+  len = end - begin;
+  memmove(buf, buf + begin, len);
+  buf[len] = '\0';
+}
+
+long String::toInt() const
+{
+  return atol(c_str());
+}
+
+float String::toFloat() const
+{
+  return static_cast<float>(atof(c_str()));
+}
+
+double String::toDouble() const
+{
+  return atof(c_str());
+}
+
+String operator+(const String &lhs, const String &rhs)
+{
+  String s(lhs);
+  s.concat(rhs);
+  return s;
+}
+
+String operator+(const String &lhs, const char *rhs)
+{
+  String s(lhs);
+  s.concat(rhs);
+  return s;
+}
+
+String operator+(const char *lhs, const String &rhs)
+{
+  String s(lhs);
+  s.concat(rhs);
+  return s;
+}
+
+String operator+(const String &lhs, char rhs)
+{
+  String s(lhs);
+  s.concat(rhs);
+  return s;
+}
+
+#define NATIVE_STRING_SUM(T)                    \
+  String operator+(const String &lhs, T rhs)    \
+  {                                             \
+    String s(lhs);                              \
+    s.concat(rhs);                              \
+    return s;                                   \
+  }
+NATIVE_STRING_SUM(int)
+NATIVE_STRING_SUM(unsigned int)
+NATIVE_STRING_SUM(long)
+NATIVE_STRING_SUM(unsigned long)
+NATIVE_STRING_SUM(long long)
+NATIVE_STRING_SUM(unsigned long long)
+NATIVE_STRING_SUM(float)
+NATIVE_STRING_SUM(double)
+#undef NATIVE_STRING_SUM
@@ -0,0 +1,253 @@
+/* Native (host) Arduino core and peripheral shims for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include <ctime>
+
+#include <Arduino.h>
+#include <Adafruit_BME280.h>
+#include <esp_adc_cal.h>
+#include <esp_sntp.h>
+#include <SPI.h>
+#include <WiFi.h>
+#include <Wire.h>
+
+#include "native_harness.h"
+
+EspClass ESP;
+WiFiClass WiFi;
+TwoWire Wire(0);
+SPIClass SPI;
+
+static uint64_t sleepTimerUs = 0;
+static int sntpPhase = -1;
+static int wifiPhase = -1;
+
+/* Time spent waiting is charged to the simulated clock instead of sleeping,
+ * so a wake that would take 15 s on the device finishes in milliseconds.
+ */
+unsigned long millis()
+{
+  return static_cast<unsigned long>(nativeNowUs() / 1000ULL);
+}
+
+unsigned long micros()
+{
+  return static_cast<unsigned long>(nativeNowUs());
+}
+
+void delay(uint32_t ms)
+{
+  nativeAdvanceUs(ms * 1000ULL);
+}
+
+void delayMicroseconds(uint32_t us)
+{
+  nativeAdvanceUs(us);
+}
+
+void yield()
+{
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+}
+
+int digitalRead(uint8_t pin)
+{
+  return LOW;
+}
+
+/* Inverse of esp_adc_cal_raw_to_voltage() for the battery voltage divider,
+ * see readBatteryVoltage().
+ */
+uint16_t analogRead(uint8_t pin)
+{
+  long mv = static_cast<long>(nativeOpts.batteryMv / 2) - NATIVE_ADC_MV_MIN;
+  long raw = mv * 4095 / (NATIVE_ADC_MV_MAX - NATIVE_ADC_MV_MIN);
+  return static_cast<uint16_t>(constrain(raw, 0L, 4095L));
+}
+
+esp_err_t gpio_hold_en(gpio_num_t gpio_num)
+{
+  return ESP_OK;
+}
+
+esp_err_t gpio_hold_dis(gpio_num_t gpio_num)
+{
+  return ESP_OK;
+}
+
+void gpio_deep_sleep_hold_en(void)
+{
+}
+
+/* The firmware only ever reads wall clock time through time() and
+ * getLocalTime(), both follow the simulated clock starting at --epoch.
+ */
+extern "C" time_t time(time_t *t)
+{
+  time_t now = static_cast<time_t>(nativeOpts.epoch
+                                   + nativeNowUs() / 1000000ULL);
+  if (t)
+  {
+    *t = now;
+  }
+  return now;
+}
+
+void configTzTime(const char *tz, const char *server1, const char *server2,
+                  const char *server3)
+{
+  setenv("TZ", tz, 1);
+  tzset();
+  sntpPhase = nativePhaseBegin("sntp");
+}
+
+sntp_sync_status_t sntp_get_sync_status(void)
+{
+  if (WiFi.status() != WL_CONNECTED
+   || nativePhase(sntpPhase) == nullptr
+   || nativeNowUs() - nativePhase(sntpPhase)->startUs
+        < nativeOpts.sntpMs * 1000ULL)
+  {
+    return SNTP_SYNC_STATUS_RESET;
+  }
+  nativePhaseEnd(sntpPhase);
+  return SNTP_SYNC_STATUS_COMPLETED;
+}
+
+bool getLocalTime(struct tm *info, uint32_t ms)
+{
+  if (sntpPhase < 0)
+  {
+    return false; // time was never configured, like an RTC after power on
+  }
+  time_t now = time(nullptr);
+  localtime_r(&now, info);
+  return true;
+}
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us)
+{
+  sleepTimerUs = time_in_us;
+  return ESP_OK;
+}
+
+void esp_deep_sleep_start(void)
+{
+  nativeWakeEnd(sleepTimerUs);
+}
+
+uint32_t EspClass::getHeapSize()
+{
+  return nativeOpts.heapSize;
+}
+
+uint32_t EspClass::getFreeHeap()
+{
+  return nativeOpts.heapSize - nativeHeapInUse();
+}
+
+uint32_t EspClass::getMinFreeHeap()
+{
+  return nativeOpts.heapSize - nativeHeapPeak();
+}
+
+uint32_t EspClass::getMaxAllocHeap()
+{
+  return getFreeHeap();
+}
+
+bool WiFiClass::mode(wifi_mode_t m)
+{
+  _mode = m;
+  if (m == WIFI_MODE_NULL)
+  {
+    _begun = false;
+  }
+  return true;
+}
+
+wl_status_t WiFiClass::begin(const char *ssid, const char *passphrase)
+{
+  _begun = true;
+  _connectAt = millis() + nativeOpts.wifiMs;
+  wifiPhase = nativePhaseBegin("wifi");
+  return status();
+}
+
+wl_status_t WiFiClass::status()
+{
+  if (!_begun || _mode == WIFI_MODE_NULL)
+  {
+    return WL_DISCONNECTED;
+  }
+  if (nativeOpts.wifiStatus >= 0)
+  {
+    return static_cast<wl_status_t>(nativeOpts.wifiStatus);
+  }
+  if (millis() < _connectAt)
+  {
+    return WL_DISCONNECTED;
+  }
+  nativePhaseEnd(wifiPhase);
+  return WL_CONNECTED;
+}
+
+bool WiFiClass::disconnect(bool wifioff, bool eraseap)
+{
+  nativePhaseEnd(wifiPhase);
+  _begun = false;
+  return true;
+}
+
+int8_t WiFiClass::RSSI()
+{
+  return -55;
+}
+
+IPAddress WiFiClass::localIP()
+{
+  return IPAddress(192, 168, 1, 42);
+}
+
+bool Adafruit_BME280::begin(uint8_t addr, TwoWire *theWire)
+{
+  delay(2); // sensor power up and calibration read
+  return nativeOpts.bmeFound;
+}
+
+float Adafruit_BME280::readTemperature(void)
+{
+  return nativeOpts.bmeTemp;
+}
+
+float Adafruit_BME280::readPressure(void)
+{
+  return 101325.0f;
+}
+
+float Adafruit_BME280::readHumidity(void)
+{
+  return nativeOpts.bmeHumidity;
+}
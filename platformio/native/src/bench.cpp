@@ -0,0 +1,94 @@
+/* Native (host) micro benchmarks for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include "native_harness.h"
+
+// bench_*.cpp
+void benchUsgsDistance();
+void benchRenderFrame();
+void benchBlit();
+void benchFont();
+void benchAqi();
+
+static const native_bench_t benches[] = {
+  {"usgs-distance", "distance to 10k events: haversine, prefilter, batch, parse",
+   benchUsgsDistance},
+  {"render-frame", "dashboard frame per panel: paged, display list, full frame",
+   benchRenderFrame},
+  {"blit", "bitmaps and glyphs: drawPixel per pixel, byte blit", benchBlit},
+  {"font", "text: glyph bitmaps vs FONT_COMPRESS runs, speed and flash",
+   benchFont},
+  {"aqi", "AQI scales: checked against a frozen reference, ns/call",
+   benchAqi},
+};
+
+static int failures = 0;
+
+void nativeBenchFail()
+{
+  ++failures;
+}
+
+/* Returns the fastest of repeat calls to fn, in nanoseconds.
+ */
+double nativeBenchNs(void (*fn)(void *), void *arg, int repeat)
+{
+  double best = 0;
+  for (int i = 0; i < repeat; ++i)
+  {
+    auto start = std::chrono::steady_clock::now();
+    fn(arg);
+    double ns = std::chrono::duration<double, std::nano>(
+                  std::chrono::steady_clock::now() - start).count();
+    if (i == 0 || ns < best)
+    {
+      best = ns;
+    }
+  }
+  return best;
+}
+
+int nativeBenchMain(const char *name)
+{
+  bool list = !strcmp(name, "list");
+  for (const native_bench_t &b : benches)
+  {
+    if (list)
+    {
+      printf("%-20s %s\n", b.name, b.description);
+    }
+    else if (!strcmp(name, b.name) || !strcmp(name, "all"))
+    {
+      printf("[bench] %s\n", b.name);
+      b.run();
+      if (strcmp(name, "all"))
+      {
+        return failures ? 1 : 0;
+      }
+    }
+  }
+  if (list || !strcmp(name, "all"))
+  {
+    return failures ? 1 : 0;
+  }
+  fprintf(stderr, "unknown benchmark '%s', try --bench list\n", name);
+  return 2;
+}
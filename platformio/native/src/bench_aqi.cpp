@@ -0,0 +1,427 @@
+/* Native (host) benchmark and differential check of the AQI library for
+ * esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <vector>
+
+#include <aqi.h>
+
+#include "aqi_reference.h"
+#include "native_harness.h"
+
+#define BENCH_AQI_PARAMS 10     // most parameters of a scale
+#define BENCH_AQI_ULPS   2      // floats checked on each side of a boundary
+#define BENCH_AQI_RANDOM 200000 // random concentrations checked per scale
+#define BENCH_AQI_CALC   20000  // random hourly samples checked per scale
+#define BENCH_AQI_SHOWN  4      // mismatches printed per scale
+#define BENCH_AQI_TIMED  4096   // concentrations per timed run
+#define BENCH_AQI_HOURS  64     // hourly samples per timed run
+#define BENCH_AQI_REPEAT 20
+
+// each scale with its parameters taken from an array, as the library and as
+// the reference computes it
+#define BENCH_AQI_SCALE(fn, ...)                                               \
+  static int lib_##fn(const float *c) { return fn(__VA_ARGS__); }              \
+  static int ref_##fn(const float *c) { return reference_##fn(__VA_ARGS__); }
+
+BENCH_AQI_SCALE(australia_aqi, c[0], c[1], c[2], c[3], c[4], c[5], c[6])
+BENCH_AQI_SCALE(canada_aqhi, c[0], c[1], c[2])
+BENCH_AQI_SCALE(china_aqi, c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7],
+                c[8], c[9])
+BENCH_AQI_SCALE(european_union_caqi, c[0], c[1], c[2], c[3])
+BENCH_AQI_SCALE(hong_kong_aqhi, c[0], c[1], c[2], c[3], c[4])
+BENCH_AQI_SCALE(india_aqi, c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7])
+BENCH_AQI_SCALE(singapore_psi, c[0], c[1], c[2], c[3], c[4], c[5], c[6])
+BENCH_AQI_SCALE(south_korea_cai, c[0], c[1], c[2], c[3], c[4], c[5])
+BENCH_AQI_SCALE(united_kingdom_daqi, c[0], c[1], c[2], c[3], c[4])
+BENCH_AQI_SCALE(united_states_aqi, c[0], c[1], c[2], c[3], c[4], c[5], c[6],
+                c[7])
+
+typedef struct aqi_scale_case
+{
+  const char  *name;
+  aqi_scale_t  scale;
+  int          params;
+  int        (*lib)(const float *c);
+  int        (*ref)(const float *c);
+} aqi_scale_case_t;
+
+#define BENCH_AQI_CASE(fn, scale, params) \
+  {#fn, scale, params, lib_##fn, ref_##fn}
+
+// same order as aqi_scale_t
+static const aqi_scale_case_t cases[] = {
+  BENCH_AQI_CASE(australia_aqi,       AUSTRALIA_AQI,       7),
+  BENCH_AQI_CASE(canada_aqhi,         CANADA_AQHI,         3),
+  BENCH_AQI_CASE(china_aqi,           CHINA_AQI,          10),
+  BENCH_AQI_CASE(european_union_caqi, EUROPEAN_UNION_CAQI, 4),
+  BENCH_AQI_CASE(hong_kong_aqhi,      HONG_KONG_AQHI,      5),
+  BENCH_AQI_CASE(india_aqi,           INDIA_AQI,           8),
+  BENCH_AQI_CASE(singapore_psi,       SINGAPORE_PSI,       7),
+  BENCH_AQI_CASE(south_korea_cai,     SOUTH_KOREA_CAI,     6),
+  BENCH_AQI_CASE(united_kingdom_daqi, UNITED_KINGDOM_DAQI, 5),
+  BENCH_AQI_CASE(united_states_aqi,   UNITED_STATES_AQI,   8),
+};
+
+// concentrations that are not measurements
+static const float specials[] = {
+  std::numeric_limits<float>::quiet_NaN(),
+  -std::numeric_limits<float>::quiet_NaN(),
+  INFINITY,
+  -INFINITY,
+  -0.f,
+  std::numeric_limits<float>::denorm_min(),
+  FLT_MIN,
+  -FLT_MIN,
+  -1e-3f,
+  -1.f,
+  -100.f,
+  -1e6f,
+  1e6f,
+  1e9f,
+  1e30f,
+  FLT_MAX,
+  -FLT_MAX,
+};
+
+typedef struct aqi_points
+{
+  std::vector<float> all;     // ascending, then the specials
+  size_t             typical; // all[0, typical) are within 0 to 2000
+} aqi_points_t;
+
+typedef struct aqi_check
+{
+  const aqi_scale_case_t *s;
+  long                    checked;
+  long                    mismatches;
+} aqi_check_t;
+
+/* xorshift32, deterministic so runs check the same concentrations. */
+static uint32_t nextRandom(uint32_t &x)
+{
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return x;
+}
+
+/* Adds x and the BENCH_AQI_ULPS floats on each side of it.
+ */
+static void addNeighbours(std::vector<float> &v, double x)
+{
+  float lo = static_cast<float>(x);
+  float hi = lo;
+  v.push_back(lo);
+  for (int i = 0; i < BENCH_AQI_ULPS; ++i)
+  {
+    lo = nextafterf(lo, -INFINITY);
+    hi = nextafterf(hi, INFINITY);
+    v.push_back(lo);
+    v.push_back(hi);
+  }
+}
+
+/* The concentrations every parameter is swept over.
+ *
+ * The published breakpoints are all multiples of 0.001 below 10, of 0.1
+ * below 2000 or integers, so every one of them is checked together with the
+ * floats just past it. The US scale truncates after converting to ppm or ppb,
+ * its boundaries are multiples of the conversion factors. A log spaced grid
+ * fills the rest, then the specials follow.
+ */
+static void makePoints(aqi_points_t &p)
+{
+  std::vector<float> &v = p.all;
+  for (int k = 0; k <= 10000; ++k)
+  {
+    addNeighbours(v, k / 1000.0);
+  }
+  for (int k = 0; k <= 20000; ++k)
+  {
+    addNeighbours(v, k / 10.0);
+  }
+  for (int k = 2000; k <= 20000; ++k)
+  {
+    addNeighbours(v, k);
+  }
+  for (int k = 20000; k <= 100000; k += 10)
+  {
+    addNeighbours(v, k);
+  }
+
+  // truncate_float() of united_states_aqi()
+  static const struct
+  {
+    double factor;
+    double step;
+    int    steps;
+  } units[] = {
+    {1145.6, 0.1,   600},  // co, ppm to 1 decimal place
+    {1963.2, 0.001, 700},  // o3, ppm to 3 decimal places
+    {1.8816, 1,     2100}, // no2, ppb
+    {8.4744, 1,     1100}, // so2, ppb
+  };
+  for (const auto &u : units)
+  {
+    for (int k = 0; k <= u.steps; ++k)
+    {
+      addNeighbours(v, k * u.step * u.factor);
+    }
+  }
+
+  // 1e-3 to 1e5, 2000 per decade
+  for (int k = -6000; k <= 10000; ++k)
+  {
+    v.push_back(static_cast<float>(pow(10.0, k / 2000.0)));
+  }
+
+  std::sort(v.begin(), v.end());
+  v.erase(std::unique(v.begin(), v.end()), v.end());
+  p.typical = std::upper_bound(v.begin(), v.end(), 2000.f) - v.begin();
+  v.insert(v.end(), std::begin(specials), std::end(specials));
+}
+
+/* A random concentration, sometimes a special one.
+ */
+static float randomPoint(const aqi_points_t &p, uint32_t &x)
+{
+  uint32_t r = nextRandom(x);
+  if (r % 16 == 0)
+  {
+    return specials[(r >> 4) % (sizeof(specials) / sizeof(specials[0]))];
+  }
+  return p.all[(r >> 4) % p.typical];
+}
+
+static void printArgs(const float *c, int n)
+{
+  for (int i = 0; i < n; ++i)
+  {
+    printf("%s%.9g", i ? ", " : "", c[i]);
+  }
+}
+
+static void check(aqi_check_t &k, const float *c)
+{
+  ++k.checked;
+  int lib = k.s->lib(c);
+  int ref = k.s->ref(c);
+  if (lib != ref && k.mismatches++ < BENCH_AQI_SHOWN)
+  {
+    printf("  MISMATCH: %s(", k.s->name);
+    printArgs(c, k.s->params);
+    printf(") = %d, reference %d\n", lib, ref);
+  }
+}
+
+/* Sweeps each parameter over every point with the others at 0, then at a
+ * random background, then checks random concentrations of all parameters.
+ */
+static void checkScale(aqi_check_t &k, const aqi_points_t &p, uint32_t &x)
+{
+  const int n = k.s->params;
+  float background[BENCH_AQI_PARAMS] = {};
+  for (int pass = 0; pass < 2; ++pass)
+  {
+    for (int i = 0; i < n; ++i)
+    {
+      float c[BENCH_AQI_PARAMS];
+      std::copy(background, background + n, c);
+      for (float v : p.all)
+      {
+        c[i] = v;
+        check(k, c);
+      }
+    }
+    for (int i = 0; i < n; ++i)
+    {
+      background[i] = p.all[nextRandom(x) % p.typical];
+    }
+  }
+
+  for (int r = 0; r < BENCH_AQI_RANDOM; ++r)
+  {
+    float c[BENCH_AQI_PARAMS];
+    for (int i = 0; i < n; ++i)
+    {
+      c[i] = randomPoint(p, x);
+    }
+    check(k, c);
+  }
+}
+
+typedef struct aqi_hours
+{
+  float  samples[9][24];
+  bool   missing[9]; // passed as NULL
+} aqi_hours_t;
+
+static void randomHours(aqi_hours_t &h, const aqi_points_t &p, uint32_t &x)
+{
+  for (int i = 0; i < 9; ++i)
+  {
+    h.missing[i] = nextRandom(x) % 8 == 0;
+    for (float &s : h.samples[i])
+    {
+      s = randomPoint(p, x);
+    }
+  }
+}
+
+template <int (*calc)(aqi_scale_t, const float *, const float *,
+                      const float *, const float *, const float *,
+                      const float *, const float *, const float *,
+                      const float *)>
+static int calcHours(aqi_scale_t scale, const aqi_hours_t &h)
+{
+  const float *a[9];
+  for (int i = 0; i < 9; ++i)
+  {
+    a[i] = h.missing[i] ? nullptr : h.samples[i];
+  }
+  return calc(scale, a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7], a[8]);
+}
+
+static int calcAverages(aqi_scale_t scale,
+             const float co[24],  const float nh3[24],  const float no[24],
+             const float no2[24], const float o3[24],   const float pb[24],
+             const float so2[24], const float pm10[24], const float pm2_5[24])
+{
+  aqi_averages_t avg;
+  aqi_averages(&avg, scale, co, nh3, no, no2, o3, pb, so2, pm10, pm2_5);
+  return calc_aqi_averages(scale, &avg);
+}
+
+/* calc_aqi() and calc_aqi_averages() of random hourly samples, some pollutants
+ * missing.
+ */
+static void checkCalc(aqi_check_t &k, const aqi_points_t &p, uint32_t &x)
+{
+  aqi_hours_t h;
+  for (int r = 0; r < BENCH_AQI_CALC; ++r)
+  {
+    randomHours(h, p, x);
+    ++k.checked;
+    int lib = calcHours<calc_aqi>(k.s->scale, h);
+    int ref = calcHours<reference_calc_aqi>(k.s->scale, h);
+    if (lib != ref && k.mismatches++ < BENCH_AQI_SHOWN)
+    {
+      printf("  MISMATCH: calc_aqi(%s) = %d, reference %d\n", k.s->name, lib,
+             ref);
+    }
+    int avg = calcHours<calcAverages>(k.s->scale, h);
+    if (avg != ref && k.mismatches++ < BENCH_AQI_SHOWN)
+    {
+      printf("  MISMATCH: calc_aqi_averages(%s) = %d, reference %d\n",
+             k.s->name, avg, ref);
+    }
+  }
+}
+
+typedef struct aqi_run
+{
+  const aqi_scale_case_t *s;
+  const float            *c;     // BENCH_AQI_TIMED x params
+  const aqi_hours_t      *hours; // BENCH_AQI_HOURS
+  bool                    reference;
+  int                     sum;
+} aqi_run_t;
+
+static void runScale(void *arg)
+{
+  aqi_run_t &run = *static_cast<aqi_run_t *>(arg);
+  int (*fn)(const float *) = run.reference ? run.s->ref : run.s->lib;
+  int sum = 0;
+  for (int i = 0; i < BENCH_AQI_TIMED; ++i)
+  {
+    sum += fn(run.c + i * run.s->params);
+  }
+  run.sum += sum;
+}
+
+static void runCalc(void *arg)
+{
+  aqi_run_t &run = *static_cast<aqi_run_t *>(arg);
+  int sum = 0;
+  for (int i = 0; i < BENCH_AQI_HOURS; ++i)
+  {
+    sum += run.reference
+         ? calcHours<reference_calc_aqi>(run.s->scale, run.hours[i])
+         : calcHours<calc_aqi>(run.s->scale, run.hours[i]);
+  }
+  run.sum += sum;
+}
+
+static double nsPerCall(void (*fn)(void *), aqi_run_t &run, bool reference,
+                        int calls)
+{
+  run.reference = reference;
+  return nativeBenchNs(fn, &run, BENCH_AQI_REPEAT) / calls;
+}
+
+void benchAqi()
+{
+  aqi_points_t p;
+  makePoints(p);
+  uint32_t x = 2463534242u;
+
+  printf("  %zu concentrations per parameter, at 0 and at a background, %d "
+         "random\n", p.all.size(), BENCH_AQI_RANDOM);
+  printf("  %-20s %10s %8s %8s %8s %8s %8s\n", "", "checked", "mismatch",
+         "ns/call", "ref ns", "calc ns", "ref calc");
+  long mismatches = 0;
+  for (const aqi_scale_case_t &s : cases)
+  {
+    aqi_check_t k = {&s, 0, 0};
+    checkScale(k, p, x);
+    checkCalc(k, p, x);
+    mismatches += k.mismatches;
+
+    // timed with typical concentrations, every pollutant given
+    std::vector<float> c(BENCH_AQI_TIMED * s.params);
+    for (float &v : c)
+    {
+      v = p.all[nextRandom(x) % p.typical];
+    }
+    std::vector<aqi_hours_t> hours(BENCH_AQI_HOURS);
+    for (aqi_hours_t &h : hours)
+    {
+      randomHours(h, p, x);
+      std::fill(std::begin(h.missing), std::end(h.missing), false);
+    }
+    aqi_run_t run = {&s, c.data(), hours.data(), false, 0};
+    double lib = nsPerCall(runScale, run, false, BENCH_AQI_TIMED);
+    double ref = nsPerCall(runScale, run, true, BENCH_AQI_TIMED);
+    double calc = nsPerCall(runCalc, run, false, BENCH_AQI_HOURS);
+    double refCalc = nsPerCall(runCalc, run, true, BENCH_AQI_HOURS);
+
+    printf("  %-20s %10ld %8ld %8.1f %8.1f %8.1f %8.1f\n", s.name, k.checked,
+           k.mismatches, lib, ref, calc, refCalc);
+  }
+
+  if (mismatches)
+  {
+    printf("  MISMATCH: %ld results differ from the reference\n", mismatches);
+    nativeBenchFail();
+  }
+}
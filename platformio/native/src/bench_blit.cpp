@@ -0,0 +1,183 @@
+/* Native (host) benchmark of drawing bitmaps and glyphs into the frame for
+ * esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+
+#include <GxEPD2_BW.h>
+#include <GxEPD2_3C.h>
+
+#include "frame_buffer.h"
+#include "native_harness.h"
+
+#include "fonts/FreeSans/FreeSans_12pt8b.h"
+#include "fonts/FreeSans/FreeSans_48pt8b_temperature.h"
+#include "icons/196x196/wi_day_sunny_196x196.h"
+#include "icons/96x96/wi_day_sunny_96x96.h"
+#include "icons/64x64/wi_cloudy_64x64.h"
+#include "icons/48x48/air_filter_48x48.h"
+
+#define BENCH_BLIT_REPEAT 20
+#define BENCH_BLIT_COUNT  200 // bitmaps or strings drawn per run
+
+/* Drivers that drop the frame, only the drawing is timed. */
+class BenchEPDBW : public GxEPD2_750_T7
+{
+public:
+  using GxEPD2_750_T7::GxEPD2_750_T7;
+  void writeImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w,
+                  int16_t h, bool invert = false, bool mirror_y = false,
+                  bool pgm = false) {}
+  void writeImageAgain(const uint8_t bitmap[], int16_t x, int16_t y,
+                       int16_t w, int16_t h, bool invert = false,
+                       bool mirror_y = false, bool pgm = false) {}
+  void refresh(bool partial_update_mode = false) {}
+};
+
+class BenchEPD3C : public GxEPD2_750c_Z08
+{
+public:
+  using GxEPD2_750c_Z08::GxEPD2_750c_Z08;
+  void writeImage(const uint8_t *black, const uint8_t *color, int16_t x,
+                  int16_t y, int16_t w, int16_t h) {}
+  void refresh(bool partial_update_mode = false) {}
+};
+
+// drawPixel() for every pixel, in one page as large as the frame
+typedef GxEPD2_BW<BenchEPDBW, BenchEPDBW::HEIGHT> bench_pixel_bw_t;
+typedef GxEPD2_3C<BenchEPD3C, BenchEPD3C::HEIGHT> bench_pixel_3c_t;
+// blitted a byte at a time
+typedef FrameBufferEPD<BenchEPDBW, FRAME_BW, GxEPD_BLACK> bench_blit_bw_t;
+typedef FrameBufferEPD<BenchEPD3C, FRAME_3C, GxEPD_RED> bench_blit_3c_t;
+
+typedef struct blit_case
+{
+  const char    *name;
+  const uint8_t *bitmap;  // nullptr for text
+  int16_t        size;    // bitmap width and height
+  int16_t        offset;  // added to the byte aligned x
+  const GFXfont *font;
+  const char    *text;
+} blit_case_t;
+
+static const blit_case_t cases[] = {
+  {"196x196 icon, aligned", wi_day_sunny_196x196, 196, 0, nullptr, nullptr},
+  {"196x196 icon, x + 3", wi_day_sunny_196x196, 196, 3, nullptr, nullptr},
+  {"96x96 icon, aligned", wi_day_sunny_96x96, 96, 0, nullptr, nullptr},
+  {"96x96 icon, x + 5", wi_day_sunny_96x96, 96, 5, nullptr, nullptr},
+  {"64x64 icon, x + 1", wi_cloudy_64x64, 64, 1, nullptr, nullptr},
+  {"48x48 icon, x + 7", air_filter_48x48, 48, 7, nullptr, nullptr},
+  {"FreeSans 12pt text", nullptr, 0, 0, &FreeSans_12pt8b,
+   "Wednesday, October 14 1013 hPa 58% 12 mph"},
+  {"FreeSans 48pt text", nullptr, 0, 0, &FreeSans_48pt8b_temperature,
+   "21\260"},
+};
+
+typedef struct blit_run
+{
+  Adafruit_GFX      *display;
+  const blit_case_t *c;
+} blit_run_t;
+
+/* Pixels a run covers, the areas of the bitmaps or glyphs drawn.
+ */
+static double casePixels(const blit_case_t &c)
+{
+  if (c.bitmap)
+  {
+    return double(c.size) * c.size * BENCH_BLIT_COUNT;
+  }
+  double px = 0;
+  uint16_t first = c.font->first;
+  for (const char *p = c.text; *p; ++p)
+  {
+    uint8_t ch = static_cast<uint8_t>(*p);
+    if (ch >= first && ch <= c.font->last)
+    {
+      const GFXglyph &g = c.font->glyph[ch - first];
+      px += g.width * g.height;
+    }
+  }
+  return px * BENCH_BLIT_COUNT;
+}
+
+template <typename Display>
+static void runCase(void *arg)
+{
+  blit_run_t &run = *static_cast<blit_run_t *>(arg);
+  Display &d = *static_cast<Display *>(run.display);
+  const blit_case_t &c = *run.c;
+  for (int i = 0; i < BENCH_BLIT_COUNT; ++i)
+  {
+    // spread over the panel, so every page row and byte column is used
+    int16_t x = ((i * 72) % 600) + c.offset;
+    int16_t y = (i * 37) % 300;
+    if (c.bitmap)
+    {
+      d.drawInvertedBitmap(x, y, c.bitmap, c.size, c.size, GxEPD_BLACK);
+    }
+    else
+    {
+      d.setFont(c.font);
+      d.setTextColor(GxEPD_BLACK);
+      d.setCursor(x / 4, y + 100);
+      d.print(c.text);
+    }
+  }
+}
+
+template <typename Display>
+static double mpxPerSecond(Display &d, const blit_case_t &c)
+{
+  blit_run_t run = {&d, &c};
+  double ns = nativeBenchNs(runCase<Display>, &run, BENCH_BLIT_REPEAT);
+  return casePixels(c) / ns * 1e3;
+}
+
+template <typename PixelDisplay, typename BlitDisplay>
+static void report(const char *panel, PixelDisplay &pixel, BlitDisplay &blit)
+{
+  pixel.init(0);
+  pixel.setTextWrap(false); // as initDisplay()
+  pixel.firstPage();
+  blit.init(0);
+  blit.setTextWrap(false);
+  blit.firstPage();
+  for (const blit_case_t &c : cases)
+  {
+    double before = mpxPerSecond(pixel, c);
+    double after = mpxPerSecond(blit, c);
+    printf("  %-3s %-24s %10.1f %10.1f %8.1fx\n", panel, c.name, before,
+           after, after / before);
+  }
+}
+
+void benchBlit()
+{
+  // the per-pixel displays are as large as their frames, keep them off the
+  // stack
+  static bench_pixel_bw_t pixelBW(BenchEPDBW(0, 0, 0, 0));
+  static bench_blit_bw_t blitBW(BenchEPDBW(0, 0, 0, 0));
+  static bench_pixel_3c_t pixel3c(BenchEPD3C(0, 0, 0, 0));
+  static bench_blit_3c_t blit3c(BenchEPD3C(0, 0, 0, 0));
+
+  printf("  megapixels (bitmap or glyph area) drawn per second\n");
+  printf("  %-3s %-24s %10s %10s %9s\n", "", "", "drawPixel", "blit",
+         "speedup");
+  report("BW", pixelBW, blitBW);
+  report("3C", pixel3c, blit3c);
+}
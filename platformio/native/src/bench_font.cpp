@@ -0,0 +1,181 @@
+/* Native (host) benchmark of drawing run coded (FONT_COMPRESS) fonts for
+ * esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+
+#include <GxEPD2_3C.h>
+
+#include "config.h"
+#include "frame_buffer.h"
+#include "native_harness.h"
+
+// the fonts as scripts/font_subset.py wrote them (FONT_COMPRESS), and the
+// originals they were made from
+#if FONT_SUBSET || FONT_COMPRESS
+#include "font_subset.h"
+#else
+#include FONT_HEADER
+#endif
+namespace raw
+{
+#include "fonts/FreeSans/FreeSans_8pt8b.h"
+#include "fonts/FreeSans/FreeSans_12pt8b.h"
+#include "fonts/FreeSans/FreeSans_26pt8b.h"
+}
+
+#define BENCH_FONT_REPEAT 20
+#define BENCH_FONT_COUNT  200 // strings drawn per run
+
+#if FONT_COMPRESS && defined(__FONTS_FREESANS_H__)
+
+/* A driver that drops the frame, only the drawing is timed. */
+class BenchEPD3C : public GxEPD2_750c_Z08
+{
+public:
+  using GxEPD2_750c_Z08::GxEPD2_750c_Z08;
+  void writeImage(const uint8_t *black, const uint8_t *color, int16_t x,
+                  int16_t y, int16_t w, int16_t h) {}
+  void refresh(bool partial_update_mode = false) {}
+};
+
+typedef FrameBufferEPD<BenchEPD3C, FRAME_3C, GxEPD_RED> bench_font_3c_t;
+
+#define BENCH_BITMAPS(font)  BENCH_BITMAPS_(font)
+#define BENCH_BITMAPS_(font) font##Bitmaps
+
+typedef struct font_case
+{
+  const char    *name;
+  const GFXfont *bits;       // original font
+  const GFXfont *runs;       // the same size, FONT_COMPRESS
+  size_t         runsBytes;  // sizeof its bitmap array
+  uint8_t        rotation;
+} font_case_t;
+
+static const char benchText[] = "Wednesday, October 14 1013 hPa 58% 12 mph";
+
+static const font_case_t cases[] = {
+  {"8pt", &raw::FreeSans_8pt8b, &FONT_8pt8b,
+   sizeof(BENCH_BITMAPS(FONT_8pt8b)), 0},
+  {"12pt", &raw::FreeSans_12pt8b, &FONT_12pt8b,
+   sizeof(BENCH_BITMAPS(FONT_12pt8b)), 0},
+  {"26pt", &raw::FreeSans_26pt8b, &FONT_26pt8b,
+   sizeof(BENCH_BITMAPS(FONT_26pt8b)), 0},
+  {"12pt, rotation 1", &raw::FreeSans_12pt8b, &FONT_12pt8b,
+   sizeof(BENCH_BITMAPS(FONT_12pt8b)), 1},
+};
+
+typedef struct font_run
+{
+  bench_font_3c_t *display;
+  const GFXfont   *font;
+  bool             compressed;
+} font_run_t;
+
+/* Pixels a run covers, the areas of the glyphs drawn.
+ */
+static double casePixels(const GFXfont *font)
+{
+  double px = 0;
+  for (const char *p = benchText; *p; ++p)
+  {
+    uint8_t ch = static_cast<uint8_t>(*p);
+    if (ch >= font->first && ch <= font->last)
+    {
+      const GFXglyph &g = font->glyph[ch - font->first];
+      px += g.width * g.height;
+    }
+  }
+  return px * BENCH_FONT_COUNT;
+}
+
+/* Bytes the glyphs of font take as bit streams, only counting the glyphs it
+ * has bitmaps for.
+ */
+static size_t bitsBytes(const GFXfont *font)
+{
+  size_t bytes = 0;
+  for (uint16_t c = font->first; c <= font->last; ++c)
+  {
+    const GFXglyph &g = font->glyph[c - font->first];
+    bytes += (g.width * g.height + 7) / 8;
+  }
+  return bytes;
+}
+
+static void runCase(void *arg)
+{
+  font_run_t &run = *static_cast<font_run_t *>(arg);
+  bench_font_3c_t &d = *run.display;
+  if (run.compressed)
+  {
+    d.setCompressedFont(run.font);
+  }
+  else
+  {
+    d.setFont(run.font);
+  }
+  d.setTextColor(GxEPD_BLACK);
+  for (int i = 0; i < BENCH_FONT_COUNT; ++i)
+  {
+    // spread over the panel, so every page row and byte column is used
+    d.setCursor(((i * 72) % 600) / 4, (i * 37) % 300 + 100);
+    d.print(benchText);
+  }
+}
+
+static double mpxPerSecond(bench_font_3c_t &d, const GFXfont *font,
+                           bool compressed)
+{
+  font_run_t run = {&d, font, compressed};
+  double ns = nativeBenchNs(runCase, &run, BENCH_FONT_REPEAT);
+  return casePixels(font) / ns * 1e3;
+}
+
+void benchFont()
+{
+  static bench_font_3c_t display(BenchEPD3C(0, 0, 0, 0));
+  display.init(0);
+  display.setTextWrap(false); // as initDisplay()
+  display.firstPage();
+
+  printf("  megapixels (glyph area) drawn per second, and bytes of glyph "
+         "bitmaps\n");
+  printf("  %-18s %10s %10s %8s %10s %10s %6s\n", "", "bits", "runs",
+         "speed", "bits B", "runs B", "size");
+  for (const font_case_t &c : cases)
+  {
+    display.setRotation(c.rotation);
+    double before = mpxPerSecond(display, c.bits, false);
+    double after = mpxPerSecond(display, c.runs, true);
+    size_t bytes = bitsBytes(c.runs);
+    printf("  %-18s %10.1f %10.1f %7.2fx %10zu %10zu %5.0f%%\n", c.name,
+           before, after, after / before, bytes, c.runsBytes,
+           100.0 * c.runsBytes / bytes);
+  }
+  display.setRotation(0);
+}
+
+#else
+
+void benchFont()
+{
+  printf("  needs FONT_COMPRESS 1 and FreeSans in config.h\n");
+}
+
+#endif
@@ -0,0 +1,170 @@
+/* Native (host) benchmark of paged and full frame rendering for
+ * esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <cstdio>
+
+#include <GxEPD2_3C.h>
+#include <GxEPD2_7C.h>
+
+#include "display_list.h"
+#include "frame_buffer.h"
+#include "native_harness.h"
+
+#include "fonts/FreeSans/FreeSans_48pt8b_temperature.h"
+#include "fonts/FreeSans/FreeSans_12pt8b.h"
+#include "fonts/FreeSans/FreeSans_8pt8b.h"
+#include "icons/96x96/wi_day_sunny_96x96.h"
+#include "icons/64x64/wi_cloudy_64x64.h"
+#include "icons/48x48/air_filter_48x48.h"
+
+#define BENCH_RENDER_REPEAT 50
+#define BENCH_RENDER_HOURS  48
+#define BENCH_RENDER_DAYS   5
+
+/* Drivers that drop the frame, the emulated panel would dominate the time. */
+class BenchEPD3C : public GxEPD2_750c_Z08
+{
+public:
+  using GxEPD2_750c_Z08::GxEPD2_750c_Z08;
+  void writeImage(const uint8_t *black, const uint8_t *color, int16_t x,
+                  int16_t y, int16_t w, int16_t h) {}
+  void refresh(bool partial_update_mode = false) {}
+};
+
+class BenchEPD7C : public GxEPD2_730c_GDEY073D46
+{
+public:
+  using GxEPD2_730c_GDEY073D46::GxEPD2_730c_GDEY073D46;
+  void writeNative(const uint8_t *data1, const uint8_t *data2, int16_t x,
+                   int16_t y, int16_t w, int16_t h) {}
+  void refresh(bool partial_update_mode = false) {}
+};
+
+typedef GxEPD2_3C<BenchEPD3C, BenchEPD3C::HEIGHT / 2> bench_paged_3c_t;
+typedef DisplayListEPD<bench_paged_3c_t> bench_list_3c_t;
+typedef FrameBufferEPD<BenchEPD3C, FRAME_3C, GxEPD_RED> bench_frame_3c_t;
+typedef GxEPD2_7C<BenchEPD7C, BenchEPD7C::HEIGHT / 4> bench_paged_7c_t;
+typedef DisplayListEPD<bench_paged_7c_t> bench_list_7c_t;
+typedef FrameBufferEPD<BenchEPD7C, FRAME_7C, GxEPD_RED> bench_frame_7c_t;
+
+template <typename Display>
+static void drawString(Display &d, int16_t x, int16_t y, const String &text,
+                       uint16_t color)
+{
+  int16_t x1, y1;
+  uint16_t w, h;
+  d.getTextBounds(text, x, y, &x1, &y1, &w, &h);
+  d.setTextColor(color);
+  d.setCursor(x - w / 2, y);
+  d.print(text);
+}
+
+/* A dashboard like the one renderer.cpp draws: the same kind of formatting,
+ * text measurement, icons and graph lines, run once per page.
+ */
+template <typename Display>
+static void drawDashboard(Display &d)
+{
+  d.drawInvertedBitmap(0, 0, wi_day_sunny_96x96, 96, 96, GxEPD_BLACK);
+  d.setFont(&FreeSans_48pt8b_temperature);
+  drawString(d, 134, 132,
+             String(static_cast<int>(std::round(294.26f - 273.15f))),
+             GxEPD_BLACK);
+  d.setFont(&FreeSans_12pt8b);
+  for (int i = 0; i < 10; ++i)
+  {
+    d.drawInvertedBitmap(i < 5 ? 0 : 170, 204 + 48 * (i % 5),
+                         air_filter_48x48, 48, 48, GxEPD_BLACK);
+    String dataStr = String(static_cast<int>(std::round(1013.f + i)))
+                   + " hPa";
+    drawString(d, i < 5 ? 108 : 278, 236 + 48 * (i % 5), dataStr,
+               GxEPD_BLACK);
+  }
+  for (int i = 0; i < BENCH_RENDER_DAYS; ++i)
+  {
+    int16_t x = 398 + i * 82;
+    d.drawInvertedBitmap(x, 94, wi_cloudy_64x64, 64, 64, GxEPD_BLACK);
+    drawString(d, x + 32, 178,
+               String(21 - i) + "\260 | " + String(12 + i) + "\260",
+               GxEPD_BLACK);
+  }
+  d.setFont(&FreeSans_8pt8b);
+  int16_t y0 = 0;
+  for (int i = 0; i < BENCH_RENDER_HOURS; ++i)
+  {
+    int16_t x = 350 + i * 8;
+    int16_t y = 400 - static_cast<int16_t>(40 * std::sin(i / 6.f));
+    if (i > 0)
+    {
+      d.drawLine(x - 8, y0, x, y, GxEPD_RED);
+      d.drawLine(x - 8, y0 + 1, x, y + 1, GxEPD_RED);
+    }
+    y0 = y;
+    if (i % 6 == 0)
+    {
+      char label[8];
+      snprintf(label, sizeof(label), "%02d", i % 24);
+      drawString(d, x, 470, label, GxEPD_BLACK);
+    }
+  }
+}
+
+template <typename Display>
+static void runFrame(void *arg)
+{
+  Display &d = *static_cast<Display *>(arg);
+  d.setFullWindow();
+  d.firstPage();
+  do
+  {
+    drawDashboard(d);
+  } while (d.nextPage());
+}
+
+template <typename Display>
+static void report(const char *name, Display &d, size_t bufferBytes)
+{
+  d.init(0);
+  d.setTextWrap(false); // as initDisplay()
+  double ns = nativeBenchNs(runFrame<Display>, &d, BENCH_RENDER_REPEAT);
+  printf("  %-24s %6u %10zu %10.3f\n", name, d.pages(), bufferBytes,
+         ns / 1e6);
+}
+
+void benchRenderFrame()
+{
+  // the paged displays are as large as their page buffers, keep them off the
+  // stack
+  static bench_paged_3c_t paged3c(BenchEPD3C(0, 0, 0, 0));
+  static bench_list_3c_t list3c(BenchEPD3C(0, 0, 0, 0));
+  static bench_frame_3c_t frame3c(BenchEPD3C(0, 0, 0, 0));
+  static bench_paged_7c_t paged7c(BenchEPD7C(0, 0, 0, 0));
+  static bench_list_7c_t list7c(BenchEPD7C(0, 0, 0, 0));
+  static bench_frame_7c_t frame7c(BenchEPD7C(0, 0, 0, 0));
+  const size_t planes = 2 * (800 / 8) * 480;
+
+  printf("  one dashboard frame, drawn and handed to the driver\n");
+  printf("  %-24s %6s %10s %10s\n", "", "pages", "buffer B", "ms/frame");
+  report("3C paged (HEIGHT / 2)", paged3c, 2 * (800 / 8) * 240);
+  report("3C paged, display list", list3c, 2 * (800 / 8) * 240);
+  report("3C full frame", frame3c, planes);
+  report("7C paged (HEIGHT / 4)", paged7c, (800 / 2) * 120);
+  report("7C paged, display list", list7c, (800 / 2) * 120);
+  report("7C full frame", frame7c, planes);
+}
@@ -0,0 +1,216 @@
+/* Native (host) benchmark of the USGS distance engine for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <WiFiClient.h>
+
+#include "api_response.h"
+#include "config.h"
+#include "geo_distance.h"
+#include "native_harness.h"
+
+#define BENCH_USGS_EVENTS 10000
+#define BENCH_USGS_REPEAT 20
+
+typedef struct bench_usgs
+{
+  std::vector<float> lat;
+  std::vector<float> lon;
+  std::vector<float> distance;
+  float nearest[USGS_NUM_SIG_EVENTS]; // ascending
+  int   inside;
+} bench_usgs_t;
+
+/* Deterministic events, spread like a world-wide feed. */
+static void makeEvents(bench_usgs_t &b)
+{
+  uint32_t x = 2463534242u; // xorshift32
+  auto next = [&x]()
+  {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return (x & 0xFFFFFF) / 16777216.f;
+  };
+  for (int i = 0; i < BENCH_USGS_EVENTS; ++i)
+  {
+    b.lat.push_back(-60.f + 130.f * next());
+    b.lon.push_back(-180.f + 360.f * next());
+  }
+  b.distance.resize(BENCH_USGS_EVENTS);
+}
+
+/* Keeps the USGS_NUM_SIG_EVENTS smallest distances, returns the largest of
+ * them once that many were seen.
+ */
+static float keepNearest(bench_usgs_t &b, int &kept, float d)
+{
+  int i = std::min(kept, USGS_NUM_SIG_EVENTS - 1);
+  if (kept == USGS_NUM_SIG_EVENTS && d >= b.nearest[i])
+  {
+    return b.nearest[i];
+  }
+  for (; i > 0 && b.nearest[i - 1] > d; --i)
+  {
+    b.nearest[i] = b.nearest[i - 1];
+  }
+  b.nearest[i] = d;
+  kept = std::min(kept + 1, USGS_NUM_SIG_EVENTS);
+  return kept == USGS_NUM_SIG_EVENTS ? b.nearest[kept - 1] : INFINITY;
+}
+
+/* Full haversine for every event, as the parser used to do. */
+static void runHaversine(void *arg)
+{
+  bench_usgs_t &b = *static_cast<bench_usgs_t *>(arg);
+  int kept = 0;
+  for (int i = 0; i < BENCH_USGS_EVENTS; ++i)
+  {
+    keepNearest(b, kept, calculateDistance(NUM_LAT, NUM_LON,
+                                           b.lat[i], b.lon[i]));
+  }
+}
+
+/* Prefilter, the radius shrinks to the worst kept event like in the parser. */
+static void runPrefilter(void *arg)
+{
+  bench_usgs_t &b = *static_cast<bench_usgs_t *>(arg);
+  geo_observer_t o;
+  geoObserverInit(o, NUM_LAT, NUM_LON);
+  int kept = 0;
+  b.inside = 0;
+  for (int i = 0; i < BENCH_USGS_EVENTS; ++i)
+  {
+    float d;
+    if (geoDistanceWithin(o, b.lat[i], b.lon[i], d))
+    {
+      ++b.inside;
+      float radius = keepNearest(b, kept, d);
+      if (radius < o.max_distance)
+      {
+        geoObserverSetMaxDistance(o, radius);
+      }
+    }
+  }
+}
+
+/* Batch kernel at a fixed radius, the worst of the nearest events. */
+static void runBatch(void *arg)
+{
+  bench_usgs_t &b = *static_cast<bench_usgs_t *>(arg);
+  geo_observer_t o;
+  geoObserverInit(o, NUM_LAT, NUM_LON);
+  geoObserverSetMaxDistance(o, b.nearest[USGS_NUM_SIG_EVENTS - 1]);
+  b.inside = geoDistanceBatch(o, b.lat.data(), b.lon.data(),
+                              b.distance.data(), BENCH_USGS_EVENTS);
+}
+
+/* Batch kernel without a radius, every distance is computed. */
+static void runBatchAll(void *arg)
+{
+  bench_usgs_t &b = *static_cast<bench_usgs_t *>(arg);
+  geo_observer_t o;
+  geoObserverInit(o, NUM_LAT, NUM_LON);
+  b.inside = geoDistanceBatch(o, b.lat.data(), b.lon.data(),
+                              b.distance.data(), BENCH_USGS_EVENTS);
+}
+
+typedef struct bench_usgs_feed
+{
+  std::string body;
+  usgs_earth_resp_t *resp;
+  DeserializationError error;
+} bench_usgs_feed_t;
+
+/* GeoJSON feed of the same events, with the properties of a real one. */
+static void makeFeed(const bench_usgs_t &b, std::string &body)
+{
+  char buf[640];
+  body = "{\"type\":\"FeatureCollection\",\"metadata\":{\"generated\":"
+         "1760626800000,\"title\":\"bench\",\"status\":200,\"count\":"
+       + std::to_string(BENCH_USGS_EVENTS) + "},\"features\":[";
+  for (int i = 0; i < BENCH_USGS_EVENTS; ++i)
+  {
+    snprintf(buf, sizeof(buf),
+      "%s{\"type\":\"Feature\",\"properties\":{\"mag\":%.1f,"
+      "\"place\":\"event %d\",\"time\":1760626200000,"
+      "\"updated\":1760626800000,\"tz\":null,\"url\":\"https://earthquake."
+      "usgs.gov/earthquakes/eventpage/bench%05d\",\"felt\":null,\"cdi\":null,"
+      "\"mmi\":null,\"alert\":null,\"status\":\"automatic\",\"tsunami\":0,"
+      "\"sig\":%d,\"net\":\"us\",\"code\":\"bench%05d\",\"magType\":\"ml\","
+      "\"type\":\"earthquake\",\"title\":\"M %.1f - event %d\"},"
+      "\"geometry\":{\"type\":\"Point\",\"coordinates\":[%.4f,%.4f,%.1f]},"
+      "\"id\":\"bench%05d\"}",
+      i ? "," : "", 1.f + (i % 60) / 10.f, i, i, i % 900, i,
+      1.f + (i % 60) / 10.f, i, b.lon[i], b.lat[i], (i % 70) * 1.f, i);
+    body += buf;
+  }
+  body += "],\"bbox\":[-180,-60,0,180,70,700]}";
+}
+
+static void runParse(void *arg)
+{
+  bench_usgs_feed_t &f = *static_cast<bench_usgs_feed_t *>(arg);
+  WiFiClient client;
+  client.nativeAttachBody(reinterpret_cast<const uint8_t *>(f.body.data()),
+                          f.body.size());
+  f.error = deserializeUSGSEarthquake(client, *f.resp, NUM_LAT, NUM_LON);
+}
+
+void benchUsgsDistance()
+{
+  bench_usgs_t b;
+  makeEvents(b);
+  const double n = BENCH_USGS_EVENTS;
+
+  printf("  %d events, nearest %d to %.4f,%.4f\n", BENCH_USGS_EVENTS,
+         USGS_NUM_SIG_EVENTS, NUM_LAT, NUM_LON);
+  printf("  %-28s %10s %10s\n", "", "ns/event", "exact");
+  double ns = nativeBenchNs(runHaversine, &b, BENCH_USGS_REPEAT);
+  printf("  %-28s %10.1f %10d\n", "haversine", ns / n, BENCH_USGS_EVENTS);
+  float farthest = b.nearest[USGS_NUM_SIG_EVENTS - 1];
+  ns = nativeBenchNs(runPrefilter, &b, BENCH_USGS_REPEAT);
+  printf("  %-28s %10.1f %10d\n", "prefilter, shrinking radius", ns / n,
+         b.inside);
+  ns = nativeBenchNs(runBatchAll, &b, BENCH_USGS_REPEAT);
+  printf("  %-28s %10.1f %10d\n", "batch, no radius", ns / n, b.inside);
+  ns = nativeBenchNs(runBatch, &b, BENCH_USGS_REPEAT);
+  printf("  %-28s %10.1f %10d\n", "batch, final radius", ns / n, b.inside);
+  if (fabsf(b.nearest[USGS_NUM_SIG_EVENTS - 1] - farthest) > 0.01f)
+  {
+    printf("  MISMATCH: prefilter kept %.3f km, haversine %.3f km\n",
+           b.nearest[USGS_NUM_SIG_EVENTS - 1], farthest);
+    nativeBenchFail();
+  }
+
+  bench_usgs_feed_t f;
+  makeFeed(b, f.body);
+  f.resp = new usgs_earth_resp_t;
+  nativeHeapReset();
+  ns = nativeBenchNs(runParse, &f, 5);
+  printf("  %-28s %10.1f %10s  %s, %zu B, heap peak %zu B\n",
+         "deserializeUSGSEarthquake", ns / n, "", f.error.c_str(),
+         f.body.size(), nativeHeapPeak());
+  printf("  nearest: %s, %.1f km\n",
+         f.resp->features[0].properties.place.c_str(),
+         f.resp->features[0].distance);
+  delete f.resp;
+}
@@ -0,0 +1,178 @@
+/* Native (host) FreeRTOS shim for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* A task runs on its own host thread and starts with the simulated clock of
+ * the task that created it, from then on each task charges its own waits and
+ * transfers. Every count of a semaphore carries the clock of the give that
+ * added it, whoever takes it continues no earlier than that. So a task
+ * waiting for others to finish resumes when the slowest of them is done on
+ * the simulated clock, and requests made by concurrent tasks overlap instead
+ * of adding up.
+ *
+ * Charged time passes instantly on the host, tasks may finish in a different
+ * order than on the simulated clock. A take uses the earliest count that has
+ * been given so far.
+ *
+ * Mutexes only guard short critical sections and do not move the clock,
+ * otherwise a task would wait for time another task merely charged.
+ *
+ * Concurrent transfers do not share the --bandwidth, each one is charged at
+ * the full link rate.
+ */
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <pthread.h>
+#include <vector>
+
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include "native_harness.h"
+
+struct native_semaphore
+{
+  std::mutex lock;
+  std::condition_variable cond;
+  std::vector<uint64_t> given; // simulated clock of each available count
+  UBaseType_t maxCount;
+  bool mutex;
+};
+
+typedef struct native_task_start
+{
+  TaskFunction_t code;
+  void *params;
+  uint64_t startUs;
+} native_task_start_t;
+
+/* Moves the calling task's clock forward to us if it is behind.
+ */
+static void catchUp(uint64_t us)
+{
+  uint64_t now = nativeNowUs();
+  if (us > now)
+  {
+    nativeAdvanceUs(us - now);
+  }
+}
+
+static void *runTask(void *arg)
+{
+  native_task_start_t start = *static_cast<native_task_start_t *>(arg);
+  delete static_cast<native_task_start_t *>(arg);
+  catchUp(start.startUs);
+  start.code(start.params);
+  return nullptr;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char *name,
+                                   uint32_t stackDepth, void *params,
+                                   UBaseType_t priority,
+                                   TaskHandle_t *createdTask,
+                                   BaseType_t coreId)
+{
+  native_task_start_t *start = new native_task_start_t{code, params,
+                                                       nativeNowUs()};
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+  pthread_t thread;
+  int err = pthread_create(&thread, &attr, runTask, start);
+  pthread_attr_destroy(&attr);
+  if (err != 0)
+  {
+    delete start;
+    return pdFAIL;
+  }
+  if (createdTask)
+  {
+    *createdTask = nullptr;
+  }
+  return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+  pthread_exit(nullptr);
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task)
+{
+  return 1; // the Arduino loop task
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task)
+{
+  return 0;
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount,
+                                           UBaseType_t initialCount)
+{
+  SemaphoreHandle_t sem = new native_semaphore;
+  sem->given.reserve(maxCount);
+  sem->given.assign(initialCount, 0);
+  sem->maxCount = maxCount;
+  sem->mutex = false;
+  return sem;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+  SemaphoreHandle_t sem = xSemaphoreCreateCounting(1, 1);
+  sem->mutex = true;
+  return sem;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticksToWait)
+{
+  std::unique_lock<std::mutex> lock(sem->lock);
+  if (sem->given.empty() && ticksToWait == 0)
+  {
+    return pdFALSE;
+  }
+  sem->cond.wait(lock, [sem] { return !sem->given.empty(); });
+  auto earliest = std::min_element(sem->given.begin(), sem->given.end());
+  uint64_t givenUs = *earliest;
+  sem->given.erase(earliest);
+  lock.unlock();
+  if (!sem->mutex)
+  {
+    catchUp(givenUs);
+  }
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+  uint64_t now = nativeNowUs();
+  std::lock_guard<std::mutex> lock(sem->lock);
+  if (sem->given.size() == sem->maxCount)
+  {
+    return pdFALSE;
+  }
+  sem->given.push_back(now);
+  sem->cond.notify_one();
+  return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem)
+{
+  delete sem;
+}
@@ -0,0 +1,467 @@
+/* Native (host) harness for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* Runs the firmware's setup() once per simulated wake. See native/README.md
+ * for the command line options and the meaning of each report column.
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <mutex>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "native_harness.h"
+
+void setup();
+
+native_options_t nativeOpts = {
+  "native/fixtures",    // fixtures
+  ".pio/native_state",  // state
+  nullptr,              // frame
+  1,                    // wakes
+  1760626800,           // epoch, 2025-10-16 15:00:00 UTC
+  0,                    // rttMs
+  0,                    // bandwidthKBps (unlimited)
+  0,                    // tlsMs
+  0,                    // tlsResumeMs
+  7200,                 // tlsLifetimeS
+  0,                    // chunkBytes (Content-Length)
+  true,                 // validators
+  0,                    // wifiMs
+  0,                    // sntpMs
+  -1,                   // wifiStatus (connect normally)
+  4000,                 // batteryMv
+  true,                 // bmeFound
+  21.5f,                // bmeTemp
+  40.0f,                // bmeHumidity
+  327680,               // heapSize, typical esp32 arduino heap
+  false,                // keepState
+  false,                // quiet
+  nullptr,              // bench
+  0,                    // numFailures
+  {}                    // failures
+};
+int nativeWakeIndex = 0;
+
+// RTC slow memory (RTC_DATA_ATTR) is the "rtc_data" section, the linker
+// provides its bounds.
+extern "C" char __start_rtc_data[] __attribute__((weak));
+extern "C" char __stop_rtc_data[] __attribute__((weak));
+
+typedef struct native_wake_summary
+{
+  uint64_t awakeUs;
+  uint64_t cpuUs;
+  uint64_t sleepUs;
+  size_t   heapPeak;
+} native_wake_summary_t;
+
+static std::chrono::steady_clock::time_point wakeStart;
+// every task has its own simulated clock, see freertos.cpp
+static thread_local uint64_t chargedUs = 0;
+static std::mutex phaseLock;
+static native_phase_t phases[NATIVE_MAX_PHASES];
+static int numPhases = 0;
+static thread_local int phaseDepth = 0;
+static int summaryFd = -1;
+
+uint64_t nativeHostUs()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+           std::chrono::steady_clock::now() - wakeStart).count();
+}
+
+uint64_t nativeNowUs()
+{
+  return nativeHostUs() + chargedUs;
+}
+
+void nativeAdvanceUs(uint64_t us)
+{
+  chargedUs += us;
+}
+
+int nativePhaseBegin(const char *name)
+{
+  std::lock_guard<std::mutex> lock(phaseLock);
+  if (numPhases == NATIVE_MAX_PHASES)
+  {
+    return -1;
+  }
+  native_phase_t &p = phases[numPhases];
+  memset(&p, 0, sizeof(p));
+  snprintf(p.name, sizeof(p.name), "%s", name);
+  p.depth = phaseDepth++;
+  p.startUs = nativeNowUs();
+  p.cpuUs = nativeHostUs();
+  p.open = true;
+  p.heapMark = nativeHeapPushMark();
+  return numPhases++;
+}
+
+void nativePhaseEnd(int phase)
+{
+  std::lock_guard<std::mutex> lock(phaseLock);
+  if (phase < 0 || !phases[phase].open)
+  {
+    return;
+  }
+  native_phase_t &p = phases[phase];
+  p.endUs = nativeNowUs();
+  p.cpuUs = nativeHostUs() - p.cpuUs;
+  p.heapPeak = nativeHeapPopMark(p.heapMark);
+  p.open = false;
+  --phaseDepth;
+}
+
+native_phase_t *nativePhase(int phase)
+{
+  return phase < 0 ? nullptr : &phases[phase];
+}
+
+/* Recorded responses are looked up as <fixtures>/<host><path>, the query
+ * string is ignored. Files are mapped so they do not count towards the heap.
+ */
+bool nativeFixtureOpen(const char *host, const char *uri,
+                       const uint8_t **data, size_t *len, time_t *modified)
+{
+  char path[512];
+  size_t pathLen = strcspn(uri, "?");
+  snprintf(path, sizeof(path), "%s/%s%.*s", nativeOpts.fixtures, host,
+           static_cast<int>(pathLen), uri);
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+  {
+    fprintf(stderr, "[native] no fixture for %s\n", path);
+    return false;
+  }
+  struct stat st;
+  fstat(fd, &st);
+  *len = st.st_size;
+  if (modified)
+  {
+    *modified = st.st_mtime;
+  }
+  *data = static_cast<const uint8_t *>(
+            mmap(nullptr, *len ? *len : 1, PROT_READ, MAP_PRIVATE, fd, 0));
+  close(fd);
+  return *data != MAP_FAILED;
+}
+
+bool nativeFixtureChunked(const uint8_t *body, size_t len, size_t chunk,
+                          const uint8_t **data, size_t *chunkedLen)
+{
+  size_t chunks = (len + chunk - 1) / chunk;
+  size_t cap = len + chunks * 24 + 8;
+  void *map = mmap(nullptr, cap, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (map == MAP_FAILED)
+  {
+    return false;
+  }
+  char *out = static_cast<char *>(map);
+  size_t n = 0;
+  for (size_t i = 0; i < len; i += chunk)
+  {
+    size_t size = std::min(chunk, len - i);
+    n += snprintf(out + n, cap - n, "%zx\r\n", size);
+    memcpy(out + n, body + i, size);
+    n += size;
+    n += snprintf(out + n, cap - n, "\r\n");
+  }
+  n += snprintf(out + n, cap - n, "0\r\n\r\n");
+  *data = reinterpret_cast<const uint8_t *>(out);
+  *chunkedLen = n;
+  return true;
+}
+
+int nativeInjectedFailure(const char *host, const char *uri)
+{
+  char target[512];
+  snprintf(target, sizeof(target), "%s%s", host, uri);
+  for (int i = 0; i < nativeOpts.numFailures; ++i)
+  {
+    if (strstr(target, nativeOpts.failures[i].match))
+    {
+      return nativeOpts.failures[i].code;
+    }
+  }
+  return 0;
+}
+
+void nativeStatePath(char *buf, size_t size, const char *name)
+{
+  snprintf(buf, size, "%s/%s", nativeOpts.state, name);
+}
+
+static void loadRtcMemory()
+{
+  size_t size = __stop_rtc_data - __start_rtc_data;
+  if (!__start_rtc_data || size == 0)
+  {
+    return;
+  }
+  char path[512];
+  nativeStatePath(path, sizeof(path), "rtc.bin");
+  FILE *f = fopen(path, "rb");
+  if (f)
+  {
+    if (fread(__start_rtc_data, 1, size, f) != size)
+    { // layout changed, start from a cold boot
+      memset(__start_rtc_data, 0, size);
+    }
+    fclose(f);
+  }
+}
+
+static void saveRtcMemory()
+{
+  size_t size = __stop_rtc_data - __start_rtc_data;
+  if (!__start_rtc_data || size == 0)
+  {
+    return;
+  }
+  char path[512];
+  nativeStatePath(path, sizeof(path), "rtc.bin");
+  FILE *f = fopen(path, "wb");
+  if (f)
+  {
+    fwrite(__start_rtc_data, 1, size, f);
+    fclose(f);
+  }
+}
+
+/* Prints the wake report and hands the summary to the parent process.
+ */
+void nativeWakeEnd(uint64_t sleepUs)
+{
+  for (int i = numPhases - 1; i >= 0; --i)
+  {
+    nativePhaseEnd(i);
+  }
+
+  native_wake_summary_t s = {};
+  s.awakeUs = nativeNowUs();
+  s.cpuUs = nativeHostUs();
+  s.sleepUs = sleepUs;
+  s.heapPeak = nativeHeapPeak();
+
+  saveRtcMemory();
+  if (nativeOpts.frame)
+  {
+    nativePanelSaveFrame(nativeOpts.frame);
+  }
+
+  fflush(stdout);
+  fprintf(stderr, "\n[native] wake %d: awake %.1f ms (host cpu %.1f ms), "
+                  "heap peak %zu B, sleep %llu s\n",
+          nativeWakeIndex, s.awakeUs / 1e3, s.cpuUs / 1e3, s.heapPeak,
+          static_cast<unsigned long long>(sleepUs / 1000000ULL));
+  fprintf(stderr, "[native]   %-52s %6s %9s %9s %9s %8s %9s\n",
+          "phase", "status", "start ms", "dur ms", "cpu ms", "bytes",
+          "heap peak");
+  for (int i = 0; i < numPhases; ++i)
+  {
+    native_phase_t &p = phases[i];
+    char name[128];
+    snprintf(name, sizeof(name), "%*s%.90s", 2 * p.depth, "", p.name);
+    fprintf(stderr, "[native]   %-52.52s %6d %9.1f %9.1f %9.1f %8zu %9zu\n",
+            name, p.status, p.startUs / 1e3, (p.endUs - p.startUs) / 1e3,
+            p.cpuUs / 1e3, p.bytes, p.heapPeak);
+  }
+  nativePanelReport();
+
+  if (summaryFd >= 0)
+  {
+    ssize_t n __attribute__((unused)) = write(summaryFd, &s, sizeof(s));
+  }
+  _exit(0);
+}
+
+static void usage(const char *argv0)
+{
+  fprintf(stderr,
+    "usage: %s [options]\n"
+    "  --fixtures DIR     recorded responses (default native/fixtures)\n"
+    "  --state DIR        NVS and RTC memory between wakes\n"
+    "                     (default .pio/native_state)\n"
+    "  --keep-state       do not clear the state directory first\n"
+    "  --wakes N          number of consecutive wakes (default 1)\n"
+    "  --epoch T          Unix time of the first wake\n"
+    "  --rtt MS           network round trip time (default 0)\n"
+    "  --bandwidth KBPS   link throughput, 0 = unlimited (default 0)\n"
+    "  --tls MS           extra time per TLS handshake (default 0)\n"
+    "  --tls-resume MS    extra time per resumed TLS handshake (default 0)\n"
+    "  --tls-lifetime S   TLS sessions can be resumed for S (default 7200)\n"
+    "  --chunked BYTES    send HTTP/1.1 bodies in chunks of BYTES (default 0)\n"
+    "  --no-validators    never send ETag/Last-Modified or answer 304\n"
+    "  --wifi MS          WiFi association time (default 0)\n"
+    "  --sntp MS          SNTP sync time (default 0)\n"
+    "  --wifi-status N    fail WiFi with the given wl_status_t\n"
+    "  --battery MV       battery voltage (default 4000)\n"
+    "  --bme T,H|none     indoor sensor reading (default 21.5,40)\n"
+    "  --heap BYTES       heap size reported by ESP (default 327680)\n"
+    "  --fail MATCH=CODE  answer requests containing MATCH with CODE\n"
+    "  --frame FILE.ppm   write the final panel image\n"
+    "  --quiet            suppress Serial output\n"
+    "  --bench NAME       run a micro benchmark ('list', 'all')\n",
+    argv0);
+  exit(2);
+}
+
+static void parseArgs(int argc, char **argv)
+{
+  for (int i = 1; i < argc; ++i)
+  {
+    const char *a = argv[i];
+    const char *v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    bool used = true;
+    if      (!strcmp(a, "--keep-state")) { nativeOpts.keepState = true; used = false; }
+    else if (!strcmp(a, "--quiet"))      { nativeOpts.quiet = true; used = false; }
+    else if (!strcmp(a, "--no-validators")) { nativeOpts.validators = false; used = false; }
+    else if (!v)                         { usage(argv[0]); }
+    else if (!strcmp(a, "--fixtures"))   { nativeOpts.fixtures = v; }
+    else if (!strcmp(a, "--state"))      { nativeOpts.state = v; }
+    else if (!strcmp(a, "--frame"))      { nativeOpts.frame = v; }
+    else if (!strcmp(a, "--wakes"))      { nativeOpts.wakes = atoi(v); }
+    else if (!strcmp(a, "--epoch"))      { nativeOpts.epoch = atoll(v); }
+    else if (!strcmp(a, "--rtt"))        { nativeOpts.rttMs = atoi(v); }
+    else if (!strcmp(a, "--bandwidth"))  { nativeOpts.bandwidthKBps = atoi(v); }
+    else if (!strcmp(a, "--tls"))        { nativeOpts.tlsMs = atoi(v); }
+    else if (!strcmp(a, "--tls-resume")) { nativeOpts.tlsResumeMs = atoi(v); }
+    else if (!strcmp(a, "--tls-lifetime")) { nativeOpts.tlsLifetimeS = atoi(v); }
+    else if (!strcmp(a, "--chunked"))    { nativeOpts.chunkBytes = atoi(v); }
+    else if (!strcmp(a, "--wifi"))       { nativeOpts.wifiMs = atoi(v); }
+    else if (!strcmp(a, "--sntp"))       { nativeOpts.sntpMs = atoi(v); }
+    else if (!strcmp(a, "--wifi-status")){ nativeOpts.wifiStatus = atoi(v); }
+    else if (!strcmp(a, "--battery"))    { nativeOpts.batteryMv = atoi(v); }
+    else if (!strcmp(a, "--heap"))       { nativeOpts.heapSize = atoi(v); }
+    else if (!strcmp(a, "--bench"))      { nativeOpts.bench = v; }
+    else if (!strcmp(a, "--bme"))
+    {
+      nativeOpts.bmeFound = strcmp(v, "none") != 0;
+      if (nativeOpts.bmeFound
+       && sscanf(v, "%f,%f", &nativeOpts.bmeTemp,
+                 &nativeOpts.bmeHumidity) != 2)
+      {
+        usage(argv[0]);
+      }
+    }
+    else if (!strcmp(a, "--fail"))
+    {
+      const char *eq = strrchr(v, '=');
+      if (!eq || nativeOpts.numFailures == NATIVE_MAX_FAILURES)
+      {
+        usage(argv[0]);
+      }
+      native_failure_t &f = nativeOpts.failures[nativeOpts.numFailures++];
+      snprintf(f.match, sizeof(f.match), "%.*s",
+               static_cast<int>(eq - v), v);
+      f.code = atoi(eq + 1);
+    }
+    else
+    {
+      usage(argv[0]);
+    }
+    i += used;
+  }
+}
+
+int main(int argc, char **argv)
+{
+  parseArgs(argc, argv);
+  setvbuf(stdout, nullptr, _IOLBF, 0); // keep Serial output in order with stderr
+  if (nativeOpts.bench)
+  {
+    return nativeBenchMain(nativeOpts.bench);
+  }
+
+  if (!nativeOpts.keepState)
+  {
+    char cmd[600];
+    snprintf(cmd, sizeof(cmd), "rm -rf '%s'", nativeOpts.state);
+    if (system(cmd) != 0)
+    {
+      fprintf(stderr, "[native] could not clear %s\n", nativeOpts.state);
+    }
+  }
+  mkdir(nativeOpts.state, 0755);
+
+  native_wake_summary_t total = {};
+  native_wake_summary_t worst = {};
+  int completed = 0;
+  for (nativeWakeIndex = 1; nativeWakeIndex <= nativeOpts.wakes;
+       ++nativeWakeIndex)
+  {
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+      perror("pipe");
+      return 1;
+    }
+    fflush(stdout);
+    fflush(stderr);
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+      close(fds[0]);
+      summaryFd = fds[1];
+      wakeStart = std::chrono::steady_clock::now();
+      loadRtcMemory();
+      nativeHeapReset();
+      setup(); // returns only by esp_deep_sleep_start()
+      fprintf(stderr, "[native] setup() returned without deep sleep\n");
+      nativeWakeEnd(0);
+    }
+    close(fds[1]);
+    native_wake_summary_t s = {};
+    ssize_t n = read(fds[0], &s, sizeof(s));
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (n != sizeof(s) || !WIFEXITED(status))
+    {
+      fprintf(stderr, "[native] wake %d crashed\n", nativeWakeIndex);
+      return 1;
+    }
+    ++completed;
+    total.awakeUs += s.awakeUs;
+    total.cpuUs += s.cpuUs;
+    worst.awakeUs = std::max(worst.awakeUs, s.awakeUs);
+    worst.heapPeak = std::max(worst.heapPeak, s.heapPeak);
+    // the next wake starts where this one went to sleep
+    nativeOpts.epoch += (s.awakeUs + s.sleepUs) / 1000000ULL;
+  }
+
+  if (completed > 1)
+  {
+    fprintf(stderr, "\n[native] %d wakes: awake avg %.1f ms max %.1f ms, "
+                    "host cpu avg %.1f ms, heap peak max %zu B\n",
+            completed, total.awakeUs / 1e3 / completed,
+            worst.awakeUs / 1e3, total.cpuUs / 1e3 / completed,
+            worst.heapPeak);
+  }
+  return 0;
+}
@@ -0,0 +1,159 @@
+/* Native (host) heap accounting for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/* malloc, calloc, realloc and free are replaced (on top of glibc) so that
+ * every String, JsonDocument, std::vector and new expression made by the
+ * firmware is counted. Block sizes are glibc's usable sizes, which is close to
+ * but not exactly what the esp32 heap would use.
+ */
+
+#include <cstddef>
+#include <cstring>
+#include <malloc.h>
+#include <mutex>
+
+#include "native_harness.h"
+
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t nmemb, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+extern "C" void __libc_free(void *ptr);
+
+#define NATIVE_MAX_HEAP_MARKS 16
+
+static size_t inUse = 0;
+static size_t peak = 0;
+static size_t base = 0; // host runtime allocations made before the wake
+static size_t marks[NATIVE_MAX_HEAP_MARKS];
+static uint32_t activeMarks = 0; // bit per mark
+static std::mutex markLock;
+
+/* Concurrent tasks allocate too, so the peaks are raised atomically.
+ */
+static void raisePeak(size_t &value, size_t now)
+{
+  size_t cur = __atomic_load_n(&value, __ATOMIC_RELAXED);
+  while (now > cur
+      && !__atomic_compare_exchange_n(&value, &cur, now, true,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+  {
+  }
+}
+
+static void account(size_t added, size_t removed)
+{
+  size_t now = __atomic_add_fetch(&inUse, added, __ATOMIC_RELAXED);
+  now = __atomic_sub_fetch(&inUse, removed, __ATOMIC_RELAXED);
+  raisePeak(peak, now);
+  uint32_t active = __atomic_load_n(&activeMarks, __ATOMIC_RELAXED);
+  for (int i = 0; active; ++i, active >>= 1)
+  {
+    if (active & 1)
+    {
+      raisePeak(marks[i], now);
+    }
+  }
+}
+
+void nativeHeapReset()
+{
+  base = inUse;
+  peak = inUse;
+}
+
+size_t nativeHeapInUse()
+{
+  return inUse - base;
+}
+
+size_t nativeHeapPeak()
+{
+  return peak - base;
+}
+
+/* Phases of concurrent tasks do not nest, each measurement gets a free slot.
+ * Returns -1 if all slots are in use.
+ */
+int nativeHeapPushMark()
+{
+  std::lock_guard<std::mutex> lock(markLock);
+  for (int i = 0; i < NATIVE_MAX_HEAP_MARKS; ++i)
+  {
+    if (!(activeMarks & (1UL << i)))
+    {
+      marks[i] = inUse;
+      __atomic_or_fetch(&activeMarks, 1UL << i, __ATOMIC_RELAXED);
+      return i;
+    }
+  }
+  return -1;
+}
+
+size_t nativeHeapPopMark(int mark)
+{
+  if (mark < 0)
+  {
+    return 0;
+  }
+  std::lock_guard<std::mutex> lock(markLock);
+  __atomic_and_fetch(&activeMarks, ~(1UL << mark), __ATOMIC_RELAXED);
+  return marks[mark] - base;
+}
+
+extern "C" void *malloc(size_t size)
+{
+  void *p = __libc_malloc(size);
+  if (p)
+  {
+    account(malloc_usable_size(p), 0);
+  }
+  return p;
+}
+
+extern "C" void *calloc(size_t nmemb, size_t size)
+{
+  void *p = __libc_calloc(nmemb, size);
+  if (p)
+  {
+    account(malloc_usable_size(p), 0);
+  }
+  return p;
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+  size_t old = ptr ? malloc_usable_size(ptr) : 0;
+  void *p = __libc_realloc(ptr, size);
+  if (p)
+  {
+    account(malloc_usable_size(p), old);
+  }
+  else if (size == 0)
+  {
+    account(0, old);
+  }
+  return p;
+}
+
+extern "C" void free(void *ptr)
+{
+  if (ptr)
+  {
+    account(0, malloc_usable_size(ptr));
+  }
+  __libc_free(ptr);
+}
@@ -0,0 +1,397 @@
+/* Native (host) WiFiClient and HTTPClient shims for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <HTTPClient.h>
+#include <WiFi.h>
+#include <WiFiClient.h>
+#include <WiFiClientSecure.h>
+
+#include "native_harness.h"
+
+/* Charges the time it takes to move n bytes over the simulated link.
+ */
+static void chargeTransfer(size_t n)
+{
+  if (nativeOpts.bandwidthKBps > 0)
+  {
+    nativeAdvanceUs(n * 1000ULL / nativeOpts.bandwidthKBps);
+  }
+}
+
+int WiFiClient::available()
+{
+  return static_cast<int>(_len - _pos);
+}
+
+int WiFiClient::read()
+{
+  if (_pos >= _len)
+  {
+    return -1;
+  }
+  chargeTransfer(1);
+  return _body[_pos++];
+}
+
+int WiFiClient::peek()
+{
+  return _pos < _len ? _body[_pos] : -1;
+}
+
+size_t WiFiClient::readBytes(char *buffer, size_t length)
+{
+  size_t n = std::min(length, _len - _pos);
+  memcpy(buffer, _body + _pos, n);
+  _pos += n;
+  chargeTransfer(n);
+  return n;
+}
+
+int WiFiClient::connect(const char *host, uint16_t port)
+{
+  if (WiFi.status() != WL_CONNECTED)
+  {
+    return 0;
+  }
+  nativeConnect(host, port);
+  return _connected ? 1 : 0;
+}
+
+uint8_t WiFiClient::connected()
+{
+  return _connected || _pos < _len;
+}
+
+void WiFiClient::stop()
+{
+  _connected = false;
+  _len = _pos; // drop the unread rest, keep the count for the report
+}
+
+bool WiFiClient::nativeIsConnectedTo(const String &host, uint16_t port) const
+{
+  return _connected && _port == port && _host == host;
+}
+
+void WiFiClient::nativeConnect(const String &host, uint16_t port)
+{
+  nativeAdvanceUs(nativeOpts.rttMs * 1000ULL); // TCP handshake
+  _host = host;
+  _port = port;
+  _connected = nativeHandshake();
+}
+
+/* Offered sessions are tickets: the emulated server accepts any session it
+ * issued less than --tls-lifetime seconds ago.
+ */
+bool WiFiClientSecure::nativeHandshake()
+{
+  if (_stillinPlainStart)
+  {
+    return true;
+  }
+  mbedtls_ssl_session &session = sslclient->ssl_ctx.session;
+  int64_t now = time(nullptr);
+  if (sslclient->ssl_ctx.has_session
+   && strcmp(session.native_host, _host.c_str()) == 0
+   && now - session.start < nativeOpts.tlsLifetimeS)
+  { // abbreviated handshake, one round trip and no key exchange
+    nativeAdvanceUs(nativeOpts.rttMs * 1000ULL
+                    + nativeOpts.tlsResumeMs * 1000ULL);
+    return true;
+  }
+
+  // two round trips, the key exchange and the certificate chain
+  nativeAdvanceUs(2 * nativeOpts.rttMs * 1000ULL
+                  + nativeOpts.tlsMs * 1000ULL);
+  chargeTransfer(4096);
+  static uint64_t issued = 0;
+  uint64_t serial = __atomic_add_fetch(&issued, 1, __ATOMIC_RELAXED);
+  memset(&session, 0, sizeof(session));
+  session.start = now;
+  session.id_len = sizeof(session.id);
+  memcpy(session.id, &now, sizeof(now));
+  memcpy(session.id + sizeof(now), &serial, sizeof(serial));
+  session.ticket_lifetime = nativeOpts.tlsLifetimeS;
+  snprintf(session.native_host, sizeof(session.native_host), "%s",
+           _host.c_str());
+  sslclient->ssl_ctx.has_session = true;
+  return true;
+}
+
+void WiFiClientSecure::stop()
+{
+  WiFiClient::stop();
+  sslclient->ssl_ctx = {}; // mbedtls_ssl_free()
+}
+
+int WiFiClientSecure::startTLS()
+{
+  if (!_stillinPlainStart || !_connected)
+  {
+    return 0;
+  }
+  _stillinPlainStart = false;
+  _connected = nativeHandshake();
+  return _connected ? 1 : 0;
+}
+
+void WiFiClient::nativeAttachBody(const uint8_t *body, size_t len)
+{
+  _body = body;
+  _len = len;
+  _pos = 0;
+}
+
+bool HTTPClient::begin(WiFiClient &client, String host, uint16_t port,
+                       String uri, bool https)
+{
+  if (_client && _client != &client)
+  {
+    _client->stop();
+  }
+  _client = &client;
+  _host = host;
+  _port = port;
+  _uri = uri;
+  _returnCode = 0;
+  _size = -1;
+  _canReuse = false;
+  _added.clear();
+  _headers.clear();
+  return true;
+}
+
+HTTPClient::~HTTPClient()
+{
+  end();
+  if (_client)
+  {
+    _client->stop();
+  }
+}
+
+void HTTPClient::end(void)
+{
+  if (_request >= 0)
+  {
+    native_phase_t *p = nativePhase(_request);
+    p->status = _returnCode;
+    p->bytes = _client ? _client->nativeBodyConsumed() : 0;
+    nativePhaseEnd(_request);
+    _request = -1;
+  }
+  if (_client && _client->connected())
+  {
+    while (_client->available() > 0) // unread data, clean up
+    {
+      _client->read();
+    }
+    if (!(_reuse && _canReuse))
+    {
+      _client->stop();
+      _client = nullptr;
+    }
+  }
+}
+
+void HTTPClient::addHeader(const String &name, const String &value,
+                           bool first, bool replace)
+{
+  for (std::pair<String, String> &h : _added)
+  {
+    if (replace && h.first.equalsIgnoreCase(name))
+    {
+      h.second = value;
+      return;
+    }
+  }
+  _added.emplace_back(name, value);
+}
+
+String HTTPClient::requestHeader(const char *name) const
+{
+  for (const std::pair<String, String> &h : _added)
+  {
+    if (h.first.equalsIgnoreCase(name))
+    {
+      return h.second;
+    }
+  }
+  return String();
+}
+
+void HTTPClient::collectHeaders(const char *headerKeys[],
+                                const size_t headerKeysCount)
+{
+  _collect.assign(headerKeys, headerKeys + headerKeysCount);
+}
+
+/* Only headers named in collectHeaders() are kept, as on the esp32.
+ */
+String HTTPClient::header(const char *name)
+{
+  bool collected = false;
+  for (const String &key : _collect)
+  {
+    collected |= key.equalsIgnoreCase(name);
+  }
+  for (const std::pair<String, String> &h : _headers)
+  {
+    if (collected && h.first.equalsIgnoreCase(name))
+    {
+      return h.second;
+    }
+  }
+  return String();
+}
+
+bool HTTPClient::hasHeader(const char *name)
+{
+  return header(name).length() > 0;
+}
+
+int HTTPClient::GET()
+{
+  if (!_client)
+  {
+    return HTTPC_ERROR_NOT_CONNECTED;
+  }
+  char name[96];
+  snprintf(name, sizeof(name), "GET %s%.*s", _host.c_str(),
+           static_cast<int>(strcspn(_uri.c_str(), "?")), _uri.c_str());
+  _request = nativePhaseBegin(name);
+
+  if (WiFi.status() != WL_CONNECTED)
+  {
+    _returnCode = HTTPC_ERROR_CONNECTION_REFUSED;
+    return _returnCode;
+  }
+  if (!_client->nativeIsConnectedTo(_host, _port))
+  {
+    _client->nativeConnect(_host, _port);
+  }
+  nativeAdvanceUs(nativeOpts.rttMs * 1000ULL); // request and response headers
+
+  _returnCode = nativeInjectedFailure(_host.c_str(), _uri.c_str());
+  if (_returnCode != 0)
+  {
+    _client->nativeAttachBody(nullptr, 0);
+    _size = 0;
+    return _returnCode;
+  }
+
+  const uint8_t *body = nullptr;
+  size_t len = 0;
+  time_t modified = 0;
+  if (!nativeFixtureOpen(_host.c_str(), _uri.c_str(), &body, &len, &modified))
+  {
+    _client->nativeAttachBody(nullptr, 0);
+    _size = 0;
+    _returnCode = HTTP_CODE_NOT_FOUND;
+    return _returnCode;
+  }
+  // an HTTP/1.0 server closes the connection after the response
+  _canReuse = _reuse && !_useHTTP10;
+
+  if (nativeOpts.validators)
+  {
+    uint32_t hash = 2166136261u; // FNV-1a of the body
+    for (size_t i = 0; i < len; ++i)
+    {
+      hash = (hash ^ body[i]) * 16777619u;
+    }
+    char etag[16];
+    char lastModified[32];
+    snprintf(etag, sizeof(etag), "\"%08x\"", hash);
+    struct tm t;
+    gmtime_r(&modified, &t);
+    strftime(lastModified, sizeof(lastModified), "%a, %d %b %Y %H:%M:%S GMT",
+             &t);
+    _headers.emplace_back("ETag", etag);
+    _headers.emplace_back("Last-Modified", lastModified);
+
+    String ifNoneMatch = requestHeader("If-None-Match");
+    String ifModifiedSince = requestHeader("If-Modified-Since");
+    if (ifNoneMatch.length() > 0 ? ifNoneMatch == etag
+                                 : ifModifiedSince == lastModified)
+    {
+      _client->nativeAttachBody(nullptr, 0);
+      _size = 0;
+      _returnCode = HTTP_CODE_NOT_MODIFIED;
+      return _returnCode;
+    }
+  }
+  if (!_useHTTP10 && nativeOpts.chunkBytes > 0
+   && nativeFixtureChunked(body, len, nativeOpts.chunkBytes, &body, &len))
+  {
+    _headers.emplace_back("Transfer-Encoding", "chunked");
+    _size = -1;
+  }
+  else
+  {
+    _size = static_cast<int>(len);
+  }
+  _client->nativeAttachBody(body, len);
+  _returnCode = HTTP_CODE_OK;
+  return _returnCode;
+}
+
+String HTTPClient::getString(void)
+{
+  String payload;
+  if (_client)
+  {
+    payload.reserve(_client->available());
+    while (_client->available())
+    {
+      payload += static_cast<char>(_client->read());
+    }
+  }
+  return payload;
+}
+
+String HTTPClient::errorToString(int error)
+{
+  switch (error)
+  {
+  case HTTPC_ERROR_CONNECTION_REFUSED:
+    return F("connection refused");
+  case HTTPC_ERROR_SEND_HEADER_FAILED:
+    return F("send header failed");
+  case HTTPC_ERROR_SEND_PAYLOAD_FAILED:
+    return F("send payload failed");
+  case HTTPC_ERROR_NOT_CONNECTED:
+    return F("not connected");
+  case HTTPC_ERROR_CONNECTION_LOST:
+    return F("connection lost");
+  case HTTPC_ERROR_NO_STREAM:
+    return F("no stream");
+  case HTTPC_ERROR_NO_HTTP_SERVER:
+    return F("no HTTP server");
+  case HTTPC_ERROR_TOO_LESS_RAM:
+    return F("too less ram");
+  case HTTPC_ERROR_ENCODING:
+    return F("Transfer-Encoding not supported");
+  case HTTPC_ERROR_STREAM_WRITE:
+    return F("Stream write error");
+  case HTTPC_ERROR_READ_TIMEOUT:
+    return F("read Timeout");
+  default:
+    return String();
+  }
+}
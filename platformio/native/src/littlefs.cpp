@@ -0,0 +1,177 @@
+/* Native (host) LittleFS shim for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <LittleFS.h>
+
+#include "native_harness.h"
+
+fs::LittleFSFS LittleFS;
+
+namespace fs
+{
+
+size_t File::read(uint8_t *buf, size_t size)
+{
+  return _f ? fread(buf, 1, size, _f.get()) : 0;
+}
+
+int File::read()
+{
+  uint8_t c;
+  return read(&c, 1) == 1 ? c : -1;
+}
+
+size_t File::write(const uint8_t *buf, size_t size)
+{
+  return _f ? fwrite(buf, 1, size, _f.get()) : 0;
+}
+
+bool File::seek(uint32_t pos)
+{
+  return _f && fseek(_f.get(), pos, SEEK_SET) == 0;
+}
+
+size_t File::position() const
+{
+  return _f ? ftell(_f.get()) : 0;
+}
+
+size_t File::size() const
+{
+  struct stat st;
+  return _f && fstat(fileno(_f.get()), &st) == 0 ? st.st_size : 0;
+}
+
+void File::flush()
+{
+  if (_f)
+  {
+    fflush(_f.get());
+  }
+}
+
+/* Paths are stored as <state>/fs-<path>, with '/' replaced by '_'.
+ */
+bool LittleFSFS::filePath(const char *path, char *out, size_t size)
+{
+  if (!_mounted || !path || path[0] != '/' || strlen(path) > 31)
+  {
+    return false;
+  }
+  char name[40];
+  snprintf(name, sizeof(name), "fs-%s", path + 1);
+  for (char *c = name; *c; ++c)
+  {
+    if (*c == '/')
+    {
+      *c = '_';
+    }
+  }
+  nativeStatePath(out, size, name);
+  return true;
+}
+
+bool LittleFSFS::begin(bool formatOnFail, const char *basePath,
+                       uint8_t maxOpenFiles, const char *partitionLabel)
+{
+  _mounted = true;
+  return true;
+}
+
+void LittleFSFS::end()
+{
+  _mounted = false;
+}
+
+bool LittleFSFS::format()
+{
+  if (!_mounted)
+  {
+    return false;
+  }
+  DIR *dir = opendir(nativeOpts.state);
+  if (!dir)
+  {
+    return true;
+  }
+  while (struct dirent *e = readdir(dir))
+  {
+    if (strncmp(e->d_name, "fs-", 3) == 0)
+    {
+      char path[512];
+      nativeStatePath(path, sizeof(path), e->d_name);
+      unlink(path);
+    }
+  }
+  closedir(dir);
+  return true;
+}
+
+File LittleFSFS::open(const char *path, const char *mode)
+{
+  char p[512];
+  if (!filePath(path, p, sizeof(p)))
+  {
+    return File();
+  }
+  char m[4];
+  snprintf(m, sizeof(m), "%c%sb", mode[0], mode[1] == '+' ? "+" : "");
+  FILE *f = fopen(p, m);
+  return f ? File(f) : File();
+}
+
+bool LittleFSFS::exists(const char *path)
+{
+  char p[512];
+  return filePath(path, p, sizeof(p)) && access(p, F_OK) == 0;
+}
+
+bool LittleFSFS::remove(const char *path)
+{
+  char p[512];
+  return filePath(path, p, sizeof(p)) && unlink(p) == 0;
+}
+
+size_t LittleFSFS::usedBytes()
+{
+  size_t used = 0;
+  DIR *dir = opendir(nativeOpts.state);
+  if (!dir)
+  {
+    return 0;
+  }
+  while (struct dirent *e = readdir(dir))
+  {
+    char path[512];
+    struct stat st;
+    nativeStatePath(path, sizeof(path), e->d_name);
+    if (strncmp(e->d_name, "fs-", 3) == 0 && stat(path, &st) == 0)
+    {
+      used += st.st_size;
+    }
+  }
+  closedir(dir);
+  return used;
+}
+
+} // namespace fs
@@ -0,0 +1,73 @@
+/* Native (host) mbedTLS session shim for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+
+#include <mbedtls/ssl.h>
+
+void mbedtls_ssl_session_init(mbedtls_ssl_session *session)
+{
+  memset(session, 0, sizeof(*session));
+}
+
+void mbedtls_ssl_session_free(mbedtls_ssl_session *session)
+{
+  memset(session, 0, sizeof(*session));
+}
+
+int mbedtls_ssl_get_session(const mbedtls_ssl_context *ssl,
+                            mbedtls_ssl_session *session)
+{
+  if (!ssl->has_session)
+  {
+    return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+  }
+  *session = ssl->session;
+  return 0;
+}
+
+int mbedtls_ssl_set_session(mbedtls_ssl_context *ssl,
+                            const mbedtls_ssl_session *session)
+{
+  ssl->session = *session;
+  ssl->has_session = true;
+  return 0;
+}
+
+int mbedtls_ssl_session_save(const mbedtls_ssl_session *session,
+                             unsigned char *buf, size_t buf_len,
+                             size_t *olen)
+{
+  *olen = sizeof(*session);
+  if (buf_len < sizeof(*session))
+  {
+    return MBEDTLS_ERR_SSL_BUFFER_TOO_SMALL;
+  }
+  memcpy(buf, session, sizeof(*session));
+  return 0;
+}
+
+int mbedtls_ssl_session_load(mbedtls_ssl_session *session,
+                             const unsigned char *buf, size_t len)
+{
+  if (len != sizeof(*session))
+  {
+    return MBEDTLS_ERR_SSL_BAD_INPUT_DATA;
+  }
+  memcpy(session, buf, sizeof(*session));
+  return 0;
+}
@@ -0,0 +1,274 @@
+/* Native (host) e-paper panel emulation for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+#include <cstring>
+
+#include <GxEPD2.h>
+
+#include "native_harness.h"
+
+#define NATIVE_PANEL_MAX_WIDTH  800
+#define NATIVE_PANEL_MAX_HEIGHT 480
+
+// native 7-color codes
+#define PX_BLACK 0
+#define PX_WHITE 1
+#define PX_RED   4
+
+// image written to the controller, and the image shown by the panel. Only a
+// refresh brings the written image to the panel.
+static uint8_t ram[NATIVE_PANEL_MAX_HEIGHT][NATIVE_PANEL_MAX_WIDTH];
+static uint8_t canvas[NATIVE_PANEL_MAX_HEIGHT][NATIVE_PANEL_MAX_WIDTH];
+static native_panel_format panelFormat = NATIVE_PANEL_BW;
+static uint16_t panelWidth = 0;
+static uint16_t panelHeight = 0;
+static uint16_t fullRefreshMs = 0;
+static uint16_t partialRefreshMs = 0;
+static int displayPhase = -1;
+
+static uint32_t numWrites = 0;
+static uint64_t bytesWritten = 0;
+static uint32_t numFullRefreshes = 0;
+static uint32_t numPartialRefreshes = 0;
+static uint64_t refreshedArea = 0;
+
+/* Clips a window to the panel, returns false if nothing is left.
+ */
+static bool clip(int16_t &x, int16_t &y, int16_t &w, int16_t &h)
+{
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  w = std::min<int16_t>(w, panelWidth - x);
+  h = std::min<int16_t>(h, panelHeight - y);
+  return w > 0 && h > 0;
+}
+
+/* The panel keeps its image without power, it is kept in <state>/panel.bin
+ * between wakes.
+ */
+static void loadCanvas()
+{
+  char path[512];
+  nativeStatePath(path, sizeof(path), "panel.bin");
+  FILE *f = fopen(path, "rb");
+  if (!f || fread(canvas, 1, sizeof(canvas), f) != sizeof(canvas))
+  {
+    memset(canvas, PX_WHITE, sizeof(canvas));
+  }
+  if (f)
+  {
+    fclose(f);
+  }
+}
+
+static void saveCanvas()
+{
+  char path[512];
+  nativeStatePath(path, sizeof(path), "panel.bin");
+  FILE *f = fopen(path, "wb");
+  if (f)
+  {
+    fwrite(canvas, 1, sizeof(canvas), f);
+    fclose(f);
+  }
+}
+
+void nativePanelInit(native_panel_format format, uint16_t width,
+                     uint16_t height, uint16_t full_refresh_time,
+                     uint16_t partial_refresh_time)
+{
+  if (displayPhase < 0)
+  {
+    displayPhase = nativePhaseBegin("display");
+    loadCanvas();
+  }
+  panelFormat = format;
+  panelWidth = std::min<uint16_t>(width, NATIVE_PANEL_MAX_WIDTH);
+  panelHeight = std::min<uint16_t>(height, NATIVE_PANEL_MAX_HEIGHT);
+  fullRefreshMs = full_refresh_time;
+  partialRefreshMs = partial_refresh_time;
+  memset(ram, PX_WHITE, sizeof(ram));
+}
+
+/* 1bpp image, MSB first, a set bit is white unless inverted.
+ */
+void nativePanelWriteBW(const uint8_t *bitmap, int16_t x, int16_t y,
+                        int16_t w, int16_t h, bool invert)
+{
+  int16_t wb = (w + 7) / 8;
+  ++numWrites;
+  bytesWritten += static_cast<uint64_t>(wb) * h;
+  for (int16_t j = 0; j < h; ++j)
+  {
+    for (int16_t i = 0; i < w; ++i)
+    {
+      int16_t px = x + i;
+      int16_t py = y + j;
+      if (px < 0 || px >= panelWidth || py < 0 || py >= panelHeight)
+      {
+        continue;
+      }
+      bool white = (bitmap[j * wb + i / 8] >> (7 - i % 8)) & 1;
+      ram[py][px] = (white != invert) ? PX_WHITE : PX_BLACK;
+    }
+  }
+}
+
+/* Two 1bpp planes, a cleared bit in the color plane is red and wins over the
+ * black plane.
+ */
+void nativePanelWrite3C(const uint8_t *black, const uint8_t *color,
+                        int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  int16_t wb = (w + 7) / 8;
+  ++numWrites;
+  bytesWritten += 2ULL * wb * h;
+  for (int16_t j = 0; j < h; ++j)
+  {
+    for (int16_t i = 0; i < w; ++i)
+    {
+      int16_t px = x + i;
+      int16_t py = y + j;
+      if (px < 0 || px >= panelWidth || py < 0 || py >= panelHeight)
+      {
+        continue;
+      }
+      uint8_t bit = 0x80 >> (i % 8);
+      uint32_t k = j * wb + i / 8;
+      if (!(color[k] & bit))
+      {
+        ram[py][px] = PX_RED;
+      }
+      else
+      {
+        ram[py][px] = (black[k] & bit) ? PX_WHITE : PX_BLACK;
+      }
+    }
+  }
+}
+
+/* 4bpp native codes, the even pixel in the high nibble.
+ */
+void nativePanelWrite7C(const uint8_t *native, int16_t x, int16_t y,
+                        int16_t w, int16_t h)
+{
+  int16_t wb = (w + 1) / 2;
+  ++numWrites;
+  bytesWritten += static_cast<uint64_t>(wb) * h;
+  for (int16_t j = 0; j < h; ++j)
+  {
+    for (int16_t i = 0; i < w; ++i)
+    {
+      int16_t px = x + i;
+      int16_t py = y + j;
+      if (px < 0 || px >= panelWidth || py < 0 || py >= panelHeight)
+      {
+        continue;
+      }
+      uint8_t b = native[j * wb + i / 2];
+      ram[py][px] = (i % 2) ? (b & 0x0F) : (b >> 4);
+    }
+  }
+}
+
+/* The refresh waveform dominates the time the display is powered, it is
+ * charged in full to the simulated clock. Only the refreshed window of the
+ * panel shows the written image afterwards.
+ */
+void nativePanelRefresh(int16_t x, int16_t y, int16_t w, int16_t h,
+                        bool partial)
+{
+  if (!clip(x, y, w, h))
+  {
+    return;
+  }
+  char name[64];
+  snprintf(name, sizeof(name), "%s refresh %dx%d+%d+%d",
+           partial ? "partial" : "full", w, h, x, y);
+  int phase = nativePhaseBegin(name);
+  nativeAdvanceUs((partial ? partialRefreshMs : fullRefreshMs) * 1000ULL);
+  nativePhaseEnd(phase);
+  if (partial)
+  {
+    ++numPartialRefreshes;
+  }
+  else
+  {
+    ++numFullRefreshes;
+  }
+  refreshedArea += static_cast<uint64_t>(w) * h;
+  for (int16_t j = y; j < y + h; ++j)
+  {
+    memcpy(&canvas[j][x], &ram[j][x], w);
+  }
+}
+
+void nativePanelHibernate()
+{
+  saveCanvas();
+  nativePhaseEnd(displayPhase);
+}
+
+void nativePanelReport()
+{
+  if (panelWidth == 0)
+  {
+    return;
+  }
+  fprintf(stderr, "[native] panel %ux%u: %u writes (%llu B), "
+                  "%u full + %u partial refreshes, %llu px refreshed\n",
+          panelWidth, panelHeight, numWrites,
+          static_cast<unsigned long long>(bytesWritten), numFullRefreshes,
+          numPartialRefreshes,
+          static_cast<unsigned long long>(refreshedArea));
+}
+
+/* Writes the panel content as a binary PPM image.
+ */
+void nativePanelSaveFrame(const char *path)
+{
+  static const uint8_t rgb[8][3] = {
+    {0x00, 0x00, 0x00}, // black
+    {0xFF, 0xFF, 0xFF}, // white
+    {0x00, 0xFF, 0x00}, // green
+    {0x00, 0x00, 0xFF}, // blue
+    {0xFF, 0x00, 0x00}, // red
+    {0xFF, 0xFF, 0x00}, // yellow
+    {0xFF, 0x80, 0x00}, // orange
+    {0xFF, 0xFF, 0xFF}, // unused, clean
+  };
+  if (panelWidth == 0)
+  {
+    return;
+  }
+  FILE *f = fopen(path, "wb");
+  if (!f)
+  {
+    fprintf(stderr, "[native] could not write %s\n", path);
+    return;
+  }
+  fprintf(f, "P6\n%u %u\n255\n", panelWidth, panelHeight);
+  for (uint16_t y = 0; y < panelHeight; ++y)
+  {
+    for (uint16_t x = 0; x < panelWidth; ++x)
+    {
+      fwrite(rgb[canvas[y][x] & 0x07], 1, 3, f);
+    }
+  }
+  fclose(f);
+}
@@ -0,0 +1,306 @@
+# Font subsetting build step for esp32-weather-epd.
+# Copyright (C) 2022-2025  Luke Marzen
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+"""Writes a copy of FONT_HEADER with only the glyphs the firmware can draw.
+
+Run by PlatformIO before each build (extra_scripts in platformio.ini), when
+FONT_SUBSET is 1 in include/config.h. The copy is written as font_subset.h in
+the build directory, which is added to the include path. renderer.cpp
+includes it instead of FONT_HEADER when FONT_SUBSET or FONT_COMPRESS is 1, so
+the full font from lib/esp32-weather-epd-assets is never picked up by mistake.
+
+Only the FONT_*pt8b sizes named in src/ and include/ are written. Each keeps
+printable ASCII (city, alert and status text come from the network), the
+characters of the selected locale's strings and the string and character
+literals of the firmware (units, the degree sign). Glyphs outside of that set
+keep a GFXglyph entry, a copy of the '?' glyph, so the font is still a GFXfont
+that Adafruit_GFX indexes from first to last and network text with other
+characters keeps its spacing.
+
+When FONT_COMPRESS is 1, each glyph is stored as runs of 4-bit codes if that
+is smaller than its bits, flagged in bit 15 of its bitmapOffset. The format is
+described in include/font_rle.h, the display decodes it as it draws. With
+FONT_SUBSET 0 and FONT_COMPRESS 1, every glyph is kept and compressed.
+
+Can also be run by hand to see what a subset saves:
+  python scripts/font_subset.py [OUTPUT_DIR]
+"""
+
+import os
+import re
+import sys
+
+ASSETS_DIR = os.path.join('lib', 'esp32-weather-epd-assets')
+CONFIG_H = os.path.join('include', 'config.h')
+LOCALES_DIR = os.path.join('include', 'locales')
+SOURCE_DIRS = ('src', 'include')
+
+# kept in every size, text from the network is not known at build time
+ALWAYS = bytes(range(0x20, 0x7F)) + b'\xb0'
+# drawn for the glyphs that are not kept
+FALLBACK = ord('?')
+# written to the build directory, see configure()
+SUBSET_HEADER = 'font_subset.h'
+
+# include/font_rle.h
+RLE_GLYPH = 0x8000
+RLE_LONG = 15
+
+C_ESCAPES = {'n': 0x0A, 't': 0x09, 'r': 0x0D, '\\': 0x5C, '\'': 0x27,
+             '"': 0x22, '?': 0x3F, 'a': 0x07, 'b': 0x08, 'f': 0x0C,
+             'v': 0x0B}
+
+
+def read_config(project_dir):
+    """Returns the active #defines of config.h, name -> value."""
+    with open(os.path.join(project_dir, CONFIG_H), encoding='utf-8') as f:
+        text = f.read()
+    return dict(re.findall(r'^[ \t]*#define[ \t]+(\w+)[ \t]*(.*?)[ \t\r]*$',
+                           text, re.M))
+
+
+def decode_literal(body):
+    """Bytes of a C string or character literal, escapes decoded."""
+    out = bytearray()
+    raw = body.encode('utf-8')
+    i = 0
+    while i < len(raw):
+        if raw[i] != 0x5C or i + 1 == len(raw):
+            out.append(raw[i])
+            i += 1
+            continue
+        e = chr(raw[i + 1])
+        if e in '01234567':
+            digits = re.match(rb'[0-7]{1,3}', raw[i + 1:]).group(0)
+            out.append(int(digits, 8) & 0xFF)
+            i += 1 + len(digits)
+        elif e == 'x':
+            digits = re.match(rb'[0-9a-fA-F]*', raw[i + 2:]).group(0)
+            out.append(int(digits or b'0', 16) & 0xFF)
+            i += 2 + len(digits)
+        else:
+            out.append(C_ESCAPES.get(e, ord(e)))
+            i += 2
+    return bytes(out)
+
+
+def literal_bytes(path):
+    """Bytes of every string and character literal in a source file."""
+    with open(path, encoding='utf-8', errors='replace') as f:
+        text = f.read()
+    # comments first, they are full of apostrophes
+    text = re.sub(r'/\*.*?\*/', ' ', text, flags=re.S)
+    text = re.sub(r'//[^\n]*', ' ', text)
+    found = bytearray()
+    for m in re.finditer(r'"((?:[^"\\\n]|\\.)*)"|\'((?:[^\'\\\n]|\\.)+)\'',
+                         text):
+        found += decode_literal(m.group(1) if m.group(1) is not None
+                                else m.group(2))
+    return bytes(found)
+
+
+def source_files(project_dir):
+    """The firmware sources that can name fonts or draw literals."""
+    for d in SOURCE_DIRS:
+        for name in sorted(os.listdir(os.path.join(project_dir, d))):
+            if name.endswith(('.cpp', '.h')) and name != 'config.h':
+                yield os.path.join(project_dir, d, name)
+
+
+def needed_chars(project_dir, locale):
+    chars = set(ALWAYS)
+    chars.update(literal_bytes(os.path.join(project_dir, LOCALES_DIR,
+                                            'locale_' + locale + '.inc')))
+    for path in source_files(project_dir):
+        chars.update(literal_bytes(path))
+    return {c for c in chars if c >= 0x20}
+
+
+def used_sizes(project_dir):
+    """FONT_*pt8b* macros the firmware uses, e.g. '12pt8b'."""
+    sizes = set()
+    for path in source_files(project_dir):
+        with open(path, encoding='utf-8', errors='replace') as f:
+            sizes.update(re.findall(r'\bFONT_(\d+pt8b\w*)', f.read()))
+    return sizes
+
+
+def parse_font(path):
+    """Bitmaps, glyphs, first, last and yAdvance of a fontconvert header."""
+    with open(path, encoding='latin-1') as f:
+        text = f.read()
+    bitmap_text = re.search(r'Bitmaps\[\]\s*PROGMEM\s*=\s*\{(.*?)\};', text,
+                            re.S).group(1)
+    bitmaps = bytes(int(b, 16)
+                    for b in re.findall(r'0x[0-9A-Fa-f]+', bitmap_text))
+    glyph_text = re.search(r'Glyphs\[\]\s*PROGMEM\s*=\s*\{(.*?)\};', text,
+                           re.S).group(1)
+    glyphs = [tuple(int(v) for v in g.split(','))
+              for g in re.findall(r'\{\s*([-\d,\s]+?)\s*\}', glyph_text)]
+    first, last, y_advance = re.search(
+        r'\(GFXglyph\s*\*\)\w+,\s*(0x[0-9A-Fa-f]+|\d+),'
+        r'\s*(0x[0-9A-Fa-f]+|\d+),\s*(\d+)\s*\}', text).groups()
+    return bitmaps, glyphs, int(first, 0), int(last, 0), int(y_advance)
+
+
+def glyph_runs(bits, n):
+    """The n pixels of a glyph's bit stream as 4-bit run codes, packed."""
+    codes = []
+    color = 0
+    run = 0
+    for i in range(n):
+        if (bits[i // 8] >> (7 - i % 8)) & 1 == color:
+            run += 1
+            continue
+        codes += [RLE_LONG] * (run // RLE_LONG) + [run % RLE_LONG]
+        color ^= 1
+        run = 1
+    codes += [RLE_LONG] * (run // RLE_LONG) + [run % RLE_LONG]
+    if len(codes) % 2:
+        codes.append(0)
+    return bytes(codes[i] << 4 | codes[i + 1]
+                 for i in range(0, len(codes), 2))
+
+
+def subset_font(name, path, chars, compress):
+    """C source of the subset font, and its size before and after, bytes.
+
+    chars is None to keep every glyph.
+    """
+    bitmaps, glyphs, first, last, y_advance = parse_font(path)
+    if chars is None:
+        chars = set(range(first, last + 1))
+    keep = [c for c in range(first, last + 1) if c in chars]
+    new_first, new_last = min(keep), max(keep)
+    out_bitmaps = bytearray()
+    out_glyphs = []
+    for c in range(new_first, new_last + 1):
+        offset, w, h, x_advance, x_offset, y_offset = glyphs[c - first]
+        if c not in chars:
+            # the advance is kept until the fallback glyph is known
+            out_glyphs.append((c, (0, 0, 0, x_advance, 0, 0), False))
+            continue
+        data = bitmaps[offset:offset + (w * h + 7) // 8]
+        new_offset = len(out_bitmaps)
+        if compress:
+            runs = glyph_runs(data, w * h)
+            if len(runs) < len(data):
+                data = runs
+                new_offset |= RLE_GLYPH
+            if len(out_bitmaps) >= RLE_GLYPH:
+                raise ValueError('%s is too large to compress, %d bytes'
+                                 % (name, len(out_bitmaps)))
+        out_glyphs.append((c, (new_offset, w, h, x_advance, x_offset,
+                               y_offset), True))
+        out_bitmaps += data
+    fallback = [g for c, g, kept in out_glyphs if kept and c == FALLBACK]
+    if fallback:
+        out_glyphs = [(c, g if kept else fallback[0], kept)
+                      for c, g, kept in out_glyphs]
+
+    lines = ['const uint8_t %sBitmaps[] PROGMEM = {' % name]
+    data = out_bitmaps or b'\x00'
+    for i in range(0, len(data), 12):
+        lines.append('  ' + ', '.join('0x%02X' % b for b in data[i:i + 12])
+                     + (',' if i + 12 < len(data) else ' };'))
+    lines.append('')
+    lines.append('const GFXglyph %sGlyphs[] PROGMEM = {' % name)
+    for i, (c, g, kept) in enumerate(out_glyphs):
+        end = ',  ' if i + 1 < len(out_glyphs) else ' };'
+        if not kept:
+            label = '(not kept)'
+        elif 0x20 <= c < 0x7F and c != 0x5C:
+            label = "'%c'" % c
+        else:
+            label = ''
+        if g[0] & RLE_GLYPH:
+            label = (label + ' runs').strip()
+        lines.append('  { %5d, %3d, %3d, %3d, %4d, %4d }%s // 0x%02X %s'
+                     % (g + (end, c, label)))
+    lines.append('')
+    lines.append('const GFXfont %s PROGMEM = {' % name)
+    lines.append('  (uint8_t  *)%sBitmaps,' % name)
+    lines.append('  (GFXglyph *)%sGlyphs,' % name)
+    lines.append('  0x%02X, 0x%02X, %d };' % (new_first, new_last, y_advance))
+    lines.append('')
+    before = len(bitmaps) + 7 * len(glyphs)
+    after = len(out_bitmaps) + 7 * len(out_glyphs)
+    return '\n'.join(lines), before, after
+
+
+def write_subset(project_dir, out_dir):
+    """Writes the subset or compressed FONT_HEADER to out_dir/font_subset.h,
+    if it changed.
+    """
+    config = read_config(project_dir)
+    subset = config.get('FONT_SUBSET') == '1'
+    compress = config.get('FONT_COMPRESS') == '1'
+    header = config['FONT_HEADER'].strip('"')
+    header_path = os.path.join(project_dir, ASSETS_DIR, header)
+    with open(header_path, encoding='utf-8') as f:
+        header_text = f.read()
+    files = {os.path.splitext(os.path.basename(inc))[0]: inc
+             for inc in re.findall(r'#include\s+"([^"]+)"', header_text)}
+    macros = [(size, name) for size, name
+              in re.findall(r'#define\s+FONT_(\w+)\s+(\w+)', header_text)
+              if not subset or size in used_sizes(project_dir)]
+    chars = needed_chars(project_dir, config['LOCALE']) if subset else None
+
+    guard = re.search(r'#ifndef\s+(\w+)', header_text).group(1)
+    out = ['// DO NOT MODIFY -- THIS FILE WAS GENERATED BY '
+           '`scripts/font_subset.py` from %s' % header,
+           '#ifndef ' + guard, '#define ' + guard, '']
+    total_before = total_after = 0
+    for size, name in macros:
+        path = os.path.join(os.path.dirname(header_path), files[name])
+        source, before, after = subset_font(name, path, chars, compress)
+        out += ['// %s: %d -> %d bytes' % (name, before, after), source]
+        total_before += before
+        total_after += after
+        print('font_subset: %-32s %7d -> %7d bytes' % (name, before, after))
+    for size, name in macros:
+        out.append('#define FONT_%s %s' % (size, name))
+    out += ['#endif', '']
+    print('font_subset: %s characters, %d sizes%s, %d -> %d bytes'
+          % (len(chars) if subset else 'all', len(macros),
+             ', compressed' if compress else '', total_before, total_after))
+
+    out_path = os.path.join(out_dir, SUBSET_HEADER)
+    text = '\n'.join(out)
+    if os.path.exists(out_path):
+        with open(out_path, encoding='latin-1') as f:
+            if f.read() == text:
+                return  # unchanged, renderer.cpp is not rebuilt
+    os.makedirs(os.path.dirname(out_path), exist_ok=True)
+    with open(out_path, 'w', encoding='latin-1') as f:
+        f.write(text)
+
+
+def configure(env):
+    project_dir = env.subst('$PROJECT_DIR')
+    config = read_config(project_dir)
+    if '1' not in (config.get('FONT_SUBSET'), config.get('FONT_COMPRESS')):
+        return
+    out_dir = os.path.join(env.subst('$BUILD_DIR'), 'font_subset')
+    write_subset(project_dir, out_dir)
+    env.Append(CPPPATH=[out_dir])
+
+
+if __name__ == '__main__':
+    write_subset(os.path.dirname(os.path.dirname(os.path.abspath(__file__))),
+                 sys.argv[1] if len(sys.argv) > 1 else 'font_subset')
+else:
+    Import('env')  # noqa: F821, provided by PlatformIO (SCons)
+    configure(env)  # noqa: F821
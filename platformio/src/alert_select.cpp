@@ -0,0 +1,182 @@
+/* Alert selection for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "alert_select.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+
+#include "_locale.h"
+
+/* Takes a string and truncates at any of these characters ,.( and trims any
+ * trailing whitespace.
+ *
+ * Ex:
+ *   input   : "severe thunderstorm warning, (starting at 10 pm)"
+ *   becomes : "severe thunderstorm warning"
+ */
+void truncateExtraAlertInfo(char *text)
+{
+  if (text[0] == '\0')
+  {
+    return;
+  }
+
+  size_t i = 1;
+  size_t lastChar = i;
+  while (text[i] != '\0'
+    && text[i] != ','
+    && text[i] != '.'
+    && text[i] != '(')
+  {
+    if (text[i] != ' ')
+    {
+      lastChar = i + 1;
+    }
+    ++i;
+  }
+
+  text[lastChar] = '\0';
+  return;
+} // end truncateExtraAlertInfo
+
+static void toLowerCase(char *text)
+{
+  for (; *text; ++text)
+  {
+    *text = static_cast<char>(tolower(static_cast<unsigned char>(*text)));
+  }
+} // end toLowerCase
+
+/* FNV-1a of a string.
+ */
+static uint32_t tagHash(const char *tag)
+{
+  uint32_t h = 2166136261u;
+  for (; *tag; ++tag)
+  {
+    h = (h ^ static_cast<uint8_t>(*tag)) * 16777619u;
+  }
+  return h;
+} // end tagHash
+
+void alertSelectorInit(alert_selector_t &s)
+{
+  s.used = 0;
+  s.offered = 0;
+} // end alertSelectorInit
+
+/* Selects the alerts to display, from the alerts of an API response offered
+ * one at a time in the order of the response.
+ *
+ * Background:
+ * The display layout is setup to show up to 2 alerts, but alerts can be
+ * unpredictible in severity and number. If more than 2 alerts are active, this
+ * algorithm will attempt to interpret the urgency of each alert and prefer to
+ * display the most urgent and recently issued alerts of each event type.
+ * Depending on the region different keywords are used to convey the level of
+ * urgency, see ALERT_URGENCY in the locale.
+ *
+ * Each alert is looked at once, when it is offered. Its event text and tags
+ * are converted to lowercase, and its urgency and the hash of its first tag
+ * are computed.
+ *
+ * // Deduplicate alerts of the same type
+ * Only the most urgent alert of each first tag is kept, the first one if
+ * there are several, and every alert without tags. An alert that is not more
+ * urgent than the kept alert of its tag is dropped as soon as it is offered,
+ * without copying anything. One that is replaces it.
+ *
+ * // Save only the 2 most recent alerts
+ * The kept alerts stay in the order they were offered. OpenWeatherMap orders
+ * alerts by issue time, so the first ALERT_SELECTED of them are the most
+ * recent, see alertSelectorResult().
+ *
+ * Extraneous info (anything that follows a comma, period, or open
+ * parentheses) is truncated from the event text of kept alerts.
+ *
+ * Only the first OWM_NUM_ALERTS alerts are considered. event and tags are
+ * modified.
+ */
+void alertSelectorOffer(alert_selector_t &s, char *event, char *tags,
+                        int64_t start, int64_t end)
+{
+  if (s.offered >= OWM_NUM_ALERTS)
+  {
+    return;
+  }
+  ++s.offered;
+
+  toLowerCase(event);
+  toLowerCase(tags);
+  const int8_t urgency = matchAlertTerms(event, strlen(event)).urgency;
+  const bool tagged = tags[0] != '\0';
+  const uint32_t hash = tagged ? tagHash(tags) : 0;
+
+  if (tagged)
+  {
+    for (uint8_t i = 0; i < s.used; ++i)
+    {
+      alert_slot_t &kept = s.slot[i];
+      // the hash only rules out most tags quickly
+      if (kept.tagged && kept.tag_hash == hash
+       && strcmp(kept.tags, tags) == 0)
+      {
+        if (kept.urgency >= urgency)
+        {
+          return;
+        }
+        // the more urgent alert takes the place of this one, at the end
+        memmove(&s.slot[i], &s.slot[i + 1],
+                (s.used - i - 1) * sizeof(alert_slot_t));
+        --s.used;
+        break;
+      }
+    }
+  }
+
+  alert_slot_t &a = s.slot[s.used++];
+  a.start = start;
+  a.end = end;
+  a.tag_hash = hash;
+  a.urgency = urgency;
+  a.tagged = tagged;
+  truncateExtraAlertInfo(event);
+  snprintf(a.event, sizeof(a.event), "%s", event);
+  snprintf(a.tags, sizeof(a.tags), "%s", tags);
+  return;
+} // end alertSelectorOffer
+
+/* Replaces alerts with the selected alerts, at most ALERT_SELECTED.
+ */
+void alertSelectorResult(const alert_selector_t &s,
+                         std::vector<owm_alerts_t> &alerts)
+{
+  alerts.clear();
+  for (uint8_t i = 0; i < s.used && i < ALERT_SELECTED; ++i)
+  {
+    const alert_slot_t &a = s.slot[i];
+    owm_alerts_t alert = {};
+    alert.event = a.event;
+    alert.start = a.start;
+    alert.end   = a.end;
+    alert.tags  = a.tags;
+    alerts.push_back(alert);
+  }
+  return;
+} // end alertSelectorResult
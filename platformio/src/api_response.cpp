@@ -15,28 +15,415 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <vector>
 #include <math.h>
 #include <ArduinoJson.h>
 
+#include "_locale.h"
+#include "alert_select.h"
 #include "api_response.h"
 #include "config.h"
+#include "conversions.h"
+#include "geo_distance.h"
+#include "json_stream.h"
 
-// Haversine formula for distance calculation
-float calculateDistance(float lat1, float lon1, float lat2, float lon2) {
-  const float R = 6371.0; // Earth radius in km
-  float dLat = radians(lat2 - lat1);
-  float dLon = radians(lon2 - lon1);
+/* Takes an OpenWeatherMap icon id like "10d" and stores the icon number and
+ * the day/night suffix.
+ */
+static void setWeatherIcon(owm_weather_t &w, const char *icon)
+{
+  w.icon = 0;
+  w.day = false;
+  if (icon == nullptr)
+  {
+    return;
+  }
+  while (*icon >= '0' && *icon <= '9')
+  {
+    w.icon = w.icon * 10 + (*icon++ - '0');
+  }
+  w.day = (*icon == 'd');
+} // end setWeatherIcon
+
+/* Copies the hours shown on the outlook graph into r.hourly_series, converted
+ * to the display units, and finds the min/max of temperature and precipitation.
+ */
+static void fillHourlySeries(owm_resp_onecall_t &r)
+{
+  owm_hourly_series_t &s = r.hourly_series;
+  s.count = std::min<int>(OWM_NUM_HOURLY, HOURLY_GRAPH_MAX);
+  for (int i = 0; i < s.count; ++i)
+  {
+    const owm_hourly_t &h = r.hourly[i];
+    s.dt[i] = h.dt;
+#ifdef UNITS_TEMP_KELVIN
+    s.temp[i] = h.temp;
+#endif
+#ifdef UNITS_TEMP_CELSIUS
+    s.temp[i] = kelvin_to_celsius(h.temp);
+#endif
+#ifdef UNITS_TEMP_FAHRENHEIT
+    s.temp[i] = kelvin_to_fahrenheit(h.temp);
+#endif
+#ifdef UNITS_HOURLY_PRECIP_POP
+    s.precip[i] = h.pop * 100;
+#endif
+#ifdef UNITS_HOURLY_PRECIP_MILLIMETERS
+    s.precip[i] = h.rain_1h + h.snow_1h;
+#endif
+#ifdef UNITS_HOURLY_PRECIP_CENTIMETERS
+    s.precip[i] = millimeters_to_centimeters(h.rain_1h + h.snow_1h);
+#endif
+#ifdef UNITS_HOURLY_PRECIP_INCHES
+    s.precip[i] = millimeters_to_inches(h.rain_1h + h.snow_1h);
+#endif
+    s.clouds[i] = static_cast<uint8_t>(h.clouds);
+    s.wind_speed[i] = h.wind_speed;
+    s.wind_gust[i] = h.wind_gust;
+    s.weather[i] = h.weather;
+  }
 
-  float a = sin(dLat / 2) * sin(dLat / 2) +
-            cos(radians(lat1)) * cos(radians(lat2)) *
-            sin(dLon / 2) * sin(dLon / 2);
+  s.temp_min = s.temp[0];
+  s.temp_max = s.temp[0];
+  s.precip_max = s.precip[0];
+  for (int i = 1; i < s.count; ++i)
+  {
+    s.temp_min = std::min(s.temp_min, s.temp[i]);
+    s.temp_max = std::max(s.temp_max, s.temp[i]);
+    s.precip_max = std::max(s.precip_max, s.precip[i]);
+  }
+} // end fillHourlySeries
 
-  float c = 2 * atan2(sqrt(a), sqrt(1 - a));
-  return R * c;
-}
+#if JSON_STREAMING_PARSER
+/* Reads the first entry of a "weather" array, later entries are skipped.
+ */
+static void readWeather(JsonStreamReader &json, owm_weather_t &w)
+{
+  char key[16];
+  char icon[4];
+  int id;
+  if (!json.beginArray())
+  {
+    json.skipValue();
+    return;
+  }
+  if (json.nextElement())
+  {
+    if (json.beginObject())
+    {
+      while (json.nextKey(key, sizeof(key)))
+      {
+        if (!strcmp(key, "id"))
+        {
+          json.readInt(id);
+          w.id = id;
+        }
+        else if (!strcmp(key, "icon"))
+        {
+          json.readString(icon, sizeof(icon));
+          setWeatherIcon(w, icon);
+        }
+        else
+        {
+          json.skipValue();
+        }
+      }
+    }
+    else
+    {
+      json.skipValue();
+    }
+    json.skipRest();
+  }
+} // end readWeather
 
-DeserializationError deserializeOneCall(WiFiClient &json,
+/* Reads precipitation objects like "rain": {"1h": 0.25}.
+ */
+static void readVolume1h(JsonStreamReader &json, float &volume)
+{
+  char key[4];
+  volume = 0.f;
+  if (!json.beginObject())
+  {
+    json.skipValue();
+    return;
+  }
+  while (json.nextKey(key, sizeof(key)))
+  {
+    if (!strcmp(key, "1h")) json.readFloat(volume);
+    else                    json.skipValue();
+  }
+} // end readVolume1h
+
+static void readCurrent(JsonStreamReader &json, owm_current_t &c)
+{
+  char key[16];
+  c = {};
+  if (!json.beginObject())
+  {
+    json.skipValue();
+    return;
+  }
+  while (json.nextKey(key, sizeof(key)))
+  {
+    if      (!strcmp(key, "dt"))         json.readInt64(c.dt);
+    else if (!strcmp(key, "sunrise"))    json.readInt64(c.sunrise);
+    else if (!strcmp(key, "sunset"))     json.readInt64(c.sunset);
+    else if (!strcmp(key, "temp"))       json.readFloat(c.temp);
+    else if (!strcmp(key, "feels_like")) json.readFloat(c.feels_like);
+    else if (!strcmp(key, "pressure"))   json.readInt(c.pressure);
+    else if (!strcmp(key, "humidity"))   json.readInt(c.humidity);
+    else if (!strcmp(key, "dew_point"))  json.readFloat(c.dew_point);
+    else if (!strcmp(key, "clouds"))     json.readInt(c.clouds);
+    else if (!strcmp(key, "uvi"))        json.readFloat(c.uvi);
+    else if (!strcmp(key, "visibility")) json.readInt(c.visibility);
+    else if (!strcmp(key, "wind_speed")) json.readFloat(c.wind_speed);
+    else if (!strcmp(key, "wind_gust"))  json.readFloat(c.wind_gust);
+    else if (!strcmp(key, "wind_deg"))   json.readInt(c.wind_deg);
+    else if (!strcmp(key, "rain"))       readVolume1h(json, c.rain_1h);
+    else if (!strcmp(key, "snow"))       readVolume1h(json, c.snow_1h);
+    else if (!strcmp(key, "weather"))    readWeather(json, c.weather);
+    else                                 json.skipValue();
+  }
+} // end readCurrent
+
+static void readHourly(JsonStreamReader &json, owm_hourly_t &h)
+{
+  char key[16];
+  h = {};
+  if (!json.beginObject())
+  {
+    json.skipValue();
+    return;
+  }
+  while (json.nextKey(key, sizeof(key)))
+  {
+    if      (!strcmp(key, "dt"))         json.readInt64(h.dt);
+    else if (!strcmp(key, "temp"))       json.readFloat(h.temp);
+    else if (!strcmp(key, "feels_like")) json.readFloat(h.feels_like);
+    else if (!strcmp(key, "pressure"))   json.readInt(h.pressure);
+    else if (!strcmp(key, "humidity"))   json.readInt(h.humidity);
+    else if (!strcmp(key, "dew_point"))  json.readFloat(h.dew_point);
+    else if (!strcmp(key, "clouds"))     json.readInt(h.clouds);
+    else if (!strcmp(key, "uvi"))        json.readFloat(h.uvi);
+    else if (!strcmp(key, "visibility")) json.readInt(h.visibility);
+    else if (!strcmp(key, "wind_speed")) json.readFloat(h.wind_speed);
+    else if (!strcmp(key, "wind_gust"))  json.readFloat(h.wind_gust);
+    else if (!strcmp(key, "wind_deg"))   json.readInt(h.wind_deg);
+    else if (!strcmp(key, "pop"))        json.readFloat(h.pop);
+    else if (!strcmp(key, "rain"))       readVolume1h(json, h.rain_1h);
+    else if (!strcmp(key, "snow"))       readVolume1h(json, h.snow_1h);
+    else if (!strcmp(key, "weather"))    readWeather(json, h.weather);
+    else                                 json.skipValue();
+  }
+} // end readHourly
+
+/* Reads the morn/day/eve/night(/min/max) objects of a daily forecast.
+ */
+static void readDailyTemp(JsonStreamReader &json, float *morn, float *day,
+                          float *eve, float *night, float *min, float *max)
+{
+  char key[8];
+  if (!json.beginObject())
+  {
+    json.skipValue();
+    return;
+  }
+  while (json.nextKey(key, sizeof(key)))
+  {
+    if      (!strcmp(key, "morn"))         json.readFloat(*morn);
+    else if (!strcmp(key, "day"))          json.readFloat(*day);
+    else if (!strcmp(key, "eve"))          json.readFloat(*eve);
+    else if (!strcmp(key, "night"))        json.readFloat(*night);
+    else if (!strcmp(key, "min") && min)   json.readFloat(*min);
+    else if (!strcmp(key, "max") && max)   json.readFloat(*max);
+    else                                   json.skipValue();
+  }
+} // end readDailyTemp
+
+static void readDaily(JsonStreamReader &json, owm_daily_t &d)
+{
+  char key[16];
+  d = {};
+  if (!json.beginObject())
+  {
+    json.skipValue();
+    return;
+  }
+  while (json.nextKey(key, sizeof(key)))
+  {
+    if      (!strcmp(key, "dt"))         json.readInt64(d.dt);
+    else if (!strcmp(key, "sunrise"))    json.readInt64(d.sunrise);
+    else if (!strcmp(key, "sunset"))     json.readInt64(d.sunset);
+    else if (!strcmp(key, "moonrise"))   json.readInt64(d.moonrise);
+    else if (!strcmp(key, "moonset"))    json.readInt64(d.moonset);
+    else if (!strcmp(key, "moon_phase")) json.readFloat(d.moon_phase);
+    else if (!strcmp(key, "temp"))
+    {
+      readDailyTemp(json, &d.temp.morn, &d.temp.day, &d.temp.eve,
+                    &d.temp.night, &d.temp.min, &d.temp.max);
+    }
+    else if (!strcmp(key, "feels_like"))
+    {
+      readDailyTemp(json, &d.feels_like.morn, &d.feels_like.day,
+                    &d.feels_like.eve, &d.feels_like.night, nullptr, nullptr);
+    }
+    else if (!strcmp(key, "pressure"))   json.readInt(d.pressure);
+    else if (!strcmp(key, "humidity"))   json.readInt(d.humidity);
+    else if (!strcmp(key, "dew_point"))  json.readFloat(d.dew_point);
+    else if (!strcmp(key, "clouds"))     json.readInt(d.clouds);
+    else if (!strcmp(key, "uvi"))        json.readFloat(d.uvi);
+    else if (!strcmp(key, "visibility")) json.readInt(d.visibility);
+    else if (!strcmp(key, "wind_speed")) json.readFloat(d.wind_speed);
+    else if (!strcmp(key, "wind_gust"))  json.readFloat(d.wind_gust);
+    else if (!strcmp(key, "wind_deg"))   json.readInt(d.wind_deg);
+    else if (!strcmp(key, "pop"))        json.readFloat(d.pop);
+    else if (!strcmp(key, "rain"))       json.readFloat(d.rain);
+    else if (!strcmp(key, "snow"))       json.readFloat(d.snow);
+    else if (!strcmp(key, "weather"))    readWeather(json, d.weather);
+    else                                 json.skipValue();
+  }
+} // end readDaily
+
+#if DISPLAY_ALERTS
+/* Reads one alert into stack buffers and offers it to the selector, which
+ * copies it only if it is kept. Like the document filter, sender_name and the
+ * (very long) description are skipped and only the first tag is kept.
+ */
+static void readAlert(JsonStreamReader &json, alert_selector_t &selector)
+{
+  char key[16];
+  char event[ALERT_READ_LEN] = {};
+  char tags[ALERT_TAG_LEN] = {};
+  int64_t start = 0;
+  int64_t end = 0;
+  if (!json.beginObject())
+  {
+    json.skipValue();
+    return;
+  }
+  while (json.nextKey(key, sizeof(key)))
+  {
+    if      (!strcmp(key, "event")) json.readString(event, sizeof(event));
+    else if (!strcmp(key, "start")) json.readInt64(start);
+    else if (!strcmp(key, "end"))   json.readInt64(end);
+    else if (!strcmp(key, "tags"))
+    {
+      if (json.beginArray())
+      {
+        if (json.nextElement())
+        {
+          json.readString(tags, sizeof(tags));
+          json.skipRest();
+        }
+      }
+      else
+      {
+        json.skipValue();
+      }
+    }
+    else
+    {
+      json.skipValue();
+    }
+  }
+  alertSelectorOffer(selector, event, tags, start, end);
+} // end readAlert
+#endif
+
+/* Streams the One Call response straight into r, without building a
+ * JsonDocument. Hourly entries past what the outlook graph shows are skipped.
+ */
+DeserializationError deserializeOneCall(Stream &stream,
+                                        owm_resp_onecall_t &r)
+{
+  JsonStreamReader json(stream);
+  char key[16];
+  const int numHourly = std::min<int>(OWM_NUM_HOURLY, HOURLY_GRAPH_MAX);
+
+  r.alerts.clear();
+  if (!json.beginObject())
+  {
+    if (json.error() == DeserializationError::Ok)
+    {
+      return DeserializationError::InvalidInput;
+    }
+    return json.error();
+  }
+  while (json.nextKey(key, sizeof(key)))
+  {
+    if      (!strcmp(key, "lat"))             json.readFloat(r.lat);
+    else if (!strcmp(key, "lon"))             json.readFloat(r.lon);
+    else if (!strcmp(key, "timezone"))        json.readString(r.timezone);
+    else if (!strcmp(key, "timezone_offset")) json.readInt(r.timezone_offset);
+    else if (!strcmp(key, "current"))         readCurrent(json, r.current);
+    else if (!strcmp(key, "hourly") && json.beginArray())
+    {
+      int i = 0;
+      while (json.nextElement())
+      {
+        if (i < numHourly)
+        {
+          readHourly(json, r.hourly[i++]);
+        }
+        else
+        {
+          json.skipValue();
+        }
+      }
+    }
+    else if (!strcmp(key, "daily") && json.beginArray())
+    {
+      int i = 0;
+      while (json.nextElement())
+      {
+        if (i < OWM_NUM_DAILY)
+        {
+          readDaily(json, r.daily[i++]);
+        }
+        else
+        {
+          json.skipValue();
+        }
+      }
+    }
+#if DISPLAY_ALERTS
+    else if (!strcmp(key, "alerts") && json.beginArray())
+    {
+      alert_selector_t selector;
+      alertSelectorInit(selector);
+      while (json.nextElement())
+      {
+        if (selector.offered < OWM_NUM_ALERTS)
+        {
+          readAlert(json, selector);
+        }
+        else
+        {
+          json.skipValue();
+        }
+      }
+      alertSelectorResult(selector, r.alerts);
+    }
+#endif
+    else
+    {
+      json.skipValue();
+    }
+  }
+
+  fillHourlySeries(r);
+
+#if DEBUG_LEVEL >= 1
+  Serial.println("[debug] streamed One Call response : "
+                 + String(json.error().c_str()));
+#endif
+  return json.error();
+} // end deserializeOneCall
+
+#else
+DeserializationError deserializeOneCall(Stream &json,
                                         owm_resp_onecall_t &r)
 {
   int i;
@@ -100,10 +487,8 @@ DeserializationError deserializeOneCall(WiFiClient &json,
   r.current.rain_1h    = current["rain"]["1h"].as<float>();
   r.current.snow_1h    = current["snow"]["1h"].as<float>();
   JsonObject current_weather = current["weather"][0];
-  r.current.weather.id          = current_weather["id"]         .as<int>();
-  r.current.weather.main        = current_weather["main"]       .as<const char *>();
-  r.current.weather.description = current_weather["description"].as<const char *>();
-  r.current.weather.icon        = current_weather["icon"]       .as<const char *>();
+  r.current.weather.id = current_weather["id"].as<int>();
+  setWeatherIcon(r.current.weather, current_weather["icon"].as<const char *>());
 
   // minutely forecast is currently unused
   // i = 0;
@@ -138,10 +523,8 @@ DeserializationError deserializeOneCall(WiFiClient &json,
     r.hourly[i].rain_1h    = hourly["rain"]["1h"].as<float>();
     r.hourly[i].snow_1h    = hourly["snow"]["1h"].as<float>();
     JsonObject hourly_weather = hourly["weather"][0];
-    r.hourly[i].weather.id          = hourly_weather["id"]         .as<int>();
-    r.hourly[i].weather.main        = hourly_weather["main"]       .as<const char *>();
-    r.hourly[i].weather.description = hourly_weather["description"].as<const char *>();
-    r.hourly[i].weather.icon        = hourly_weather["icon"]       .as<const char *>();
+    r.hourly[i].weather.id = hourly_weather["id"].as<int>();
+    setWeatherIcon(r.hourly[i].weather, hourly_weather["icon"].as<const char *>());
 
     if (i == OWM_NUM_HOURLY - 1)
     {
@@ -184,10 +567,8 @@ DeserializationError deserializeOneCall(WiFiClient &json,
     r.daily[i].rain       = daily["rain"]      .as<float>();
     r.daily[i].snow       = daily["snow"]      .as<float>();
     JsonObject daily_weather = daily["weather"][0];
-    r.daily[i].weather.id          = daily_weather["id"]         .as<int>();
-    r.daily[i].weather.main        = daily_weather["main"]       .as<const char *>();
-    r.daily[i].weather.description = daily_weather["description"].as<const char *>();
-    r.daily[i].weather.icon        = daily_weather["icon"]       .as<const char *>();
+    r.daily[i].weather.id = daily_weather["id"].as<int>();
+    setWeatherIcon(r.daily[i].weather, daily_weather["icon"].as<const char *>());
 
     if (i == OWM_NUM_DAILY - 1)
     {
@@ -197,37 +578,176 @@ DeserializationError deserializeOneCall(WiFiClient &json,
   }
 
 #if DISPLAY_ALERTS
-  i = 0;
+  alert_selector_t selector;
+  alertSelectorInit(selector);
   for (JsonObject alerts : doc["alerts"].as<JsonArray>())
   {
-    owm_alerts_t new_alert = {};
-    // new_alert.sender_name = alerts["sender_name"].as<const char *>();
-    new_alert.event       = alerts["event"]      .as<const char *>();
-    new_alert.start       = alerts["start"]      .as<int64_t>();
-    new_alert.end         = alerts["end"]        .as<int64_t>();
-    // new_alert.description = alerts["description"].as<const char *>();
-    new_alert.tags        = alerts["tags"][0]    .as<const char *>();
-    r.alerts.push_back(new_alert);
+    // sender_name and description are filtered out
+    char event[ALERT_READ_LEN];
+    char tags[ALERT_TAG_LEN];
+    snprintf(event, sizeof(event), "%s", alerts["event"] | "");
+    snprintf(tags, sizeof(tags), "%s", alerts["tags"][0] | "");
+    alertSelectorOffer(selector, event, tags, alerts["start"].as<int64_t>(),
+                       alerts["end"].as<int64_t>());
 
-    if (i == OWM_NUM_ALERTS - 1)
+    if (selector.offered == OWM_NUM_ALERTS)
     {
       break;
     }
-    ++i;
   }
+  alertSelectorResult(selector, r.alerts);
 #endif
 
+  fillHourlySeries(r);
+
   return error;
 } // end deserializeOneCall
+#endif // JSON_STREAMING_PARSER
 
-DeserializationError deserializeAirQuality(WiFiClient &json,
+#if JSON_STREAMING_PARSER
+/* Reads one entry of the air pollution history. Only the concentrations of
+ * pollutants in mask are stored.
+ */
+static void readAirPollutionEntry(JsonStreamReader &json,
+                                  owm_resp_air_pollution_t &r, int i, int mask)
+{
+  char key[16];
+  if (!json.beginObject())
+  {
+    json.skipValue();
+    return;
+  }
+  while (json.nextKey(key, sizeof(key)))
+  {
+    if (!strcmp(key, "dt"))
+    {
+      json.readInt64(r.dt[i]);
+    }
+    else if (!strcmp(key, "main") && json.beginObject())
+    {
+      while (json.nextKey(key, sizeof(key)))
+      {
+        if (!strcmp(key, "aqi")) json.readInt(r.main_aqi[i]);
+        else                     json.skipValue();
+      }
+    }
+    else if (!strcmp(key, "components") && json.beginObject())
+    {
+      owm_components_t &c = r.components;
+      while (json.nextKey(key, sizeof(key)))
+      {
+        float *conc = nullptr;
+        if      (!strcmp(key, "co")    && (mask & AQI_POLLUTANT_CO))    conc = c.co;
+        else if (!strcmp(key, "no")    && (mask & AQI_POLLUTANT_NO))    conc = c.no;
+        else if (!strcmp(key, "no2")   && (mask & AQI_POLLUTANT_NO2))   conc = c.no2;
+        else if (!strcmp(key, "o3")    && (mask & AQI_POLLUTANT_O3))    conc = c.o3;
+        else if (!strcmp(key, "so2")   && (mask & AQI_POLLUTANT_SO2))   conc = c.so2;
+        else if (!strcmp(key, "pm2_5") && (mask & AQI_POLLUTANT_PM2_5)) conc = c.pm2_5;
+        else if (!strcmp(key, "pm10")  && (mask & AQI_POLLUTANT_PM10))  conc = c.pm10;
+        else if (!strcmp(key, "nh3")   && (mask & AQI_POLLUTANT_NH3))   conc = c.nh3;
+
+        if (conc)
+        {
+          json.readFloat(conc[i]);
+        }
+        else
+        {
+          json.skipValue();
+        }
+      }
+    }
+    else
+    {
+      json.skipValue();
+    }
+  }
+} // end readAirPollutionEntry
+
+/* Streams the air pollution history into r. Concentrations of pollutants that
+ * the AQI_SCALE of the locale does not use are skipped and left at 0.
+ */
+DeserializationError deserializeAirQuality(Stream &stream,
+                                           owm_resp_air_pollution_t &r)
+{
+  JsonStreamReader json(stream);
+  char key[8];
+  const int mask = aqi_scale_pollutants(AQI_SCALE);
+
+  r.components = {};
+  if (!json.beginObject())
+  {
+    if (json.error() == DeserializationError::Ok)
+    {
+      return DeserializationError::InvalidInput;
+    }
+    return json.error();
+  }
+  while (json.nextKey(key, sizeof(key)))
+  {
+    if (!strcmp(key, "coord") && json.beginObject())
+    {
+      while (json.nextKey(key, sizeof(key)))
+      {
+        if      (!strcmp(key, "lat")) json.readFloat(r.coord.lat);
+        else if (!strcmp(key, "lon")) json.readFloat(r.coord.lon);
+        else                          json.skipValue();
+      }
+    }
+    else if (!strcmp(key, "list") && json.beginArray())
+    {
+      int i = 0;
+      while (json.nextElement())
+      {
+        if (i < OWM_NUM_AIR_POLLUTION)
+        {
+          readAirPollutionEntry(json, r, i++, mask);
+        }
+        else
+        {
+          json.skipValue();
+        }
+      }
+    }
+    else
+    {
+      json.skipValue();
+    }
+  }
+
+#if DEBUG_LEVEL >= 1
+  Serial.println("[debug] streamed Air Pollution response : "
+                 + String(json.error().c_str()));
+#endif
+  return json.error();
+} // end deserializeAirQuality
+
+#else
+DeserializationError deserializeAirQuality(Stream &json,
                                            owm_resp_air_pollution_t &r)
 {
   int i = 0;
 
+  const int mask = aqi_scale_pollutants(AQI_SCALE);
+
+  // only keep the pollutants used by the AQI scale
+  JsonDocument filter;
+  filter["coord"]                  = true;
+  filter["list"][0]["main"]["aqi"] = true;
+  filter["list"][0]["dt"]          = true;
+  JsonVariant components = filter["list"][0]["components"];
+  components["co"]    = (mask & AQI_POLLUTANT_CO)    != 0;
+  components["no"]    = (mask & AQI_POLLUTANT_NO)    != 0;
+  components["no2"]   = (mask & AQI_POLLUTANT_NO2)   != 0;
+  components["o3"]    = (mask & AQI_POLLUTANT_O3)    != 0;
+  components["so2"]   = (mask & AQI_POLLUTANT_SO2)   != 0;
+  components["pm2_5"] = (mask & AQI_POLLUTANT_PM2_5) != 0;
+  components["pm10"]  = (mask & AQI_POLLUTANT_PM10)  != 0;
+  components["nh3"]   = (mask & AQI_POLLUTANT_NH3)   != 0;
+
   JsonDocument doc;
 
-  DeserializationError error = deserializeJson(doc, json);
+  DeserializationError error = deserializeJson(doc, json,
+                                         DeserializationOption::Filter(filter));
 #if DEBUG_LEVEL >= 1
   Serial.println("[debug] doc.overflowed() : "
                  + String(doc.overflowed()));
@@ -268,11 +788,273 @@ DeserializationError deserializeAirQuality(WiFiClient &json,
 
   return error;
 } // end deserializeAirQuality
+#endif // JSON_STREAMING_PARSER
+
+/* Returns the ranking score of an earthquake, lower ranks first.
+ */
+static float usgsScore(float distance, float mag)
+{
+#if USGS_RANK_BY_MAGNITUDE
+  // the radius an earthquake is felt in grows roughly with 10^(M/2)
+  return distance / powf(10.f, 0.5f * mag);
+#else
+  return distance;
+#endif
+} // end usgsScore
+
+static bool usgsRanksBefore(const usgs_feature_t &a, const usgs_feature_t &b)
+{
+  return usgsScore(a.distance, a.properties.mag)
+       < usgsScore(b.distance, b.properties.mag);
+} // end usgsRanksBefore
+
+/* Returns true if an event with this score would be kept.
+ *
+ * While a feed is read r.features is a max-heap of the best events so far, the
+ * worst of them at the top, so this is a single comparison.
+ */
+static bool usgsWouldKeep(const usgs_earth_resp_t &r, float score)
+{
+  if (r.num_features < USGS_NUM_SIG_EVENTS)
+  {
+    return true;
+  }
+  const usgs_feature_t &worst = r.features[0];
+  return score < usgsScore(worst.distance, worst.properties.mag);
+} // end usgsWouldKeep
+
+/* Adds f to the best events, replacing the worst one once full.
+ */
+static void usgsKeep(usgs_earth_resp_t &r, usgs_feature_t &f)
+{
+  usgs_feature_t *first = r.features;
+  if (r.num_features < USGS_NUM_SIG_EVENTS)
+  {
+    first[r.num_features++] = std::move(f);
+    std::push_heap(first, first + r.num_features, usgsRanksBefore);
+  }
+  else if (usgsRanksBefore(f, first[0]))
+  {
+    std::pop_heap(first, first + r.num_features, usgsRanksBefore);
+    first[r.num_features - 1] = std::move(f);
+    std::push_heap(first, first + r.num_features, usgsRanksBefore);
+  }
+} // end usgsKeep
+
+/* Once the best events are known, only closer events can be kept. Shrinks
+ * the search radius of o to the worst kept distance so the distance engine
+ * rejects the rest without computing their distance.
+ *
+ * Ranking by magnitude has no fixed radius, every event is checked.
+ */
+static void usgsUpdateRadius(const usgs_earth_resp_t &r, geo_observer_t &o)
+{
+#if !USGS_RANK_BY_MAGNITUDE
+  if (r.num_features == USGS_NUM_SIG_EVENTS)
+  {
+    geoObserverSetMaxDistance(o, r.features[0].distance);
+  }
+#endif
+} // end usgsUpdateRadius
+
+/* Sorts the kept events, best first.
+ */
+static void usgsFinishRanking(usgs_earth_resp_t &r)
+{
+  std::sort_heap(r.features, r.features + r.num_features, usgsRanksBefore);
+  if (r.num_features == 0)
+  {
+    r.features[0] = {};
+  }
+} // end usgsFinishRanking
+
+#if JSON_STREAMING_PARSER
+/* Reads one GeoJSON feature into fixed buffers and only builds a
+ * usgs_feature_t if the event ranks among the best so far.
+ */
+static void readUSGSFeature(JsonStreamReader &json, usgs_earth_resp_t &r,
+                            geo_observer_t &observer)
+{
+  char key[16];
+  char place[96] = {};
+  char alert[12] = {};
+  char status[16] = {};
+  char type[24] = {};
+  char id[24] = {};
+  float mag = 0.f;
+  float dmin = 0.f;
+  int64_t time = 0;
+  int64_t updated = 0;
+  int tsunami = 0;
+  float coordinates[3] = {};
+  int numCoordinates = 0;
+
+  if (!json.beginObject())
+  {
+    json.skipValue();
+    return;
+  }
+  while (json.nextKey(key, sizeof(key)))
+  {
+    if (!strcmp(key, "properties") && json.beginObject())
+    {
+      while (json.nextKey(key, sizeof(key)))
+      {
+        if      (!strcmp(key, "mag"))     json.readFloat(mag);
+        else if (!strcmp(key, "place"))   json.readString(place, sizeof(place));
+        else if (!strcmp(key, "time"))    json.readInt64(time);
+        else if (!strcmp(key, "updated")) json.readInt64(updated);
+        else if (!strcmp(key, "alert"))   json.readString(alert, sizeof(alert));
+        else if (!strcmp(key, "status"))  json.readString(status, sizeof(status));
+        else if (!strcmp(key, "tsunami")) json.readInt(tsunami);
+        else if (!strcmp(key, "dmin"))    json.readFloat(dmin);
+        else if (!strcmp(key, "type"))    json.readString(type, sizeof(type));
+        else                              json.skipValue();
+      }
+    }
+    else if (!strcmp(key, "geometry") && json.beginObject())
+    {
+      while (json.nextKey(key, sizeof(key)))
+      {
+        if (!strcmp(key, "coordinates") && json.beginArray())
+        {
+          // [longitude, latitude, depth]
+          while (json.nextElement())
+          {
+            if (numCoordinates < 3)
+            {
+              json.readFloat(coordinates[numCoordinates++]);
+            }
+            else
+            {
+              json.skipValue();
+            }
+          }
+        }
+        else
+        {
+          json.skipValue();
+        }
+      }
+    }
+    else if (!strcmp(key, "id"))
+    {
+      json.readString(id, sizeof(id));
+    }
+    else
+    {
+      json.skipValue();
+    }
+  }
 
-DeserializationError deserializeUSGSEarthquake(WiFiClient &json, usgs_feature_t &r, 
-                                               float my_lat, float my_lon){
-  float min_distance;
+  float distance;
+  if (json.error() || numCoordinates < 2
+   || !geoDistanceWithin(observer, coordinates[1], coordinates[0], distance)
+   || !usgsWouldKeep(r, usgsScore(distance, mag)))
+  {
+    return;
+  }
 
+  usgs_feature_t f = {};
+  f.properties.mag     = mag;
+  f.properties.place   = place;
+  f.properties.time    = time;
+  f.properties.updated = updated;
+  f.properties.alert   = alert;
+  f.properties.status  = status;
+  f.properties.tsunami = tsunami;
+  f.properties.dmin    = dmin;
+  f.properties.type    = type;
+  f.geometry.lon       = coordinates[0];
+  f.geometry.lat       = coordinates[1];
+  f.geometry.depth     = coordinates[2];
+  f.id                 = id;
+  f.distance           = distance;
+  usgsKeep(r, f);
+  usgsUpdateRadius(r, observer);
+} // end readUSGSFeature
+
+/* Streams a USGS GeoJSON feed and keeps the best ranked USGS_NUM_SIG_EVENTS
+ * events. Only one feature is held at a time, memory use does not depend on
+ * the size of the feed.
+ */
+DeserializationError deserializeUSGSEarthquake(Stream &stream,
+                                               usgs_earth_resp_t &r,
+                                               float my_lat, float my_lon)
+{
+  JsonStreamReader json(stream);
+  char key[16];
+  geo_observer_t observer;
+  geoObserverInit(observer, my_lat, my_lon);
+
+  r.num_features = 0;
+  r.metadata.count = 0;
+  if (!json.beginObject())
+  {
+    if (json.error() == DeserializationError::Ok)
+    {
+      return DeserializationError::InvalidInput;
+    }
+    return json.error();
+  }
+  while (json.nextKey(key, sizeof(key)))
+  {
+    if (!strcmp(key, "metadata") && json.beginObject())
+    {
+      while (json.nextKey(key, sizeof(key)))
+      {
+        if      (!strcmp(key, "generated")) json.readInt64(r.metadata.generated);
+        else if (!strcmp(key, "title"))     json.readString(r.metadata.title);
+        else if (!strcmp(key, "status"))    json.readInt(r.metadata.status);
+        else                                json.skipValue();
+      }
+    }
+    else if (!strcmp(key, "features") && json.beginArray())
+    {
+      while (json.nextElement())
+      {
+        readUSGSFeature(json, r, observer);
+        ++r.metadata.count;
+      }
+    }
+    else if (!strcmp(key, "bbox") && json.beginArray())
+    {
+      float *bbox[] = {&r.bbox.min_longitude, &r.bbox.min_latitude,
+                       &r.bbox.min_depth,     &r.bbox.max_longitude,
+                       &r.bbox.max_latitude,  &r.bbox.max_depth};
+      int i = 0;
+      while (json.nextElement())
+      {
+        if (i < 6)
+        {
+          json.readFloat(*bbox[i++]);
+        }
+        else
+        {
+          json.skipValue();
+        }
+      }
+    }
+    else
+    {
+      json.skipValue();
+    }
+  }
+  usgsFinishRanking(r);
+
+#if DEBUG_LEVEL >= 1
+  Serial.println("[debug] streamed USGS feed : " + String(json.error().c_str())
+                 + ", " + String(r.metadata.count) + " events, kept "
+                 + String(r.num_features));
+#endif
+  return json.error();
+} // end deserializeUSGSEarthquake
+
+#else
+DeserializationError deserializeUSGSEarthquake(Stream &json,
+                                               usgs_earth_resp_t &r,
+                                               float my_lat, float my_lon)
+{
   JsonDocument filter;
   filter["type"]                                 = false;
   filter["metadata"]                             = false;
@@ -282,13 +1064,9 @@ DeserializationError deserializeUSGSEarthquake(WiFiClient &json, usgs_feature_t
   filter["features"][0]["id"]                    = false;
 
   JsonDocument doc;
-  
-  //DeserializationError error = deserializeJson(doc, json);
-  
+
   DeserializationError error = deserializeJson(doc, json,
                                         DeserializationOption::Filter(filter));
-  
-  
 #if DEBUG_LEVEL >= 1
   Serial.println("[debug] doc.overflowed() : "
                  + String(doc.overflowed()));
@@ -300,40 +1078,183 @@ DeserializationError deserializeUSGSEarthquake(WiFiClient &json, usgs_feature_t
     return error;
   }
 
-  min_distance = __FLT_MAX__;
-  float lat = 0.0;
-  float lon = 0.0;
+  geo_observer_t observer;
+  geoObserverInit(observer, my_lat, my_lon);
 
+  r.num_features = 0;
+  r.metadata.count = 0;
   for (JsonObject feature : doc["features"].as<JsonArray>()) {
+    ++r.metadata.count;
 
     JsonArray coordinates = feature["geometry"]["coordinates"];
-    lon = coordinates[0].as<float>();  // Longitude is first
-    lat = coordinates[1].as<float>();  // Latitude is second
+    float lon = coordinates[0].as<float>();  // Longitude is first
+    float lat = coordinates[1].as<float>();  // Latitude is second
+    float distance;
+    if (!geoDistanceWithin(observer, lat, lon, distance)) {
+      continue;
+    }
 
-    float distance = calculateDistance(my_lat, my_lon, lat, lon);
+    JsonObject properties = feature["properties"];
+    float mag = properties["mag"].as<float>();
+    if (!usgsWouldKeep(r, usgsScore(distance, mag))) {
+      continue;
+    }
 
-    if (distance < min_distance) {
-      min_distance = distance;
+    usgs_feature_t f = {};
+    f.geometry.lat       = lat;
+    f.geometry.lon       = lon;
+    f.geometry.depth     = coordinates[2].as<float>();
+    f.properties.mag     = mag;
+    f.properties.place   = properties["place"]   .as<const char *>();
+    f.properties.time    = properties["time"]    .as<int64_t>();
+    f.properties.updated = properties["updated"] .as<int64_t>();
+    f.properties.alert   = properties["alert"]   .as<const char *>();
+    f.properties.status  = properties["status"]  .as<const char *>();
+    f.properties.tsunami = properties["tsunami"] .as<int64_t>();
+    f.properties.dmin    = properties["dmin"]    .as<float>();
+    f.properties.type    = properties["type"]    .as<const char *>();
+    f.distance           = distance;
+    usgsKeep(r, f);
+    usgsUpdateRadius(r, observer);
+  }
+  usgsFinishRanking(r);
 
-      JsonObject geometry = feature["geometry"];
-      r.geometry.lat   = lat;
-      r.geometry.lon   = lon;
-      r.geometry.depth = geometry["depth"] .as<float>();
+  return error;
+} // end deserializeUSGSEarthquake
+#endif // JSON_STREAMING_PARSER
 
-      JsonObject properties = feature["properties"];
-      r.properties.mag      = properties["mag"]     .as<float>();
-      r.properties.place    = properties["place"]   .as<const char *>();
-      r.properties.time     = properties["time"]    .as<int64_t>();
-      r.properties.updated  = properties["updated"] .as<int64_t>();
-      r.properties.alert    = properties["alert"]   .as<const char *>();
-      r.properties.status   = properties["status"]  .as<int64_t>();
-      r.properties.tsunami  = properties["tsunami"] .as<int64_t>();
-      r.properties.dmin     = properties["dmin"]    .as<float>();  
-      r.properties.type     = properties["type"]    .as<const char *>();                             
-    }
+/*
+ * Flat binary form of a parsed USGS feed, for the response cache. Numbers are
+ * copied as they are in memory, strings are prefixed with their length.
+ */
+typedef struct usgs_pack_cursor
+{
+  uint8_t *buf;
+  size_t   size;
+  size_t   pos;
+  bool     ok;
+} usgs_pack_cursor_t;
 
+static void packBytes(usgs_pack_cursor_t &c, const void *data, size_t len)
+{
+  if (c.ok && c.pos + len <= c.size)
+  {
+    memcpy(c.buf + c.pos, data, len);
+    c.pos += len;
   }
+  else
+  {
+    c.ok = false;
+  }
+} // end packBytes
 
-  return error;
+static void packString(usgs_pack_cursor_t &c, const String &s)
+{
+  uint8_t len = static_cast<uint8_t>(std::min<size_t>(s.length(), 255));
+  packBytes(c, &len, sizeof(len));
+  packBytes(c, s.c_str(), len);
+} // end packString
 
-} // end deserializeUSGSEarthquake
\ No newline at end of file
+static void unpackBytes(usgs_pack_cursor_t &c, void *data, size_t len)
+{
+  if (c.ok && c.pos + len <= c.size)
+  {
+    memcpy(data, c.buf + c.pos, len);
+    c.pos += len;
+  }
+  else
+  {
+    c.ok = false;
+  }
+} // end unpackBytes
+
+static void unpackString(usgs_pack_cursor_t &c, String &s)
+{
+  uint8_t len = 0;
+  unpackBytes(c, &len, sizeof(len));
+  char str[256];
+  unpackBytes(c, str, len);
+  str[c.ok ? len : 0] = '\0';
+  s = str;
+} // end unpackString
+
+/* Writes the fields of r that deserializeUSGSEarthquake() fills to buf.
+ *
+ * Returns the number of bytes written, 0 if buf is too small.
+ */
+size_t packUSGSEarthquake(const usgs_earth_resp_t &r, uint8_t *buf,
+                          size_t size)
+{
+  usgs_pack_cursor_t c = {buf, size, 0, true};
+  packBytes(c, &r.metadata.generated, sizeof(r.metadata.generated));
+  packString(c, r.metadata.title);
+  packBytes(c, &r.metadata.status, sizeof(r.metadata.status));
+  packBytes(c, &r.metadata.count, sizeof(r.metadata.count));
+  packBytes(c, &r.bbox, sizeof(r.bbox));
+  packBytes(c, &r.num_features, sizeof(r.num_features));
+  for (int i = 0; i < r.num_features; ++i)
+  {
+    const usgs_feature_t &f = r.features[i];
+    packBytes(c, &f.properties.mag, sizeof(f.properties.mag));
+    packString(c, f.properties.place);
+    packBytes(c, &f.properties.time, sizeof(f.properties.time));
+    packBytes(c, &f.properties.updated, sizeof(f.properties.updated));
+    packString(c, f.properties.alert);
+    packString(c, f.properties.status);
+    packBytes(c, &f.properties.tsunami, sizeof(f.properties.tsunami));
+    packBytes(c, &f.properties.dmin, sizeof(f.properties.dmin));
+    packString(c, f.properties.type);
+    packBytes(c, &f.geometry, sizeof(f.geometry));
+    packString(c, f.id);
+    packBytes(c, &f.distance, sizeof(f.distance));
+  }
+  return c.ok ? c.pos : 0;
+} // end packUSGSEarthquake
+
+/* Reads r back from the len bytes written by packUSGSEarthquake().
+ *
+ * Returns false if buf is truncated or malformed.
+ */
+bool unpackUSGSEarthquake(usgs_earth_resp_t &r, const uint8_t *buf,
+                          size_t len)
+{
+  usgs_pack_cursor_t c = {const_cast<uint8_t *>(buf), len, 0, true};
+  unpackBytes(c, &r.metadata.generated, sizeof(r.metadata.generated));
+  unpackString(c, r.metadata.title);
+  unpackBytes(c, &r.metadata.status, sizeof(r.metadata.status));
+  unpackBytes(c, &r.metadata.count, sizeof(r.metadata.count));
+  unpackBytes(c, &r.bbox, sizeof(r.bbox));
+  unpackBytes(c, &r.num_features, sizeof(r.num_features));
+  if (!c.ok || r.num_features < 0 || r.num_features > USGS_NUM_SIG_EVENTS)
+  {
+    r.num_features = 0;
+    return false;
+  }
+  for (int i = 0; i < USGS_NUM_SIG_EVENTS; ++i)
+  {
+    usgs_feature_t &f = r.features[i];
+    f = {};
+    if (i >= r.num_features)
+    {
+      continue;
+    }
+    unpackBytes(c, &f.properties.mag, sizeof(f.properties.mag));
+    unpackString(c, f.properties.place);
+    unpackBytes(c, &f.properties.time, sizeof(f.properties.time));
+    unpackBytes(c, &f.properties.updated, sizeof(f.properties.updated));
+    unpackString(c, f.properties.alert);
+    unpackString(c, f.properties.status);
+    unpackBytes(c, &f.properties.tsunami, sizeof(f.properties.tsunami));
+    unpackBytes(c, &f.properties.dmin, sizeof(f.properties.dmin));
+    unpackString(c, f.properties.type);
+    unpackBytes(c, &f.geometry, sizeof(f.geometry));
+    unpackString(c, f.id);
+    unpackBytes(c, &f.distance, sizeof(f.distance));
+  }
+  if (!c.ok || c.pos != len)
+  {
+    r.num_features = 0;
+    return false;
+  }
+  return true;
+} // end unpackUSGSEarthquake
@@ -38,9 +38,14 @@
 #include "client_utils.h"
 #include "config.h"
 #include "display_utils.h"
+#include "http_cache.h"
+#include "http_stream.h"
 #include "renderer.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 #ifndef USE_HTTP
   #include <WiFiClientSecure.h>
+  #include "tls_session.h"
 #endif
 
 #ifdef USE_HTTP
@@ -49,6 +54,127 @@
   static const uint16_t OWM_PORT = 443;
 #endif
 
+static http_connection_t connPool[HTTP_POOL_SIZE];
+
+/* Requests may run at the same time, see fetchAll().
+ */
+static SemaphoreHandle_t poolLock()
+{
+  static SemaphoreHandle_t lock = xSemaphoreCreateMutex();
+  return lock;
+} // poolLock
+
+static void initClient(api_client_t &client, const char *caCert)
+{
+#if defined(USE_HTTPS_NO_CERT_VERIF)
+  client.setInsecure();
+#elif defined(USE_HTTPS_WITH_CERT_VERIF)
+  client.setCACert(caCert);
+#endif
+} // initClient
+
+/* Returns a connection to host for one request. A connection that is still
+ * open from an earlier request to host is preferred, so that the request
+ * skips the TCP and TLS setup. Otherwise an unused entry, or the connection
+ * kept to another host, is given to host and connects on the first request.
+ *
+ * Returns nullptr if every connection is in use.
+ */
+http_connection_t *acquireConnection(const String &host, const char *caCert)
+{
+  xSemaphoreTake(poolLock(), portMAX_DELAY);
+  http_connection_t *conn = nullptr;
+  for (http_connection_t &c : connPool)
+  {
+    if (!c.busy && c.host == host && c.client.connected())
+    {
+      conn = &c;
+      break;
+    }
+  }
+  for (int pass = 0; !conn && pass < 2; ++pass)
+  { // a closed connection first, one kept to another host last
+    for (http_connection_t &c : connPool)
+    {
+      if (!c.busy && (pass == 1 || !c.client.connected()))
+      {
+        conn = &c;
+        break;
+      }
+    }
+  }
+  if (conn)
+  {
+    conn->busy = true;
+    if (conn->host != host)
+    {
+      conn->client.stop();
+      conn->host = host;
+      initClient(conn->client, caCert);
+    }
+  }
+  xSemaphoreGive(poolLock());
+  return conn;
+} // acquireConnection
+
+/* Returns a connection to the pool, it stays open if the request left it
+ * ready for the next one.
+ */
+void releaseConnection(http_connection_t *conn)
+{
+  xSemaphoreTake(poolLock(), portMAX_DELAY);
+  conn->busy = false;
+  xSemaphoreGive(poolLock());
+} // releaseConnection
+
+/* Closes the kept connections, each one holds the buffers of its TLS session.
+ */
+void closeConnections()
+{
+  xSemaphoreTake(poolLock(), portMAX_DELAY);
+  for (http_connection_t &c : connPool)
+  {
+    c.client.stop();
+  }
+  xSemaphoreGive(poolLock());
+} // closeConnections
+
+/* Sends a GET request for uri to the host of conn, over its open connection
+ * if the previous response left one. With validators of a cached response,
+ * the request is conditional and the server may answer 304 Not Modified
+ * without a body.
+ *
+ * Returns the HTTP Status Code, or an HTTPClient error.
+ */
+static int sendGET(http_connection_t &conn, const String &uri,
+                   const http_cache_validators_t *validators)
+{
+  static const char *responseHeaders[] = {"Transfer-Encoding", "ETag",
+                                          "Last-Modified"};
+  HTTPClient &http = conn.http;
+  http.setConnectTimeout(HTTP_CLIENT_TCP_TIMEOUT); // default 5000ms
+  http.setTimeout(HTTP_CLIENT_TCP_TIMEOUT); // default 5000ms
+  http.setReuse(true); // HTTP/1.1 keep-alive
+  http.collectHeaders(responseHeaders,
+                      sizeof(responseHeaders) / sizeof(responseHeaders[0]));
+#ifndef USE_HTTP
+  if (!conn.client.connected())
+  { // HTTPClient reuses this connection, or makes its own if it failed
+    tlsConnect(conn.client, conn.host, OWM_PORT);
+  }
+#endif
+  http.begin(conn.client, conn.host, OWM_PORT, uri);
+  if (validators && validators->etag[0])
+  {
+    http.addHeader("If-None-Match", validators->etag);
+  }
+  if (validators && validators->last_modified[0])
+  {
+    http.addHeader("If-Modified-Since", validators->last_modified);
+  }
+  return http.GET();
+} // sendGET
+
 /* Power-on and connect WiFi.
  * Takes int parameter to store WiFi RSSI, or “Received Signal Strength
  * Indicator"
@@ -90,6 +216,7 @@ wl_status_t startWiFi(int &wifiRSSI)
  */
 void killWiFi()
 {
+  closeConnections();
   WiFi.disconnect();
   WiFi.mode(WIFI_OFF);
 } // killWiFi
@@ -143,11 +270,7 @@ bool waitForSNTPSync(tm *timeInfo)
  *
  * Returns the HTTP Status Code.
  */
-#ifdef USE_HTTP
-  int getOWMonecall(WiFiClient &client, owm_resp_onecall_t &r)
-#else
-  int getOWMonecall(WiFiClientSecure &client, owm_resp_onecall_t &r)
-#endif
+int getOWMonecall(http_connection_t &conn, owm_resp_onecall_t &r)
 {
   int attempts = 0;
   bool rxSuccess = false;
@@ -166,8 +289,8 @@ bool waitForSNTPSync(tm *timeInfo)
 
   uri += "&appid=" + OWM_APIKEY;
 
-  Serial.print(TXT_ATTEMPTING_HTTP_REQ);
-  Serial.println(": " + sanitizedUri);
+  // one write per line, requests may run in concurrent tasks
+  Serial.println(String(TXT_ATTEMPTING_HTTP_REQ) + ": " + sanitizedUri);
   int httpResponse = 0;
   while (!rxSuccess && attempts < 3)
   {
@@ -178,23 +301,27 @@ bool waitForSNTPSync(tm *timeInfo)
       return -512 - static_cast<int>(connection_status);
     }
 
-    HTTPClient http;
-    http.setConnectTimeout(HTTP_CLIENT_TCP_TIMEOUT); // default 5000ms
-    http.setTimeout(HTTP_CLIENT_TCP_TIMEOUT); // default 5000ms
-    http.begin(client, OWM_ENDPOINT, OWM_PORT, uri);
-    httpResponse = http.GET();
+    bool keepAlive = false;
+    // not cached, the parsed response is too large
+    httpResponse = sendGET(conn, uri, nullptr);
     if (httpResponse == HTTP_CODE_OK)
     {
-      jsonErr = deserializeOneCall(http.getStream(), r);
+      httpCacheCount(false);
+      HttpBodyStream body(conn.http);
+      jsonErr = deserializeOneCall(body, r);
       if (jsonErr)
       {
         // -256 offset distinguishes these errors from httpClient errors
         httpResponse = -256 - static_cast<int>(jsonErr.code());
       }
       rxSuccess = !jsonErr;
+      keepAlive = rxSuccess && body.drain();
+    }
+    if (!keepAlive)
+    {
+      conn.client.stop();
     }
-    client.stop();
-    http.end();
+    conn.http.end();
     Serial.println("  " + String(httpResponse, DEC) + " "
                    + getHttpResponsePhrase(httpResponse));
     ++attempts;
@@ -203,17 +330,40 @@ bool waitForSNTPSync(tm *timeInfo)
   return httpResponse;
 } // getOWMonecall
 
+/* Format of a cached air pollution result: its size and the pollutants the
+ * AQI scale has parsed.
+ */
+static uint32_t airPollutionCacheFormat()
+{
+  const uint32_t settings[] = {
+    sizeof(owm_resp_air_pollution_t),
+    static_cast<uint32_t>(aqi_scale_pollutants(AQI_SCALE)),
+  };
+  return httpCacheFormat(settings, sizeof(settings));
+} // end airPollutionCacheFormat
+
+/* Format of a cached USGS result: the size of an event, how many are kept,
+ * how they are ranked and the location their distance is from.
+ */
+static uint32_t usgsCacheFormat()
+{
+  const float settings[] = {
+    static_cast<float>(sizeof(usgs_feature_t)),
+    USGS_NUM_SIG_EVENTS,
+    USGS_RANK_BY_MAGNITUDE,
+    NUM_LAT,
+    NUM_LON,
+  };
+  return httpCacheFormat(settings, sizeof(settings));
+} // end usgsCacheFormat
+
 /* Perform an HTTP GET request to OpenWeatherMap's "Air Pollution" API
  * If data is received, it will be parsed and stored in the global variable
  * owm_air_pollution.
  *
  * Returns the HTTP Status Code.
  */
-#ifdef USE_HTTP
-  int getOWMairpollution(WiFiClient &client, owm_resp_air_pollution_t &r)
-#else
-  int getOWMairpollution(WiFiClientSecure &client, owm_resp_air_pollution_t &r)
-#endif
+int getOWMairpollution(http_connection_t &conn, owm_resp_air_pollution_t &r)
 {
   int attempts = 0;
   bool rxSuccess = false;
@@ -221,8 +371,11 @@ bool waitForSNTPSync(tm *timeInfo)
 
   // set start and end to appropriate values so that the last 24 hours of air
   // pollution history is returned. Unix, UTC.
+  // The history is hourly, so end is rounded down to the hour. This keeps the
+  // URI the same for an hour and the cached response can be revalidated.
   time_t now;
   int64_t end = time(&now);
+  end -= end % 3600;
   // minus 1 is important here, otherwise we could get an extra hour of history
   int64_t start = end - ((3600 * OWM_NUM_AIR_POLLUTION) - 1);
   char endStr[22];
@@ -239,8 +392,11 @@ bool waitForSNTPSync(tm *timeInfo)
                + "&start=" + startStr + "&end=" + endStr
                + "&appid={API key}";
 
-  Serial.print(TXT_ATTEMPTING_HTTP_REQ);
-  Serial.println(": " + sanitizedUri);
+  // one write per line, requests may run in concurrent tasks
+  Serial.println(String(TXT_ATTEMPTING_HTTP_REQ) + ": " + sanitizedUri);
+  const uint32_t format = airPollutionCacheFormat();
+  http_cache_validators_t validators;
+  bool cached = httpCacheValidators(uri, format, validators);
   int httpResponse = 0;
   while (!rxSuccess && attempts < 3)
   {
@@ -251,23 +407,46 @@ bool waitForSNTPSync(tm *timeInfo)
       return -512 - static_cast<int>(connection_status);
     }
 
-    HTTPClient http;
-    http.setConnectTimeout(HTTP_CLIENT_TCP_TIMEOUT); // default 5000ms
-    http.setTimeout(HTTP_CLIENT_TCP_TIMEOUT); // default 5000ms
-    http.begin(client, OWM_ENDPOINT, OWM_PORT, uri);
-    httpResponse = http.GET();
-    if (httpResponse == HTTP_CODE_OK)
+    bool keepAlive = false;
+    httpResponse = sendGET(conn, uri, cached ? &validators : nullptr);
+    if (httpResponse == HTTP_CODE_NOT_MODIFIED)
+    {
+      rxSuccess = httpCacheLoad(uri, format, &r, sizeof(r)) == sizeof(r);
+      if (rxSuccess)
+      {
+        httpCacheCount(true);
+        httpResponse = HTTP_CODE_OK;
+        keepAlive = true; // a 304 response has no body
+      }
+      else
+      { // ask for the full response again
+        httpCacheForget(uri);
+        cached = false;
+      }
+    }
+    else if (httpResponse == HTTP_CODE_OK)
     {
-      jsonErr = deserializeAirQuality(http.getStream(), r);
+      httpCacheCount(false);
+      HttpBodyStream body(conn.http);
+      jsonErr = deserializeAirQuality(body, r);
       if (jsonErr)
       {
         // -256 offset to distinguishes these errors from httpClient errors
         httpResponse = -256 - static_cast<int>(jsonErr.code());
       }
       rxSuccess = !jsonErr;
+      keepAlive = rxSuccess && body.drain();
+      if (rxSuccess)
+      {
+        httpCacheStore(uri, format, conn.http.header("ETag"),
+                       conn.http.header("Last-Modified"), &r, sizeof(r));
+      }
+    }
+    if (!keepAlive)
+    {
+      conn.client.stop();
     }
-    client.stop();
-    http.end();
+    conn.http.end();
     Serial.println("  " + String(httpResponse, DEC) + " "
                    + getHttpResponsePhrase(httpResponse));
     ++attempts;
@@ -278,11 +457,8 @@ bool waitForSNTPSync(tm *timeInfo)
 
 
 // getUSGSEarthquakeData
-#ifdef USE_HTTP
-  int getUSGSEarthquake(WiFiClient &client, usgs_earth_resp_t &r, String uri)
-#else
-  int getUSGSEarthquake(WiFiClientSecure &client, usgs_feature_t &r, String uri)
-#endif
+int getUSGSEarthquake(http_connection_t &conn, usgs_earth_resp_t &r,
+                      String uri)
 {
   int attempts = 0;
   bool rxSuccess = false;
@@ -290,8 +466,11 @@ bool waitForSNTPSync(tm *timeInfo)
 
   String sanitizedUri = USGS_ENDPOINT + uri;
 
-  Serial.print(TXT_ATTEMPTING_HTTP_REQ);
-  Serial.println(": " + sanitizedUri);
+  // one write per line, requests may run in concurrent tasks
+  Serial.println(String(TXT_ATTEMPTING_HTTP_REQ) + ": " + sanitizedUri);
+  const uint32_t format = usgsCacheFormat();
+  http_cache_validators_t validators;
+  bool cached = httpCacheValidators(uri, format, validators);
   int httpResponse = 0;
   while (!rxSuccess && attempts < 3)
   {
@@ -302,30 +481,51 @@ bool waitForSNTPSync(tm *timeInfo)
       return -512 - static_cast<int>(connection_status);
     }
 
-    HTTPClient http;
-    http.setConnectTimeout(HTTP_CLIENT_TCP_TIMEOUT); // default 5000ms
-    http.setTimeout(HTTP_CLIENT_TCP_TIMEOUT);        // default 5000ms
-    http.useHTTP10(true);
-    http.begin(client, USGS_ENDPOINT, OWM_PORT, uri);
-
-    httpResponse = http.GET();
-    if (httpResponse == HTTP_CODE_OK)
+    bool keepAlive = false;
+    httpResponse = sendGET(conn, uri, cached ? &validators : nullptr);
+    if (httpResponse == HTTP_CODE_NOT_MODIFIED)
     {
-
-      jsonErr = deserializeUSGSEarthquake(http.getStream(), r, NUM_LAT, NUM_LON);
-
-      
-
+      // only the cache paths need the packed response
+      std::vector<uint8_t> packed(HTTP_CACHE_MAX_RESULT);
+      size_t len = httpCacheLoad(uri, format, packed.data(), packed.size());
+      rxSuccess = len > 0 && unpackUSGSEarthquake(r, packed.data(), len);
+      if (rxSuccess)
+      {
+        httpCacheCount(true);
+        httpResponse = HTTP_CODE_OK;
+        keepAlive = true; // a 304 response has no body
+      }
+      else
+      { // ask for the full response again
+        httpCacheForget(uri);
+        cached = false;
+      }
+    }
+    else if (httpResponse == HTTP_CODE_OK)
+    {
+      httpCacheCount(false);
+      HttpBodyStream body(conn.http);
+      jsonErr = deserializeUSGSEarthquake(body, r, NUM_LAT, NUM_LON);
       if (jsonErr)
       {
         // -256 offset distinguishes these errors from httpClient errors
         httpResponse = -256 - static_cast<int>(jsonErr.code());
       }
       rxSuccess = !jsonErr;
+      keepAlive = rxSuccess && body.drain();
+      if (rxSuccess)
+      {
+        std::vector<uint8_t> packed(HTTP_CACHE_MAX_RESULT);
+        size_t len = packUSGSEarthquake(r, packed.data(), packed.size());
+        httpCacheStore(uri, format, conn.http.header("ETag"),
+                       conn.http.header("Last-Modified"), packed.data(), len);
+      }
+    }
+    if (!keepAlive)
+    {
+      conn.client.stop();
     }
-    client.stop();
-    http.useHTTP10(false);
-    http.end();
+    conn.http.end();
     Serial.println("  " + String(httpResponse, DEC) + " "
                    + getHttpResponsePhrase(httpResponse));
     ++attempts;
@@ -55,6 +55,13 @@ const unsigned long WIFI_TIMEOUT = 10000; // ms, WiFi connection timeout.
 //   -11  Read Timeout
 //   -258 Deserialization Incomplete Input
 const unsigned HTTP_CLIENT_TCP_TIMEOUT = 10000; // ms
+// TLS sessions kept from earlier wakes are offered to the server for at most
+// this long, or for as long as the server said it would accept them if that
+// is shorter.
+const uint32_t TLS_SESSION_MAX_AGE = 86400; // s
+// If a request fails, the last good response is drawn instead if it is at
+// most this old. Otherwise the error screen is shown.
+const uint32_t STALE_DATA_MAX_AGE = 21600; // s
 
 // OPENWEATHERMAP API
 // OpenWeatherMap API key, https://openweathermap.org/
@@ -76,11 +83,18 @@ const String OWM_ENDPOINT = "api.openweathermap.org";
 //   calls.
 const String OWM_ONECALL_VERSION = "3.0";
 
+// USGS EARTHQUAKE HAZARDS PROGRAM
+// GeoJSON summary feeds, https://earthquake.usgs.gov/earthquakes/feed/
+const String USGS_ENDPOINT = "earthquake.usgs.gov";
+
 // LOCATION
 // Set your latitude and longitude.
 // (used to get weather data as part of API requests to OpenWeatherMap)
 const String LAT = "40.7128";
 const String LON = "-74.0060";
+// Same location as above, used to find the nearest earthquake.
+const float NUM_LAT = 40.7128f;
+const float NUM_LON = -74.0060f;
 // City name that will be shown in the top-right corner of the display.
 const String CITY_STRING = "New York";
 
@@ -138,6 +152,15 @@ const int WAKE_TIME = 06; // Hour of first update after BED_TIME, 06:00.
 // Number of hours to display on the outlook graph. (range: [8-48])
 const int HOURLY_GRAPH_MAX = 24;
 
+// PARTIAL REFRESH
+// Partial refreshes slowly build up ghosting. After this many partial refreshes
+// the next refresh is a full refresh. Wakes where nothing changed on the
+// display are not counted.
+const uint16_t FULL_REFRESH_INTERVAL = 12;
+// If more than this much of the display changed (e.g. the error screen is
+// shown), a full refresh is done instead.
+const uint8_t PARTIAL_REFRESH_MAX_AREA = 50; // %
+
 // BATTERY
 // To protect the battery upon LOW_BATTERY_VOLTAGE, the display will cease to
 // update until battery is charged again. The ESP32 will deep-sleep (consuming
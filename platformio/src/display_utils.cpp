@@ -212,154 +212,6 @@ void toTitleCase(String &text)
   return;
 } // end toTitleCase
 
-/* Takes a String and truncates at any of these characters ,.( and trims any
- * trailing whitespace.
- *
- * Ex:
- *   input   : "Severe Thunderstorm Warning, (Starting At 10 Pm)"
- *   becomes : "Severe Thunderstorm Warning"
- */
-void truncateExtraAlertInfo(String &text)
-{
-  if (text.isEmpty())
-  {
-    return;
-  }
-
-  int i = 1;
-  int lastChar = i;
-  while (i < text.length()
-    && text.charAt(i) != ','
-    && text.charAt(i) != '.'
-    && text.charAt(i) != '(')
-  {
-    if (text.charAt(i) != ' ')
-    {
-      lastChar = i + 1;
-    }
-    ++i;
-  }
-
-  text = text.substring(0, lastChar);
-  return;
-} // end truncateExtraAlertInfo
-
-/* Returns the urgency of an event based by checking if the event String
- * contains any indicator keywords.
- *
- * Urgency keywords are defined in config.h because they are very regional.
- *   ex: United States - (Watch < Advisory < Warning)
- *
- * The index in vector<String> ALERT_URGENCY indicates the urgency level.
- * If an event string matches none of these keywords the urgency is unknown, -1
- * is returned.
- * In the United States example, Watch = 0, Advisory = 1, Warning = 2
- */
-int eventUrgency(const String &event)
-{
-  int urgency_lvl = -1;
-  for (int i = 0; i < ALERT_URGENCY.size(); ++i)
-  {
-    if (event.indexOf(ALERT_URGENCY[i]) >= 0)
-    {
-      urgency_lvl = i;
-    }
-  }
-  return urgency_lvl;
-} // end eventUrgency
-
-/* This algorithm filters alerts from the API responses to be displayed by
- * marking the corresponding index in the ignore list.
- *
- * Background:
- * The display layout is setup to show up to 2 alerts, but alerts can be
- * unpredictible in severity and number. If more than 2 alerts are active, this
- * algorithm will attempt to interpret the urgency of each alert and prefer to
- * display the most urgent and recently issued alerts of each event type.
- * Depending on the region different keywords are used to convey the level of
- * urgency.
- *
- * A vector array is used to store these keywords. (defined in config.h) Urgency
- * is ranked from low to high where the first index of the vector is the least
- * urgent keyword and the last index is the most urgent keyword. Expected as all
- * lowercase.
- *
- *
- * Pseudo Code:
- * Convert all event text and tags to lowercase.
- *
- * // Deduplicate alerts of the same type
- * Dedup alerts with the same first tag. (ie. tag 0) Keeping only the most
- *   urgent alerts of each tag and alerts who's urgency cannot be determined.
- * Note: urgency keywords are defined in config.h because they are very
- *       regional. ex: United States - (Watch < Advisory < Warning)
- *
- * // Save only the 2 most recent alerts
- * If (more than 2 weather alerts remain)
- *   Keep only the 2 most recently issued alerts (aka greatest "start" time)
- *   OpenWeatherMap provides this order, so we can just take index 0 and 1.
- *
- * Truncate Extraneous Info (anything that follows a comma, period, or open
- *   parentheses)
- */
-void filterAlerts(std::vector<owm_alerts_t> &resp, int *ignore_list)
-{
-  // Convert all event text and tags to lowercase.
-  for (auto &alert : resp)
-  {
-    alert.event.toLowerCase();
-    alert.tags.toLowerCase();
-  }
-
-  // Deduplicate alerts with the same first tag. Keeping only the most urgent
-  // alerts of each tag and alerts who's urgency cannot be determined.
-  for (int i = 0; i < resp.size(); ++i)
-  {
-    if (ignore_list[i] == 1)
-    {
-      continue;
-    }
-    if (resp[i].tags.isEmpty())
-    {
-      continue; // urgency can not be determined so it remains in the list
-    }
-
-    for (int j = 0; j < resp.size(); ++j)
-    {
-      if (i != j && resp[i].tags == resp[j].tags)
-      {
-        // comparing alerts of the same tag, removing the less urgent alert
-        if (eventUrgency(resp[i].event) >= eventUrgency(resp[j].event))
-        {
-          ignore_list[j] = 1;
-        }
-      }
-    }
-  }
-
-  // Save only the 2 most recent alerts
-  int valid_cnt = 0;
-  for (int i = 0; i < resp.size(); ++i)
-  {
-    if (valid_cnt < 2 && !ignore_list[i])
-    {
-      ++valid_cnt;
-    }
-    else
-    {
-      ignore_list[i] = 1;
-    }
-  }
-
-  // Remove trailing/extraneous information
-  for (auto &alert : resp)
-  {
-    truncateExtraAlertInfo(alert.event);
-  }
-
-  return;
-} // end filterAlerts
-
 /* Returns the descriptor text for the given UV index.
  */
 const char *getUVIdesc(unsigned int uvi)
@@ -438,12 +290,12 @@ const uint8_t *getWiFiBitmap16(int rssi)
   }
 } // end getWiFiBitmap24
 
-/* Returns true if icon is a daytime icon, false otherwise.
+/* Returns true if the weather icon is a daytime icon, false otherwise.
  */
-bool isDay(String icon) 
+bool isDay(const owm_weather_t &weather)
 {
   // OpenWeatherMap indicates sun is up with d otherwise n for night
-  return icon.endsWith("d");
+  return weather.day;
 }
 
 /* Returns true if the moon is currently in the sky above, false otherwise.
@@ -636,20 +488,20 @@ const uint8_t *getConditionsBitmap(int id, bool day, bool moon, bool cloudy,
   }
 } // end getConditionsBitmap
 
-/* Takes the daily weather forecast (from OpenWeatherMap API response) and
- * returns a pointer to the icon's 32x32 bitmap.
+/* Takes hour i of the hourly forecast series and returns a pointer to the
+ * icon's 32x32 bitmap.
  *
  * The daily weather forcast of today is needed for moonrise and moonset times.
  */
-const uint8_t *getHourlyForecastBitmap32(const owm_hourly_t &hourly,
-                                         const owm_daily_t  &today)
+const uint8_t *getHourlyForecastBitmap32(const owm_hourly_series_t &hourly,
+                                         int i, const owm_daily_t &today)
 {
-  const int id = hourly.weather.id;
-  const bool day = isDay(hourly.weather.icon);
-  const bool moon = isMoonInSky(hourly.dt, today.moonrise, today.moonset,
+  const int id = hourly.weather[i].id;
+  const bool day = isDay(hourly.weather[i]);
+  const bool moon = isMoonInSky(hourly.dt[i], today.moonrise, today.moonset,
                                 today.moon_phase);
-  const bool cloudy = isCloudy(hourly.clouds);
-  const bool windy = isWindy(hourly.wind_speed, hourly.wind_gust);
+  const bool cloudy = isCloudy(hourly.clouds[i]);
+  const bool windy = isWindy(hourly.wind_speed[i], hourly.wind_gust[i]);
   return getConditionsBitmap<32>(id, day, moon, cloudy, windy);
 }
 
@@ -677,7 +529,7 @@ const uint8_t *getCurrentConditionsBitmap196(const owm_current_t &current,
                                              const owm_daily_t   &today)
 {
   const int id = current.weather.id;
-  const bool day = isDay(current.weather.icon);
+  const bool day = isDay(current.weather);
   const bool moon = isMoonInSky(current.dt, today.moonrise, today.moonset,
                                 today.moon_phase);
   const bool cloudy = isCloudy(current.clouds);
@@ -689,7 +541,7 @@ const uint8_t *getCurrentConditionsBitmap96(const owm_current_t &current,
   const owm_daily_t   &today)
 {
   const int id = current.weather.id;
-  const bool day = isDay(current.weather.icon);
+  const bool day = isDay(current.weather);
   const bool moon = isMoonInSky(current.dt, today.moonrise, today.moonset,
   today.moon_phase);
   const bool cloudy = isCloudy(current.clouds);
@@ -789,22 +641,40 @@ const uint8_t *getAlertBitmap48(const owm_alerts_t &alert)
   }
 } // end getAlertBitmap48
 
-/* Returns true of a String, s, contains any of the strings in the terminology
- * vector.
+/* Scans text once for the keywords of the locale's alert terminology
+ * (TERM_*) and urgency levels (ALERT_URGENCY), with the automaton built from
+ * them at compile time.
+ *
+ * Returns the category of the first TERM_* list, in the order of enum
+ * alert_category, that has a keyword in text, and the highest urgency level
+ * in text, -1 for either if there is none.
  *
  * Note: This function is case sensitive.
  */
-bool containsTerminology(const String s, const std::vector<String> &terminology)
+alert_match_t matchAlertTerms(const char *text, size_t len)
 {
-  for (const String &term : terminology)
+  const alert_node_t *node = ALERT_AUTOMATON;
+  alert_match_t m = {-1, -1};
+  if (len > 0)
+  { // an empty keyword is in any text that is not empty, as with indexOf()
+    m = {node[0].category, node[0].urgency};
+  }
+  uint16_t s = 0;
+  for (size_t i = 0; i < len; ++i)
   {
-    if (s.indexOf(term) >= 0)
+    s = alertNextState(node, s, static_cast<uint8_t>(text[i]));
+    const alert_node_t &n = node[s];
+    if (n.category >= 0 && (m.category < 0 || n.category < m.category))
+    {
+      m.category = n.category;
+    }
+    if (n.urgency > m.urgency)
     {
-      return true;
+      m.urgency = n.urgency;
     }
   }
-  return false;
-} // end containsTerminology
+  return m;
+} // end matchAlertTerms
 
 /* Returns the category of an alert based on the terminology found in the event
  * name.
@@ -813,103 +683,8 @@ bool containsTerminology(const String s, const std::vector<String> &terminology)
  */
 enum alert_category getAlertCategory(const owm_alerts_t &alert)
 {
-  if (containsTerminology(alert.event, TERM_SMOG))
-  {
-    return alert_category::SMOG;
-  }
-  if (containsTerminology(alert.event, TERM_SMOKE))
-  {
-    return alert_category::SMOKE;
-  }
-  if (containsTerminology(alert.event, TERM_FOG))
-  {
-    return alert_category::FOG;
-  }
-  if (containsTerminology(alert.event, TERM_METEOR))
-  {
-    return alert_category::METEOR;
-  }
-  if (containsTerminology(alert.event, TERM_NUCLEAR))
-  {
-    return alert_category::NUCLEAR;
-  }
-  if (containsTerminology(alert.event, TERM_BIOHAZARD))
-  {
-    return alert_category::BIOHAZARD;
-  }
-  if (containsTerminology(alert.event, TERM_EARTHQUAKE))
-  {
-    return alert_category::EARTHQUAKE;
-  }
-  if (containsTerminology(alert.event, TERM_FIRE))
-  {
-    return alert_category::FIRE;
-  }
-  if (containsTerminology(alert.event, TERM_HEAT))
-  {
-    return alert_category::HEAT;
-  }
-  if (containsTerminology(alert.event, TERM_WINTER))
-  {
-    return alert_category::WINTER;
-  }
-  if (containsTerminology(alert.event, TERM_TSUNAMI))
-  {
-    return alert_category::TSUNAMI;
-  }
-  if (containsTerminology(alert.event, TERM_LIGHTNING))
-  {
-    return alert_category::LIGHTNING;
-  }
-  if (containsTerminology(alert.event, TERM_SANDSTORM))
-  {
-    return alert_category::SANDSTORM;
-  }
-  if (containsTerminology(alert.event, TERM_FLOOD))
-  {
-    return alert_category::FLOOD;
-  }
-  if (containsTerminology(alert.event, TERM_VOLCANO))
-  {
-    return alert_category::VOLCANO;
-  }
-  if (containsTerminology(alert.event, TERM_AIR_QUALITY))
-  {
-    return alert_category::AIR_QUALITY;
-  }
-  if (containsTerminology(alert.event, TERM_TORNADO))
-  {
-    return alert_category::TORNADO;
-  }
-  if (containsTerminology(alert.event, TERM_SMALL_CRAFT_ADVISORY))
-  {
-    return alert_category::SMALL_CRAFT_ADVISORY;
-  }
-  if (containsTerminology(alert.event, TERM_GALE_WARNING))
-  {
-    return alert_category::GALE_WARNING;
-  }
-  if (containsTerminology(alert.event, TERM_STORM_WARNING))
-  {
-    return alert_category::STORM_WARNING;
-  }
-  if (containsTerminology(alert.event, TERM_HURRICANE_WARNING))
-  {
-    return alert_category::HURRICANE_WARNING;
-  }
-  if (containsTerminology(alert.event, TERM_HURRICANE))
-  {
-    return alert_category::HURRICANE;
-  }
-  if (containsTerminology(alert.event, TERM_DUST))
-  {
-    return alert_category::DUST;
-  }
-  if (containsTerminology(alert.event, TERM_STRONG_WIND))
-  {
-    return alert_category::STRONG_WIND;
-  }
-  return alert_category::NOT_FOUND;
+  return static_cast<enum alert_category>(
+    matchAlertTerms(alert.event.c_str(), alert.event.length()).category);
 } // end getAlertCategory
 
 #ifdef WIND_ICONS_CARDINAL
@@ -1347,7 +1122,145 @@ static const unsigned char *wind_direction_icon_arr[] = {
   wind_direction_meteorological_358deg_24x24,
   wind_direction_meteorological_359deg_24x24};
 #endif // end WIND_ICONS_360
+#ifdef WIND_ICONS_ROTATED
+// sin of 0 to 90 degrees, Q14
+static const int16_t SIN_Q14[91] PROGMEM = {
+      0,   286,   572,   857,  1143,  1428,  1713,  1997,  2280,  2563,
+   2845,  3126,  3406,  3686,  3964,  4240,  4516,  4790,  5063,  5334,
+   5604,  5872,  6138,  6402,  6664,  6924,  7182,  7438,  7692,  7943,
+   8192,  8438,  8682,  8923,  9162,  9397,  9630,  9860, 10087, 10311,
+  10531, 10749, 10963, 11174, 11381, 11585, 11786, 11982, 12176, 12365,
+  12551, 12733, 12911, 13085, 13255, 13421, 13583, 13741, 13894, 14044,
+  14189, 14330, 14466, 14598, 14726, 14849, 14968, 15082, 15191, 15296,
+  15396, 15491, 15582, 15668, 15749, 15826, 15897, 15964, 16026, 16083,
+  16135, 16182, 16225, 16262, 16294, 16322, 16344, 16362, 16374, 16382,
+  16384};
+// arrow pointing down (0 degrees), 1/8 px from the center of the icon
+static const int16_t WIND_ARROW[][2] PROGMEM = {
+  {  0,  83}, // tip
+  {-57, -78}, // left wing
+  {  0, -43}, // notch
+  { 57, -78}  // right wing
+};
+#define WIND_ARROW_POINTS (sizeof(WIND_ARROW) / sizeof(WIND_ARROW[0]))
+// rotated arrows kept, the display list draws a frame's bitmaps after the
+// renderer has returned
+#define WIND_ARROW_CACHE  4
+
+/* sin of any whole number of degrees, Q14.
+ */
+static int32_t sinQ14(int deg)
+{
+  deg %= 360;
+  if (deg < 0)
+  {
+    deg += 360;
+  }
+  if (deg <= 90)
+  {
+    return pgm_read_word(&SIN_Q14[deg]);
+  }
+  if (deg <= 180)
+  {
+    return pgm_read_word(&SIN_Q14[180 - deg]);
+  }
+  if (deg <= 270)
+  {
+    return -static_cast<int16_t>(pgm_read_word(&SIN_Q14[deg - 180]));
+  }
+  return -static_cast<int16_t>(pgm_read_word(&SIN_Q14[360 - deg]));
+} // end sinQ14
+
+/* Draws the arrow turned windDeg clockwise into a 24x24 inverted bitmap. A
+ * pixel is inked if its center is inside the outline.
+ */
+static void rotateWindArrow(uint8_t *bitmap, int windDeg)
+{
+  const int32_t s = sinQ14(windDeg);
+  const int32_t c = sinQ14(windDeg + 90);
+  // outline in 1/256 px of the bitmap
+  int32_t px[WIND_ARROW_POINTS], py[WIND_ARROW_POINTS];
+  for (size_t i = 0; i < WIND_ARROW_POINTS; ++i)
+  {
+    int32_t x = static_cast<int16_t>(pgm_read_word(&WIND_ARROW[i][0]));
+    int32_t y = static_cast<int16_t>(pgm_read_word(&WIND_ARROW[i][1]));
+    px[i] = ((x * c - y * s) >> 9) + (12 << 8);
+    py[i] = ((x * s + y * c) >> 9) + (12 << 8);
+  }
+
+  memset(bitmap, 0xFF, 24 * 24 / 8);
+  for (int row = 0; row < 24; ++row)
+  {
+    // crossings of the outline with the row's centerline, in order
+    const int32_t y = (row << 8) + 128;
+    int32_t xs[WIND_ARROW_POINTS];
+    int n = 0;
+    for (size_t i = 0; i < WIND_ARROW_POINTS; ++i)
+    {
+      size_t j = (i + 1) % WIND_ARROW_POINTS;
+      if ((py[i] > y) != (py[j] > y))
+      {
+        int32_t x = px[i] + (y - py[i]) * (px[j] - px[i]) / (py[j] - py[i]);
+        int k = n++;
+        for (; k > 0 && xs[k - 1] > x; --k)
+        {
+          xs[k] = xs[k - 1];
+        }
+        xs[k] = x;
+      }
+    }
+    for (int k = 0; k + 1 < n; k += 2)
+    {
+      for (int col = 0; col < 24; ++col)
+      {
+        int32_t x = (col << 8) + 128;
+        if (x >= xs[k] && x < xs[k + 1])
+        {
+          bitmap[row * 3 + col / 8] &= ~(0x80 >> (col % 8));
+        }
+      }
+    }
+  }
+} // end rotateWindArrow
+
+/* Returns a 24x24 wind direction icon bitmap for angles 0 to 359 degrees
+ * Parameter is meteorological wind direction, arrow points in the direction the
+ * wind is going.
+ *
+ * The arrow is rotated to the nearest degree from one outline. The bitmap is
+ * in RAM and stays valid until WIND_ARROW_CACHE other directions are drawn.
+ */
+const uint8_t *getWindBitmap24(int windDeg)
+{
+  typedef struct wind_arrow
+  {
+    bool    used;
+    int16_t deg;
+    uint8_t bitmap[24 * 24 / 8];
+  } wind_arrow_t;
+  static wind_arrow_t arrows[WIND_ARROW_CACHE] = {};
+  static int next = 0;
 
+  windDeg %= 360; // enforce domain
+  if (windDeg < 0)
+  {
+    windDeg += 360;
+  }
+  for (const wind_arrow_t &a : arrows)
+  {
+    if (a.used && a.deg == windDeg)
+    {
+      return a.bitmap;
+    }
+  }
+  wind_arrow_t &a = arrows[next];
+  next = (next + 1) % WIND_ARROW_CACHE;
+  a.used = true;
+  a.deg = windDeg;
+  rotateWindArrow(a.bitmap, windDeg);
+  return a.bitmap;
+} // end getWindBitmap24
+#else // stored icons
 /* Returns a 24x24 wind direction icon bitmap for angles 0 to 359 degrees
  * Parameter is meteorological wind direction, arrow points in the direction the
  * wind is going.
@@ -1363,6 +1276,7 @@ const uint8_t *getWindBitmap24(int windDeg)
 
   return wind_direction_icon_arr[arr_offset];
 } // end getWindBitmap24
+#endif // end WIND_ICONS_ROTATED
 
 /* Returns a pointer to a string that expresses the Compass Point Notation (CPN)
  * of the given windDeg.
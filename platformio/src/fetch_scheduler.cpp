@@ -0,0 +1,129 @@
+/* Concurrent API requests for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <HTTPClient.h>
+
+#include "config.h"
+#include "fetch_scheduler.h"
+
+#if CONCURRENT_REQUESTS > 1
+// one count per request that may run, given back by each task when it is done
+static SemaphoreHandle_t fetchSlots = NULL;
+#endif
+
+/* Runs the jobs one after the other in the calling task. Without
+ * STALE_DATA_FALLBACK it stops at the first one that fails; with it every job
+ * runs, so that only the failed ones are drawn from the snapshot.
+ *
+ * Returns the index of the first failed job, or -1 if all succeeded.
+ */
+static int fetchSequential(fetch_job_t *jobs, int n)
+{
+  int failed = -1;
+  for (int i = 0; i < n; ++i)
+  {
+    jobs[i].status = jobs[i].fetch(jobs[i].resp);
+    if (jobs[i].status != HTTP_CODE_OK && failed < 0)
+    {
+      failed = i;
+    }
+    if (failed >= 0 && !STALE_DATA_FALLBACK)
+    {
+      return failed;
+    }
+  }
+  return failed;
+} // end fetchSequential
+
+#if CONCURRENT_REQUESTS > 1
+static void fetchTask(void *arg)
+{
+  fetch_job_t *job = static_cast<fetch_job_t *>(arg);
+  job->status = job->fetch(job->resp);
+  job->stackUnused = uxTaskGetStackHighWaterMark(NULL);
+  xSemaphoreGive(fetchSlots);
+  vTaskDelete(NULL);
+} // end fetchTask
+#endif
+
+/* Runs the API requests, up to CONCURRENT_REQUESTS at a time. Each one runs in
+ * its own FreeRTOS task on whichever core is free, so their TLS handshakes and
+ * round trips overlap. Returns once every request has finished.
+ *
+ * Returns the index of the first job (in the order given) that failed, or -1
+ * if all succeeded.
+ */
+int fetchAll(fetch_job_t *jobs, int n)
+{
+#if CONCURRENT_REQUESTS > 1
+  fetchSlots = xSemaphoreCreateCounting(CONCURRENT_REQUESTS,
+                                        CONCURRENT_REQUESTS);
+  if (fetchSlots == NULL)
+  {
+    return fetchSequential(jobs, n);
+  }
+
+  UBaseType_t priority = uxTaskPriorityGet(NULL);
+  for (int i = 0; i < n; ++i)
+  {
+    jobs[i].stackUnused = 0;
+    xSemaphoreTake(fetchSlots, portMAX_DELAY);
+    if (xTaskCreatePinnedToCore(fetchTask, "fetch", FETCH_TASK_STACK_SIZE,
+                                &jobs[i], priority, NULL, tskNO_AFFINITY)
+        != pdPASS)
+    { // not enough memory for another task, run the request here
+      jobs[i].status = jobs[i].fetch(jobs[i].resp);
+      xSemaphoreGive(fetchSlots);
+    }
+  }
+  // every slot is given back once the last task has finished
+  for (int i = 0; i < CONCURRENT_REQUESTS; ++i)
+  {
+    xSemaphoreTake(fetchSlots, portMAX_DELAY);
+  }
+  vSemaphoreDelete(fetchSlots);
+  fetchSlots = NULL;
+
+#if DEBUG_LEVEL >= 1
+  // printed once every task is done, so the lines do not interleave
+  for (int i = 0; i < n; ++i)
+  {
+    if (jobs[i].stackUnused)
+    {
+      Serial.println("[debug] fetch stack     : " + jobs[i].name + ", "
+                     + String(FETCH_TASK_STACK_SIZE - jobs[i].stackUnused)
+                     + "/" + String(FETCH_TASK_STACK_SIZE) + " B used");
+    }
+  }
+#endif
+
+  for (int i = 0; i < n; ++i)
+  {
+    if (jobs[i].status != HTTP_CODE_OK)
+    {
+      return i;
+    }
+  }
+  return -1;
+#else
+  return fetchSequential(jobs, n);
+#endif
+} // end fetchAll
@@ -0,0 +1,150 @@
+/* Great-circle distance functions for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "geo_distance.h"
+
+#include <cmath>
+
+#define GEO_PI         3.14159265358979f
+#define GEO_HALF_PI    1.57079632679490f
+#define GEO_DEG_TO_RAD 0.01745329251994f
+// slack on the bounding box for float rounding, ~0.6km
+#define GEO_BOX_MARGIN 1e-4f
+
+/* Returns the great-circle distance in km between two points given in
+ * degrees (haversine formula).
+ */
+float calculateDistance(float lat1, float lon1, float lat2, float lon2)
+{
+  float dLat = (lat2 - lat1) * GEO_DEG_TO_RAD;
+  float dLon = (lon2 - lon1) * GEO_DEG_TO_RAD;
+
+  float a = sinf(dLat / 2) * sinf(dLat / 2)
+          + cosf(lat1 * GEO_DEG_TO_RAD) * cosf(lat2 * GEO_DEG_TO_RAD)
+          * sinf(dLon / 2) * sinf(dLon / 2);
+
+  float c = 2 * atan2f(sqrtf(a), sqrtf(1 - a));
+  return GEO_EARTH_RADIUS_KM * c;
+} // end calculateDistance
+
+/* Prepares o for distance queries from (lat, lon), given in degrees, with no
+ * search radius.
+ */
+void geoObserverInit(geo_observer_t &o, float lat, float lon)
+{
+  o.lat = lat * GEO_DEG_TO_RAD;
+  o.lon = lon * GEO_DEG_TO_RAD;
+  o.cos_lat = cosf(o.lat);
+  geoObserverSetMaxDistance(o, INFINITY);
+} // end geoObserverInit
+
+/* Sets the search radius in km. Points further away are rejected by
+ * geoDistanceWithin(), most of them by the bounding box without any
+ * trigonometry.
+ *
+ * The longitude bound is the tangent of the radius' circle at the observer's
+ * latitude: asin(sin(r) / cos(lat)). Near a pole the circle wraps around it
+ * and only the latitude bound is used.
+ *
+ * References:
+ *   http://janmatuschek.de/LatitudeLongitudeBoundingCoordinates
+ */
+void geoObserverSetMaxDistance(geo_observer_t &o, float km)
+{
+  o.max_distance = km;
+  float angle = km / GEO_EARTH_RADIUS_KM;
+  if (!(angle < GEO_PI))
+  {
+    o.max_dlat = INFINITY;
+    o.max_dlon = INFINITY;
+    o.max_hav = INFINITY;
+    return;
+  }
+  o.max_dlat = angle + GEO_BOX_MARGIN;
+  float s = sinf(angle) / o.cos_lat;
+  if (fabsf(o.lat) + angle >= GEO_HALF_PI || s >= 1.f)
+  {
+    o.max_dlon = INFINITY;
+  }
+  else
+  {
+    o.max_dlon = asinf(s) + GEO_BOX_MARGIN;
+  }
+  float h = sinf(angle / 2);
+  o.max_hav = h * h;
+} // end geoObserverSetMaxDistance
+
+/* Returns true and the distance in km if (lat, lon) is closer than the search
+ * radius, false otherwise.
+ *
+ * The exact haversine is compared to the radius before the (expensive) atan2
+ * and square roots, those only run for points that are accepted.
+ */
+bool geoDistanceWithin(const geo_observer_t &o, float lat, float lon,
+                       float &distance)
+{
+  float phi = lat * GEO_DEG_TO_RAD;
+  float dLat = phi - o.lat;
+  if (fabsf(dLat) > o.max_dlat)
+  {
+    return false;
+  }
+  float dLon = lon * GEO_DEG_TO_RAD - o.lon;
+  if (dLon > GEO_PI)
+  {
+    dLon -= 2 * GEO_PI;
+  }
+  else if (dLon < -GEO_PI)
+  {
+    dLon += 2 * GEO_PI;
+  }
+  if (fabsf(dLon) > o.max_dlon)
+  {
+    return false;
+  }
+
+  float sLat = sinf(dLat / 2);
+  float sLon = sinf(dLon / 2);
+  float a = sLat * sLat + o.cos_lat * cosf(phi) * sLon * sLon;
+  if (a >= o.max_hav)
+  {
+    return false;
+  }
+  distance = GEO_EARTH_RADIUS_KM * 2 * atan2f(sqrtf(a), sqrtf(1 - a));
+  return true;
+} // end geoDistanceWithin
+
+/* Computes the distances of n points, lat[i] and lon[i] in degrees. Points
+ * outside the search radius get INFINITY. Returns the number of points inside.
+ */
+int geoDistanceBatch(const geo_observer_t &o, const float *lat,
+                     const float *lon, float *distance, int n)
+{
+  int inside = 0;
+  for (int i = 0; i < n; ++i)
+  {
+    if (geoDistanceWithin(o, lat[i], lon[i], distance[i]))
+    {
+      ++inside;
+    }
+    else
+    {
+      distance[i] = INFINITY;
+    }
+  }
+  return inside;
+} // end geoDistanceBatch
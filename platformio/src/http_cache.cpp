@@ -0,0 +1,242 @@
+/* HTTP response cache for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+#include <cstring>
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <Preferences.h>
+
+#include "config.h"
+#include "http_cache.h"
+
+/*
+ * Each cached response is two NVS entries, keyed by a hash of its URI: the
+ * validators ("v" + hash) and the parsed result ("r" + hash). Results are
+ * only rewritten when the server sends a changed response.
+ *
+ * NVS is kept through a reflash, so the record also holds the format of the
+ * result, see httpCacheFormat(). A record of another format is dropped.
+ */
+typedef struct http_cache_record
+{
+  http_cache_validators_t validators;
+  uint32_t format;
+  uint32_t len;  // bytes of the parsed result
+} http_cache_record_t;
+
+// this wake, and since the last power on
+static uint32_t wakeHits = 0;
+static uint32_t wakeMisses = 0;
+RTC_DATA_ATTR static uint32_t totalHits = 0;
+RTC_DATA_ATTR static uint32_t totalMisses = 0;
+
+/* Requests may run at the same time, see fetchAll().
+ */
+static SemaphoreHandle_t cacheLock()
+{
+  static SemaphoreHandle_t lock = xSemaphoreCreateMutex();
+  return lock;
+} // end cacheLock
+
+/* NVS keys of uri, FNV-1a of the URI.
+ */
+static void cacheKeys(const String &uri, char *validatorKey, char *resultKey)
+{
+  uint32_t hash = 2166136261u;
+  for (const char *c = uri.c_str(); *c; ++c)
+  {
+    hash = (hash ^ static_cast<uint8_t>(*c)) * 16777619u;
+  }
+  snprintf(validatorKey, 10, "v%08lx", static_cast<unsigned long>(hash));
+  snprintf(resultKey, 10, "r%08lx", static_cast<unsigned long>(hash));
+} // end cacheKeys
+
+/* Identifies what a cached result means beyond the response it was parsed
+ * from: HTTP_CACHE_VERSION and the len bytes of settings, which hold the size
+ * of the result and the configuration the parser used. FNV-1a.
+ */
+uint32_t httpCacheFormat(const void *settings, size_t len)
+{
+  uint32_t hash = 2166136261u;
+  const uint8_t version[] = {HTTP_CACHE_VERSION};
+  const uint8_t *bytes[] = {version, static_cast<const uint8_t *>(settings)};
+  const size_t lens[] = {sizeof(version), len};
+  for (int i = 0; i < 2; ++i)
+  {
+    for (size_t n = 0; n < lens[i]; ++n)
+    {
+      hash = (hash ^ bytes[i][n]) * 16777619u;
+    }
+  }
+  return hash;
+} // end httpCacheFormat
+
+static bool readRecord(Preferences &nvs, const char *key, uint32_t format,
+                       http_cache_record_t &record)
+{
+  return nvs.getBytes(key, &record, sizeof(record)) == sizeof(record)
+      && record.format == format
+      && record.len <= HTTP_CACHE_MAX_RESULT
+      && memchr(record.validators.etag, '\0',
+                sizeof(record.validators.etag))
+      && memchr(record.validators.last_modified, '\0',
+                sizeof(record.validators.last_modified));
+} // end readRecord
+
+/* Gets the validators of the cached response to uri.
+ *
+ * Returns false if there is no cached response of this format. One of another
+ * format, or an unreadable one, is dropped.
+ */
+bool httpCacheValidators(const String &uri, uint32_t format,
+                         http_cache_validators_t &v)
+{
+  if (!HTTP_RESPONSE_CACHE)
+  {
+    return false;
+  }
+  char vKey[10], rKey[10];
+  cacheKeys(uri, vKey, rKey);
+  http_cache_record_t record;
+  xSemaphoreTake(cacheLock(), portMAX_DELAY);
+  Preferences nvs;
+  bool found = false;
+  if (nvs.begin(HTTP_CACHE_NAMESPACE, false))
+  {
+    found = readRecord(nvs, vKey, format, record);
+    if (!found && nvs.isKey(vKey))
+    {
+      nvs.remove(vKey);
+      nvs.remove(rKey);
+    }
+  }
+  nvs.end();
+  xSemaphoreGive(cacheLock());
+  if (found)
+  {
+    v = record.validators;
+  }
+  return found;
+} // end httpCacheValidators
+
+/* Loads the parsed result of this format cached for uri into result (size
+ * bytes), after the server answered 304 Not Modified.
+ *
+ * Returns the length of the result, 0 if it is missing or larger than size.
+ */
+size_t httpCacheLoad(const String &uri, uint32_t format, void *result,
+                     size_t size)
+{
+  char vKey[10], rKey[10];
+  cacheKeys(uri, vKey, rKey);
+  http_cache_record_t record;
+  size_t len = 0;
+  xSemaphoreTake(cacheLock(), portMAX_DELAY);
+  Preferences nvs;
+  if (nvs.begin(HTTP_CACHE_NAMESPACE, true)
+   && readRecord(nvs, vKey, format, record) && record.len <= size
+   && nvs.getBytes(rKey, result, record.len) == record.len)
+  {
+    len = record.len;
+  }
+  nvs.end();
+  xSemaphoreGive(cacheLock());
+  return len;
+} // end httpCacheLoad
+
+/* Caches the parsed result of a response to uri along with its validators.
+ * Nothing is kept if the server sent neither an ETag nor a Last-Modified
+ * header, the response could not be validated later.
+ */
+void httpCacheStore(const String &uri, uint32_t format, const String &etag,
+                    const String &lastModified,
+                    const void *result, size_t len)
+{
+  char vKey[10], rKey[10];
+  cacheKeys(uri, vKey, rKey);
+  http_cache_record_t record = {};
+  if ((etag.length() == 0 && lastModified.length() == 0)
+   || etag.length() >= sizeof(record.validators.etag)
+   || lastModified.length() >= sizeof(record.validators.last_modified)
+   || len == 0 || len > HTTP_CACHE_MAX_RESULT || !HTTP_RESPONSE_CACHE)
+  {
+    httpCacheForget(uri);
+    return;
+  }
+  strcpy(record.validators.etag, etag.c_str());
+  strcpy(record.validators.last_modified, lastModified.c_str());
+  record.format = format;
+  record.len = len;
+
+  xSemaphoreTake(cacheLock(), portMAX_DELAY);
+  Preferences nvs;
+  if (nvs.begin(HTTP_CACHE_NAMESPACE, false))
+  {
+    // the result first, validators without it would never be used
+    if (nvs.putBytes(rKey, result, len) != len
+     || nvs.putBytes(vKey, &record, sizeof(record)) != sizeof(record))
+    {
+      nvs.remove(vKey);
+    }
+  }
+  nvs.end();
+  xSemaphoreGive(cacheLock());
+} // end httpCacheStore
+
+void httpCacheForget(const String &uri)
+{
+  char vKey[10], rKey[10];
+  cacheKeys(uri, vKey, rKey);
+  xSemaphoreTake(cacheLock(), portMAX_DELAY);
+  Preferences nvs;
+  if (nvs.begin(HTTP_CACHE_NAMESPACE, false) && nvs.isKey(vKey))
+  {
+    nvs.remove(vKey);
+    nvs.remove(rKey);
+  }
+  nvs.end();
+  xSemaphoreGive(cacheLock());
+} // end httpCacheForget
+
+/* Counts a request that was answered from the cache (hit), or with a full
+ * response (miss).
+ */
+void httpCacheCount(bool hit)
+{
+  xSemaphoreTake(cacheLock(), portMAX_DELAY);
+  if (hit)
+  {
+    ++wakeHits;
+    ++totalHits;
+  }
+  else
+  {
+    ++wakeMisses;
+    ++totalMisses;
+  }
+  xSemaphoreGive(cacheLock());
+} // end httpCacheCount
+
+void httpCachePrintStats()
+{
+  Serial.println("[debug] HTTP cache      : " + String(wakeHits) + " hit, "
+                 + String(wakeMisses) + " miss (" + String(totalHits)
+                 + " hit, " + String(totalMisses) + " miss since power on)");
+} // end httpCachePrintStats
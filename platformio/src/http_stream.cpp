@@ -0,0 +1,230 @@
+/* HTTP response body stream for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+
+#include "http_stream.h"
+
+HttpBodyStream::HttpBodyStream(HTTPClient &http)
+  : _stream(http.getStream()), _chunked(false), _sized(false), _done(false),
+    _failed(false), _inChunk(false), _remaining(0)
+{
+  String encoding = http.header("Transfer-Encoding");
+  encoding.toLowerCase();
+  _chunked = encoding.indexOf("chunked") >= 0;
+  int size = http.getSize();
+  if (!_chunked && size >= 0)
+  {
+    _sized = true;
+    _remaining = static_cast<uint32_t>(size);
+  }
+  else if (!_chunked)
+  { // until the server closes the connection
+    _remaining = UINT32_MAX;
+  }
+} // end HttpBodyStream
+
+/* Returns the next byte of the connection, waiting up to its timeout, or -1.
+ */
+int HttpBodyStream::getByte()
+{
+  char c;
+  return _stream.readBytes(&c, 1) == 1 ? static_cast<uint8_t>(c) : -1;
+} // end getByte
+
+/* Reads one line of the chunk framing without its CRLF, lines longer than
+ * size - 1 are truncated. Returns false if the connection ended first.
+ */
+bool HttpBodyStream::readLine(char *line, size_t size)
+{
+  size_t n = 0;
+  for (;;)
+  {
+    int c = getByte();
+    if (c < 0)
+    {
+      return false;
+    }
+    if (c == '\n')
+    {
+      break;
+    }
+    if (c != '\r' && n < size - 1)
+    {
+      line[n++] = static_cast<char>(c);
+    }
+  }
+  line[n] = '\0';
+  return true;
+} // end readLine
+
+/* Reads the size line of the next chunk. The last chunk (size 0) and the
+ * trailer after it are consumed too, so that the connection is left at the
+ * start of the next response.
+ *
+ * Returns true if there is another chunk of data.
+ */
+bool HttpBodyStream::nextChunk()
+{
+  char line[24];
+  if (_inChunk && (!readLine(line, sizeof(line)) || line[0] != '\0'))
+  { // the data of a chunk is followed by CRLF
+    _failed = true;
+    return false;
+  }
+  if (!readLine(line, sizeof(line)))
+  {
+    _failed = true;
+    return false;
+  }
+  char *end;
+  unsigned long size = strtoul(line, &end, 16);
+  if (end == line || (*end != '\0' && *end != ';' && *end != ' '))
+  {
+    _failed = true;
+    return false;
+  }
+  _inChunk = true;
+  if (size == 0)
+  { // trailer fields, if any, end with an empty line
+    do
+    {
+      if (!readLine(line, sizeof(line)))
+      {
+        _failed = true;
+        return false;
+      }
+    } while (line[0] != '\0');
+    _done = true;
+    return false;
+  }
+  _remaining = static_cast<uint32_t>(size);
+  return true;
+} // end nextChunk
+
+/* Returns true if there are bytes of the body left in the current chunk (or
+ * the body). Otherwise the next chunk header is read, unless wait is false
+ * and it has not arrived yet.
+ */
+bool HttpBodyStream::ensure(bool wait)
+{
+  if (_remaining > 0)
+  {
+    return true;
+  }
+  if (_done || _failed)
+  {
+    return false;
+  }
+  if (!_chunked)
+  {
+    _done = true;
+    return false;
+  }
+  if (!wait && _stream.available() <= 0)
+  {
+    return false;
+  }
+  return nextChunk();
+} // end ensure
+
+/* The connection ended before the body did, unless the body had no length.
+ */
+int HttpBodyStream::endOfStream()
+{
+  if (!_chunked && !_sized)
+  {
+    _done = true;
+    _remaining = 0;
+  }
+  else
+  {
+    _failed = true;
+  }
+  return -1;
+} // end endOfStream
+
+int HttpBodyStream::available()
+{
+  if (!ensure(false))
+  {
+    return 0;
+  }
+  int avail = _stream.available();
+  if (avail <= 0)
+  {
+    return 0;
+  }
+  return static_cast<uint32_t>(avail) < _remaining
+         ? avail : static_cast<int>(_remaining);
+} // end available
+
+int HttpBodyStream::read()
+{
+  if (!ensure(true))
+  {
+    return -1;
+  }
+  int c = getByte();
+  if (c < 0)
+  {
+    return endOfStream();
+  }
+  --_remaining;
+  return c;
+} // end read
+
+int HttpBodyStream::peek()
+{
+  if (!ensure(true))
+  {
+    return -1;
+  }
+  return _stream.peek();
+} // end peek
+
+size_t HttpBodyStream::readBytes(char *buffer, size_t length)
+{
+  size_t n = 0;
+  while (n < length && ensure(true))
+  {
+    size_t want = std::min<size_t>(length - n, _remaining);
+    size_t got = _stream.readBytes(buffer + n, want);
+    _remaining -= got;
+    n += got;
+    if (got < want)
+    {
+      endOfStream();
+      break;
+    }
+  }
+  return n;
+} // end readBytes
+
+/* Reads and discards the rest of the body.
+ *
+ * Returns true if the whole body was read, the connection can then be used
+ * for the next request.
+ */
+bool HttpBodyStream::drain()
+{
+  char buf[64];
+  while (readBytes(buf, sizeof(buf)) > 0)
+  {
+  }
+  return complete();
+} // end drain
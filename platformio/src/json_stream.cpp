@@ -0,0 +1,484 @@
+/* Streaming JSON reader for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include <cstring>
+
+#include "json_stream.h"
+
+JsonStreamReader::JsonStreamReader(Stream &stream)
+  : _stream(stream), _len(0), _pos(0), _error(DeserializationError::Ok),
+    _depth(0), _first(0), _object(0)
+{
+} // end JsonStreamReader
+
+/* Returns the next byte without consuming it, or -1 at the end of the
+ * stream.
+ *
+ * Whatever is already available is read in one go. Otherwise a single byte is
+ * requested, which waits up to the stream's timeout like ArduinoJson does.
+ */
+int JsonStreamReader::peek()
+{
+  if (_pos == _len)
+  {
+    int avail = _stream.available();
+    size_t want = avail > 0 ? std::min<size_t>(avail, sizeof(_buf)) : 1;
+    _len = _stream.readBytes(_buf, want);
+    _pos = 0;
+    if (_len == 0)
+    {
+      return -1;
+    }
+  }
+  return static_cast<uint8_t>(_buf[_pos]);
+} // end peek
+
+int JsonStreamReader::get()
+{
+  int c = peek();
+  if (c >= 0)
+  {
+    ++_pos;
+  }
+  return c;
+} // end get
+
+/* Returns the first byte of the next token, skipping whitespace.
+ */
+int JsonStreamReader::peekToken()
+{
+  int c = peek();
+  while (c == ' ' || c == '\n' || c == '\r' || c == '\t')
+  {
+    ++_pos;
+    c = peek();
+  }
+  return c;
+} // end peekToken
+
+bool JsonStreamReader::fail(DeserializationError::Code code)
+{
+  if (_error == DeserializationError::Ok)
+  {
+    _error = code;
+  }
+  return false;
+} // end fail
+
+bool JsonStreamReader::enter(char open)
+{
+  if (_error != DeserializationError::Ok)
+  {
+    return false;
+  }
+  int c = peekToken();
+  if (c < 0)
+  {
+    return fail(_depth == 0 && _len == 0 ? DeserializationError::EmptyInput
+                                         : DeserializationError::IncompleteInput);
+  }
+  if (c != open)
+  {
+    return false;
+  }
+  if (_depth == JSON_STREAM_MAX_DEPTH)
+  {
+    return fail(DeserializationError::TooDeep);
+  }
+  ++_pos;
+  ++_depth;
+  _first |= 1UL << _depth;
+  if (open == '{')
+  {
+    _object |= 1UL << _depth;
+  }
+  else
+  {
+    _object &= ~(1UL << _depth);
+  }
+  return true;
+} // end enter
+
+/* Consumes the separator in front of the next member, or the closing
+ * character. Returns true if there is another member.
+ */
+bool JsonStreamReader::next(char close)
+{
+  if (_error != DeserializationError::Ok)
+  {
+    return false;
+  }
+  int c = peekToken();
+  if (c == close)
+  {
+    ++_pos;
+    _first &= ~(1UL << _depth);
+    --_depth;
+    return false;
+  }
+  if (_first & (1UL << _depth))
+  {
+    _first &= ~(1UL << _depth);
+  }
+  else if (c == ',')
+  {
+    ++_pos;
+  }
+  else
+  {
+    return fail(c < 0 ? DeserializationError::IncompleteInput
+                      : DeserializationError::InvalidInput);
+  }
+  if (peekToken() < 0)
+  {
+    return fail(DeserializationError::IncompleteInput);
+  }
+  return true;
+} // end next
+
+/* Returns true if the next value is an object, and enters it.
+ * Any other value is left for the caller to read or skip.
+ */
+bool JsonStreamReader::beginObject()
+{
+  return enter('{');
+} // end beginObject
+
+/* Returns true if the next value is an array, and enters it.
+ */
+bool JsonStreamReader::beginArray()
+{
+  return enter('[');
+} // end beginArray
+
+/* Returns true and the name of the next member of the current object, keys
+ * longer than size - 1 are truncated. Returns false at the end of the object.
+ */
+bool JsonStreamReader::nextKey(char *key, size_t size)
+{
+  if (!next('}'))
+  {
+    return false;
+  }
+  if (get() != '"')
+  {
+    return fail(DeserializationError::InvalidInput);
+  }
+  if (!readStringBody(key, size, nullptr))
+  {
+    return false;
+  }
+  int c = peekToken();
+  if (c != ':')
+  {
+    return fail(c < 0 ? DeserializationError::IncompleteInput
+                      : DeserializationError::InvalidInput);
+  }
+  ++_pos;
+  return true;
+} // end nextKey
+
+/* Returns true if the current array has another element.
+ */
+bool JsonStreamReader::nextElement()
+{
+  return next(']');
+} // end nextElement
+
+/* Reads the characters of a number literal, returns false (without consuming
+ * anything) if the next value is not a number.
+ */
+bool JsonStreamReader::readNumberToken(char *buf, size_t size)
+{
+  int c = peekToken();
+  if (!(c == '-' || (c >= '0' && c <= '9')))
+  {
+    return false;
+  }
+  size_t n = 0;
+  while (c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E'
+      || (c >= '0' && c <= '9'))
+  {
+    if (n < size - 1)
+    {
+      buf[n++] = static_cast<char>(c);
+    }
+    ++_pos;
+    c = peek();
+  }
+  buf[n] = '\0';
+  return true;
+} // end readNumberToken
+
+bool JsonStreamReader::readInt64(int64_t &value)
+{
+  char num[32];
+  value = 0;
+  if (_error != DeserializationError::Ok)
+  {
+    return false;
+  }
+  if (!readNumberToken(num, sizeof(num)))
+  {
+    return skipValue();
+  }
+  if (strpbrk(num, ".eE"))
+  {
+    value = static_cast<int64_t>(strtod(num, nullptr));
+  }
+  else
+  {
+    value = strtoll(num, nullptr, 10);
+  }
+  return true;
+} // end readInt64
+
+bool JsonStreamReader::readInt(int &value)
+{
+  int64_t v;
+  bool ok = readInt64(v);
+  value = static_cast<int>(v);
+  return ok;
+} // end readInt
+
+bool JsonStreamReader::readFloat(float &value)
+{
+  char num[32];
+  value = 0.f;
+  if (_error != DeserializationError::Ok)
+  {
+    return false;
+  }
+  if (!readNumberToken(num, sizeof(num)))
+  {
+    return skipValue();
+  }
+  value = strtof(num, nullptr);
+  return true;
+} // end readFloat
+
+/* Reads the rest of a string after the opening quote into buf (truncated to
+ * size - 1 characters) and/or str. Escapes are decoded, \u to UTF-8.
+ */
+bool JsonStreamReader::readStringBody(char *buf, size_t size, String *str)
+{
+  size_t n = 0;
+  // str grows a chunk at a time, not a character at a time
+  char chunk[64];
+  unsigned int chunkLen = 0;
+  for (;;)
+  {
+    int c = get();
+    if (c < 0)
+    {
+      return fail(DeserializationError::IncompleteInput);
+    }
+    if (c == '"')
+    {
+      break;
+    }
+    char utf8[3];
+    int utf8Len = 0;
+    if (c == '\\')
+    {
+      c = get();
+      switch (c)
+      {
+      case 'b': c = '\b'; break;
+      case 'f': c = '\f'; break;
+      case 'n': c = '\n'; break;
+      case 'r': c = '\r'; break;
+      case 't': c = '\t'; break;
+      case '"': case '\\': case '/': break;
+      case 'u':
+      {
+        char hex[5];
+        for (int i = 0; i < 4; ++i)
+        {
+          int h = get();
+          if (h < 0)
+          {
+            return fail(DeserializationError::IncompleteInput);
+          }
+          hex[i] = static_cast<char>(h);
+        }
+        hex[4] = '\0';
+        long u = strtol(hex, nullptr, 16);
+        if (u < 0x80)
+        {
+          c = static_cast<int>(u);
+        }
+        else if (u < 0x800)
+        {
+          c = 0xC0 | (u >> 6);
+          utf8[utf8Len++] = static_cast<char>(0x80 | (u & 0x3F));
+        }
+        else
+        {
+          c = 0xE0 | (u >> 12);
+          utf8[utf8Len++] = static_cast<char>(0x80 | ((u >> 6) & 0x3F));
+          utf8[utf8Len++] = static_cast<char>(0x80 | (u & 0x3F));
+        }
+        break;
+      }
+      default:
+        return fail(c < 0 ? DeserializationError::IncompleteInput
+                          : DeserializationError::InvalidInput);
+      }
+    }
+    for (int i = -1; i < utf8Len; ++i)
+    {
+      char ch = (i < 0) ? static_cast<char>(c) : utf8[i];
+      if (buf && n < size - 1)
+      {
+        buf[n++] = ch;
+      }
+      if (str)
+      {
+        if (chunkLen == sizeof(chunk))
+        {
+          str->concat(chunk, chunkLen);
+          chunkLen = 0;
+        }
+        chunk[chunkLen++] = ch;
+      }
+    }
+  }
+  if (str && chunkLen)
+  {
+    str->concat(chunk, chunkLen);
+  }
+  if (buf)
+  {
+    buf[n] = '\0';
+  }
+  return true;
+} // end readStringBody
+
+bool JsonStreamReader::readString(char *buf, size_t size)
+{
+  buf[0] = '\0';
+  if (_error != DeserializationError::Ok)
+  {
+    return false;
+  }
+  if (peekToken() != '"')
+  {
+    return skipValue();
+  }
+  ++_pos;
+  return readStringBody(buf, size, nullptr);
+} // end readString
+
+bool JsonStreamReader::readString(String &value)
+{
+  value = "";
+  if (_error != DeserializationError::Ok)
+  {
+    return false;
+  }
+  if (peekToken() != '"')
+  {
+    return skipValue();
+  }
+  ++_pos;
+  return readStringBody(nullptr, 0, &value);
+} // end readString
+
+/* Consumes the next value, whatever its type.
+ */
+bool JsonStreamReader::skipValue()
+{
+  if (_error != DeserializationError::Ok)
+  {
+    return false;
+  }
+  int c = peekToken();
+  if (c == '{')
+  {
+    enter('{');
+    char key[1];
+    while (nextKey(key, sizeof(key)))
+    {
+      skipValue();
+    }
+  }
+  else if (c == '[')
+  {
+    enter('[');
+    while (nextElement())
+    {
+      skipValue();
+    }
+  }
+  else if (c == '"')
+  {
+    ++_pos;
+    readStringBody(nullptr, 0, nullptr);
+  }
+  else if (c == '-' || (c >= '0' && c <= '9'))
+  {
+    char num[2];
+    readNumberToken(num, sizeof(num));
+  }
+  else if (c == 't' || c == 'f' || c == 'n')
+  {
+    const char *literal = (c == 't') ? "true" : (c == 'f') ? "false" : "null";
+    for (const char *p = literal; *p; ++p)
+    {
+      int l = get();
+      if (l != *p)
+      {
+        return fail(l < 0 ? DeserializationError::IncompleteInput
+                          : DeserializationError::InvalidInput);
+      }
+    }
+  }
+  else
+  {
+    return fail(c < 0 ? DeserializationError::IncompleteInput
+                      : DeserializationError::InvalidInput);
+  }
+  return _error == DeserializationError::Ok;
+} // end skipValue
+
+/* Skips the remaining members of the current object or array, including the
+ * closing character.
+ */
+void JsonStreamReader::skipRest()
+{
+  if (_depth == 0)
+  {
+    return;
+  }
+  if (_object & (1UL << _depth))
+  {
+    char key[1];
+    while (nextKey(key, sizeof(key)))
+    {
+      skipValue();
+    }
+  }
+  else
+  {
+    while (nextElement())
+    {
+      skipValue();
+    }
+  }
+} // end skipRest
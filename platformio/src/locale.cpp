@@ -22,3 +22,20 @@
 #define LOCALE_INC(code) X_LOCALE_INC(code)
 
 #include LOCALE_INC(LOCALE)
+
+// keyword lists in the order of enum alert_category
+static constexpr const char *const *ALERT_CATEGORY_TERMS[] = {
+  TERM_SMOG, TERM_SMOKE, TERM_FOG, TERM_METEOR, TERM_NUCLEAR, TERM_BIOHAZARD,
+  TERM_EARTHQUAKE, TERM_FIRE, TERM_HEAT, TERM_WINTER, TERM_TSUNAMI,
+  TERM_LIGHTNING, TERM_SANDSTORM, TERM_FLOOD, TERM_VOLCANO, TERM_AIR_QUALITY,
+  TERM_TORNADO, TERM_SMALL_CRAFT_ADVISORY, TERM_GALE_WARNING,
+  TERM_STORM_WARNING, TERM_HURRICANE_WARNING, TERM_HURRICANE, TERM_DUST,
+  TERM_STRONG_WIND};
+static constexpr size_t ALERT_CATEGORIES =
+  sizeof(ALERT_CATEGORY_TERMS) / sizeof(ALERT_CATEGORY_TERMS[0]);
+
+static constexpr auto ALERT_AUTOMATON_STATES =
+  buildAlertAutomaton<alertAutomatonSize(ALERT_CATEGORY_TERMS,
+                                         ALERT_CATEGORIES, ALERT_URGENCY)>(
+    ALERT_CATEGORY_TERMS, ALERT_CATEGORIES, ALERT_URGENCY);
+const alert_node_t *const ALERT_AUTOMATON = ALERT_AUTOMATON_STATES.node;
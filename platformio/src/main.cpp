@@ -28,8 +28,11 @@
 #include "client_utils.h"
 #include "config.h"
 #include "display_utils.h"
+#include "fetch_scheduler.h"
+#include "http_cache.h"
 #include "icons/icons_196x196.h"
 #include "renderer.h"
+#include "snapshot.h"
 #if defined(USE_HTTPS_WITH_CERT_VERIF) || defined(USE_HTTPS_WITH_CERT_VERIF)
   #include <WiFiClientSecure.h>
 #endif
@@ -40,11 +43,76 @@
 // too large to allocate locally on stack
 static owm_resp_onecall_t       owm_onecall;
 static owm_resp_air_pollution_t owm_air_pollution;
-static usgs_feature_t           usgs_earthquake;
-static usgs_feature_t           usgs_earthquake_recent;
+static usgs_earth_resp_t        usgs_earthquake;
+static usgs_earth_resp_t        usgs_earthquake_recent;
 
 Preferences prefs;
 
+#ifdef USE_HTTPS_WITH_CERT_VERIF
+  #define OWM_CA_CERT  cert_Sectigo_RSA_Organization_Validation_Secure_Server_CA
+  #define USGS_CA_CERT cert_USGS
+#else
+  #define OWM_CA_CERT  nullptr
+  #define USGS_CA_CERT nullptr
+#endif
+
+/* Every request takes its own connection from the pool, so that fetchAll()
+ * can run them at the same time, and gives it back for the next request to
+ * the same host.
+ */
+static int fetchOneCall(void *resp)
+{
+  http_connection_t *conn = acquireConnection(OWM_ENDPOINT, OWM_CA_CERT);
+  if (!conn)
+  {
+    return HTTPC_ERROR_NOT_CONNECTED;
+  }
+  int status = getOWMonecall(*conn, *static_cast<owm_resp_onecall_t *>(resp));
+  releaseConnection(conn);
+  return status;
+} // end fetchOneCall
+
+static int fetchAirPollution(void *resp)
+{
+  http_connection_t *conn = acquireConnection(OWM_ENDPOINT, OWM_CA_CERT);
+  if (!conn)
+  {
+    return HTTPC_ERROR_NOT_CONNECTED;
+  }
+  int status = getOWMairpollution(*conn,
+                          *static_cast<owm_resp_air_pollution_t *>(resp));
+  releaseConnection(conn);
+  return status;
+} // end fetchAirPollution
+
+static int fetchUSGSSignificant(void *resp)
+{
+  http_connection_t *conn = acquireConnection(USGS_ENDPOINT, USGS_CA_CERT);
+  if (!conn)
+  {
+    return HTTPC_ERROR_NOT_CONNECTED;
+  }
+  int status = getUSGSEarthquake(*conn,
+                                 *static_cast<usgs_earth_resp_t *>(resp),
+    "/earthquakes/feed/v1.0/summary/significant_week.geojson");
+  releaseConnection(conn);
+  return status;
+} // end fetchUSGSSignificant
+
+static int fetchUSGSRecent(void *resp)
+{
+  http_connection_t *conn = acquireConnection(USGS_ENDPOINT, USGS_CA_CERT);
+  if (!conn)
+  {
+    return HTTPC_ERROR_NOT_CONNECTED;
+  }
+  int status = getUSGSEarthquake(*conn,
+                                 *static_cast<usgs_earth_resp_t *>(resp),
+    "/earthquakes/feed/v1.0/summary/1.0_hour.geojson");
+  releaseConnection(conn);
+  return status;
+} // end fetchUSGSRecent
+
 /* Put esp32 into ultra low-power deep sleep (<11μA).
  * Aligns wake time to the minute. Sleep times defined in config.cpp.
  */
@@ -245,66 +313,66 @@ void setup()
   }
 
   // MAKE API REQUESTS
-#ifdef USE_HTTP
-  WiFiClient client;
-#elif defined(USE_HTTPS_NO_CERT_VERIF)
-  WiFiClientSecure client;
-  client.setInsecure();
-#elif defined(USE_HTTPS_WITH_CERT_VERIF)
-  WiFiClientSecure client;
-  client.setCACert(cert_Sectigo_RSA_Organization_Validation_Secure_Server_CA);
+  // The hosts alternate, so that running requests go to different hosts and
+  // each one leaves its connection open for the next request to its host.
+  fetch_job_t jobs[] = {
+    {"One Call " + OWM_ONECALL_VERSION + " API", fetchOneCall, &owm_onecall},
+    {"USGS Earthquake API", fetchUSGSSignificant, &usgs_earthquake},
+    {"Air Pollution API",   fetchAirPollution,    &owm_air_pollution},
+    {"USGS Earthquake API", fetchUSGSRecent,      &usgs_earthquake_recent},
+  };
+  const int numJobs = sizeof(jobs) / sizeof(jobs[0]);
+  const snapshot_section_t sections[numJobs] = {
+    SNAPSHOT_ONECALL,
+    SNAPSHOT_USGS_SIGNIFICANT,
+    SNAPSHOT_AIR_POLLUTION,
+    SNAPSHOT_USGS_RECENT,
+  };
+  int failed = fetchAll(jobs, numJobs);
+#if DEBUG_LEVEL >= 1
+  httpCachePrintStats();
 #endif
-  int rxStatus = getOWMonecall(client, owm_onecall);
-  if (rxStatus != HTTP_CODE_OK)
+
+  // Keep every response that was parsed. A failed request is replaced by its
+  // last good response if there is a recent enough one.
+  int64_t now = time(nullptr);
+  int64_t staleSince = 0; // fetch time of the oldest response drawn instead
+  failed = -1;
+  for (int i = 0; i < numJobs; ++i)
   {
-    killWiFi();
-    statusStr = "One Call " + OWM_ONECALL_VERSION + " API";
-    tmpStr = String(rxStatus, DEC) + ": " + getHttpResponsePhrase(rxStatus);
-    initDisplay();
-    do
+    if (jobs[i].status == HTTP_CODE_OK)
     {
-      drawError(wi_cloud_down_196x196, statusStr, tmpStr);
-    } while (display.nextPage());
-    powerOffDisplay();
-    beginDeepSleep(startTime, &timeInfo);
-  }
-  rxStatus = getOWMairpollution(client, owm_air_pollution);
-  if (rxStatus != HTTP_CODE_OK)
-  {
-    killWiFi();
-    statusStr = "Air Pollution API";
-    tmpStr = String(rxStatus, DEC) + ": " + getHttpResponsePhrase(rxStatus);
-    initDisplay();
-    do
+      saveSnapshot(sections[i], jobs[i].resp, now);
+      continue;
+    }
+    int64_t fetched = 0;
+    if (STALE_DATA_FALLBACK
+     && loadSnapshot(sections[i], jobs[i].resp, fetched)
+     && now - fetched <= STALE_DATA_MAX_AGE)
     {
-      drawError(wi_cloud_down_196x196, statusStr, tmpStr);
-    } while (display.nextPage());
-    powerOffDisplay();
-    beginDeepSleep(startTime, &timeInfo);
-  }
-  // getUSGSEarthquake
-  client.setCACert(cert_USGS);
-  rxStatus = getUSGSEarthquake(client, usgs_earthquake,
-  "/earthquakes/feed/v1.0/summary/significant_week.geojson");
-  if(rxStatus != HTTP_CODE_OK){
-    killWiFi();
-    statusStr = "USGS Earthquake API";
-    tmpStr = String(rxStatus, DEC) + ": " + getHttpResponsePhrase(rxStatus);
-    initDisplay();
-    do
+      Serial.println(jobs[i].name + ": " + String(jobs[i].status, DEC)
+                     + ", drawing data from " + String(now - fetched)
+                     + "s ago");
+      if (sections[i] == SNAPSHOT_ONECALL)
+      {
+        advanceOneCall(owm_onecall, now);
+      }
+      if (staleSince == 0 || fetched < staleSince)
+      {
+        staleSince = fetched;
+      }
+    }
+    else if (failed < 0)
     {
-      drawError(wi_cloud_down_196x196, statusStr, tmpStr);
-    } while (display.nextPage());
-    powerOffDisplay();
-    beginDeepSleep(startTime, &timeInfo);
+      failed = i;
+    }
   }
-
-  rxStatus = getUSGSEarthquake(client, usgs_earthquake_recent, 
-    "/earthquakes/feed/v1.0/summary/1.0_hour.geojson");
-  if(rxStatus != HTTP_CODE_OK){
+  if (failed >= 0)
+  {
     killWiFi();
-    statusStr = "USGS Earthquake API";
-    tmpStr = String(rxStatus, DEC) + ": " + getHttpResponsePhrase(rxStatus);
+    statusStr = jobs[failed].name;
+    tmpStr = String(jobs[failed].status, DEC) + ": "
+             + getHttpResponsePhrase(jobs[failed].status);
     initDisplay();
     do
     {
@@ -318,10 +386,10 @@ void setup()
   Serial.println("=== Earthquake Event ===");
 
     // Properties
-    Serial.print("Magnitude: "); Serial.println(usgs_earthquake_recent.properties.mag);
-    Serial.print("Location: "); Serial.println(usgs_earthquake_recent.properties.place);
-    Serial.print("Time: "); Serial.println(usgs_earthquake_recent.properties.time);
-    Serial.print("Updated: "); Serial.println(usgs_earthquake_recent.properties.updated);
+    Serial.print("Magnitude: "); Serial.println(usgs_earthquake_recent.features[0].properties.mag);
+    Serial.print("Location: "); Serial.println(usgs_earthquake_recent.features[0].properties.place);
+    Serial.print("Time: "); Serial.println(usgs_earthquake_recent.features[0].properties.time);
+    Serial.print("Updated: "); Serial.println(usgs_earthquake_recent.features[0].properties.updated);
 
   // GET INDOOR TEMPERATURE AND HUMIDITY, start BME280...
   pinMode(PIN_BME_PWR, OUTPUT);
@@ -359,6 +427,15 @@ void setup()
   }
   digitalWrite(PIN_BME_PWR, LOW);
 
+  if (staleSince != 0)
+  { // takes the place of a BME280 error, stale data is more important
+    time_t ts = staleSince;
+    tm staleTimeInfo;
+    localtime_r(&ts, &staleTimeInfo);
+    getRefreshTimeStr(tmpStr, true, &staleTimeInfo);
+    statusStr = String(TXT_DATA_FROM) + " " + tmpStr;
+  }
+
   String refreshTimeStr;
   getRefreshTimeStr(refreshTimeStr, timeConfigured, &timeInfo);
   String dateStr;
@@ -370,8 +447,9 @@ void setup()
   {
     drawCurrentConditions(owm_onecall.current, owm_onecall.daily[0],
                           owm_air_pollution, inTemp, inHumidity);
-    drawUSGSData(usgs_earthquake, usgs_earthquake_recent);
-    drawOutlookGraph(owm_onecall.hourly, owm_onecall.daily, timeInfo);
+    drawUSGSData(usgs_earthquake.features[0],
+                 usgs_earthquake_recent.features[0]);
+    drawOutlookGraph(owm_onecall.hourly_series, owm_onecall.daily, timeInfo);
     drawForecast(owm_onecall.daily, timeInfo);
     drawLocationDate(CITY_STRING, dateStr);
 #if DISPLAY_ALERTS
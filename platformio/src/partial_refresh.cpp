@@ -0,0 +1,568 @@
+/* Partial refresh for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include <cstring>
+
+#include <Arduino.h>
+#include <esp_rom_crc.h>
+#include <LittleFS.h>
+
+#include "config.h"
+#include "partial_refresh.h"
+
+#define FRAME_MAGIC   0x4652 // "RF"
+#define FRAME_VERSION 1
+
+/*
+ * The frame on the panel is kept in flash, PackBits compressed (~17kB for the
+ * 48kB frame of the dashboard).
+ */
+typedef struct frame_header
+{
+  uint16_t magic;
+  uint8_t  version;
+  uint8_t  reserved;
+  uint16_t width;
+  uint16_t height;
+  uint16_t partials; // partial refreshes since the last full refresh
+  uint16_t reserved2;
+  uint32_t crc;      // of the uncompressed frame
+} frame_header_t;
+
+// refreshes since the last power on
+RTC_DATA_ATTR static uint32_t totalFull = 0;
+RTC_DATA_ATTR static uint32_t totalPartial = 0;
+RTC_DATA_ATTR static uint32_t totalSkipped = 0;
+RTC_DATA_ATTR static uint64_t totalPixels = 0;
+RTC_DATA_ATTR static uint64_t totalMs = 0;
+
+/* Mounts the filesystem the frame is kept in, once.
+ */
+static bool mountFrameFs()
+{
+  static bool mounted = false;
+  if (!mounted)
+  {
+    mounted = LittleFS.begin(true);
+  }
+  return mounted;
+} // end mountFrameFs
+
+/* Reads the header of the frame file. Returns false if there is no usable
+ * frame of this size.
+ */
+static bool readFrameHeader(File &file, frame_header_t &header,
+                            uint16_t width, uint16_t height)
+{
+  return file.read(reinterpret_cast<uint8_t *>(&header), sizeof(header))
+           == sizeof(header)
+      && header.magic == FRAME_MAGIC
+      && header.version == FRAME_VERSION
+      && header.width == width
+      && header.height == height;
+} // end readFrameHeader
+
+/* Returns true if the frame on the panel is kept in flash.
+ */
+bool previousFrameAvailable(uint16_t width, uint16_t height)
+{
+#if PARTIAL_REFRESH
+  if (!mountFrameFs() || !LittleFS.exists(FRAME_FILE))
+  {
+    return false;
+  }
+  File file = LittleFS.open(FRAME_FILE, FILE_READ);
+  frame_header_t header;
+  bool ok = file && readFrameHeader(file, header, width, height);
+  file.close();
+  return ok;
+#else
+  return false;
+#endif
+} // end previousFrameAvailable
+
+/* Removes the frame kept in flash, when the panel shows a frame that was not
+ * kept. The next refresh is full then.
+ */
+void forgetFrame()
+{
+#if PARTIAL_REFRESH
+  if (mountFrameFs() && LittleFS.exists(FRAME_FILE))
+  {
+    LittleFS.remove(FRAME_FILE);
+  }
+#endif
+} // end forgetFrame
+
+/* Decompresses the frame file into frame (width * height / 8 bytes).
+ * Returns false if the file is missing, truncated or corrupt.
+ */
+static bool loadFrame(uint8_t *frame, uint16_t width, uint16_t height,
+                      uint16_t &partials)
+{
+  File file = LittleFS.open(FRAME_FILE, FILE_READ);
+  frame_header_t header;
+  if (!file || !readFrameHeader(file, header, width, height))
+  {
+    file.close();
+    return false;
+  }
+
+  const size_t len = static_cast<size_t>(width) * height / 8;
+  uint8_t in[256];
+  size_t inLen = 0;
+  size_t inPos = 0;
+  size_t out = 0;
+  int run = 0;      // bytes left of the current run
+  bool repeat = false;
+  while (out < len)
+  {
+    if (inPos == inLen)
+    {
+      inLen = file.read(in, sizeof(in));
+      inPos = 0;
+      if (inLen == 0)
+      {
+        break;
+      }
+    }
+    uint8_t b = in[inPos++];
+    if (run == 0)
+    {
+      // PackBits header: n >= 0 copies n + 1 literal bytes, n < 0 repeats the
+      // next byte 1 - n times
+      int8_t n = static_cast<int8_t>(b);
+      if (n == -128)
+      {
+        continue;
+      }
+      repeat = n < 0;
+      run = repeat ? 1 - n : n + 1;
+      continue;
+    }
+    int count = repeat ? run : 1;
+    if (out + count > len)
+    {
+      break;
+    }
+    memset(frame + out, b, count);
+    out += count;
+    run -= count;
+  }
+  file.close();
+
+  partials = header.partials;
+  return out == len && run == 0
+      && esp_rom_crc32_le(0, frame, len) == header.crc;
+} // end loadFrame
+
+/* Buffered writes to the frame file.
+ */
+typedef struct frame_writer
+{
+  File    *file;
+  uint8_t  buf[256];
+  size_t   len;
+  bool     ok;
+} frame_writer_t;
+
+static void writeBytes(frame_writer_t &w, const uint8_t *data, size_t len)
+{
+  while (len > 0)
+  {
+    size_t n = min(len, sizeof(w.buf) - w.len);
+    memcpy(w.buf + w.len, data, n);
+    w.len += n;
+    data += n;
+    len -= n;
+    if (w.len == sizeof(w.buf))
+    {
+      w.ok = w.ok && w.file->write(w.buf, w.len) == w.len;
+      w.len = 0;
+    }
+  }
+} // end writeBytes
+
+/* Compresses frame into the frame file, replacing the frame kept before.
+ */
+static bool saveFrame(const uint8_t *frame, uint16_t width, uint16_t height,
+                      uint16_t partials)
+{
+  const size_t len = static_cast<size_t>(width) * height / 8;
+  frame_header_t header = {};
+  header.magic    = FRAME_MAGIC;
+  header.version  = FRAME_VERSION;
+  header.width    = width;
+  header.height   = height;
+  header.partials = partials;
+  header.crc      = esp_rom_crc32_le(0, frame, len);
+
+  File file = LittleFS.open(FRAME_FILE, FILE_WRITE);
+  if (!file)
+  {
+    return false;
+  }
+  frame_writer_t w = {};
+  w.file = &file;
+  w.ok = true;
+  writeBytes(w, reinterpret_cast<const uint8_t *>(&header), sizeof(header));
+
+  size_t i = 0;
+  while (i < len)
+  {
+    size_t rep = 1;
+    while (i + rep < len && rep < 128 && frame[i + rep] == frame[i])
+    {
+      ++rep;
+    }
+    if (rep >= 3)
+    {
+      uint8_t run[2] = {static_cast<uint8_t>(1 - static_cast<int>(rep)),
+                        frame[i]};
+      writeBytes(w, run, sizeof(run));
+      i += rep;
+      continue;
+    }
+    // literals up to the next run of 3
+    size_t lit = 0;
+    while (i + lit < len && lit < 128
+        && !(i + lit + 2 < len && frame[i + lit] == frame[i + lit + 1]
+                               && frame[i + lit] == frame[i + lit + 2]))
+    {
+      ++lit;
+    }
+    if (lit == 0)
+    {
+      lit = 1;
+    }
+    uint8_t n = static_cast<uint8_t>(lit - 1);
+    writeBytes(w, &n, 1);
+    writeBytes(w, frame + i, lit);
+    i += lit;
+  }
+  if (w.len > 0)
+  {
+    w.ok = w.ok && file.write(w.buf, w.len) == w.len;
+  }
+  file.close();
+  if (!w.ok)
+  {
+    LittleFS.remove(FRAME_FILE);
+  }
+  return w.ok;
+} // end saveFrame
+
+/* Updates the partial refresh count of the frame file, for a frame that is
+ * already kept. Rewrites the header only, not the ~17kB frame.
+ */
+static bool saveFrameHeader(uint16_t partials)
+{
+  File file = LittleFS.open(FRAME_FILE, "r+");
+  frame_header_t header;
+  if (!file || file.read(reinterpret_cast<uint8_t *>(&header),
+                         sizeof(header)) != sizeof(header))
+  {
+    file.close();
+    return false;
+  }
+  header.partials = partials;
+  bool ok = file.seek(0)
+         && file.write(reinterpret_cast<const uint8_t *>(&header),
+                       sizeof(header)) == sizeof(header);
+  file.close();
+  return ok;
+} // end saveFrameHeader
+
+/* Returns true if any pixel differs in tile (tx, ty).
+ */
+static bool tileChanged(const uint8_t *a, const uint8_t *b, uint16_t width,
+                        uint16_t height, int tx, int ty)
+{
+  const size_t stride = width / 8;
+  const size_t x0 = tx * (FRAME_TILE_WIDTH / 8);
+  const size_t x1 = min(x0 + FRAME_TILE_WIDTH / 8, stride);
+  const int y1 = min((ty + 1) * FRAME_TILE_HEIGHT, static_cast<int>(height));
+  for (int y = ty * FRAME_TILE_HEIGHT; y < y1; ++y)
+  {
+    if (memcmp(a + y * stride + x0, b + y * stride + x0, x1 - x0) != 0)
+    {
+      return true;
+    }
+  }
+  return false;
+} // end tileChanged
+
+/* Area of the smallest rect around r1 and r2.
+ */
+static int32_t unionArea(const refresh_rect_t &r1, const refresh_rect_t &r2)
+{
+  int32_t x0 = min(r1.x, r2.x);
+  int32_t y0 = min(r1.y, r2.y);
+  int32_t x1 = max(r1.x + r1.w, r2.x + r2.w);
+  int32_t y1 = max(r1.y + r1.h, r2.y + r2.h);
+  return (x1 - x0) * (y1 - y0);
+} // end unionArea
+
+/* Changed areas of frame compared to previous, as at most maxRects rects.
+ *
+ * Runs of changed tiles in a tile row become rects, which grow downward while
+ * the next row has a run with the same columns. The pair of rects whose union
+ * adds the least unchanged area is then merged until maxRects are left.
+ */
+static int findChangedRects(refresh_rect_t *rects, int maxRects,
+                            const uint8_t *previous, const uint8_t *frame,
+                            uint16_t width, uint16_t height)
+{
+  const int cols = (width + FRAME_TILE_WIDTH - 1) / FRAME_TILE_WIDTH;
+  const int rows = (height + FRAME_TILE_HEIGHT - 1) / FRAME_TILE_HEIGHT;
+  // more rects than this are merged while they are found
+  const int capacity = 32;
+  refresh_rect_t found[capacity + 1];
+  int n = 0;
+  int rowStart = 0; // first rect that may continue into this row
+
+  for (int ty = 0; ty < rows; ++ty)
+  {
+    int y = ty * FRAME_TILE_HEIGHT;
+    int h = min(FRAME_TILE_HEIGHT, height - y);
+    int nextRowStart = n;
+    int tx = 0;
+    while (tx < cols)
+    {
+      if (!tileChanged(previous, frame, width, height, tx, ty))
+      {
+        ++tx;
+        continue;
+      }
+      int start = tx;
+      while (tx < cols && tileChanged(previous, frame, width, height, tx, ty))
+      {
+        ++tx;
+      }
+      refresh_rect_t r;
+      r.x = start * FRAME_TILE_WIDTH;
+      r.y = y;
+      r.w = min(tx * FRAME_TILE_WIDTH, static_cast<int>(width)) - r.x;
+      r.h = h;
+
+      bool grown = false;
+      for (int i = rowStart; i < nextRowStart && !grown; ++i)
+      {
+        if (found[i].x == r.x && found[i].w == r.w
+         && found[i].y + found[i].h == y)
+        {
+          found[i].h += h;
+          grown = true;
+        }
+      }
+      if (!grown)
+      {
+        found[n++] = r;
+      }
+      if (n > capacity)
+      {
+        // merge the last rect into the one that grows the least
+        int best = 0;
+        for (int i = 1; i < n - 1; ++i)
+        {
+          if (unionArea(found[i], found[n - 1])
+            < unionArea(found[best], found[n - 1]))
+          {
+            best = i;
+          }
+        }
+        const refresh_rect_t &last = found[n - 1];
+        int16_t x0 = min(found[best].x, last.x);
+        int16_t y0 = min(found[best].y, last.y);
+        found[best].w = max(found[best].x + found[best].w, last.x + last.w)
+                        - x0;
+        found[best].h = max(found[best].y + found[best].h, last.y + last.h)
+                        - y0;
+        found[best].x = x0;
+        found[best].y = y0;
+        --n;
+        nextRowStart = min(nextRowStart, n);
+        rowStart = 0;
+      }
+    }
+    rowStart = nextRowStart;
+  }
+
+  while (n > maxRects)
+  {
+    int bi = 0;
+    int bj = 1;
+    int32_t bestCost = INT32_MAX;
+    for (int i = 0; i < n; ++i)
+    {
+      for (int j = i + 1; j < n; ++j)
+      {
+        int32_t cost = unionArea(found[i], found[j])
+                       - static_cast<int32_t>(found[i].w) * found[i].h
+                       - static_cast<int32_t>(found[j].w) * found[j].h;
+        if (cost < bestCost)
+        {
+          bestCost = cost;
+          bi = i;
+          bj = j;
+        }
+      }
+    }
+    int16_t x0 = min(found[bi].x, found[bj].x);
+    int16_t y0 = min(found[bi].y, found[bj].y);
+    found[bi].w = max(found[bi].x + found[bi].w, found[bj].x + found[bj].w)
+                  - x0;
+    found[bi].h = max(found[bi].y + found[bi].h, found[bj].y + found[bj].h)
+                  - y0;
+    found[bi].x = x0;
+    found[bi].y = y0;
+    found[bj] = found[--n];
+  }
+
+  memcpy(rects, found, n * sizeof(refresh_rect_t));
+  return n;
+} // end findChangedRects
+
+/* Decides how frame gets to the panel. A full refresh is done if the frame on
+ * the panel is unknown, if FULL_REFRESH_INTERVAL partial refreshes were done
+ * since the last one (partial refreshes slowly build up ghosting), if more
+ * than PARTIAL_REFRESH_MAX_AREA changed, or if the partial refreshes would
+ * take as long as a full refresh.
+ *
+ * restorable: false if the controller was initialized for a full refresh.
+ */
+void planRefresh(refresh_plan_t &plan, const uint8_t *frame,
+                 uint16_t width, uint16_t height, bool restorable,
+                 uint16_t fullRefreshMs, uint16_t partialRefreshMs)
+{
+  plan.full = true;
+  plan.num_rects = 0;
+  plan.previous = nullptr;
+  plan.partials = 0;
+#if PARTIAL_REFRESH
+  if (!restorable || !mountFrameFs())
+  {
+    return;
+  }
+  const size_t len = static_cast<size_t>(width) * height / 8;
+  plan.previous = static_cast<uint8_t *>(malloc(len));
+  if (plan.previous == nullptr)
+  {
+    return;
+  }
+  if (!loadFrame(plan.previous, width, height, plan.partials))
+  {
+    free(plan.previous);
+    plan.previous = nullptr;
+    return;
+  }
+  if (plan.partials >= FULL_REFRESH_INTERVAL)
+  {
+    return;
+  }
+
+  // each partial refresh takes about as long, regardless of its size
+  int maxRects = PARTIAL_REFRESH_MAX_RECTS;
+  if (partialRefreshMs > 0)
+  {
+    maxRects = min(maxRects, (fullRefreshMs - 1) / partialRefreshMs);
+  }
+  if (maxRects < 1)
+  {
+    return;
+  }
+  int num = findChangedRects(plan.rects, maxRects, plan.previous, frame,
+                             width, height);
+  uint32_t area = 0;
+  for (int i = 0; i < num; ++i)
+  {
+    area += static_cast<uint32_t>(plan.rects[i].w) * plan.rects[i].h;
+  }
+  if (area * 100 > static_cast<uint32_t>(width) * height
+                   * PARTIAL_REFRESH_MAX_AREA)
+  {
+    return;
+  }
+  plan.num_rects = num;
+  plan.full = false;
+#endif
+} // end planRefresh
+
+/* Keeps frame in flash once it is on the panel and frees the plan. Prints
+ * what was refreshed with DEBUG_LEVEL >= 1.
+ */
+void finishRefresh(refresh_plan_t &plan, const uint8_t *frame,
+                   uint16_t width, uint16_t height, unsigned long ms)
+{
+  uint32_t pixels = 0;
+  if (plan.full)
+  {
+    pixels = static_cast<uint32_t>(width) * height;
+    ++totalFull;
+  }
+  else if (plan.num_rects > 0)
+  {
+    for (int i = 0; i < plan.num_rects; ++i)
+    {
+      pixels += static_cast<uint32_t>(plan.rects[i].w) * plan.rects[i].h;
+    }
+    ++totalPartial;
+  }
+  else
+  {
+    ++totalSkipped;
+  }
+  totalPixels += pixels;
+  totalMs += ms;
+
+#if PARTIAL_REFRESH
+  if (plan.full || plan.num_rects > 0)
+  {
+    uint16_t partials = plan.full ? 0 : plan.partials + 1;
+    // a full refresh of the frame already kept (FULL_REFRESH_INTERVAL) only
+    // resets the count, which saves a flash write of the whole frame
+    const size_t len = static_cast<size_t>(width) * height / 8;
+    bool unchanged = plan.previous != nullptr
+                  && memcmp(plan.previous, frame, len) == 0;
+    if (!mountFrameFs()
+     || !(unchanged ? saveFrameHeader(partials)
+                    : saveFrame(frame, width, height, partials)))
+    {
+      Serial.println("Failed to save frame, next refresh will be full");
+    }
+  }
+#endif
+  free(plan.previous);
+  plan.previous = nullptr;
+
+#if DEBUG_LEVEL >= 1
+  const char *mode = plan.full ? "full"
+                   : plan.num_rects > 0 ? "partial" : "none";
+  Serial.printf("[debug] Refresh         : %s, %d areas, %lu px (%.1f%%), "
+                "%lu ms\n", mode, plan.num_rects,
+                static_cast<unsigned long>(pixels),
+                100.0 * pixels / (static_cast<uint32_t>(width) * height), ms);
+  Serial.printf("[debug] Refresh totals  : %lu full, %lu partial, %lu "
+                "skipped, %llu px, %llu ms since power on\n",
+                static_cast<unsigned long>(totalFull),
+                static_cast<unsigned long>(totalPartial),
+                static_cast<unsigned long>(totalSkipped),
+                static_cast<unsigned long long>(totalPixels),
+                static_cast<unsigned long long>(totalMs));
+#endif
+} // end finishRefresh
@@ -22,9 +22,14 @@
 #include "config.h"
 #include "conversions.h"
 #include "display_utils.h"
+#include "text_metrics.h"
 
 // fonts
-#include FONT_HEADER
+#if FONT_SUBSET || FONT_COMPRESS
+  #include "font_subset.h" // FONT_HEADER, written by scripts/font_subset.py
+#else
+  #include FONT_HEADER
+#endif
 
 // icon header files
 #include "icons/icons_16x16.h"
@@ -37,15 +42,35 @@
 #include "icons/icons_160x160.h"
 #include "icons/icons_196x196.h"
 
-#ifdef DISP_BW_V2
-  GxEPD2_BW<GxEPD2_750_T7,
+#if defined(DISP_BW_V2) && FULL_FRAME_BUFFER
+  FrameBufferEPD<PartialRefreshEPD<GxEPD2_750_T7>, FRAME_BW,
+                 GxEPD_BLACK> display(
+    PartialRefreshEPD<GxEPD2_750_T7>(PIN_EPD_CS,
+                                     PIN_EPD_DC,
+                                     PIN_EPD_RST,
+                                     PIN_EPD_BUSY));
+#elif defined(DISP_BW_V2)
+  GxEPD2_BW<PartialRefreshEPD<GxEPD2_750_T7>,
             GxEPD2_750_T7::HEIGHT> display(
-    GxEPD2_750_T7(PIN_EPD_CS,
-                  PIN_EPD_DC,
-                  PIN_EPD_RST,
-                  PIN_EPD_BUSY));
+    PartialRefreshEPD<GxEPD2_750_T7>(PIN_EPD_CS,
+                                     PIN_EPD_DC,
+                                     PIN_EPD_RST,
+                                     PIN_EPD_BUSY));
 #endif
-#ifdef DISP_3C_B
+#if defined(DISP_3C_B) && FULL_FRAME_BUFFER
+  FrameBufferEPD<GxEPD2_750c_Z08, FRAME_3C, ACCENT_COLOR> display(
+    GxEPD2_750c_Z08(PIN_EPD_CS,
+                    PIN_EPD_DC,
+                    PIN_EPD_RST,
+                    PIN_EPD_BUSY));
+#elif defined(DISP_3C_B) && DISPLAY_LIST
+  DisplayListEPD<GxEPD2_3C<GxEPD2_750c_Z08,
+                           GxEPD2_750c_Z08::HEIGHT / 2>> display(
+    GxEPD2_750c_Z08(PIN_EPD_CS,
+                    PIN_EPD_DC,
+                    PIN_EPD_RST,
+                    PIN_EPD_BUSY));
+#elif defined(DISP_3C_B)
   GxEPD2_3C<GxEPD2_750c_Z08,
             GxEPD2_750c_Z08::HEIGHT / 2> display(
     GxEPD2_750c_Z08(PIN_EPD_CS,
@@ -53,7 +78,20 @@
                     PIN_EPD_RST,
                     PIN_EPD_BUSY));
 #endif
-#ifdef DISP_7C_F
+#if defined(DISP_7C_F) && FULL_FRAME_BUFFER
+  FrameBufferEPD<GxEPD2_730c_GDEY073D46, FRAME_7C, ACCENT_COLOR> display(
+    GxEPD2_730c_GDEY073D46(PIN_EPD_CS,
+                           PIN_EPD_DC,
+                           PIN_EPD_RST,
+                           PIN_EPD_BUSY));
+#elif defined(DISP_7C_F) && DISPLAY_LIST
+  DisplayListEPD<GxEPD2_7C<GxEPD2_730c_GDEY073D46,
+                           GxEPD2_730c_GDEY073D46::HEIGHT / 4>> display(
+    GxEPD2_730c_GDEY073D46(PIN_EPD_CS,
+                           PIN_EPD_DC,
+                           PIN_EPD_RST,
+                           PIN_EPD_BUSY));
+#elif defined(DISP_7C_F)
   GxEPD2_7C<GxEPD2_730c_GDEY073D46,
             GxEPD2_730c_GDEY073D46::HEIGHT / 4> display(
     GxEPD2_730c_GDEY073D46(PIN_EPD_CS,
@@ -61,7 +99,13 @@
                            PIN_EPD_RST,
                            PIN_EPD_BUSY));
 #endif
-#ifdef DISP_BW_V1
+#if defined(DISP_BW_V1) && FULL_FRAME_BUFFER
+  FrameBufferEPD<GxEPD2_750, FRAME_BW, GxEPD_BLACK> display(
+    GxEPD2_750(PIN_EPD_CS,
+               PIN_EPD_DC,
+               PIN_EPD_RST,
+               PIN_EPD_BUSY));
+#elif defined(DISP_BW_V1)
   GxEPD2_BW<GxEPD2_750,
             GxEPD2_750::HEIGHT> display(
     GxEPD2_750(PIN_EPD_CS,
@@ -74,24 +118,49 @@
   #define ACCENT_COLOR GxEPD_BLACK
 #endif
 
+// font last passed to setFont()
+static const GFXfont *currentFont = nullptr;
+
+/* Sets the font of the display. Use this instead of display.setFont(), the
+ * text measurement needs to know the font.
+ */
+void setFont(const GFXfont *font)
+{
+  currentFont = font;
+#if FONT_COMPRESS
+  display.setCompressedFont(font);
+#else
+  display.setFont(font);
+#endif
+}
+
+/* Returns the bounds of text drawn at (0, 0) in the current font, from the
+ * text measurement cache when possible.
+ */
+static text_bounds_t measureString(const String &text)
+{
+  text_bounds_t bounds = {};
+  if (!measureText(currentFont, text.c_str(), text.length(), bounds)
+   && text.length() != 0)
+  {
+    display.getTextBounds(text, 0, 0, &bounds.x1, &bounds.y1,
+                          &bounds.w, &bounds.h);
+  }
+  return bounds;
+}
+
 /* Returns the string width in pixels
  */
 uint16_t getStringWidth(const String &text)
 {
-  int16_t x1, y1;
-  uint16_t w, h;
-  display.getTextBounds(text, 0, 0, &x1, &y1, &w, &h);
-  return w;
+  return measureString(text).w;
 }
 
 /* Returns the string height in pixels
  */
 uint16_t getStringHeight(const String &text)
 {
-  int16_t x1, y1;
-  uint16_t w, h;
-  display.getTextBounds(text, 0, 0, &x1, &y1, &w, &h);
-  return h;
+  return measureString(text).h;
 }
 
 /* Draws a string with alignment
@@ -99,10 +168,8 @@ uint16_t getStringHeight(const String &text)
 void drawString(int16_t x, int16_t y, const String &text, alignment_t alignment,
                 uint16_t color)
 {
-  int16_t x1, y1;
-  uint16_t w, h;
+  uint16_t w = measureString(text).w;
   display.setTextColor(color);
-  display.getTextBounds(text, x, y, &x1, &y1, &w, &h);
   if (alignment == RIGHT)
   {
     x = x - w;
@@ -135,10 +202,7 @@ void drawMultiLnString(int16_t x, int16_t y, const String &text,
   // print until we reach max_lines or no more text remains
   while (current_line < max_lines && !textRemaining.isEmpty())
   {
-    int16_t  x1, y1;
-    uint16_t w, h;
-
-    display.getTextBounds(textRemaining, 0, 0, &x1, &y1, &w, &h);
+    uint16_t w = measureString(textRemaining).w;
 
     int endIndex = textRemaining.length();
     // check if remaining text is to wide, if it is then print what we can
@@ -191,13 +255,13 @@ void drawMultiLnString(int16_t x, int16_t y, const String &text,
         if (current_line < max_lines - 1)
         {
           // this is not the last line
-          display.getTextBounds(subStr, 0, 0, &x1, &y1, &w, &h);
+          w = measureString(subStr).w;
         }
         else
         {
           // this is the last line, we need to make sure there is space for
           // ellipsis
-          display.getTextBounds(subStr + "...", 0, 0, &x1, &y1, &w, &h);
+          w = measureString(subStr + "...").w;
           if (w <= max_width)
           {
             // ellipsis fit, add them to subStr
@@ -290,13 +354,13 @@ void drawCurrentConditions(const owm_current_t &current,
 #endif
   // FONT_**_temperature fonts only have the character set used for displaying
   // temperature (0123456789.-\260)
-  display.setFont(&FONT_26pt8b);
+  setFont(&FONT_26pt8b);
 #ifndef DISP_BW_V1
     drawString(96 + 32, 63, dataStr, CENTER);
 #elif defined(DISP_BW_V1)
     drawString(156 + 164 / 2 - 20, 196 / 2 + 69 / 2, dataStr, CENTER);
 #endif
-  display.setFont(&FONT_14pt8b);
+  setFont(&FONT_14pt8b);
   drawString(display.getCursorX(), 96 / 2 - 69 / 2 + 30, unitStr, LEFT);
 
   // current feels like
@@ -316,7 +380,7 @@ void drawCurrentConditions(const owm_current_t &current,
                      kelvin_to_fahrenheit(current.feels_like))))
             + '\260';
 #endif
-  display.setFont(&FONT_12pt8b);
+  setFont(&FONT_12pt8b);
 #ifndef DISP_BW_V1
   //drawString(196 + 164 / 2, 98 + 69 / 2 + 12 + 17, dataStr, CENTER);
   drawString(196 + 164 / 2, 96 / 2 + 20, dataStr, CENTER);
@@ -374,7 +438,7 @@ void drawCurrentConditions(const owm_current_t &current,
 #endif
 
   // current weather data labels
-  display.setFont(&FONT_7pt8b);
+  setFont(&FONT_7pt8b);
   drawString(48, 200 + 16 + 6 + 9 + 5, "Mag", LEFT);
   drawString(48, 310 + 22 + 13 + 10, "Mag", LEFT);
 
@@ -405,7 +469,7 @@ void drawCurrentConditions(const owm_current_t &current,
 
 // sunrise (string)
 /*
-  display.setFont(&FONT_12pt8b);
+  setFont(&FONT_12pt8b);
   char timeBuffer[12] = {}; // big enough to accommodate "hh:mm:ss am"
   time_t ts = current.sunrise;
   tm *timeInfo = localtime(&ts);
@@ -453,13 +517,13 @@ void drawCurrentConditions(const owm_current_t &current,
 #else
   drawString(48     , 204 + 17 / 2 + (48 + 8) * 0 + 48 / 2, dataStr, LEFT);
 #endif
-  display.setFont(&FONT_8pt8b);
+  setFont(&FONT_8pt8b);
   drawString(display.getCursorX(), 104 + 17 / 2 + (48 + 8) * 0 + 48 / 2,
              unitStr, LEFT);
 
 #if defined(WIND_INDICATOR_NUMBER)
   dataStr = String(current.wind_deg) + "\260";
-  display.setFont(&FONT_12pt8b);
+  setFont(&FONT_12pt8b);
   drawString(display.getCursorX() + 6, 204 + 17 / 2 + (48 + 8) * 0 + 48 / 2,
              dataStr, LEFT);
 #endif
@@ -468,7 +532,7 @@ void drawCurrentConditions(const owm_current_t &current,
  || defined(WIND_INDICATOR_CPN_SECONDARY_INTERCARDINAL) \
  || defined(WIND_INDICATOR_CPN_TERTIARY_INTERCARDINAL)
   dataStr = getCompassPointNotation(current.wind_deg);
-  display.setFont(&FONT_12pt8b);
+  setFont(&FONT_12pt8b);
   drawString(display.getCursorX() + 6, 204 + 17 / 2 + (48 + 8) * 0 + 48 / 2,
              dataStr, LEFT);
 #endif
@@ -481,12 +545,12 @@ void drawCurrentConditions(const owm_current_t &current,
   
 
   // uv index
-  display.setFont(&FONT_12pt8b);
+  setFont(&FONT_12pt8b);
   unsigned int uvi = static_cast<unsigned int>(
                                 std::max(std::round(current.uvi), 0.0f));
   dataStr = String(uvi);
   drawString(48, 204 + 17 / 2 + (48 + 8) * 2 + 48 / 2, dataStr, LEFT);
-  display.setFont(&FONT_7pt8b);
+  setFont(&FONT_7pt8b);
   dataStr = String(getUVIdesc(uvi));
   int max_w = 170 - (display.getCursorX() + sp);
   if (getStringWidth(dataStr) <= max_w)
@@ -496,7 +560,7 @@ void drawCurrentConditions(const owm_current_t &current,
   }
   else
   { // use smaller font
-    display.setFont(&FONT_5pt8b);
+    setFont(&FONT_5pt8b);
     if (getStringWidth(dataStr) <= max_w)
     { // Fits on a single line with smaller font, draw along bottom
       drawString(display.getCursorX() + sp,
@@ -514,7 +578,7 @@ void drawCurrentConditions(const owm_current_t &current,
 
 #ifndef DISP_BW_V1
   // air quality index
-  display.setFont(&FONT_12pt8b);
+  setFont(&FONT_12pt8b);
   const owm_components_t &c = owm_air_pollution.components;
   // OpenWeatherMap does not provide pb (lead) conentrations, so we pass NULL.
   int aqi = calc_aqi(AQI_SCALE, c.co, c.nh3, c.no, c.no2, c.o3, NULL, c.so2,
@@ -529,7 +593,7 @@ void drawCurrentConditions(const owm_current_t &current,
     dataStr = String(aqi);
   }
   drawString(300, 108 + 17 / 2 + (48 + 8) * 0 + 48 / 2, dataStr, LEFT);
-  display.setFont(&FONT_7pt8b);
+  setFont(&FONT_7pt8b);
   dataStr = String(aqi_desc(AQI_SCALE, aqi));
   max_w = 170 - (display.getCursorX() + sp);
   if (getStringWidth(dataStr) <= max_w)
@@ -539,7 +603,7 @@ void drawCurrentConditions(const owm_current_t &current,
   }
   else
   { // use smaller font
-    display.setFont(&FONT_5pt8b);
+    setFont(&FONT_5pt8b);
     if (getStringWidth(dataStr) <= max_w)
     { // Fits on a single line with smaller font, draw along bottom
       drawString(display.getCursorX() + sp,
@@ -556,7 +620,7 @@ void drawCurrentConditions(const owm_current_t &current,
 
   // indoor temperature
   
-  display.setFont(&FONT_12pt8b);
+  setFont(&FONT_12pt8b);
   if (!std::isnan(inTemp))
   {
 #ifdef UNITS_TEMP_KELVIN
@@ -591,10 +655,10 @@ void drawCurrentConditions(const owm_current_t &current,
   */
 
   // humidity
-  display.setFont(&FONT_12pt8b);
+  setFont(&FONT_12pt8b);
   dataStr = String(current.humidity);
   drawString(135 + 48, 104 + 17 / 2 + (48 + 8) * 0 + 48 / 2, dataStr, LEFT);
-  display.setFont(&FONT_8pt8b);
+  setFont(&FONT_8pt8b);
   drawString(display.getCursorX(), 104 + 17 / 2 + (48 + 8) * 0 + 48 / 2,
              "%", LEFT);
 
@@ -643,9 +707,9 @@ void drawCurrentConditions(const owm_current_t &current,
                    ) / 1e2f, 2);
   unitStr = String(" ") + TXT_UNITS_PRES_POUNDSPERSQUAREINCH;
 #endif
-  display.setFont(&FONT_12pt8b);
+  setFont(&FONT_12pt8b);
   drawString(170 + 48, 204 + 17 / 2 + (48 + 8) * 2 + 48 / 2, dataStr, LEFT);
-  display.setFont(&FONT_8pt8b);
+  setFont(&FONT_8pt8b);
   drawString(display.getCursorX(), 204 + 17 / 2 + (48 + 8) * 2 + 48 / 2,
              unitStr, LEFT);
 */
@@ -653,7 +717,7 @@ void drawCurrentConditions(const owm_current_t &current,
 #ifndef DISP_BW_V1
   // visibility
   /*
-  display.setFont(&FONT_12pt8b);
+  setFont(&FONT_12pt8b);
 #ifdef UNITS_DIST_KILOMETERS
   float vis = meters_to_kilometers(current.visibility);
   unitStr = String(" ") + TXT_UNITS_DIST_KILOMETERS;
@@ -684,13 +748,13 @@ void drawCurrentConditions(const owm_current_t &current,
     dataStr = "> " + dataStr;
   }
   drawString(170 + 48, 204 + 17 / 2 + (48 + 8) * 3 + 48 / 2, dataStr, LEFT);
-  display.setFont(&FONT_8pt8b);
+  setFont(&FONT_8pt8b);
   drawString(display.getCursorX(), 204 + 17 / 2 + (48 + 8) * 3 + 48 / 2,
              unitStr, LEFT);
   */ 
 
   // indoor humidity
-  display.setFont(&FONT_12pt8b);
+  setFont(&FONT_12pt8b);
   if (!std::isnan(inHumidity))
   {
     dataStr = String(static_cast<int>(std::round(inHumidity)));
@@ -700,7 +764,7 @@ void drawCurrentConditions(const owm_current_t &current,
     dataStr = "--";
   }
   drawString(170 + 48, 204 + 17 / 2 + (48 + 8) * 4 + 48 / 2, dataStr, LEFT);
-  display.setFont(&FONT_8pt8b);
+  setFont(&FONT_8pt8b);
   drawString(display.getCursorX(), 204 + 17 / 2 + (48 + 8) * 4 + 48 / 2,
              "%", LEFT);
 
@@ -714,7 +778,7 @@ void drawCurrentConditions(const owm_current_t &current,
 void drawUSGSData(const usgs_feature_t &sig, const usgs_feature_t &rec){
   String dataStr;
   dataStr = "USGS Seismic Activity";
-  display.setFont(&FONT_12pt8b);
+  setFont(&FONT_12pt8b);
   drawString(0, 175, dataStr, LEFT);
 
   // earthquake important data                                                   
@@ -726,13 +790,13 @@ void drawUSGSData(const usgs_feature_t &sig, const usgs_feature_t &rec){
 
   //sub-headers / locations
   dataStr = "Nearest Significant Event: " + String(sig.properties.type);
-  display.setFont(&FONT_8pt8b);
+  setFont(&FONT_8pt8b);
   drawString(0, 197, dataStr, LEFT);
 
   dataStr = "Nearest Recent Event: " + String(rec.properties.type);
   drawString(0, 310 + 5, dataStr, LEFT);
 
-  display.setFont(&FONT_10pt8b);
+  setFont(&FONT_10pt8b);
   dataStr = String(sig.properties.place);
   drawString(0, 200 + 16 + 5, dataStr, LEFT);
 
@@ -753,7 +817,7 @@ void drawUSGSData(const usgs_feature_t &sig, const usgs_feature_t &rec){
                             wi_tsunami_48x48, 48, 48, GxEPD_BLACK);
   
   // warning / time information
-  display.setFont(&FONT_8pt8b);
+  setFont(&FONT_8pt8b);
   dataStr = getTsunamiWarning(sig);
   drawString(135 + 48, 200 + 16 + 3 + (9 + 3) + 24 + 5, dataStr, LEFT);
 
@@ -788,14 +852,14 @@ void drawForecast(const owm_daily_t *daily, tm timeInfo)
                                getDailyForecastBitmap64(daily[i]),
                                64, 64, GxEPD_BLACK);
     // day of week label
-    display.setFont(&FONT_11pt8b);
+    setFont(&FONT_11pt8b);
     char dayBuffer[8] = {};
     _strftime(dayBuffer, sizeof(dayBuffer), "%a", &timeInfo); // abbrv'd day
     drawString(x + 31 - 2, 98 + 69 / 2 - 32 - 26 - 6 + 16, dayBuffer, CENTER);
     timeInfo.tm_wday = (timeInfo.tm_wday + 1) % 7; // increment to next day
 
     // high | low
-    display.setFont(&FONT_8pt8b);
+    setFont(&FONT_8pt8b);
     drawString(x + 31, 98 + 69 / 2 + 38 - 6 + 12, "|", CENTER);
 #ifdef UNITS_TEMP_KELVIN
     hiStr = String(static_cast<int>(std::round(daily[i].temp.max)));
@@ -852,7 +916,7 @@ void drawForecast(const owm_daily_t *daily, tm timeInfo)
       if (dailyPrecip > 0.0f)
       {
 #endif
-        display.setFont(&FONT_6pt8b);
+        setFont(&FONT_6pt8b);
         drawString(x + 31, 98 + 69 / 2 + 38 - 6 + 26,
                    dataStr + unitStr, CENTER);
 #if (DISPLAY_DAILY_PRECIP == 2) // smart
@@ -878,68 +942,37 @@ void drawForecast(const owm_daily_t *daily, tm timeInfo)
   { // no alerts to draw
     return;
   }
-
-  int *ignore_list = (int *) calloc(alerts.size(), sizeof(*ignore_list));
-  int *alert_indices = (int *) calloc(alerts.size(), sizeof(*alert_indices));
-  if (!ignore_list || !alert_indices)
-  {
-    Serial.println("Error: Failed to allocate memory while handling alerts.");
-    free(ignore_list);
-    free(alert_indices);
-    return;
-  }
-
-  // Converts all event text and tags to lowercase, removes extra information,
-  // and filters out redundant alerts of lesser urgency.
-  filterAlerts(alerts, ignore_list);
+  // The alerts were selected as the response was read: lowercase, without
+  // extra information and without redundant alerts of lesser urgency. See
+  // alertSelectorOffer().
 
   // limit alert text width so that is does not run into the location or date
   // strings
-  display.setFont(&FONT_16pt8b);
+  setFont(&FONT_16pt8b);
   int city_w = getStringWidth(city);
-  display.setFont(&FONT_12pt8b);
+  setFont(&FONT_12pt8b);
   int date_w = getStringWidth(date);
   int max_w = DISP_WIDTH - 2 - std::max(city_w, date_w) - (196 + 4) - 8;
 
-  // find indices of valid alerts
-  int num_valid_alerts = 0;
-#if DEBUG_LEVEL >= 1
-  Serial.print("[debug] ignore_list      : [ ");
-#endif
-  for (int i = 0; i < alerts.size(); ++i)
-  {
-#if DEBUG_LEVEL >= 1
-    Serial.print(String(ignore_list[i]) + " ");
-#endif
-    if (!ignore_list[i])
-    {
-      alert_indices[num_valid_alerts] = i;
-      ++num_valid_alerts;
-    }
-  }
-#if DEBUG_LEVEL >= 1
-  Serial.println("]\n[debug] num_valid_alerts : " + String(num_valid_alerts));
-#endif
-
-  if (num_valid_alerts >= 1)
+  if (alerts.size() >= 1)
   { // 1 alert
     // adjust max width to for 48x48 icons
     max_w -= 48;
 
-    owm_alerts_t &cur_alert = alerts[alert_indices[0]];
+    owm_alerts_t &cur_alert = alerts[0];
     display.drawInvertedBitmap(196, 0, getAlertBitmap48(cur_alert), 48, 48,
                                ACCENT_COLOR);
     // must be called after getAlertBitmap
     toTitleCase(cur_alert.event);
 
-    display.setFont(&FONT_14pt8b);
+    setFont(&FONT_14pt8b);
     if (getStringWidth(cur_alert.event) <= max_w)
     { // Fits on a single line, draw along bottom
       drawString(196 + 48 + 4, 24 - 12 + 20 + 1, cur_alert.event, LEFT);
     }
     else
     { // use smaller font
-      display.setFont(&FONT_12pt8b);
+      setFont(&FONT_12pt8b);
       if (getStringWidth(cur_alert.event) <= max_w)
       { // Fits on a single line with smaller font, draw along bottom
         drawString(196 + 48 + 4, 24 - 12 + 17 + 1, cur_alert.event, LEFT);
@@ -957,10 +990,10 @@ void drawForecast(const owm_daily_t *daily, tm timeInfo)
     /*
     max_w -= 32;
 
-    display.setFont(&FONT_12pt8b);
+    setFont(&FONT_12pt8b);
     for (int i = 0; i < 2; ++i)
     {
-      owm_alerts_t &cur_alert = alerts[alert_indices[i]];
+      owm_alerts_t &cur_alert = alerts[i];
 
       display.drawInvertedBitmap(196, (i * 32), getAlertBitmap32(cur_alert),
                                  32, 32, ACCENT_COLOR);
@@ -973,10 +1006,6 @@ void drawForecast(const owm_daily_t *daily, tm timeInfo)
     */
   } // end 2 alerts
 
-
-  free(ignore_list);
-  free(alert_indices);
-
   return;
 } // end drawAlerts
 
@@ -986,9 +1015,9 @@ void drawForecast(const owm_daily_t *daily, tm timeInfo)
 void drawLocationDate(const String &city, const String &date)
 {
   // location, date
-  display.setFont(&FONT_16pt8b);
+  setFont(&FONT_16pt8b);
   drawString(DISP_WIDTH - 2, 23, city, RIGHT, ACCENT_COLOR);
-  display.setFont(&FONT_12pt8b);
+  setFont(&FONT_12pt8b);
   drawString(DISP_WIDTH - 2, 30 + 4 + 17, date, RIGHT);
   return;
 } // end drawLocationDate
@@ -1004,30 +1033,21 @@ inline int modulo(int a, int b)
   return result >= 0 ? result : result + b;
 }
 
-/* Convert temperature in kelvin to the display y coordinate to be plotted.
+/* Convert temperature in display units to the display y coordinate to be
+ * plotted.
  */
-int kelvin_to_plot_y(float kelvin, int tempBoundMin, float yPxPerUnit,
-                     int yBoundMin)
+int temp_to_plot_y(float temp, int tempBoundMin, float yPxPerUnit,
+                   int yBoundMin)
 {
-#ifdef UNITS_TEMP_KELVIN
   return static_cast<int>(std::round(
-    yBoundMin - (yPxPerUnit * (kelvin - tempBoundMin)) ));
-#endif
-#ifdef UNITS_TEMP_CELSIUS
-  return static_cast<int>(std::round(
-    yBoundMin - (yPxPerUnit * (kelvin_to_celsius(kelvin) - tempBoundMin)) ));
-#endif
-#ifdef UNITS_TEMP_FAHRENHEIT
-  return static_cast<int>(std::round(
-    yBoundMin - (yPxPerUnit * (kelvin_to_fahrenheit(kelvin) - tempBoundMin)) ));
-#endif
+    yBoundMin - (yPxPerUnit * (temp - tempBoundMin)) ));
 }
 
 /* This function is responsible for drawing the outlook graph for the specified
  * number of hours(up to 48).
  */
-void drawOutlookGraph(const owm_hourly_t *hourly, const owm_daily_t *daily,
-                      tm timeInfo)
+void drawOutlookGraph(const owm_hourly_series_t &hourly,
+                      const owm_daily_t *daily, tm timeInfo)
 {
   const int xPos0 = 350;
   int xPos1 = DISP_WIDTH;
@@ -1036,43 +1056,12 @@ void drawOutlookGraph(const owm_hourly_t *hourly, const owm_daily_t *daily,
 
   // calculate y max/min and intervals
   int yMajorTicks = 5;
-#ifdef UNITS_TEMP_KELVIN
-  float tempMin = hourly[0].temp;
-#endif
-#ifdef UNITS_TEMP_CELSIUS
-  float tempMin = kelvin_to_celsius(hourly[0].temp);
-#endif
-#ifdef UNITS_TEMP_FAHRENHEIT
-  float tempMin = kelvin_to_fahrenheit(hourly[0].temp);
-#endif
-  float tempMax = tempMin;
-#ifdef UNITS_HOURLY_PRECIP_POP
-  float precipMax = hourly[0].pop;
-#else
-  float precipMax = hourly[0].rain_1h + hourly[0].snow_1h;
-#endif
+  const int numHours = hourly.count;
+  const float tempMin = hourly.temp_min;
+  const float tempMax = hourly.temp_max;
+  // already in the precipitation display units
+  const float precipMax = hourly.precip_max;
   int yTempMajorTicks = 5;
-  float newTemp = 0;
-  for (int i = 1; i < HOURLY_GRAPH_MAX; ++i)
-  {
-#ifdef UNITS_TEMP_KELVIN
-    newTemp = hourly[i].temp;
-#endif
-#ifdef UNITS_TEMP_CELSIUS
-    newTemp = kelvin_to_celsius(hourly[i].temp);
-#endif
-#ifdef UNITS_TEMP_FAHRENHEIT
-    newTemp = kelvin_to_fahrenheit(hourly[i].temp);
-#endif
-    tempMin = std::min(tempMin, newTemp);
-    tempMax = std::max(tempMax, newTemp);
-#ifdef UNITS_HOURLY_PRECIP_POP
-    precipMax = std::max<float>(precipMax, hourly[i].pop);
-#else
-    precipMax = std::max<float>(
-                precipMax, hourly[i].rain_1h + hourly[i].snow_1h);
-#endif
-  }
   int tempBoundMin = static_cast<int>(tempMin - 1)
                       - modulo(static_cast<int>(tempMin - 1), yTempMajorTicks);
   int tempBoundMax = static_cast<int>(tempMax + 1)
@@ -1120,7 +1109,6 @@ void drawOutlookGraph(const owm_hourly_t *hourly, const owm_daily_t *daily,
 #endif
 #ifdef UNITS_HOURLY_PRECIP_CENTIMETERS
   xPos1 = DISP_WIDTH - 25;
-  precipMax = millimeters_to_centimeters(precipMax);
   // Round up to nearest 0.1 cm
   float precipBoundMax = std::ceil(precipMax * 10) / 10.0f;
   int yPrecipMajorTickDecimals;
@@ -1143,7 +1131,6 @@ void drawOutlookGraph(const owm_hourly_t *hourly, const owm_daily_t *daily,
 #endif
 #ifdef UNITS_HOURLY_PRECIP_INCHES
   xPos1 = DISP_WIDTH - 25;
-  precipMax = millimeters_to_inches(precipMax);
   // Round up to nearest 0.1 inch
   float precipBoundMax = std::ceil(precipMax * 10) / 10.0f;
   int yPrecipMajorTickDecimals;
@@ -1179,7 +1166,7 @@ void drawOutlookGraph(const owm_hourly_t *hourly, const owm_daily_t *daily,
   {
     String dataStr;
     int yTick = static_cast<int>(yPos0 + (i * yInterval));
-    display.setFont(&FONT_8pt8b);
+    setFont(&FONT_8pt8b);
     // Temperature
     dataStr = String(tempBoundMax - (i * yTempMajorTicks));
 #if defined(UNITS_TEMP_CELSIUS) || defined(UNITS_TEMP_FAHRENHEIT)
@@ -1211,7 +1198,7 @@ void drawOutlookGraph(const owm_hourly_t *hourly, const owm_daily_t *daily,
 #endif
 
       drawString(xPos1 + 8, yTick + 4, dataStr, LEFT);
-      display.setFont(&FONT_5pt8b);
+      setFont(&FONT_5pt8b);
       drawString(display.getCursorX(), yTick + 4, precipUnit, LEFT);
     } // end draw labels if precip is >0
 
@@ -1226,21 +1213,19 @@ void drawOutlookGraph(const owm_hourly_t *hourly, const owm_daily_t *daily,
   }
 
   int xMaxTicks = 8;
-  int hourInterval = static_cast<int>(ceil(HOURLY_GRAPH_MAX
+  int hourInterval = static_cast<int>(ceil(numHours
                                            / static_cast<float>(xMaxTicks)));
-  float xInterval = (xPos1 - xPos0 - 1) / static_cast<float>(HOURLY_GRAPH_MAX);
-  display.setFont(&FONT_8pt8b);
+  float xInterval = (xPos1 - xPos0 - 1) / static_cast<float>(numHours);
+  setFont(&FONT_8pt8b);
   
   // precalculate all x and y coordinates for temperature values
   float yPxPerUnit = (yPos1 - yPos0)
                      / static_cast<float>(tempBoundMax - tempBoundMin);
-  std::vector<int> x_t;
-  std::vector<int> y_t;
-  x_t.reserve(HOURLY_GRAPH_MAX);
-  y_t.reserve(HOURLY_GRAPH_MAX);
-    for (int i = 0; i < HOURLY_GRAPH_MAX; ++i)
+  int x_t[OWM_NUM_HOURLY];
+  int y_t[OWM_NUM_HOURLY];
+  for (int i = 0; i < numHours; ++i)
   {
-    y_t[i] = kelvin_to_plot_y(hourly[i].temp, tempBoundMin, yPxPerUnit, yPos1);
+    y_t[i] = temp_to_plot_y(hourly.temp[i], tempBoundMin, yPxPerUnit, yPos1);
     x_t[i] = static_cast<int>(std::round(xPos0 + (i * xInterval)
                                           + (0.5 * xInterval) ));
   }
@@ -1248,8 +1233,8 @@ void drawOutlookGraph(const owm_hourly_t *hourly, const owm_daily_t *daily,
 #if DISPLAY_HOURLY_ICONS
   int day_idx = 0;
 #endif
-  display.setFont(&FONT_8pt8b);
-  for (int i = 0; i < HOURLY_GRAPH_MAX; ++i)
+  setFont(&FONT_8pt8b);
+  for (int i = 0; i < numHours; ++i)
   {
     int xTick = static_cast<int>(xPos0 + (i * xInterval));
     int x0_t, x1_t, y0_t, y1_t;
@@ -1268,7 +1253,7 @@ void drawOutlookGraph(const owm_hourly_t *hourly, const owm_daily_t *daily,
 
       // draw hourly bitmap
 #if DISPLAY_HOURLY_ICONS
-      if (daily[day_idx].dt + 86400 <= hourly[i].dt) {
+      if (daily[day_idx].dt + 86400 <= hourly.dt[i]) {
         ++day_idx;
       }
       if ((i % hourInterval) == 0) // skip first and last tick
@@ -1281,7 +1266,7 @@ void drawOutlookGraph(const owm_hourly_t *hourly, const owm_daily_t *daily,
         // y = mx + b
         int span = static_cast<int>(std::round(16 / xInterval));
         int l_idx = std::max(i - 1 - span, 0);
-        int r_idx = std::min(i + span, HOURLY_GRAPH_MAX - 1);
+        int r_idx = std::min(i + span, numHours - 1);
         // left intersecting slope
         float m_l = (y_t[l_idx + 1] - y_t[l_idx]) / xInterval;
         int x_l = xTick - 16 - x_t[l_idx];
@@ -1297,7 +1282,7 @@ void drawOutlookGraph(const owm_hourly_t *hourly, const owm_daily_t *daily,
         {
           y_b = std::min(y_t[idx], y_b);
         }
-        const uint8_t *bitmap = getHourlyForecastBitmap32(hourly[i],
+        const uint8_t *bitmap = getHourlyForecastBitmap32(hourly, i,
                                                           daily[day_idx]);
         display.drawInvertedBitmap(xTick - 16, y_b - 32,
                                    bitmap, 32, 32, GxEPD_BLACK);
@@ -1305,17 +1290,7 @@ void drawOutlookGraph(const owm_hourly_t *hourly, const owm_daily_t *daily,
 #endif
     }
 
-#ifdef UNITS_HOURLY_PRECIP_POP
-    float precipVal = hourly[i].pop * 100;
-#else
-    float precipVal = hourly[i].rain_1h + hourly[i].snow_1h;
-#ifdef UNITS_HOURLY_PRECIP_CENTIMETERS
-    precipVal = millimeters_to_centimeters(precipVal);
-#endif
-#ifdef UNITS_HOURLY_PRECIP_INCHES
-    precipVal = millimeters_to_inches(precipVal);
-#endif
-#endif
+    float precipVal = hourly.precip[i];
 
     x0_t = static_cast<int>(std::round( xPos0 + 1 + (i * xInterval)));
     x1_t = static_cast<int>(std::round( xPos0 + 1 + ((i + 1) * xInterval) ));
@@ -1339,7 +1314,7 @@ void drawOutlookGraph(const owm_hourly_t *hourly, const owm_daily_t *daily,
       display.drawLine(xTick + 1, yPos1 + 1, xTick + 1, yPos1 + 4, GxEPD_BLACK);
       // draw x axis labels
       char timeBuffer[12] = {}; // big enough to accommodate "hh:mm:ss am"
-      time_t ts = hourly[i].dt;
+      time_t ts = hourly.dt[i];
       tm *timeInfo = localtime(&ts);
       _strftime(timeBuffer, sizeof(timeBuffer), HOUR_FORMAT, timeInfo);
       drawString(xTick, yPos1 + 1 + 12 + 4 + 3, timeBuffer, CENTER);
@@ -1348,16 +1323,16 @@ void drawOutlookGraph(const owm_hourly_t *hourly, const owm_daily_t *daily,
   }
 
   // draw the last tick mark
-  if ((HOURLY_GRAPH_MAX % hourInterval) == 0)
+  if ((numHours % hourInterval) == 0)
   {
     int xTick = static_cast<int>(
-                std::round(xPos0 + (HOURLY_GRAPH_MAX * xInterval)));
+                std::round(xPos0 + (numHours * xInterval)));
     // draw x tick marks
     display.drawLine(xTick    , yPos1 + 1, xTick    , yPos1 + 4, GxEPD_BLACK);
     display.drawLine(xTick + 1, yPos1 + 1, xTick + 1, yPos1 + 4, GxEPD_BLACK);
     // draw x axis labels
     char timeBuffer[12] = {}; // big enough to accommodate "hh:mm:ss am"
-    time_t ts = hourly[HOURLY_GRAPH_MAX - 1].dt + 3600;
+    time_t ts = hourly.dt[numHours - 1] + 3600;
     tm *timeInfo = localtime(&ts);
     _strftime(timeBuffer, sizeof(timeBuffer), HOUR_FORMAT, timeInfo);
     drawString(xTick, yPos1 + 1 + 12 + 4 + 3, timeBuffer, CENTER);
@@ -1374,7 +1349,7 @@ void drawStatusBar(const String &statusStr, const String &refreshTimeStr,
 {
   String dataStr;
   uint16_t dataColor = GxEPD_BLACK;
-  display.setFont(&FONT_6pt8b);
+  setFont(&FONT_6pt8b);
   int pos = DISP_WIDTH - 2;
   const int sp = 2;
 
@@ -1445,7 +1420,7 @@ void drawStatusBar(const String &statusStr, const String &refreshTimeStr,
 void drawError(const uint8_t *bitmap_196x196,
                const String &errMsgLn1, const String &errMsgLn2)
 {
-  display.setFont(&FONT_26pt8b);
+  setFont(&FONT_26pt8b);
   if (!errMsgLn2.isEmpty())
   {
     drawString(DISP_WIDTH / 2,
@@ -0,0 +1,675 @@
+/* Parsed data snapshot for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+#include <Arduino.h>
+#include <esp_rom_crc.h>
+
+#include "_locale.h"
+#include "api_response.h"
+#include "config.h"
+#include "snapshot.h"
+#include "tls_session.h"
+
+/*
+ * The snapshot is a header followed by a body of sections:
+ *
+ *   section id (1 byte), fetch time, payload length, payload
+ *
+ * All integers are LEB128 varints, signed ones zigzag encoded. Floats are
+ * quantized to fixed point (most are 1/100ths, as precise as the APIs send
+ * them). Timestamps are deltas from the previous timestamp, or from the time
+ * of the current conditions, so most of them take 2-3 bytes. Only the fields
+ * the dashboard draws are kept.
+ */
+#define SNAPSHOT_MAGIC 0x5053 // "SP"
+
+typedef struct snapshot_header
+{
+  uint16_t magic;
+  uint8_t  version;
+  uint8_t  reserved;
+  uint16_t len;     // bytes of the body
+  uint32_t crc;     // CRC-32 of the body
+} snapshot_header_t;
+
+RTC_DATA_ATTR static snapshot_header_t snapshotHeader;
+RTC_DATA_ATTR static uint8_t snapshotBody[SNAPSHOT_MAX_LEN];
+
+/*
+ * Longest encodings of each section. A varint holds 7 bits per byte, so any
+ * value below 2^34 in magnitude takes at most 5 bytes; that covers the fixed
+ * point values and the time deltas. Unix times (ms for USGS) take up to 7.
+ */
+#define SNAPSHOT_INT_LEN      5
+#define SNAPSHOT_TIME_LEN     7
+#define SNAPSHOT_WEATHER_LEN  (3 + 1 + 1) // id, icon, day
+#define SNAPSHOT_SECTION_LEN  (1 + SNAPSHOT_TIME_LEN + 2) // id, time, length
+#define SNAPSHOT_POLLUTANTS   9 // one per bit up to AQI_POLLUTANT_PM2_5
+
+#define SNAPSHOT_ONECALL_LEN                                                  \
+  (SNAPSHOT_TIME_LEN + 15 * SNAPSHOT_INT_LEN + SNAPSHOT_WEATHER_LEN           \
+   + OWM_NUM_DAILY * (14 * SNAPSHOT_INT_LEN + SNAPSHOT_WEATHER_LEN)           \
+   + 1 + OWM_NUM_HOURLY * (5 * SNAPSHOT_INT_LEN + 1 + SNAPSHOT_WEATHER_LEN)   \
+   + 3 * SNAPSHOT_INT_LEN                                                     \
+   + 1 + SNAPSHOT_NUM_ALERTS * (1 + 63 + 1 + 31 + 2 * SNAPSHOT_INT_LEN))
+#define SNAPSHOT_AIR_POLLUTION_LEN                                            \
+  (2 * SNAPSHOT_INT_LEN + SNAPSHOT_TIME_LEN                                   \
+   + (OWM_NUM_AIR_POLLUTION - 1) * SNAPSHOT_INT_LEN + OWM_NUM_AIR_POLLUTION   \
+   + 2 + SNAPSHOT_POLLUTANTS * OWM_NUM_AIR_POLLUTION * SNAPSHOT_INT_LEN)
+#define SNAPSHOT_USGS_LEN                                                     \
+  (SNAPSHOT_TIME_LEN + 1                                                      \
+   + SNAPSHOT_NUM_EVENTS * (3 * SNAPSHOT_INT_LEN + 1 + 63 + 1 + 15))
+
+static_assert(OWM_NUM_HOURLY < 128 && SNAPSHOT_NUM_ALERTS < 128
+              && SNAPSHOT_NUM_EVENTS < 128,
+              "snapshot counts must fit in a 1 byte varint");
+static_assert(SNAPSHOT_NUM_SECTIONS * SNAPSHOT_SECTION_LEN
+              + SNAPSHOT_ONECALL_LEN + SNAPSHOT_AIR_POLLUTION_LEN
+              + 2 * SNAPSHOT_USGS_LEN <= SNAPSHOT_MAX_LEN,
+              "SNAPSHOT_MAX_LEN is too small for every section");
+// the other RTC variables: counters of http_cache.cpp and partial_refresh.cpp
+static_assert(sizeof(snapshotHeader) + sizeof(snapshotBody)
+              + TLS_SESSION_RTC_LEN + 64 <= RTC_DATA_BUDGET,
+              "RTC memory is too small for the snapshot and TLS sessions");
+
+typedef struct snapshot_cursor
+{
+  uint8_t *buf;
+  size_t   size;
+  size_t   pos;
+  bool     ok;
+} snapshot_cursor_t;
+
+static void putByte(snapshot_cursor_t &c, uint8_t b)
+{
+  if (c.ok && c.pos < c.size)
+  {
+    c.buf[c.pos++] = b;
+  }
+  else
+  {
+    c.ok = false;
+  }
+} // end putByte
+
+static void putVarint(snapshot_cursor_t &c, uint64_t v)
+{
+  do
+  {
+    uint8_t b = v & 0x7f;
+    v >>= 7;
+    putByte(c, v ? b | 0x80 : b);
+  } while (v && c.ok);
+} // end putVarint
+
+static void putInt(snapshot_cursor_t &c, int64_t v)
+{
+  putVarint(c, (static_cast<uint64_t>(v) << 1)
+               ^ static_cast<uint64_t>(v >> 63));
+} // end putInt
+
+/* Writes v in units of 1/scale. NAN is kept as INT32_MIN.
+ */
+static void putFixed(snapshot_cursor_t &c, float v, float scale)
+{
+  putInt(c, std::isnan(v) ? INT32_MIN
+                          : static_cast<int64_t>(std::llround(v * scale)));
+} // end putFixed
+
+static void putString(snapshot_cursor_t &c, const String &s, size_t maxLen)
+{
+  size_t len = std::min<size_t>(s.length(), maxLen);
+  putVarint(c, len);
+  for (size_t i = 0; i < len; ++i)
+  {
+    putByte(c, s[i]);
+  }
+} // end putString
+
+static void putWeather(snapshot_cursor_t &c, const owm_weather_t &w)
+{
+  putVarint(c, w.id);
+  putByte(c, w.icon);
+  putByte(c, w.day);
+} // end putWeather
+
+static uint8_t getByte(snapshot_cursor_t &c)
+{
+  if (c.ok && c.pos < c.size)
+  {
+    return c.buf[c.pos++];
+  }
+  c.ok = false;
+  return 0;
+} // end getByte
+
+static uint64_t getVarint(snapshot_cursor_t &c)
+{
+  uint64_t v = 0;
+  for (int shift = 0; shift < 64 && c.ok; shift += 7)
+  {
+    uint8_t b = getByte(c);
+    v |= static_cast<uint64_t>(b & 0x7f) << shift;
+    if (!(b & 0x80))
+    {
+      return v;
+    }
+  }
+  c.ok = false;
+  return 0;
+} // end getVarint
+
+static int64_t getInt(snapshot_cursor_t &c)
+{
+  uint64_t v = getVarint(c);
+  return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+} // end getInt
+
+static float getFixed(snapshot_cursor_t &c, float scale)
+{
+  int64_t v = getInt(c);
+  return v == INT32_MIN ? NAN : v / scale;
+} // end getFixed
+
+static void getString(snapshot_cursor_t &c, String &s)
+{
+  size_t len = getVarint(c);
+  if (!c.ok || len > c.size - c.pos)
+  {
+    c.ok = false;
+    s = "";
+    return;
+  }
+  s = "";
+  s.concat(reinterpret_cast<const char *>(c.buf + c.pos), len);
+  c.pos += len;
+} // end getString
+
+static void getWeather(snapshot_cursor_t &c, owm_weather_t &w)
+{
+  w.id   = getVarint(c);
+  w.icon = getByte(c);
+  w.day  = getByte(c);
+} // end getWeather
+
+/* Pollutant concentrations of the air pollution history, by AQI_POLLUTANT_*
+ * bit. OpenWeatherMap does not report lead.
+ */
+static const float *pollutant(const owm_components_t &c, int bit)
+{
+  switch (bit)
+  {
+    case AQI_POLLUTANT_CO:    return c.co;
+    case AQI_POLLUTANT_NH3:   return c.nh3;
+    case AQI_POLLUTANT_NO:    return c.no;
+    case AQI_POLLUTANT_NO2:   return c.no2;
+    case AQI_POLLUTANT_O3:    return c.o3;
+    case AQI_POLLUTANT_SO2:   return c.so2;
+    case AQI_POLLUTANT_PM10:  return c.pm10;
+    case AQI_POLLUTANT_PM2_5: return c.pm2_5;
+    default:                  return nullptr;
+  }
+} // end pollutant
+
+static float *pollutant(owm_components_t &c, int bit)
+{
+  return const_cast<float *>(
+           pollutant(static_cast<const owm_components_t &>(c), bit));
+} // end pollutant
+
+static void putOneCall(snapshot_cursor_t &c, const owm_resp_onecall_t &r)
+{
+  const owm_current_t &cur = r.current;
+  putInt(c, cur.dt);
+  putInt(c, cur.sunrise - cur.dt);
+  putInt(c, cur.sunset - cur.dt);
+  putFixed(c, cur.temp, 100);
+  putFixed(c, cur.feels_like, 100);
+  putInt(c, cur.pressure);
+  putInt(c, cur.humidity);
+  putFixed(c, cur.dew_point, 100);
+  putInt(c, cur.clouds);
+  putFixed(c, cur.uvi, 100);
+  putInt(c, cur.visibility);
+  putFixed(c, cur.wind_speed, 100);
+  putFixed(c, cur.wind_gust, 100);
+  putInt(c, cur.wind_deg);
+  putFixed(c, cur.rain_1h, 100);
+  putFixed(c, cur.snow_1h, 100);
+  putWeather(c, cur.weather);
+
+  int64_t prev = cur.dt;
+  for (const owm_daily_t &d : r.daily)
+  {
+    putInt(c, d.dt - prev);
+    prev = d.dt;
+    putInt(c, d.sunrise - d.dt);
+    putInt(c, d.sunset - d.dt);
+    putInt(c, d.moonrise - d.dt);
+    putInt(c, d.moonset - d.dt);
+    putFixed(c, d.moon_phase, 100);
+    putFixed(c, d.temp.min, 100);
+    putFixed(c, d.temp.max, 100);
+    putInt(c, d.clouds);
+    putFixed(c, d.wind_speed, 100);
+    putFixed(c, d.wind_gust, 100);
+    putFixed(c, d.pop, 100);
+    putFixed(c, d.rain, 100);
+    putFixed(c, d.snow, 100);
+    putWeather(c, d.weather);
+  }
+
+  const owm_hourly_series_t &h = r.hourly_series;
+  putVarint(c, h.count);
+  prev = cur.dt;
+  for (int i = 0; i < h.count; ++i)
+  {
+    putInt(c, h.dt[i] - prev);
+    prev = h.dt[i];
+    putFixed(c, h.temp[i], 100);
+    putFixed(c, h.precip[i], 100);
+    putByte(c, h.clouds[i]);
+    putFixed(c, h.wind_speed[i], 100);
+    putFixed(c, h.wind_gust[i], 100);
+    putWeather(c, h.weather[i]);
+  }
+  putFixed(c, h.temp_min, 100);
+  putFixed(c, h.temp_max, 100);
+  putFixed(c, h.precip_max, 100);
+
+  size_t numAlerts = std::min<size_t>(r.alerts.size(), SNAPSHOT_NUM_ALERTS);
+  putVarint(c, numAlerts);
+  for (size_t i = 0; i < numAlerts; ++i)
+  {
+    const owm_alerts_t &a = r.alerts[i];
+    putString(c, a.event, 63);
+    putString(c, a.tags, 31);
+    putInt(c, a.start - cur.dt);
+    putInt(c, a.end - a.start);
+  }
+} // end putOneCall
+
+static void getOneCall(snapshot_cursor_t &c, owm_resp_onecall_t &r)
+{
+  owm_current_t &cur = r.current;
+  cur = {};
+  cur.dt         = getInt(c);
+  cur.sunrise    = cur.dt + getInt(c);
+  cur.sunset     = cur.dt + getInt(c);
+  cur.temp       = getFixed(c, 100);
+  cur.feels_like = getFixed(c, 100);
+  cur.pressure   = getInt(c);
+  cur.humidity   = getInt(c);
+  cur.dew_point  = getFixed(c, 100);
+  cur.clouds     = getInt(c);
+  cur.uvi        = getFixed(c, 100);
+  cur.visibility = getInt(c);
+  cur.wind_speed = getFixed(c, 100);
+  cur.wind_gust  = getFixed(c, 100);
+  cur.wind_deg   = getInt(c);
+  cur.rain_1h    = getFixed(c, 100);
+  cur.snow_1h    = getFixed(c, 100);
+  getWeather(c, cur.weather);
+
+  int64_t prev = cur.dt;
+  for (owm_daily_t &d : r.daily)
+  {
+    d = {};
+    d.dt         = prev + getInt(c);
+    prev = d.dt;
+    d.sunrise    = d.dt + getInt(c);
+    d.sunset     = d.dt + getInt(c);
+    d.moonrise   = d.dt + getInt(c);
+    d.moonset    = d.dt + getInt(c);
+    d.moon_phase = getFixed(c, 100);
+    d.temp.min   = getFixed(c, 100);
+    d.temp.max   = getFixed(c, 100);
+    d.clouds     = getInt(c);
+    d.wind_speed = getFixed(c, 100);
+    d.wind_gust  = getFixed(c, 100);
+    d.pop        = getFixed(c, 100);
+    d.rain       = getFixed(c, 100);
+    d.snow       = getFixed(c, 100);
+    getWeather(c, d.weather);
+  }
+
+  owm_hourly_series_t &h = r.hourly_series;
+  h.count = getVarint(c);
+  if (h.count > OWM_NUM_HOURLY)
+  {
+    c.ok = false;
+    h.count = 0;
+  }
+  prev = cur.dt;
+  for (int i = 0; i < h.count; ++i)
+  {
+    h.dt[i]         = prev + getInt(c);
+    prev = h.dt[i];
+    h.temp[i]       = getFixed(c, 100);
+    h.precip[i]     = getFixed(c, 100);
+    h.clouds[i]     = getByte(c);
+    h.wind_speed[i] = getFixed(c, 100);
+    h.wind_gust[i]  = getFixed(c, 100);
+    getWeather(c, h.weather[i]);
+  }
+  h.temp_min   = getFixed(c, 100);
+  h.temp_max   = getFixed(c, 100);
+  h.precip_max = getFixed(c, 100);
+
+  size_t numAlerts = getVarint(c);
+  r.alerts.clear();
+  for (size_t i = 0; i < numAlerts && i < SNAPSHOT_NUM_ALERTS && c.ok; ++i)
+  {
+    owm_alerts_t a = {};
+    getString(c, a.event);
+    getString(c, a.tags);
+    a.start = cur.dt + getInt(c);
+    a.end   = a.start + getInt(c);
+    r.alerts.push_back(a);
+  }
+  if (numAlerts > SNAPSHOT_NUM_ALERTS)
+  {
+    c.ok = false;
+  }
+} // end getOneCall
+
+static void putAirPollution(snapshot_cursor_t &c,
+                            const owm_resp_air_pollution_t &r)
+{
+  putFixed(c, r.coord.lat, 10000);
+  putFixed(c, r.coord.lon, 10000);
+  int64_t prev = 0;
+  for (int i = 0; i < OWM_NUM_AIR_POLLUTION; ++i)
+  {
+    putInt(c, r.dt[i] - prev);
+    prev = r.dt[i];
+    putByte(c, r.main_aqi[i]);
+  }
+  // only the pollutants the parser kept, see deserializeAirQuality()
+  const int mask = aqi_scale_pollutants(AQI_SCALE);
+  putVarint(c, mask);
+  for (int bit = 1; bit <= mask; bit <<= 1)
+  {
+    const float *conc = (mask & bit) ? pollutant(r.components, bit) : nullptr;
+    for (int i = 0; conc && i < OWM_NUM_AIR_POLLUTION; ++i)
+    {
+      putFixed(c, conc[i], 100);
+    }
+  }
+} // end putAirPollution
+
+static void getAirPollution(snapshot_cursor_t &c,
+                            owm_resp_air_pollution_t &r)
+{
+  r.coord.lat = getFixed(c, 10000);
+  r.coord.lon = getFixed(c, 10000);
+  int64_t prev = 0;
+  for (int i = 0; i < OWM_NUM_AIR_POLLUTION; ++i)
+  {
+    r.dt[i] = prev + getInt(c);
+    prev = r.dt[i];
+    r.main_aqi[i] = getByte(c);
+  }
+  const int mask = getVarint(c);
+  if (mask != aqi_scale_pollutants(AQI_SCALE))
+  { // kept for another AQI_SCALE
+    c.ok = false;
+    return;
+  }
+  r.components = {};
+  for (int bit = 1; bit <= mask; bit <<= 1)
+  {
+    float *conc = (mask & bit) ? pollutant(r.components, bit) : nullptr;
+    for (int i = 0; conc && i < OWM_NUM_AIR_POLLUTION; ++i)
+    {
+      conc[i] = getFixed(c, 100);
+    }
+  }
+} // end getAirPollution
+
+static void putUSGS(snapshot_cursor_t &c, const usgs_earth_resp_t &r)
+{
+  putInt(c, r.metadata.generated);
+  int n = std::min(std::max(r.num_features, 0), SNAPSHOT_NUM_EVENTS);
+  putVarint(c, n);
+  for (int i = 0; i < n; ++i)
+  {
+    const usgs_feature_t &f = r.features[i];
+    putFixed(c, f.properties.mag, 100);
+    putString(c, f.properties.place, 63);
+    putInt(c, f.properties.time - r.metadata.generated);
+    putString(c, f.properties.type, 15);
+    putFixed(c, f.distance, 10);
+  }
+} // end putUSGS
+
+static void getUSGS(snapshot_cursor_t &c, usgs_earth_resp_t &r)
+{
+  r.metadata = {};
+  r.metadata.generated = getInt(c);
+  r.bbox = {};
+  r.num_features = getVarint(c);
+  if (r.num_features > SNAPSHOT_NUM_EVENTS)
+  {
+    c.ok = false;
+    r.num_features = 0;
+  }
+  for (int i = 0; i < USGS_NUM_SIG_EVENTS; ++i)
+  {
+    usgs_feature_t &f = r.features[i];
+    f = {};
+    if (i >= r.num_features)
+    {
+      continue;
+    }
+    f.properties.mag  = getFixed(c, 100);
+    getString(c, f.properties.place);
+    f.properties.time = r.metadata.generated + getInt(c);
+    getString(c, f.properties.type);
+    f.distance        = getFixed(c, 10);
+  }
+} // end getUSGS
+
+static bool snapshotValid()
+{
+  return snapshotHeader.magic == SNAPSHOT_MAGIC
+      && snapshotHeader.version == SNAPSHOT_VERSION
+      && snapshotHeader.len <= SNAPSHOT_MAX_LEN
+      && snapshotHeader.crc == esp_rom_crc32_le(0, snapshotBody,
+                                                snapshotHeader.len);
+} // end snapshotValid
+
+/* Replaces one section of the snapshot in RTC memory with resp, a response
+ * parsed at the Unix time fetched. The other sections are kept as they are.
+ *
+ * Returns false if the snapshot would not fit, the old one is kept then.
+ */
+bool saveSnapshot(snapshot_section_t section, const void *resp,
+                  int64_t fetched)
+{
+  std::vector<uint8_t> payload(SNAPSHOT_MAX_LEN);
+  snapshot_cursor_t p = {payload.data(), payload.size(), 0, true};
+  switch (section)
+  {
+    case SNAPSHOT_ONECALL:
+      putOneCall(p, *static_cast<const owm_resp_onecall_t *>(resp));
+      break;
+    case SNAPSHOT_AIR_POLLUTION:
+      putAirPollution(p, *static_cast<const owm_resp_air_pollution_t *>(resp));
+      break;
+    case SNAPSHOT_USGS_SIGNIFICANT:
+    case SNAPSHOT_USGS_RECENT:
+      putUSGS(p, *static_cast<const usgs_earth_resp_t *>(resp));
+      break;
+    default:
+      return false;
+  }
+
+  std::vector<uint8_t> body(SNAPSHOT_MAX_LEN);
+  snapshot_cursor_t w = {body.data(), body.size(), 0, true};
+  if (snapshotValid())
+  { // copy the other sections
+    snapshot_cursor_t r = {snapshotBody, snapshotHeader.len, 0, true};
+    while (r.ok && r.pos < r.size)
+    {
+      uint8_t id = getByte(r);
+      int64_t time = getInt(r);
+      size_t len = getVarint(r);
+      if (!r.ok || len > r.size - r.pos)
+      {
+        break;
+      }
+      if (id != section)
+      {
+        putByte(w, id);
+        putInt(w, time);
+        putVarint(w, len);
+        for (size_t i = 0; i < len; ++i)
+        {
+          putByte(w, r.buf[r.pos + i]);
+        }
+      }
+      r.pos += len;
+    }
+  }
+  putByte(w, section);
+  putInt(w, fetched);
+  putVarint(w, p.pos);
+  for (size_t i = 0; i < p.pos; ++i)
+  {
+    putByte(w, payload[i]);
+  }
+  if (!p.ok || !w.ok)
+  { // only for values outside the ranges assumed by SNAPSHOT_MAX_LEN
+    Serial.println("Snapshot too large, not saved");
+    return false;
+  }
+
+  memcpy(snapshotBody, body.data(), w.pos);
+  snapshotHeader.magic    = SNAPSHOT_MAGIC;
+  snapshotHeader.version  = SNAPSHOT_VERSION;
+  snapshotHeader.reserved = 0;
+  snapshotHeader.len      = w.pos;
+  snapshotHeader.crc      = esp_rom_crc32_le(0, snapshotBody, w.pos);
+#if DEBUG_LEVEL >= 1
+  Serial.println("[debug] snapshot        : " + String(w.pos) + "/"
+                 + String(SNAPSHOT_MAX_LEN) + " bytes");
+#endif
+  return true;
+} // end saveSnapshot
+
+/* Loads one section of the snapshot into resp, and the Unix time it was
+ * fetched at into fetched.
+ *
+ * Returns false if there is no valid snapshot of the section.
+ */
+bool loadSnapshot(snapshot_section_t section, void *resp, int64_t &fetched)
+{
+  if (!snapshotValid())
+  {
+    return false;
+  }
+  snapshot_cursor_t r = {snapshotBody, snapshotHeader.len, 0, true};
+  while (r.ok && r.pos < r.size)
+  {
+    uint8_t id = getByte(r);
+    int64_t time = getInt(r);
+    size_t len = getVarint(r);
+    if (!r.ok || len > r.size - r.pos)
+    {
+      return false;
+    }
+    if (id != section)
+    {
+      r.pos += len;
+      continue;
+    }
+
+    snapshot_cursor_t p = {snapshotBody + r.pos, len, 0, true};
+    switch (section)
+    {
+      case SNAPSHOT_ONECALL:
+        getOneCall(p, *static_cast<owm_resp_onecall_t *>(resp));
+        break;
+      case SNAPSHOT_AIR_POLLUTION:
+        getAirPollution(p, *static_cast<owm_resp_air_pollution_t *>(resp));
+        break;
+      case SNAPSHOT_USGS_SIGNIFICANT:
+      case SNAPSHOT_USGS_RECENT:
+        getUSGS(p, *static_cast<usgs_earth_resp_t *>(resp));
+        break;
+      default:
+        return false;
+    }
+    fetched = time;
+    return p.ok && p.pos == len;
+  }
+  return false;
+} // end loadSnapshot
+
+/* Drops the hours and days of a One Call response that are already over at
+ * the Unix time now, so that the graph and forecast of an older response
+ * start at the current hour and day. The last day is repeated at the end.
+ */
+void advanceOneCall(owm_resp_onecall_t &r, int64_t now)
+{
+  owm_hourly_series_t &h = r.hourly_series;
+  int past = 0;
+  while (past < h.count - 1 && h.dt[past] + 3600 <= now)
+  {
+    ++past;
+  }
+  if (past > 0)
+  {
+    h.count -= past;
+    memmove(h.dt, h.dt + past, h.count * sizeof(h.dt[0]));
+    memmove(h.temp, h.temp + past, h.count * sizeof(h.temp[0]));
+    memmove(h.precip, h.precip + past, h.count * sizeof(h.precip[0]));
+    memmove(h.clouds, h.clouds + past, h.count * sizeof(h.clouds[0]));
+    memmove(h.wind_speed, h.wind_speed + past,
+            h.count * sizeof(h.wind_speed[0]));
+    memmove(h.wind_gust, h.wind_gust + past,
+            h.count * sizeof(h.wind_gust[0]));
+    memmove(h.weather, h.weather + past, h.count * sizeof(h.weather[0]));
+  }
+
+  time_t t = now;
+  tm today;
+  localtime_r(&t, &today);
+  past = 0;
+  while (past < OWM_NUM_DAILY - 1)
+  {
+    t = r.daily[past].dt;
+    tm day;
+    localtime_r(&t, &day);
+    if (day.tm_year > today.tm_year
+     || (day.tm_year == today.tm_year && day.tm_yday >= today.tm_yday))
+    {
+      break;
+    }
+    ++past;
+  }
+  for (int i = 0; i < OWM_NUM_DAILY; ++i)
+  {
+    r.daily[i] = r.daily[std::min(i + past, OWM_NUM_DAILY - 1)];
+  }
+} // end advanceOneCall
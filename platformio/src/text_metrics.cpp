@@ -0,0 +1,192 @@
+/* Text measurement for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "text_metrics.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <Arduino.h>
+
+typedef struct font_table
+{
+  const GFXfont   *font;
+  uint16_t         first;
+  uint16_t         last;
+  uint8_t          y_advance;
+  uint32_t         used;   // fontClock when last used
+  glyph_metrics_t *glyphs; // first..last
+} font_table_t;
+
+typedef struct measured_text
+{
+  const GFXfont *font;  // nullptr if the entry is empty
+  uint32_t       hash;
+  size_t         len;
+  text_bounds_t  bounds;
+  char           text[TEXT_METRICS_TEXT_LEN]; // len bytes, not terminated
+} measured_text_t;
+
+static font_table_t    fontTables[TEXT_METRICS_FONTS];
+static uint32_t        fontClock = 0;
+static measured_text_t measuredTexts[TEXT_METRICS_STRINGS];
+
+/* Returns the glyph table of font, built from flash the first time the font
+ * is measured. Returns nullptr if there is no memory for it.
+ */
+static const font_table_t *fontTable(const GFXfont *font)
+{
+  font_table_t *lru = &fontTables[0];
+  for (font_table_t &t : fontTables)
+  {
+    if (t.font == font)
+    {
+      t.used = ++fontClock;
+      return &t;
+    }
+    if (t.used < lru->used)
+    {
+      lru = &t;
+    }
+  }
+
+  uint16_t first = pgm_read_word(&font->first);
+  uint16_t last = pgm_read_word(&font->last);
+  size_t count = last >= first ? last - first + 1 : 0;
+  glyph_metrics_t *glyphs = static_cast<glyph_metrics_t *>(
+    realloc(lru->glyphs, count * sizeof(glyph_metrics_t)));
+  if (!glyphs)
+  {
+    free(lru->glyphs);
+    *lru = {};
+    return nullptr;
+  }
+  const GFXglyph *glyph = font->glyph;
+  for (size_t i = 0; i < count; ++i)
+  {
+    glyphs[i].left = pgm_read_byte(&glyph[i].xOffset);
+    glyphs[i].top = pgm_read_byte(&glyph[i].yOffset);
+    glyphs[i].width = pgm_read_byte(&glyph[i].width);
+    glyphs[i].height = pgm_read_byte(&glyph[i].height);
+    glyphs[i].advance = pgm_read_byte(&glyph[i].xAdvance);
+  }
+  *lru = {font, first, last, pgm_read_byte(&font->yAdvance), ++fontClock,
+          glyphs};
+  return lru;
+} // end fontTable
+
+/* FNV-1a of the font and the text.
+ */
+static uint32_t textHash(const GFXfont *font, const char *text, size_t len)
+{
+  uint32_t h = 2166136261u;
+  uintptr_t f = reinterpret_cast<uintptr_t>(font);
+  for (size_t i = 0; i < sizeof(f); ++i)
+  {
+    h = (h ^ ((f >> (8 * i)) & 0xFF)) * 16777619u;
+  }
+  for (size_t i = 0; i < len; ++i)
+  {
+    h = (h ^ static_cast<uint8_t>(text[i])) * 16777619u;
+  }
+  return h;
+} // end textHash
+
+/* Same walk as Adafruit_GFX::getTextBounds() from (0, 0), with text size 1
+ * and without wrapping, but reading the glyph table.
+ */
+static void measureGlyphs(const font_table_t &t, const char *text, size_t len,
+                          text_bounds_t &bounds)
+{
+  int16_t x = 0, y = 0;
+  int16_t minx = 0x7FFF, miny = 0x7FFF, maxx = -1, maxy = -1;
+  for (size_t i = 0; i < len; ++i)
+  {
+    uint8_t c = static_cast<uint8_t>(text[i]);
+    if (c == '\n')
+    {
+      x = 0;
+      y += t.y_advance;
+    }
+    else if (c != '\r' && c >= t.first && c <= t.last)
+    {
+      const glyph_metrics_t &g = t.glyphs[c - t.first];
+      int16_t x1 = x + g.left;
+      int16_t y1 = y + g.top;
+      minx = std::min<int16_t>(minx, x1);
+      miny = std::min<int16_t>(miny, y1);
+      maxx = std::max<int16_t>(maxx, x1 + g.width - 1);
+      maxy = std::max<int16_t>(maxy, y1 + g.height - 1);
+      x += g.advance;
+    }
+  }
+  bounds = {};
+  if (maxx >= minx)
+  {
+    bounds.x1 = minx;
+    bounds.w = maxx - minx + 1;
+  }
+  if (maxy >= miny)
+  {
+    bounds.y1 = miny;
+    bounds.h = maxy - miny + 1;
+  }
+} // end measureGlyphs
+
+/* Measures len characters of text in font, with the cursor at (0, 0).
+ *
+ * Each font's glyph metrics are copied to a table in RAM once, and the
+ * bounds of recently measured strings (up to TEXT_METRICS_TEXT_LEN long) are
+ * kept, so aligning a string and then asking for its width again costs one
+ * hash and one compare of the string.
+ *
+ * Returns false if the text can not be measured here (no font, or no memory
+ * for the font's table), Adafruit_GFX::getTextBounds() has to be used then.
+ * Text size 1 and no text wrapping are assumed, as set by initDisplay().
+ */
+bool measureText(const GFXfont *font, const char *text, size_t len,
+                 text_bounds_t &bounds)
+{
+  if (!font)
+  {
+    return false;
+  }
+  uint32_t hash = textHash(font, text, len);
+  measured_text_t &m = measuredTexts[hash % TEXT_METRICS_STRINGS];
+  if (m.font == font && m.hash == hash && m.len == len
+   && memcmp(m.text, text, len) == 0)
+  {
+    bounds = m.bounds;
+    return true;
+  }
+
+  const font_table_t *t = fontTable(font);
+  if (!t)
+  {
+    return false;
+  }
+  measureGlyphs(*t, text, len, bounds);
+  if (len <= TEXT_METRICS_TEXT_LEN)
+  {
+    m.font = font;
+    m.hash = hash;
+    m.len = len;
+    m.bounds = bounds;
+    memcpy(m.text, text, len);
+  }
+  return true;
+} // end measureText
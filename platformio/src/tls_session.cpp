@@ -0,0 +1,224 @@
+/* TLS session resumption for esp32-weather-epd.
+ * Copyright (C) 2022-2025  Luke Marzen
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <ctime>
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <mbedtls/ssl.h>
+
+#include "config.h"
+#include "tls_session.h"
+
+#if TLS_SESSION_RESUMPTION
+RTC_DATA_ATTR static tls_session_entry_t tlsSessions[TLS_SESSION_NUM_HOSTS];
+
+/* Requests to different hosts may run at the same time, see fetchAll().
+ */
+static SemaphoreHandle_t sessionLock()
+{
+  static SemaphoreHandle_t lock = xSemaphoreCreateMutex();
+  return lock;
+} // end sessionLock
+
+static tls_session_entry_t *findSession(const String &host)
+{
+  for (tls_session_entry_t &e : tlsSessions)
+  {
+    if (e.len > 0 && strncmp(e.host, host.c_str(), sizeof(e.host)) == 0)
+    {
+      return &e;
+    }
+  }
+  return nullptr;
+} // end findSession
+
+/* Loads the stored session of host into session.
+ *
+ * Returns false if there is none, or if it expired. Without a synchronized
+ * clock the age of a session is unknown and it is not used either.
+ */
+static bool loadSession(const String &host, mbedtls_ssl_session &session)
+{
+  bool loaded = false;
+  int64_t now = time(nullptr);
+  xSemaphoreTake(sessionLock(), portMAX_DELAY);
+  tls_session_entry_t *e = findSession(host);
+  if (e && e->len <= TLS_SESSION_MAX_LEN
+   && now >= e->saved && now - e->saved < e->lifetime)
+  {
+    loaded = mbedtls_ssl_session_load(&session, e->data, e->len) == 0;
+  }
+  if (e && !loaded)
+  {
+    e->len = 0;
+  }
+  xSemaphoreGive(sessionLock());
+  return loaded;
+} // end loadSession
+
+/* Stores session as the session of host, replacing the oldest entry if every
+ * entry is taken by other hosts.
+ *
+ * The server certificate is left out, resuming does not verify it again and
+ * it would not fit in the entry. A session that still does not fit is
+ * reported and not kept.
+ */
+static void saveSession(const String &host, const mbedtls_ssl_session &session,
+                        int64_t handshakeTime)
+{
+  uint32_t lifetime = TLS_SESSION_MAX_AGE;
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+  if (session.ticket_lifetime > 0 && session.ticket_lifetime < lifetime)
+  { // the server's hint for how long it will accept the ticket
+    lifetime = session.ticket_lifetime;
+  }
+#endif
+
+  xSemaphoreTake(sessionLock(), portMAX_DELAY);
+  tls_session_entry_t *e = findSession(host);
+  if (!e)
+  {
+    e = &tlsSessions[0];
+    for (tls_session_entry_t &candidate : tlsSessions)
+    {
+      if (candidate.len == 0 || candidate.saved < e->saved)
+      {
+        e = &candidate;
+        if (candidate.len == 0)
+        {
+          break;
+        }
+      }
+    }
+  }
+  // shares the pointers of session, only read by mbedtls_ssl_session_save()
+  mbedtls_ssl_session saved = session;
+#if defined(MBEDTLS_X509_CRT_PARSE_C) \
+ && defined(MBEDTLS_SSL_KEEP_PEER_CERTIFICATE)
+  saved.peer_cert = NULL;
+#endif
+  size_t len = 0;
+  int err = mbedtls_ssl_session_save(&saved, e->data, sizeof(e->data), &len);
+  if (err == 0)
+  {
+    snprintf(e->host, sizeof(e->host), "%s", host.c_str());
+    e->saved = handshakeTime;
+    e->lifetime = lifetime;
+    e->len = static_cast<uint16_t>(len);
+  }
+  else
+  { // too large for the entry, keep nothing rather than a stale session
+    e->len = 0;
+  }
+  xSemaphoreGive(sessionLock());
+  if (err != 0)
+  {
+    Serial.printf("  TLS %s session not saved: -0x%04x, %u B\n", host.c_str(),
+                  static_cast<unsigned>(-err), static_cast<unsigned>(len));
+  }
+} // end saveSession
+
+static void forgetSession(const String &host)
+{
+  xSemaphoreTake(sessionLock(), portMAX_DELAY);
+  tls_session_entry_t *e = findSession(host);
+  if (e)
+  {
+    e->len = 0;
+  }
+  xSemaphoreGive(sessionLock());
+} // end forgetSession
+#endif
+
+/* Opens a TLS connection to host. If a session of this host was kept from an
+ * earlier connection, possibly before deep sleep, it is offered to the server
+ * for an abbreviated handshake without the key exchange. The server may
+ * decline and do a full handshake instead. If the handshake fails with an
+ * offered session, it is forgotten and a full handshake is tried once.
+ *
+ * With DEBUG_LEVEL >= 1 the duration of each handshake is logged.
+ *
+ * Returns true if the connection is established, the caller's HTTPClient
+ * then reuses it.
+ */
+bool tlsConnect(ResumableClientSecure &client, const String &host,
+                uint16_t port)
+{
+  mbedtls_ssl_context *ssl = client.sslContext();
+  mbedtls_ssl_session offered;
+  mbedtls_ssl_session_init(&offered);
+#if TLS_SESSION_RESUMPTION
+  bool offer = ssl && loadSession(host, offered);
+#else
+  bool offer = false;
+#endif
+
+  unsigned long start __attribute__((unused)) = millis();
+  int64_t handshakeTime = time(nullptr);
+  bool connected = false;
+  for (int attempt = 0; !connected && attempt < (offer ? 2 : 1); ++attempt)
+  {
+    if (attempt > 0)
+    { // the offered session broke the handshake, start over without it
+      client.stop();
+      offer = false;
+#if TLS_SESSION_RESUMPTION
+      forgetSession(host);
+#endif
+    }
+    client.setPlainStart();
+    if (!client.connect(host.c_str(), port))
+    {
+      break;
+    }
+    if (offer)
+    {
+      mbedtls_ssl_set_session(ssl, &offered);
+    }
+    connected = client.startTLS();
+  }
+
+  bool resumed = false;
+  mbedtls_ssl_session current;
+  mbedtls_ssl_session_init(&current);
+  if (connected && ssl && mbedtls_ssl_get_session(ssl, &current) == 0)
+  {
+    // a server that accepts the session echoes its id
+    resumed = offer && current.id_len > 0
+           && current.id_len == offered.id_len
+           && memcmp(current.id, offered.id, current.id_len) == 0;
+#if TLS_SESSION_RESUMPTION
+    if (!resumed)
+    {
+      saveSession(host, current, handshakeTime);
+    }
+#endif
+  }
+#if DEBUG_LEVEL >= 1
+  Serial.printf("  TLS %s %s: %lu ms\n", host.c_str(),
+                !connected ? "handshake failed"
+                : resumed  ? "resumed handshake" : "full handshake",
+                millis() - start);
+#endif
+
+  mbedtls_ssl_session_free(&current);
+  mbedtls_ssl_session_free(&offered);
+  return connected;
+} // end tlsConnect